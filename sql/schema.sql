@@ -68,9 +68,32 @@ CREATE TABLE IF NOT EXISTS orders (
     created_at      TIMESTAMP     NOT NULL DEFAULT NOW(),
     updated_at      TIMESTAMP     NOT NULL DEFAULT NOW(),
     total           NUMERIC(10,2) NOT NULL DEFAULT 0.00,
-    restaurant_id   INTEGER       NOT NULL REFERENCES restaurant(id) ON DELETE CASCADE
+    restaurant_id   INTEGER       NOT NULL REFERENCES restaurant(id) ON DELETE CASCADE,
+    idempotency_key VARCHAR(64)
 );
+-- createOrder's key: ApiLogicServer ignores the Idempotency-Key header, so a
+-- retried create finds its order by this column instead of adding another
+ALTER TABLE orders ADD COLUMN IF NOT EXISTS idempotency_key VARCHAR(64);
+CREATE UNIQUE INDEX IF NOT EXISTS idx_orders_idempotency_key ON orders(idempotency_key);
 CREATE INDEX IF NOT EXISTS idx_orders_restaurant_status ON orders(restaurant_id, status);
+-- getOrderChangesSince: filter[restaurant_id] + filter[updated_at][ge]
+CREATE INDEX IF NOT EXISTS idx_orders_restaurant_updated ON orders(restaurant_id, updated_at);
+
+-- The change cursor pages on updated_at, so the database stamps it on every
+-- insert and update with its own clock, in UTC: clients never set it, and
+-- neither terminal clock skew nor a DST change can take it backwards
+CREATE OR REPLACE FUNCTION orders_stamp_updated_at() RETURNS TRIGGER AS $$
+BEGIN
+    NEW.updated_at := NOW() AT TIME ZONE 'UTC';
+    RETURN NEW;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS orders_touch_updated_at ON orders;
+DROP TRIGGER IF EXISTS orders_stamp_updated_at ON orders;
+CREATE TRIGGER orders_stamp_updated_at BEFORE INSERT OR UPDATE ON orders
+    FOR EACH ROW EXECUTE PROCEDURE orders_stamp_updated_at();
+DROP FUNCTION IF EXISTS orders_touch_updated_at();
 
 -- OrderItem (line items on an order)
 CREATE TABLE IF NOT EXISTS order_item (
@@ -79,9 +102,14 @@ CREATE TABLE IF NOT EXISTS order_item (
     unit_price            NUMERIC(10,2) NOT NULL DEFAULT 0.00,
     special_instructions  TEXT          NOT NULL DEFAULT '',
     order_id              INTEGER       NOT NULL REFERENCES orders(id) ON DELETE CASCADE,
-    menu_item_id          INTEGER       NOT NULL REFERENCES menu_item(id) ON DELETE RESTRICT
+    menu_item_id          INTEGER       NOT NULL REFERENCES menu_item(id) ON DELETE RESTRICT,
+    line_key              VARCHAR(80)
 );
 CREATE INDEX IF NOT EXISTS idx_order_item_order ON order_item(order_id);
+-- addOrderItems' per-line key (the order's idempotency key and the line's
+-- position): a retried submission looks a line up by it before posting again
+ALTER TABLE order_item ADD COLUMN IF NOT EXISTS line_key VARCHAR(80);
+CREATE UNIQUE INDEX IF NOT EXISTS idx_order_item_line_key ON order_item(line_key);
 
 -- Users (POS operators)
 CREATE TABLE IF NOT EXISTS app_user (
@@ -1,11 +1,20 @@
 #include <Wt/WApplication.h>
 #include <Wt/WServer.h>
 
+#include "ui/MetricsResource.h"
+#include "ui/OrderFeed.h"
 #include "ui/RestaurantApp.h"
+#include "services/CoalescingApiService.h"
+#include "services/HybridApiService.h"
+#include "services/InstrumentedApiService.h"
 #include "services/LocalApiService.h"
+#include "services/MenuCatalog.h"
+#include "services/OrderSubmitter.h"
 #include "services/RestApiService.h"
 #include "services/SiteConfig.h"
+#include "services/ThreadedAsyncApiService.h"
 
+#include <chrono>
 #include <memory>
 #include <iostream>
 
@@ -16,12 +25,26 @@ int main(int argc, char** argv) {
 
         // Select API service based on data_source_type config / env variable
         std::shared_ptr<IApiService> apiService;
+        std::shared_ptr<IAsyncApiService> asyncApiService;
         std::string mode = siteConfig->dataSourceType();
 
         if (mode == "ALS") {
             std::cout << "[main] Enterprise mode: connecting to ApiLogicServer at "
                       << siteConfig->apiBaseUrl() << std::endl;
-            apiService = std::make_shared<RestApiService>(siteConfig);
+            auto rest = std::make_shared<RestApiService>(siteConfig);
+            apiService = rest;
+            asyncApiService = rest;     // curl_multi event loop
+
+            // Reads fail over to a local copy of ALS while it is slow or down
+            std::string replicaPath = siteConfig->apiReplicaPath();
+            if (!replicaPath.empty()) {
+                HybridApiService::Options options;
+                options.latencyBudget =
+                    std::chrono::milliseconds(siteConfig->apiReplicaBudgetMs());
+                auto hybrid = std::make_shared<HybridApiService>(rest, replicaPath, options);
+                apiService = hybrid;
+                asyncApiService = hybrid;
+            }
         } else {
             std::cout << "[main] Local mode: using SQLite database" << std::endl;
             auto local = std::make_shared<LocalApiService>("restaurant_pos.db");
@@ -30,16 +53,52 @@ int main(int argc, char** argv) {
             apiService = local;
         }
 
+        // Per-method call counts, errors and latency for /metrics
+        apiService = std::make_shared<InstrumentedApiService>(apiService);
+
+        // SQLite has no async API; run blocking calls off Wt's request threads
+        if (!asyncApiService) {
+            asyncApiService = std::make_shared<ThreadedAsyncApiService>(apiService, 2);
+        }
+
+        // Screens polling the same restaurant share one backend read per tick
+        auto coalescing = std::make_shared<CoalescingApiService>(apiService, asyncApiService);
+        apiService = coalescing;
+        asyncApiService = coalescing;
+
+        // Menus are read once per restaurant and shared by every session;
+        // edits from outside this process show up within a minute
+        auto menuCatalog = std::make_shared<MenuCatalog>(apiService, std::chrono::seconds(60));
+
+        // One kitchen poll per restaurant, whatever the number of screens:
+        // every 5 s while orders change, backing off to once a minute
+        auto orderFeed = std::make_shared<OrderFeed>(asyncApiService);
+
+        // Orders are placed off the request thread, so the front desk can
+        // start the next one while the last is still being sent
+        auto orderSubmitter = std::make_shared<OrderSubmitter>(apiService, 4);
+
         // Store for access in application factory
         RestaurantApp::sharedApiService = apiService;
+        RestaurantApp::sharedAsyncApiService = asyncApiService;
         RestaurantApp::sharedSiteConfig = siteConfig;
+        RestaurantApp::sharedMenuCatalog = menuCatalog;
+        RestaurantApp::sharedOrderFeed = orderFeed;
+        RestaurantApp::sharedOrderSubmitter = orderSubmitter;
+
+        // Declared before the server so it outlives it
+        auto metricsResource = std::make_shared<MetricsResource>();
 
         Wt::WServer server(argc, argv);
+        server.addResource(metricsResource.get(), "/metrics");
 
         server.addEntryPoint(
             Wt::EntryPointType::Application,
-            [apiService, siteConfig](const Wt::WEnvironment& env) {
-                return std::make_unique<RestaurantApp>(env, apiService, siteConfig);
+            [apiService, asyncApiService, siteConfig, menuCatalog,
+             orderFeed, orderSubmitter](const Wt::WEnvironment& env) {
+                return std::make_unique<RestaurantApp>(env, apiService, asyncApiService,
+                                                       siteConfig, menuCatalog, orderFeed,
+                                                       orderSubmitter);
             }
         );
 
@@ -39,6 +39,7 @@ struct OrderDto {
     double total = 0.0;
     long long restaurant_id = 0;
     std::string created_at;
+    std::string updated_at;
 };
 
 struct OrderItemDto {
@@ -51,6 +52,47 @@ struct OrderItemDto {
     std::string menu_item_name;  // denormalized for display
 };
 
+// A line for IApiService::addOrderItems.  line_key, when set, is unique to
+// the line (not to its contents), so two identical lines stay two lines.
+struct NewOrderItemDto {
+    long long menu_item_id = 0;
+    int quantity = 0;
+    std::string special_instructions;
+    std::string line_key;
+};
+
+// Result of getOrderChangesSince.  `cursor` is opaque: hand it back on the
+// next call.  With `reset` set, `orders` is the restaurant's active orders
+// and replaces whatever the caller holds; otherwise it lists orders created
+// or changed since the cursor, whatever their status (so Served and
+// Cancelled show up once, for the caller to drop).
+struct OrderChangesDto {
+    std::vector<OrderDto> orders;
+    std::string cursor;
+    bool reset = false;
+};
+
+// One page of a restaurant's orders (IApiService::getOrdersPage).  An
+// empty status means every status; ties in sortBy are broken by id in the
+// same direction, so pages never overlap.
+struct OrderPageQuery {
+    std::string status;
+    std::string sortBy = "id";
+    bool descending = true;
+    int offset = 0;
+    int limit = 50;
+
+    static bool sortable(const std::string& column) {
+        return column == "id" || column == "table_number" || column == "customer_name" ||
+               column == "total" || column == "status" || column == "created_at";
+    }
+};
+
+struct OrderPageDto {
+    std::vector<OrderDto> orders;
+    int total = 0;    // matching orders across all pages
+};
+
 struct UserDto {
     long long id = 0;
     std::string username;
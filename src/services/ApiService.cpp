@@ -2,6 +2,7 @@
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <stdexcept>
 
 ApiService::ApiService(const std::string& dbPath) {
     connection_ = std::make_unique<Wt::Dbo::backend::Sqlite3>(dbPath);
@@ -23,6 +24,42 @@ void ApiService::initializeDatabase() {
     } catch (Wt::Dbo::Exception& e) {
         std::cout << "[ApiService] Tables may already exist: " << e.what() << std::endl;
     }
+
+    // Not a mapped class: databases from before it (or from loadgen) get it here
+    Wt::Dbo::Transaction t(session_);
+    session_.execute("create table if not exists order_idempotency ("
+                     "idempotency_key text primary key, order_id bigint not null)");
+
+    // Change numbering for getOrderChangesSince.  change_seq is not mapped:
+    // triggers stamp every insert and update of an order with the next
+    // value of a one-row counter, whatever wrote it (Wt::Dbo, the replica
+    // upserts, loadgen).  The update trigger's own write changes change_seq,
+    // which its `when` skips; SQLite does not recurse into triggers anyway.
+    int hasSeq = session_.query<int>(
+        "select count(1) from pragma_table_info('orders') where name = 'change_seq'");
+    if (!hasSeq) {
+        session_.execute("alter table orders add column change_seq bigint not null default 0");
+    }
+    session_.execute("create table if not exists order_change_seq ("
+                     "id integer primary key check (id = 1), seq bigint not null)");
+    session_.execute("insert or ignore into order_change_seq (id, seq) values (1, 0)");
+    session_.execute(
+        "create trigger if not exists orders_change_insert after insert on orders begin "
+        "update order_change_seq set seq = seq + 1 where id = 1; "
+        "update orders set change_seq = (select seq from order_change_seq where id = 1) "
+        "where id = new.id; end");
+    session_.execute(
+        "create trigger if not exists orders_change_update after update on orders "
+        "when new.change_seq = old.change_seq begin "
+        "update order_change_seq set seq = seq + 1 where id = 1; "
+        "update orders set change_seq = (select seq from order_change_seq where id = 1) "
+        "where id = new.id; end");
+    session_.execute("create index if not exists idx_orders_restaurant_change "
+                     "on orders (restaurant_id, change_seq)");
+
+    // getOrdersPage counts and pages by status (same name as sql/schema.sql)
+    session_.execute("create index if not exists idx_orders_restaurant_status "
+                     "on orders (restaurant_id, status)");
 }
 
 std::string ApiService::getNowTimestamp() {
@@ -360,6 +397,52 @@ std::vector<Wt::Dbo::ptr<Order>> ApiService::getActiveOrders(long long restauran
     return std::vector<Wt::Dbo::ptr<Order>>(results.begin(), results.end());
 }
 
+std::vector<Wt::Dbo::ptr<Order>> ApiService::getOrdersPage(
+    long long restaurantId, const OrderPageQuery& query, int& total)
+{
+    // sortBy goes into the SQL text, so only known columns
+    if (!OrderPageQuery::sortable(query.sortBy)) {
+        throw std::runtime_error("Orders cannot be sorted by " + query.sortBy);
+    }
+    std::string dir = query.descending ? " DESC" : " ASC";
+    std::string order = query.sortBy + dir;
+    if (query.sortBy != "id") order += ", id" + dir;
+
+    Wt::Dbo::Transaction t(session_);
+    auto count = session_.query<int>("select count(1) from orders")
+        .where("restaurant_id = ?").bind(restaurantId);
+    auto find = session_.find<Order>()
+        .where("restaurant_id = ?").bind(restaurantId);
+    if (!query.status.empty()) {
+        count.where("status = ?").bind(query.status);
+        find.where("status = ?").bind(query.status);
+    }
+    total = count.resultValue();
+    auto results = find.orderBy(order).limit(query.limit).offset(query.offset).resultList();
+    return std::vector<Wt::Dbo::ptr<Order>>(results.begin(), results.end());
+}
+
+long long ApiService::orderChangeSeq() {
+    Wt::Dbo::Transaction t(session_);
+    return session_.query<long long>("select seq from order_change_seq where id = 1")
+        .resultValue();
+}
+
+std::vector<Wt::Dbo::ptr<Order>> ApiService::getOrderChangesSince(
+    long long restaurantId, long long since, long long& upTo)
+{
+    // Writers are serialised, so every change up to the counter read here
+    // is committed and visible to the select in the same transaction
+    Wt::Dbo::Transaction t(session_);
+    upTo = orderChangeSeq();
+    auto results = session_.find<Order>()
+        .where("restaurant_id = ? AND change_seq > ? AND change_seq <= ?")
+        .bind(restaurantId).bind(since).bind(upTo)
+        .orderBy("change_seq")
+        .resultList();
+    return std::vector<Wt::Dbo::ptr<Order>>(results.begin(), results.end());
+}
+
 Wt::Dbo::ptr<Order> ApiService::getOrder(long long id) {
     Wt::Dbo::Transaction t(session_);
     return session_.find<Order>().where("id = ?").bind(id).resultValue();
@@ -367,9 +450,19 @@ Wt::Dbo::ptr<Order> ApiService::getOrder(long long id) {
 
 Wt::Dbo::ptr<Order> ApiService::createOrder(
     long long restaurantId, int tableNumber,
-    const std::string& customerName, const std::string& notes)
+    const std::string& customerName, const std::string& notes,
+    const std::string& idempotencyKey)
 {
     Wt::Dbo::Transaction t(session_);
+    if (!idempotencyKey.empty()) {
+        auto ids = session_.query<long long>(
+            "select order_id from order_idempotency where idempotency_key = ?")
+            .bind(idempotencyKey).resultList();
+        if (!ids.empty()) {
+            return session_.find<Order>().where("id = ?").bind(*ids.begin()).resultValue();
+        }
+    }
+
     auto rest = session_.find<Restaurant>().where("id = ?").bind(restaurantId).resultValue();
     auto order = session_.add(std::make_unique<Order>());
     order.modify()->table_number = tableNumber;
@@ -380,6 +473,11 @@ Wt::Dbo::ptr<Order> ApiService::createOrder(
     order.modify()->updated_at = getNowTimestamp();
     order.modify()->total = 0.0;
     order.modify()->restaurant = rest;
+    if (!idempotencyKey.empty()) {
+        order.flush();   // assigns the id
+        session_.execute("insert into order_idempotency (idempotency_key, order_id) "
+                         "values (?, ?)").bind(idempotencyKey).bind(order.id());
+    }
     t.commit();
     return order;
 }
@@ -476,3 +574,81 @@ int ApiService::getInProgressOrderCount(long long restaurantId) {
         "select count(1) from orders where restaurant_id = ? AND status = 'In Progress'")
         .bind(restaurantId);
 }
+
+// ─── Replica ─────────────────────────────────────────────────────────────────
+// Plain SQL: Wt::Dbo only inserts with ids it assigns.  Upserts update in
+// place (no replace), so rows referring to them stay valid; nullif turns
+// the DTOs' 0 "no reference" back into null.
+
+void ApiService::upsertRestaurant(const RestaurantDto& r) {
+    Wt::Dbo::Transaction t(session_);
+    session_.execute(
+        "insert into restaurant (id, version, name, cuisine_type, description) "
+        "values (?, 0, ?, ?, ?) on conflict(id) do update set "
+        "version = version + 1, name = excluded.name, "
+        "cuisine_type = excluded.cuisine_type, description = excluded.description")
+        .bind(r.id).bind(r.name).bind(r.cuisine_type).bind(r.description);
+}
+
+void ApiService::upsertCategory(const CategoryDto& c) {
+    Wt::Dbo::Transaction t(session_);
+    session_.execute(
+        "insert into category (id, version, name, sort_order, restaurant_id) "
+        "values (?, 0, ?, ?, nullif(?, 0)) on conflict(id) do update set "
+        "version = version + 1, name = excluded.name, sort_order = excluded.sort_order, "
+        "restaurant_id = excluded.restaurant_id")
+        .bind(c.id).bind(c.name).bind(c.sort_order).bind(c.restaurant_id);
+}
+
+void ApiService::upsertMenuItem(const MenuItemDto& m) {
+    Wt::Dbo::Transaction t(session_);
+    session_.execute(
+        "insert into menu_item (id, version, name, description, price, available, category_id) "
+        "values (?, 0, ?, ?, ?, ?, nullif(?, 0)) on conflict(id) do update set "
+        "version = version + 1, name = excluded.name, description = excluded.description, "
+        "price = excluded.price, available = excluded.available, "
+        "category_id = excluded.category_id")
+        .bind(m.id).bind(m.name).bind(m.description).bind(m.price).bind(m.available)
+        .bind(m.category_id);
+}
+
+void ApiService::upsertOrder(const OrderDto& o) {
+    Wt::Dbo::Transaction t(session_);
+    session_.execute(
+        "insert into orders (id, version, table_number, status, customer_name, notes, "
+        "created_at, updated_at, total, restaurant_id) "
+        "values (?, 0, ?, ?, ?, ?, ?, ?, ?, nullif(?, 0)) on conflict(id) do update set "
+        "version = version + 1, table_number = excluded.table_number, "
+        "status = excluded.status, customer_name = excluded.customer_name, "
+        "notes = excluded.notes, created_at = excluded.created_at, "
+        "updated_at = excluded.updated_at, total = excluded.total, "
+        "restaurant_id = excluded.restaurant_id")
+        .bind(o.id).bind(o.table_number).bind(o.status).bind(o.customer_name).bind(o.notes)
+        .bind(o.created_at).bind(o.updated_at).bind(o.total).bind(o.restaurant_id);
+}
+
+void ApiService::upsertOrderItem(const OrderItemDto& i) {
+    Wt::Dbo::Transaction t(session_);
+    session_.execute(
+        "insert into order_item (id, version, quantity, unit_price, special_instructions, "
+        "order_id, menu_item_id) "
+        "values (?, 0, ?, ?, ?, nullif(?, 0), nullif(?, 0)) on conflict(id) do update set "
+        "version = version + 1, quantity = excluded.quantity, "
+        "unit_price = excluded.unit_price, "
+        "special_instructions = excluded.special_instructions, "
+        "order_id = excluded.order_id, menu_item_id = excluded.menu_item_id")
+        .bind(i.id).bind(i.quantity).bind(i.unit_price).bind(i.special_instructions)
+        .bind(i.order_id).bind(i.menu_item_id);
+}
+
+std::string ApiService::latestOrderUpdate() {
+    Wt::Dbo::Transaction t(session_);
+    return session_.query<std::string>("select coalesce(max(updated_at), '') from orders")
+        .resultValue();
+}
+
+long long ApiService::latestOrderItemId() {
+    Wt::Dbo::Transaction t(session_);
+    return session_.query<long long>("select coalesce(max(id), 0) from order_item")
+        .resultValue();
+}
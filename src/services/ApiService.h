@@ -10,6 +10,7 @@
 #include <Wt/Dbo/Dbo.h>
 #include <Wt/Dbo/backend/Sqlite3.h>
 
+#include "../models/Dto.h"
 #include "../models/Models.h"
 
 // ─── Service layer that abstracts DB operations ──────────────────────────────
@@ -47,10 +48,23 @@ public:
     std::vector<Wt::Dbo::ptr<Order>> getOrdersByStatus(long long restaurantId,
                                                          const std::string& status);
     std::vector<Wt::Dbo::ptr<Order>> getActiveOrders(long long restaurantId);
+    // One page by limit/offset; `total` receives the count over all pages
+    std::vector<Wt::Dbo::ptr<Order>> getOrdersPage(long long restaurantId,
+                                                   const OrderPageQuery& query, int& total);
+    // Every order insert and update takes the next change number (see
+    // initializeDatabase).  orderChangeSeq() is the latest one handed out;
+    // getOrderChangesSince returns the restaurant's orders changed after
+    // `since`, oldest change first, and sets `upTo` to the number it read up to.
+    long long orderChangeSeq();
+    std::vector<Wt::Dbo::ptr<Order>> getOrderChangesSince(long long restaurantId,
+                                                          long long since, long long& upTo);
     Wt::Dbo::ptr<Order> getOrder(long long id);
+    // A non-empty idempotencyKey is recorded in order_idempotency (primary
+    // key); a key already there returns its order instead of inserting.
     Wt::Dbo::ptr<Order> createOrder(long long restaurantId, int tableNumber,
                                      const std::string& customerName,
-                                     const std::string& notes);
+                                     const std::string& notes,
+                                     const std::string& idempotencyKey = "");
     void addOrderItem(long long orderId, long long menuItemId,
                       int quantity, const std::string& instructions);
     void updateOrderStatus(long long orderId, const std::string& status);
@@ -70,6 +84,17 @@ public:
     int getPendingOrderCount(long long restaurantId);
     int getInProgressOrderCount(long long restaurantId);
 
+    // ── Replica (HybridApiService keeps a copy of ApiLogicServer here) ──
+    // Insert or update a row under the server's id.  Rows the session has
+    // loaded are stale afterwards: call session().rereadAll() after a batch.
+    void upsertRestaurant(const RestaurantDto& r);
+    void upsertCategory(const CategoryDto& c);
+    void upsertMenuItem(const MenuItemDto& m);
+    void upsertOrder(const OrderDto& o);
+    void upsertOrderItem(const OrderItemDto& i);
+    std::string latestOrderUpdate();     // max(updated_at), "" when there are no orders
+    long long latestOrderItemId();       // 0 when there are no items
+
     Wt::Dbo::Session& session() { return session_; }
 
 private:
@@ -0,0 +1,261 @@
+#include "CoalescingApiService.h"
+#include "Metrics.h"
+
+namespace {
+
+std::string key(const char* method, long long id) {
+    return std::string(method) + '|' + std::to_string(id);
+}
+
+}  // namespace
+
+CoalescingApiService::CoalescingApiService(std::shared_ptr<IApiService> inner,
+                                           std::shared_ptr<IAsyncApiService> asyncInner)
+    : inner_(std::move(inner)),
+      asyncInner_(std::move(asyncInner)),
+      coalesced_(&MetricsRegistry::instance().counter(
+          "pos_api_coalesced_total",
+          "Reads answered by an identical call already in flight", ""))
+{
+}
+
+void CoalescingApiService::countCoalesced() {
+    coalesced_->inc();
+}
+
+// ─── Restaurant ──────────────────────────────────────────────────────────────
+
+std::vector<RestaurantDto> CoalescingApiService::getRestaurants() {
+    return read<std::vector<RestaurantDto>>("getRestaurants",
+                                            [&] { return inner_->getRestaurants(); });
+}
+
+RestaurantDto CoalescingApiService::getRestaurant(long long id) {
+    return read<RestaurantDto>(key("getRestaurant", id),
+                               [&] { return inner_->getRestaurant(id); });
+}
+
+// ─── Category ────────────────────────────────────────────────────────────────
+
+std::vector<CategoryDto> CoalescingApiService::getCategories(long long restaurantId) {
+    return read<std::vector<CategoryDto>>(key("getCategories", restaurantId),
+                                          [&] { return inner_->getCategories(restaurantId); });
+}
+
+// ─── MenuItem ────────────────────────────────────────────────────────────────
+
+std::vector<MenuItemDto> CoalescingApiService::getMenuItemsByCategory(long long categoryId) {
+    return read<std::vector<MenuItemDto>>(
+        key("getMenuItemsByCategory", categoryId),
+        [&] { return inner_->getMenuItemsByCategory(categoryId); });
+}
+
+std::vector<MenuItemDto> CoalescingApiService::getMenuItemsByRestaurant(long long restaurantId) {
+    return read<std::vector<MenuItemDto>>(
+        key("getMenuItemsByRestaurant", restaurantId),
+        [&] { return inner_->getMenuItemsByRestaurant(restaurantId); });
+}
+
+MenuItemDto CoalescingApiService::getMenuItem(long long id) {
+    return read<MenuItemDto>(key("getMenuItem", id), [&] { return inner_->getMenuItem(id); });
+}
+
+void CoalescingApiService::updateMenuItemAvailability(long long id, bool available) {
+    write([&] { inner_->updateMenuItemAvailability(id, available); });
+}
+
+// ─── Order ───────────────────────────────────────────────────────────────────
+
+std::vector<OrderDto> CoalescingApiService::getOrders(long long restaurantId) {
+    return read<std::vector<OrderDto>>(key("getOrders", restaurantId),
+                                       [&] { return inner_->getOrders(restaurantId); });
+}
+
+std::vector<OrderDto> CoalescingApiService::getOrdersByStatus(long long restaurantId,
+                                                              const std::string& status) {
+    return read<std::vector<OrderDto>>(
+        key("getOrdersByStatus", restaurantId) + '|' + status,
+        [&] { return inner_->getOrdersByStatus(restaurantId, status); });
+}
+
+std::vector<OrderDto> CoalescingApiService::getActiveOrders(long long restaurantId) {
+    return read<std::vector<OrderDto>>(key("getActiveOrders", restaurantId),
+                                       [&] { return inner_->getActiveOrders(restaurantId); });
+}
+
+OrderPageDto CoalescingApiService::getOrdersPage(long long restaurantId,
+                                                 const OrderPageQuery& query) {
+    return read<OrderPageDto>(
+        key("getOrdersPage", restaurantId) + '|' + query.status + '|' + query.sortBy +
+            (query.descending ? "|d|" : "|a|") + std::to_string(query.offset) + '|' +
+            std::to_string(query.limit),
+        [&] { return inner_->getOrdersPage(restaurantId, query); });
+}
+
+OrderDto CoalescingApiService::getOrder(long long id) {
+    return read<OrderDto>(key("getOrder", id), [&] { return inner_->getOrder(id); });
+}
+
+OrderDto CoalescingApiService::createOrder(long long restaurantId, int tableNumber,
+                                           const std::string& customerName,
+                                           const std::string& notes,
+                                           const std::string& idempotencyKey) {
+    OrderDto order;
+    write([&] {
+        order = inner_->createOrder(restaurantId, tableNumber, customerName, notes,
+                                    idempotencyKey);
+    });
+    return order;
+}
+
+void CoalescingApiService::addOrderItem(long long orderId, long long menuItemId,
+                                        int quantity, const std::string& instructions) {
+    write([&] { inner_->addOrderItem(orderId, menuItemId, quantity, instructions); });
+}
+
+void CoalescingApiService::addOrderItems(long long orderId,
+                                         const std::vector<NewOrderItemDto>& lines,
+                                         size_t& added) {
+    write([&] { inner_->addOrderItems(orderId, lines, added); });
+}
+
+void CoalescingApiService::updateOrderStatus(long long orderId, const std::string& status) {
+    write([&] { inner_->updateOrderStatus(orderId, status); });
+}
+
+void CoalescingApiService::cancelOrder(long long orderId) {
+    write([&] { inner_->cancelOrder(orderId); });
+}
+
+OrderChangesDto CoalescingApiService::getOrderChangesSince(long long restaurantId,
+                                                           const std::string& cursor) {
+    return read<OrderChangesDto>(
+        key("getOrderChangesSince", restaurantId) + '|' + cursor,
+        [&] { return inner_->getOrderChangesSince(restaurantId, cursor); });
+}
+
+// ─── OrderItem ───────────────────────────────────────────────────────────────
+
+std::vector<OrderItemDto> CoalescingApiService::getOrderItems(long long orderId) {
+    return read<std::vector<OrderItemDto>>(key("getOrderItems", orderId),
+                                           [&] { return inner_->getOrderItems(orderId); });
+}
+
+// ─── Dashboard / reporting ───────────────────────────────────────────────────
+
+int CoalescingApiService::getOrderCount(long long restaurantId) {
+    return read<int>(key("getOrderCount", restaurantId),
+                     [&] { return inner_->getOrderCount(restaurantId); });
+}
+
+double CoalescingApiService::getRevenue(long long restaurantId) {
+    return read<double>(key("getRevenue", restaurantId),
+                        [&] { return inner_->getRevenue(restaurantId); });
+}
+
+int CoalescingApiService::getPendingOrderCount(long long restaurantId) {
+    return read<int>(key("getPendingOrderCount", restaurantId),
+                     [&] { return inner_->getPendingOrderCount(restaurantId); });
+}
+
+int CoalescingApiService::getInProgressOrderCount(long long restaurantId) {
+    return read<int>(key("getInProgressOrderCount", restaurantId),
+                     [&] { return inner_->getInProgressOrderCount(restaurantId); });
+}
+
+// ─── IAsyncApiService ────────────────────────────────────────────────────────
+
+void CoalescingApiService::getCategories(long long restaurantId,
+                                         ApiCallback<std::vector<CategoryDto>> cb) {
+    readAsync(key("getCategories", restaurantId), std::move(cb),
+              [&](ApiCallback<std::vector<CategoryDto>> done) {
+                  asyncInner_->getCategories(restaurantId, std::move(done));
+              });
+}
+
+void CoalescingApiService::getMenuItemsByCategory(long long categoryId,
+                                                  ApiCallback<std::vector<MenuItemDto>> cb) {
+    readAsync(key("getMenuItemsByCategory", categoryId), std::move(cb),
+              [&](ApiCallback<std::vector<MenuItemDto>> done) {
+                  asyncInner_->getMenuItemsByCategory(categoryId, std::move(done));
+              });
+}
+
+void CoalescingApiService::getOrders(long long restaurantId,
+                                     ApiCallback<std::vector<OrderDto>> cb) {
+    readAsync(key("getOrders", restaurantId), std::move(cb),
+              [&](ApiCallback<std::vector<OrderDto>> done) {
+                  asyncInner_->getOrders(restaurantId, std::move(done));
+              });
+}
+
+void CoalescingApiService::getOrdersByStatus(long long restaurantId, const std::string& status,
+                                             ApiCallback<std::vector<OrderDto>> cb) {
+    readAsync(key("getOrdersByStatus", restaurantId) + '|' + status, std::move(cb),
+              [&](ApiCallback<std::vector<OrderDto>> done) {
+                  asyncInner_->getOrdersByStatus(restaurantId, status, std::move(done));
+              });
+}
+
+void CoalescingApiService::getActiveOrders(long long restaurantId,
+                                           ApiCallback<std::vector<OrderDto>> cb) {
+    readAsync(key("getActiveOrders", restaurantId), std::move(cb),
+              [&](ApiCallback<std::vector<OrderDto>> done) {
+                  asyncInner_->getActiveOrders(restaurantId, std::move(done));
+              });
+}
+
+void CoalescingApiService::updateOrderStatus(long long orderId, const std::string& status,
+                                             ApiCallback<bool> cb) {
+    asyncInner_->updateOrderStatus(orderId, status,
+        [this, cb = std::move(cb)](ApiResult<bool> result) {
+            forgetInFlight();
+            cb(std::move(result));
+        });
+}
+
+void CoalescingApiService::getOrderChangesSince(long long restaurantId,
+                                                const std::string& cursor,
+                                                ApiCallback<OrderChangesDto> cb) {
+    readAsync(key("getOrderChangesSince", restaurantId) + '|' + cursor, std::move(cb),
+              [&](ApiCallback<OrderChangesDto> done) {
+                  asyncInner_->getOrderChangesSince(restaurantId, cursor, std::move(done));
+              });
+}
+
+void CoalescingApiService::getOrderItems(long long orderId,
+                                         ApiCallback<std::vector<OrderItemDto>> cb) {
+    readAsync(key("getOrderItems", orderId), std::move(cb),
+              [&](ApiCallback<std::vector<OrderItemDto>> done) {
+                  asyncInner_->getOrderItems(orderId, std::move(done));
+              });
+}
+
+void CoalescingApiService::getOrderCount(long long restaurantId, ApiCallback<int> cb) {
+    readAsync(key("getOrderCount", restaurantId), std::move(cb),
+              [&](ApiCallback<int> done) {
+                  asyncInner_->getOrderCount(restaurantId, std::move(done));
+              });
+}
+
+void CoalescingApiService::getRevenue(long long restaurantId, ApiCallback<double> cb) {
+    readAsync(key("getRevenue", restaurantId), std::move(cb),
+              [&](ApiCallback<double> done) {
+                  asyncInner_->getRevenue(restaurantId, std::move(done));
+              });
+}
+
+void CoalescingApiService::getPendingOrderCount(long long restaurantId, ApiCallback<int> cb) {
+    readAsync(key("getPendingOrderCount", restaurantId), std::move(cb),
+              [&](ApiCallback<int> done) {
+                  asyncInner_->getPendingOrderCount(restaurantId, std::move(done));
+              });
+}
+
+void CoalescingApiService::getInProgressOrderCount(long long restaurantId,
+                                                   ApiCallback<int> cb) {
+    readAsync(key("getInProgressOrderCount", restaurantId), std::move(cb),
+              [&](ApiCallback<int> done) {
+                  asyncInner_->getInProgressOrderCount(restaurantId, std::move(done));
+              });
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "IApiService.h"
+#include "IAsyncApiService.h"
+#include "SingleFlight.h"
+
+#include <memory>
+#include <string>
+
+class MetricCounter;
+
+// ─── Single-flight decorator for reads ───────────────────────────────────────
+// Identical reads that overlap in time (eight kitchen screens refreshing
+// the same restaurant on the same tick) share one backend call: the first
+// one goes through, the rest wait for it and receive the same result.
+// Sync calls coalesce with sync calls and async with async; each side
+// wraps its own inner service.
+//
+// Writes pass straight through.  When one completes, in-flight reads are
+// detached (SingleFlight::forget), so a read issued after a write never
+// gets data fetched before it.
+//
+// Exported as pos_api_coalesced_total: reads answered by another's call.
+
+class CoalescingApiService : public IApiService, public IAsyncApiService {
+public:
+    CoalescingApiService(std::shared_ptr<IApiService> inner,
+                         std::shared_ptr<IAsyncApiService> asyncInner);
+
+    // ── IApiService ──
+    std::vector<RestaurantDto> getRestaurants() override;
+    RestaurantDto getRestaurant(long long id) override;
+
+    std::vector<CategoryDto> getCategories(long long restaurantId) override;
+
+    std::vector<MenuItemDto> getMenuItemsByCategory(long long categoryId) override;
+    std::vector<MenuItemDto> getMenuItemsByRestaurant(long long restaurantId) override;
+    MenuItemDto getMenuItem(long long id) override;
+    void updateMenuItemAvailability(long long id, bool available) override;
+
+    std::vector<OrderDto> getOrders(long long restaurantId) override;
+    std::vector<OrderDto> getOrdersByStatus(long long restaurantId,
+                                             const std::string& status) override;
+    std::vector<OrderDto> getActiveOrders(long long restaurantId) override;
+    OrderPageDto getOrdersPage(long long restaurantId, const OrderPageQuery& query) override;
+    OrderDto getOrder(long long id) override;
+    OrderDto createOrder(long long restaurantId, int tableNumber,
+                          const std::string& customerName,
+                          const std::string& notes,
+                          const std::string& idempotencyKey = "") override;
+    void addOrderItem(long long orderId, long long menuItemId,
+                      int quantity, const std::string& instructions) override;
+    void addOrderItems(long long orderId, const std::vector<NewOrderItemDto>& lines,
+                       size_t& added) override;
+    void updateOrderStatus(long long orderId, const std::string& status) override;
+    void cancelOrder(long long orderId) override;
+    OrderChangesDto getOrderChangesSince(long long restaurantId,
+                                         const std::string& cursor) override;
+
+    std::vector<OrderItemDto> getOrderItems(long long orderId) override;
+
+    int getOrderCount(long long restaurantId) override;
+    double getRevenue(long long restaurantId) override;
+    int getPendingOrderCount(long long restaurantId) override;
+    int getInProgressOrderCount(long long restaurantId) override;
+
+    // ── IAsyncApiService ──
+    void getCategories(long long restaurantId,
+                       ApiCallback<std::vector<CategoryDto>> cb) override;
+    void getMenuItemsByCategory(long long categoryId,
+                                ApiCallback<std::vector<MenuItemDto>> cb) override;
+
+    void getOrders(long long restaurantId,
+                   ApiCallback<std::vector<OrderDto>> cb) override;
+    void getOrdersByStatus(long long restaurantId, const std::string& status,
+                           ApiCallback<std::vector<OrderDto>> cb) override;
+    void getActiveOrders(long long restaurantId,
+                         ApiCallback<std::vector<OrderDto>> cb) override;
+    void updateOrderStatus(long long orderId, const std::string& status,
+                           ApiCallback<bool> cb) override;
+    void getOrderChangesSince(long long restaurantId, const std::string& cursor,
+                              ApiCallback<OrderChangesDto> cb) override;
+
+    void getOrderItems(long long orderId,
+                       ApiCallback<std::vector<OrderItemDto>> cb) override;
+
+    void getOrderCount(long long restaurantId, ApiCallback<int> cb) override;
+    void getRevenue(long long restaurantId, ApiCallback<double> cb) override;
+    void getPendingOrderCount(long long restaurantId, ApiCallback<int> cb) override;
+    void getInProgressOrderCount(long long restaurantId, ApiCallback<int> cb) override;
+
+private:
+    template <typename T, typename F>
+    T read(const std::string& key, F&& call) {
+        bool shared = false;
+        T value = flights_.run<T>(key, std::forward<F>(call), &shared);
+        if (shared) countCoalesced();
+        return value;
+    }
+
+    template <typename T, typename Start>
+    void readAsync(const std::string& key, ApiCallback<T> cb, Start&& start) {
+        if (asyncFlights_.join<T>(key, std::move(cb), std::forward<Start>(start))) {
+            countCoalesced();
+        }
+    }
+
+    // A failed write may still have reached the backend, so forget either way
+    template <typename F>
+    void write(F&& call) {
+        try {
+            call();
+        } catch (...) {
+            forgetInFlight();
+            throw;
+        }
+        forgetInFlight();
+    }
+
+    void forgetInFlight() {
+        flights_.forget();
+        asyncFlights_.forget();
+    }
+
+    void countCoalesced();
+
+    std::shared_ptr<IApiService> inner_;
+    std::shared_ptr<IAsyncApiService> asyncInner_;
+    SingleFlight flights_;
+    SingleFlight asyncFlights_;
+    MetricCounter* coalesced_;
+};
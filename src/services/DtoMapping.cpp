@@ -0,0 +1,56 @@
+#include "DtoMapping.h"
+
+RestaurantDto toDto(const Wt::Dbo::ptr<Restaurant>& p) {
+    RestaurantDto d;
+    d.id           = p.id();
+    d.name         = p->name;
+    d.cuisine_type = p->cuisine_type;
+    d.description  = p->description;
+    return d;
+}
+
+CategoryDto toDto(const Wt::Dbo::ptr<Category>& p) {
+    CategoryDto d;
+    d.id            = p.id();
+    d.name          = p->name;
+    d.sort_order    = p->sort_order;
+    d.restaurant_id = p->restaurant.id();
+    return d;
+}
+
+MenuItemDto toDto(const Wt::Dbo::ptr<MenuItem>& p) {
+    MenuItemDto d;
+    d.id          = p.id();
+    d.name        = p->name;
+    d.description = p->description;
+    d.price       = p->price;
+    d.available   = p->available;
+    d.category_id = p->category.id();
+    return d;
+}
+
+OrderDto toDto(const Wt::Dbo::ptr<Order>& p) {
+    OrderDto d;
+    d.id            = p.id();
+    d.table_number  = p->table_number;
+    d.status        = p->status;
+    d.customer_name = p->customer_name;
+    d.notes         = p->notes;
+    d.total         = p->total;
+    d.restaurant_id = p->restaurant.id();
+    d.created_at    = p->created_at;
+    d.updated_at    = p->updated_at;
+    return d;
+}
+
+OrderItemDto toDto(const Wt::Dbo::ptr<OrderItem>& p) {
+    OrderItemDto d;
+    d.id                   = p.id();
+    d.quantity             = p->quantity;
+    d.unit_price           = p->unit_price;
+    d.special_instructions = p->special_instructions;
+    d.order_id             = p->order.id();
+    d.menu_item_id         = p->menu_item.id();
+    d.menu_item_name       = p->menu_item->name;
+    return d;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "../models/Dto.h"
+#include "../models/Models.h"
+
+// ─── Helpers: Wt::Dbo::ptr<T> → DTO ─────────────────────────────────────────
+// Used by LocalApiService.  Must be called inside a Wt::Dbo::Transaction:
+// OrderItem's conversion dereferences menu_item, which may lazy-load.
+
+RestaurantDto toDto(const Wt::Dbo::ptr<Restaurant>& p);
+CategoryDto toDto(const Wt::Dbo::ptr<Category>& p);
+MenuItemDto toDto(const Wt::Dbo::ptr<MenuItem>& p);
+OrderDto toDto(const Wt::Dbo::ptr<Order>& p);
+OrderItemDto toDto(const Wt::Dbo::ptr<OrderItem>& p);
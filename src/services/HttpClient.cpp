@@ -0,0 +1,339 @@
+#include "HttpClient.h"
+#include "Metrics.h"
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <map>
+
+// ─── Transfer metrics ────────────────────────────────────────────────────────
+// libcurl phase timings per request (TTFB and total are measured from the
+// start of the transfer) plus request outcomes by verb.
+
+namespace {
+
+enum Verb { VerbGet, VerbPost, VerbPatch, VerbCount };
+
+struct TransferMetrics {
+    LatencyHistogram* dns;
+    LatencyHistogram* connect;
+    LatencyHistogram* tls;
+    LatencyHistogram* ttfb;
+    LatencyHistogram* total;
+    MetricCounter* outcomes[VerbCount][3];   // [verb][ok/http_error/transport_error]
+    MetricCounter* wireBytes;
+    MetricCounter* decodedBytes;
+};
+
+TransferMetrics& transferMetrics() {
+    static TransferMetrics m = [] {
+        auto& r = MetricsRegistry::instance();
+        const char* family = "pos_http_phase_duration_seconds";
+        const char* help = "libcurl transfer phase timings (ApiLogicServer)";
+        TransferMetrics t;
+        t.dns     = &r.histogram(family, help, "phase=\"dns\"");
+        t.connect = &r.histogram(family, help, "phase=\"connect\"");
+        t.tls     = &r.histogram(family, help, "phase=\"tls\"");
+        t.ttfb    = &r.histogram(family, help, "phase=\"ttfb\"");
+        t.total   = &r.histogram(family, help, "phase=\"total\"");
+        const char* verbs[] = {"GET", "POST", "PATCH"};
+        const char* outcomes[] = {"ok", "http_error", "transport_error"};
+        for (int v = 0; v < VerbCount; v++)
+            for (int o = 0; o < 3; o++)
+                t.outcomes[v][o] = &r.counter(
+                    "pos_http_requests_total", "HTTP requests to ApiLogicServer",
+                    std::string("verb=\"") + verbs[v] + "\",outcome=\"" + outcomes[o] + "\"");
+        const char* bytesHelp = "ApiLogicServer response body bytes";
+        t.wireBytes    = &r.counter("pos_http_response_bytes_total", bytesHelp, "stage=\"wire\"");
+        t.decodedBytes = &r.counter("pos_http_response_bytes_total", bytesHelp, "stage=\"decoded\"");
+        return t;
+    }();
+    return m;
+}
+
+Verb verbOf(const std::string& method) {
+    if (method == "POST") return VerbPost;
+    if (method == "PATCH") return VerbPatch;
+    return VerbGet;
+}
+
+long long recordTransfer(CURL* curl, Verb verb, CURLcode res, long httpCode,
+                         size_t decodedBytes) {
+    TransferMetrics& m = transferMetrics();
+    int outcome = res != CURLE_OK ? 2 : (httpCode >= 400 ? 1 : 0);
+    m.outcomes[verb][outcome]->inc();
+
+    // SIZE_DOWNLOAD counts the body as received, i.e. still compressed
+    curl_off_t wire = 0;
+    curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &wire);
+    m.wireBytes->inc((uint64_t)wire);
+    m.decodedBytes->inc(decodedBytes);
+
+    curl_off_t dns = 0, connect = 0, tls = 0, ttfb = 0, total = 0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &dns);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &tls);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &ttfb);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+
+    // Reused connections report zero for the phases they skipped
+    if (connect > 0) {
+        m.dns->recordMicros((uint64_t)dns);
+        m.connect->recordMicros((uint64_t)(connect - dns));
+    }
+    if (tls > 0) m.tls->recordMicros((uint64_t)(tls - connect));
+    if (res == CURLE_OK) m.ttfb->recordMicros((uint64_t)ttfb);
+    m.total->recordMicros((uint64_t)total);
+    return (long long)wire;
+}
+
+size_t writeCallback(char* ptr, size_t size, size_t nmemb, void* userdata) {
+    auto* buf = static_cast<std::string*>(userdata);
+    buf->append(ptr, size * nmemb);
+    return size * nmemb;
+}
+
+}  // namespace
+
+// ─── Transfer ────────────────────────────────────────────────────────────────
+// Owns one easy handle and everything libcurl points into while it runs.
+
+struct HttpClient::Transfer {
+    explicit Transfer(HttpRequest r) : request(std::move(r)) {
+        easy = curl_easy_init();
+        if (!easy) return;
+
+        for (auto& h : request.headers) headers = curl_slist_append(headers, h.c_str());
+
+        curl_easy_setopt(easy, CURLOPT_URL, request.url.c_str());
+        curl_easy_setopt(easy, CURLOPT_HTTPHEADER, headers);
+        curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, writeCallback);
+        curl_easy_setopt(easy, CURLOPT_WRITEDATA, &response);
+        curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, request.timeoutMs);
+        curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);   // required off the main thread
+        curl_easy_setopt(easy, CURLOPT_PRIVATE, this);
+        // "" lets libcurl list (and transparently decode) all it was built with
+        if (request.compressed) curl_easy_setopt(easy, CURLOPT_ACCEPT_ENCODING, "");
+
+        if (request.method == "POST" || request.method == "PATCH") {
+            if (request.method == "PATCH")
+                curl_easy_setopt(easy, CURLOPT_CUSTOMREQUEST, "PATCH");
+            curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request.body.c_str());
+            curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, (long)request.body.size());
+        }
+    }
+
+    ~Transfer() {
+        if (headers) curl_slist_free_all(headers);
+        if (easy) curl_easy_cleanup(easy);
+    }
+
+    HttpResponse finish(CURLcode res) {
+        HttpResponse out;
+        curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &out.status);
+        out.wireBytes = recordTransfer(easy, verbOf(request.method), res, out.status,
+                                       response.size());
+        if (res != CURLE_OK) {
+            out.status = 0;
+            out.error = curl_easy_strerror(res);
+        }
+        out.body = std::move(response);
+        return out;
+    }
+
+    HttpRequest request;
+    CURL* easy = nullptr;
+    curl_slist* headers = nullptr;
+    std::string response;
+    std::shared_ptr<Callback> callback;    // shared with a hedge twin
+
+    Transfer* twin = nullptr;              // other copy of a hedged request, while running
+    bool duplicate = false;
+};
+
+// ─── HttpClient ──────────────────────────────────────────────────────────────
+
+HttpClient::HttpClient() {
+    curl_global_init(CURL_GLOBAL_DEFAULT);   // reference-counted by libcurl
+}
+
+HttpClient::~HttpClient() {
+    if (loop_.joinable()) {
+        stop_ = true;
+        curl_multi_wakeup(static_cast<CURLM*>(multi_));
+        loop_.join();
+        curl_multi_cleanup(static_cast<CURLM*>(multi_));
+    }
+    curl_global_cleanup();
+}
+
+namespace {
+
+// The client whose loop runs on this thread, if any
+thread_local const HttpClient* loopThread = nullptr;
+
+}  // namespace
+
+HttpResponse HttpClient::perform(const HttpRequest& request) {
+    // On the loop thread (a completion callback) waiting for the loop would
+    // never return: the request goes out unhedged instead
+    assert(!(request.hedgeAfterMs > 0 && loopThread == this));
+    if (request.hedgeAfterMs > 0 && loopThread == this) {
+        HttpRequest plain = request;
+        plain.hedgeAfterMs = 0;
+        return perform(plain);
+    }
+
+    if (request.hedgeAfterMs > 0) {
+        // Hedging needs the loop's timers; block on the result instead
+        auto done = std::make_shared<std::promise<HttpResponse>>();
+        auto result = done->get_future();
+        performAsync(request, [done](HttpResponse res) { done->set_value(std::move(res)); });
+        return result.get();
+    }
+
+    Transfer t(request);
+    if (!t.easy) {
+        HttpResponse out;
+        out.error = "Failed to init curl";
+        return out;
+    }
+    CURLcode res = curl_easy_perform(t.easy);
+    return t.finish(res);
+}
+
+void HttpClient::performAsync(HttpRequest request, Callback callback) {
+    std::call_once(loopStarted_, [this] { startLoop(); });
+
+    auto t = std::make_unique<Transfer>(std::move(request));
+    t->callback = std::make_shared<Callback>(std::move(callback));
+    if (!t->easy) {
+        HttpResponse out;
+        out.error = "Failed to init curl";
+        (*t->callback)(std::move(out));
+        return;
+    }
+
+    inFlight_++;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued_.push_back(std::move(t));
+    }
+    curl_multi_wakeup(static_cast<CURLM*>(multi_));
+}
+
+void HttpClient::startLoop() {
+    multi_ = curl_multi_init();
+    loop_ = std::thread(&HttpClient::runLoop, this);
+}
+
+void HttpClient::runLoop() {
+    using Clock = std::chrono::steady_clock;
+    loopThread = this;
+    CURLM* multi = static_cast<CURLM*>(multi_);
+    std::map<Transfer*, std::unique_ptr<Transfer>> active;
+    std::vector<std::pair<Clock::time_point, Transfer*>> hedgeTimers;
+
+    auto start = [&](std::unique_ptr<Transfer> t) {
+        curl_multi_add_handle(multi, t->easy);
+        if (t->request.hedgeAfterMs > 0 && !t->duplicate) {
+            hedgeTimers.emplace_back(
+                Clock::now() + std::chrono::milliseconds(t->request.hedgeAfterMs), t.get());
+        }
+        Transfer* raw = t.get();
+        active[raw] = std::move(t);
+    };
+
+    // Takes a transfer off the loop; the caller decides whether to keep it
+    auto detach = [&](Transfer* t) {
+        curl_multi_remove_handle(multi, t->easy);
+        hedgeTimers.erase(std::remove_if(hedgeTimers.begin(), hedgeTimers.end(),
+                              [t](const std::pair<Clock::time_point, Transfer*>& h) {
+                                  return h.second == t;
+                              }),
+                          hedgeTimers.end());
+        if (t->twin) t->twin->twin = nullptr;
+        auto it = active.find(t);
+        std::unique_ptr<Transfer> owned = std::move(it->second);
+        active.erase(it);
+        return owned;
+    };
+
+    while (!stop_) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& t : queued_) start(std::move(t));
+            queued_.clear();
+        }
+
+        // Send duplicates for hedged requests still unanswered
+        auto now = Clock::now();
+        for (size_t i = 0; i < hedgeTimers.size();) {
+            if (hedgeTimers[i].first > now) { i++; continue; }
+            Transfer* primary = hedgeTimers[i].second;
+            hedgeTimers.erase(hedgeTimers.begin() + i);
+            if (primary->twin) continue;
+            if (primary->request.hedgeAllowed && !primary->request.hedgeAllowed()) continue;
+
+            HttpRequest copy = primary->request;
+            copy.timeoutMs = std::max(1L, copy.timeoutMs - copy.hedgeAfterMs);
+            auto dup = std::make_unique<Transfer>(std::move(copy));
+            if (!dup->easy) continue;
+            dup->callback = primary->callback;
+            dup->duplicate = true;
+            dup->twin = primary;
+            primary->twin = dup.get();
+            start(std::move(dup));
+        }
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        CURLMsg* msg;
+        int remaining = 0;
+        while ((msg = curl_multi_info_read(multi, &remaining))) {
+            if (msg->msg != CURLMSG_DONE) continue;
+            CURL* easy = msg->easy_handle;
+            CURLcode res = msg->data.result;   // msg is invalid after remove_handle
+
+            Transfer* raw = nullptr;
+            curl_easy_getinfo(easy, CURLINFO_PRIVATE, &raw);
+            if (!raw || !active.count(raw)) continue;
+
+            Transfer* twin = raw->twin;
+            std::unique_ptr<Transfer> t = detach(raw);
+            HttpResponse response = t->finish(res);
+            response.hedged = t->duplicate;
+
+            if (twin) {
+                // A failed copy leaves the answer to the one still running
+                if (!response.ok()) continue;
+                detach(twin);   // cancelled; destroyed here
+            }
+
+            inFlight_--;
+            try {
+                (*t->callback)(std::move(response));
+            } catch (std::exception& e) {
+                std::cerr << "[HttpClient] Callback for " << t->request.url
+                          << " threw: " << e.what() << std::endl;
+            }
+        }
+
+        // Sleeps until socket activity, a curl timeout, the next hedge or
+        // curl_multi_wakeup()
+        int waitMs = 1000;
+        now = Clock::now();
+        for (auto& h : hedgeTimers) {
+            auto due = std::chrono::duration_cast<std::chrono::milliseconds>(h.first - now).count();
+            waitMs = std::max(0, std::min(waitMs, (int)due));
+        }
+        curl_multi_poll(multi, nullptr, 0, waitMs, nullptr);
+    }
+
+    for (auto& kv : active) curl_multi_remove_handle(multi, kv.first->easy);
+}
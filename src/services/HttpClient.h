@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ─── libcurl transport for RestApiService ────────────────────────────────────
+// perform()       blocking transfer on the calling thread (curl easy API)
+// performAsync()  queued onto one curl_multi event-loop thread; the callback
+//                 runs on that thread when the transfer completes
+//
+// Both paths share option setup and record transfer-phase metrics
+// (pos_http_phase_duration_seconds, pos_http_requests_total) and response
+// sizes before and after content decoding (pos_http_response_bytes_total).
+//
+// Hedging: with hedgeAfterMs set, the loop sends a duplicate of the request
+// if no answer has arrived by then (and hedgeAllowed, if given, agrees at
+// that moment).  The first successful answer wins and the other transfer
+// is cancelled.  Only use it for idempotent requests.  A blocking perform()
+// of a hedged request is routed through the loop; from the loop thread
+// itself (a completion callback), where that would deadlock, it asserts,
+// and in release builds sends the request unhedged.
+
+struct HttpRequest {
+    std::string method = "GET";            // GET, POST or PATCH
+    std::string url;
+    std::string body;
+    std::vector<std::string> headers;      // "Name: value"
+    long timeoutMs = 10000;
+    bool compressed = false;               // offer every encoding libcurl decodes (gzip, br, ...)
+
+    long hedgeAfterMs = 0;                 // 0: never hedge
+    std::function<bool()> hedgeAllowed;    // runs on the loop thread
+};
+
+struct HttpResponse {
+    long status = 0;                       // 0 when the transfer failed
+    std::string body;
+    std::string error;                     // transport error, empty on success
+    bool hedged = false;                   // answered by the duplicate
+    long long wireBytes = 0;               // body bytes received, before decoding
+
+    bool ok() const { return error.empty() && status > 0 && status < 400; }
+};
+
+class HttpClient {
+public:
+    using Callback = std::function<void(HttpResponse)>;
+
+    HttpClient();
+    ~HttpClient();   // stops the loop; callbacks of unfinished transfers are dropped
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    HttpResponse perform(const HttpRequest& request);
+    void performAsync(HttpRequest request, Callback callback);
+
+    // Transfers queued or running on the event loop
+    int inFlight() const { return inFlight_.load(std::memory_order_relaxed); }
+
+private:
+    struct Transfer;
+
+    void startLoop();
+    void runLoop();
+
+    void* multi_ = nullptr;                // CURLM*, created with the loop
+    std::thread loop_;
+    std::once_flag loopStarted_;
+    std::atomic<bool> stop_{false};
+    std::atomic<int> inFlight_{0};
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<Transfer>> queued_;
+};
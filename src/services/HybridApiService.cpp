@@ -0,0 +1,430 @@
+#include "HybridApiService.h"
+#include "Metrics.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+const char* reasonLabel(int i) {
+    static const char* labels[] = {"catalog", "circuit_open", "pull_failed", "slow", "error"};
+    return labels[i];
+}
+
+}  // namespace
+
+HybridApiService::HybridApiService(std::shared_ptr<RestApiService> remote,
+                                   const std::string& replicaPath, Options options)
+    : remote_(std::move(remote)),
+      replica_(std::make_shared<LocalApiService>(replicaPath)),
+      replicaAsync_(replica_, 1),
+      options_(options)
+{
+    auto& r = MetricsRegistry::instance();
+    for (int i = 0; i < static_cast<int>(Reason::Count_); i++) {
+        replicaReads_[i] = &r.counter("pos_replica_reads_total",
+                                      "Reads answered from the local ALS replica",
+                                      std::string("reason=\"") + reasonLabel(i) + "\"");
+    }
+    pullsOk_ = &r.counter("pos_replica_pulls_total", "Replica change pulls from ALS",
+                          "result=\"ok\"");
+    pullsFailed_ = &r.counter("pos_replica_pulls_total", "Replica change pulls from ALS",
+                              "result=\"error\"");
+    age_ = &r.gauge("pos_replica_age_seconds",
+                    "Seconds since the replica last pulled from ALS", "");
+
+    replica_->initializeDatabase();
+    orderCursor_ = replica_->latestOrderUpdate();
+    itemCursor_ = replica_->latestOrderItemId();
+    // A replica left by an earlier run is better than nothing if ALS is
+    // down now; until then only its catalog is out of date
+    hasData_ = !orderCursor_.empty() || !replica_->getRestaurants().empty();
+    std::cout << "[HybridApi] Replica " << replicaPath << " resumes at "
+              << (orderCursor_.empty() ? "(empty)" : orderCursor_) << std::endl;
+
+    lastPull_ = std::chrono::system_clock::now();
+    puller_ = std::thread(&HybridApiService::runPuller, this);
+}
+
+HybridApiService::~HybridApiService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (puller_.joinable()) puller_.join();
+}
+
+// ─── Routing ─────────────────────────────────────────────────────────────────
+
+HybridApiService::Reason HybridApiService::degradedReason() const {
+    if (remote_->circuitOpen()) return Reason::CircuitOpen;
+    if (pullFailed_) return Reason::PullFailed;
+    if (slow_) return Reason::Slow;
+    return Reason::Count_;
+}
+
+void HybridApiService::noteLatency(Clock::duration elapsed) {
+    if (elapsed > options_.latencyBudget) slow_ = true;
+}
+
+void HybridApiService::countReplicaRead(Reason why) {
+    replicaReads_[static_cast<int>(why)]->inc();
+}
+
+void HybridApiService::logReplicaError(const std::exception& e) {
+    std::cerr << "[HybridApi] Replica update failed: " << e.what() << std::endl;
+}
+
+void HybridApiService::wakePuller() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wakeRequested_ = true;
+    }
+    wake_.notify_one();
+}
+
+// ─── Puller ──────────────────────────────────────────────────────────────────
+
+void HybridApiService::runPuller() {
+    Clock::time_point nextCatalog;   // due at once
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        lock.unlock();
+        pull(nextCatalog);
+        lock.lock();
+        wake_.wait_for(lock, options_.pullInterval, [this] { return stop_ || wakeRequested_; });
+        wakeRequested_ = false;
+    }
+}
+
+void HybridApiService::pull(Clock::time_point& nextCatalog) {
+    try {
+        if (Clock::now() >= nextCatalog) {
+            auto restaurants = remote_->pullRestaurants();
+            auto categories = remote_->pullCategories();
+            auto menuItems = remote_->pullMenuItems();
+            replica_->applyCatalog(restaurants, categories, menuItems);
+            catalogPulled_ = true;
+            nextCatalog = Clock::now() + options_.catalogInterval;
+        }
+
+        // Items first: every item's order exists by then, so the order pull
+        // that follows brings any the replica lacks
+        bool catchingUp = orderCursor_.empty();
+        auto start = Clock::now();
+        auto items = remote_->pullOrderItemsAfter(itemCursor_);
+        auto orders = remote_->pullOrdersUpdatedSince(orderCursor_);
+        auto elapsed = Clock::now() - start;
+
+        try {
+            replica_->applyOrders(orders, items);
+        } catch (std::exception&) {
+            // Most likely an item for a menu item newer than our catalog
+            nextCatalog = Clock::now();
+            throw;
+        }
+        for (auto& o : orders) orderCursor_ = std::max(orderCursor_, o.updated_at);
+        for (auto& i : items) itemCursor_ = std::max(itemCursor_, i.id);
+
+        hasData_ = true;
+        // The first pull copies everything; only change pulls measure ALS
+        if (!catchingUp) slow_ = elapsed > options_.latencyBudget;
+        if (pullFailed_) std::cout << "[HybridApi] ALS reachable again" << std::endl;
+        pullFailed_ = false;
+        lastPull_ = std::chrono::system_clock::now();
+        pullsOk_->inc();
+    } catch (std::exception& e) {
+        if (!pullFailed_) {
+            std::cerr << "[HybridApi] Pull failed, reads fail over to the replica: "
+                      << e.what() << std::endl;
+        }
+        pullFailed_ = true;
+        pullsFailed_->inc();
+    }
+    age_->set(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now() - lastPull_).count());
+}
+
+// ─── Restaurant ──────────────────────────────────────────────────────────────
+
+std::vector<RestaurantDto> HybridApiService::getRestaurants() {
+    return catalogRead<std::vector<RestaurantDto>>(
+        [&] { return remote_->getRestaurants(); },
+        [&] { return replica_->getRestaurants(); });
+}
+
+RestaurantDto HybridApiService::getRestaurant(long long id) {
+    return catalogRead<RestaurantDto>([&] { return remote_->getRestaurant(id); },
+                                      [&] { return replica_->getRestaurant(id); });
+}
+
+// ─── Category ────────────────────────────────────────────────────────────────
+
+std::vector<CategoryDto> HybridApiService::getCategories(long long restaurantId) {
+    return catalogRead<std::vector<CategoryDto>>(
+        [&] { return remote_->getCategories(restaurantId); },
+        [&] { return replica_->getCategories(restaurantId); });
+}
+
+// ─── MenuItem ────────────────────────────────────────────────────────────────
+
+std::vector<MenuItemDto> HybridApiService::getMenuItemsByCategory(long long categoryId) {
+    return catalogRead<std::vector<MenuItemDto>>(
+        [&] { return remote_->getMenuItemsByCategory(categoryId); },
+        [&] { return replica_->getMenuItemsByCategory(categoryId); });
+}
+
+std::vector<MenuItemDto> HybridApiService::getMenuItemsByRestaurant(long long restaurantId) {
+    return catalogRead<std::vector<MenuItemDto>>(
+        [&] { return remote_->getMenuItemsByRestaurant(restaurantId); },
+        [&] { return replica_->getMenuItemsByRestaurant(restaurantId); });
+}
+
+MenuItemDto HybridApiService::getMenuItem(long long id) {
+    return catalogRead<MenuItemDto>([&] { return remote_->getMenuItem(id); },
+                                    [&] { return replica_->getMenuItem(id); });
+}
+
+void HybridApiService::updateMenuItemAvailability(long long id, bool available) {
+    remote_->updateMenuItemAvailability(id, available);
+    applyLocally([&] { replica_->updateMenuItemAvailability(id, available); });
+}
+
+// ─── Order ───────────────────────────────────────────────────────────────────
+
+std::vector<OrderDto> HybridApiService::getOrders(long long restaurantId) {
+    return read<std::vector<OrderDto>>([&] { return remote_->getOrders(restaurantId); },
+                                       [&] { return replica_->getOrders(restaurantId); });
+}
+
+std::vector<OrderDto> HybridApiService::getOrdersByStatus(long long restaurantId,
+                                                          const std::string& status) {
+    return read<std::vector<OrderDto>>(
+        [&] { return remote_->getOrdersByStatus(restaurantId, status); },
+        [&] { return replica_->getOrdersByStatus(restaurantId, status); });
+}
+
+std::vector<OrderDto> HybridApiService::getActiveOrders(long long restaurantId) {
+    return read<std::vector<OrderDto>>([&] { return remote_->getActiveOrders(restaurantId); },
+                                       [&] { return replica_->getActiveOrders(restaurantId); });
+}
+
+OrderPageDto HybridApiService::getOrdersPage(long long restaurantId,
+                                             const OrderPageQuery& query) {
+    return read<OrderPageDto>([&] { return remote_->getOrdersPage(restaurantId, query); },
+                              [&] { return replica_->getOrdersPage(restaurantId, query); });
+}
+
+OrderDto HybridApiService::getOrder(long long id) {
+    return read<OrderDto>([&] { return remote_->getOrder(id); },
+                          [&] { return replica_->getOrder(id); });
+}
+
+OrderDto HybridApiService::createOrder(long long restaurantId, int tableNumber,
+                                       const std::string& customerName,
+                                       const std::string& notes,
+                                       const std::string& idempotencyKey) {
+    OrderDto order = remote_->createOrder(restaurantId, tableNumber, customerName, notes,
+                                          idempotencyKey);
+    // Provisional (queued) orders reach the replica through a later pull
+    applyLocally([&] {
+        if (order.id > 0) replica_->applyOrders({order}, {});
+    });
+    return order;
+}
+
+void HybridApiService::addOrderItem(long long orderId, long long menuItemId,
+                                    int quantity, const std::string& instructions) {
+    remote_->addOrderItem(orderId, menuItemId, quantity, instructions);
+    // Item ids are the server's; the next pull brings the row
+    wakePuller();
+}
+
+void HybridApiService::addOrderItems(long long orderId,
+                                     const std::vector<NewOrderItemDto>& lines,
+                                     size_t& added) {
+    remote_->addOrderItems(orderId, lines, added);
+    wakePuller();
+}
+
+void HybridApiService::updateOrderStatus(long long orderId, const std::string& status) {
+    remote_->updateOrderStatus(orderId, status);
+    applyLocally([&] { replica_->updateOrderStatus(orderId, status); });
+}
+
+void HybridApiService::cancelOrder(long long orderId) {
+    remote_->cancelOrder(orderId);
+    applyLocally([&] { replica_->cancelOrder(orderId); });
+}
+
+// The two sides' cursors differ, so a switch between them costs the caller
+// one snapshot
+OrderChangesDto HybridApiService::getOrderChangesSince(long long restaurantId,
+                                                       const std::string& cursor) {
+    return read<OrderChangesDto>(
+        [&] { return remote_->getOrderChangesSince(restaurantId, cursor); },
+        [&] { return replica_->getOrderChangesSince(restaurantId, cursor); });
+}
+
+// ─── OrderItem ───────────────────────────────────────────────────────────────
+
+std::vector<OrderItemDto> HybridApiService::getOrderItems(long long orderId) {
+    return read<std::vector<OrderItemDto>>([&] { return remote_->getOrderItems(orderId); },
+                                           [&] { return replica_->getOrderItems(orderId); });
+}
+
+// ─── Dashboard / reporting ───────────────────────────────────────────────────
+
+int HybridApiService::getOrderCount(long long restaurantId) {
+    return read<int>([&] { return remote_->getOrderCount(restaurantId); },
+                     [&] { return replica_->getOrderCount(restaurantId); });
+}
+
+double HybridApiService::getRevenue(long long restaurantId) {
+    return read<double>([&] { return remote_->getRevenue(restaurantId); },
+                        [&] { return replica_->getRevenue(restaurantId); });
+}
+
+int HybridApiService::getPendingOrderCount(long long restaurantId) {
+    return read<int>([&] { return remote_->getPendingOrderCount(restaurantId); },
+                     [&] { return replica_->getPendingOrderCount(restaurantId); });
+}
+
+int HybridApiService::getInProgressOrderCount(long long restaurantId) {
+    return read<int>([&] { return remote_->getInProgressOrderCount(restaurantId); },
+                     [&] { return replica_->getInProgressOrderCount(restaurantId); });
+}
+
+// ─── IAsyncApiService ────────────────────────────────────────────────────────
+// Replica reads run on replicaAsync_'s worker; ALS reads on the curl loop.
+
+void HybridApiService::getCategories(long long restaurantId,
+                                     ApiCallback<std::vector<CategoryDto>> cb) {
+    readAsync<std::vector<CategoryDto>>(std::move(cb),
+        [this, restaurantId](ApiCallback<std::vector<CategoryDto>> done) {
+            remote_->getCategories(restaurantId, std::move(done));
+        },
+        [this, restaurantId](ApiCallback<std::vector<CategoryDto>> done) {
+            replicaAsync_.getCategories(restaurantId, std::move(done));
+        },
+        true);
+}
+
+void HybridApiService::getMenuItemsByCategory(long long categoryId,
+                                              ApiCallback<std::vector<MenuItemDto>> cb) {
+    readAsync<std::vector<MenuItemDto>>(std::move(cb),
+        [this, categoryId](ApiCallback<std::vector<MenuItemDto>> done) {
+            remote_->getMenuItemsByCategory(categoryId, std::move(done));
+        },
+        [this, categoryId](ApiCallback<std::vector<MenuItemDto>> done) {
+            replicaAsync_.getMenuItemsByCategory(categoryId, std::move(done));
+        },
+        true);
+}
+
+void HybridApiService::getOrders(long long restaurantId,
+                                 ApiCallback<std::vector<OrderDto>> cb) {
+    readAsync<std::vector<OrderDto>>(std::move(cb),
+        [this, restaurantId](ApiCallback<std::vector<OrderDto>> done) {
+            remote_->getOrders(restaurantId, std::move(done));
+        },
+        [this, restaurantId](ApiCallback<std::vector<OrderDto>> done) {
+            replicaAsync_.getOrders(restaurantId, std::move(done));
+        });
+}
+
+void HybridApiService::getOrdersByStatus(long long restaurantId, const std::string& status,
+                                         ApiCallback<std::vector<OrderDto>> cb) {
+    readAsync<std::vector<OrderDto>>(std::move(cb),
+        [this, restaurantId, status](ApiCallback<std::vector<OrderDto>> done) {
+            remote_->getOrdersByStatus(restaurantId, status, std::move(done));
+        },
+        [this, restaurantId, status](ApiCallback<std::vector<OrderDto>> done) {
+            replicaAsync_.getOrdersByStatus(restaurantId, status, std::move(done));
+        });
+}
+
+void HybridApiService::getActiveOrders(long long restaurantId,
+                                       ApiCallback<std::vector<OrderDto>> cb) {
+    readAsync<std::vector<OrderDto>>(std::move(cb),
+        [this, restaurantId](ApiCallback<std::vector<OrderDto>> done) {
+            remote_->getActiveOrders(restaurantId, std::move(done));
+        },
+        [this, restaurantId](ApiCallback<std::vector<OrderDto>> done) {
+            replicaAsync_.getActiveOrders(restaurantId, std::move(done));
+        });
+}
+
+void HybridApiService::getOrderChangesSince(long long restaurantId, const std::string& cursor,
+                                            ApiCallback<OrderChangesDto> cb) {
+    readAsync<OrderChangesDto>(std::move(cb),
+        [this, restaurantId, cursor](ApiCallback<OrderChangesDto> done) {
+            remote_->getOrderChangesSince(restaurantId, cursor, std::move(done));
+        },
+        [this, restaurantId, cursor](ApiCallback<OrderChangesDto> done) {
+            replicaAsync_.getOrderChangesSince(restaurantId, cursor, std::move(done));
+        });
+}
+
+void HybridApiService::updateOrderStatus(long long orderId, const std::string& status,
+                                         ApiCallback<bool> cb) {
+    remote_->updateOrderStatus(orderId, status,
+        [this, orderId, status, cb = std::move(cb)](ApiResult<bool> result) {
+            // Off the curl loop: the replica write is a SQLite transaction
+            if (result.ok()) replicaAsync_.updateOrderStatus(orderId, status, [](ApiResult<bool>) {});
+            wakePuller();
+            cb(std::move(result));
+        });
+}
+
+void HybridApiService::getOrderItems(long long orderId,
+                                     ApiCallback<std::vector<OrderItemDto>> cb) {
+    readAsync<std::vector<OrderItemDto>>(std::move(cb),
+        [this, orderId](ApiCallback<std::vector<OrderItemDto>> done) {
+            remote_->getOrderItems(orderId, std::move(done));
+        },
+        [this, orderId](ApiCallback<std::vector<OrderItemDto>> done) {
+            replicaAsync_.getOrderItems(orderId, std::move(done));
+        });
+}
+
+void HybridApiService::getOrderCount(long long restaurantId, ApiCallback<int> cb) {
+    readAsync<int>(std::move(cb),
+        [this, restaurantId](ApiCallback<int> done) {
+            remote_->getOrderCount(restaurantId, std::move(done));
+        },
+        [this, restaurantId](ApiCallback<int> done) {
+            replicaAsync_.getOrderCount(restaurantId, std::move(done));
+        });
+}
+
+void HybridApiService::getRevenue(long long restaurantId, ApiCallback<double> cb) {
+    readAsync<double>(std::move(cb),
+        [this, restaurantId](ApiCallback<double> done) {
+            remote_->getRevenue(restaurantId, std::move(done));
+        },
+        [this, restaurantId](ApiCallback<double> done) {
+            replicaAsync_.getRevenue(restaurantId, std::move(done));
+        });
+}
+
+void HybridApiService::getPendingOrderCount(long long restaurantId, ApiCallback<int> cb) {
+    readAsync<int>(std::move(cb),
+        [this, restaurantId](ApiCallback<int> done) {
+            remote_->getPendingOrderCount(restaurantId, std::move(done));
+        },
+        [this, restaurantId](ApiCallback<int> done) {
+            replicaAsync_.getPendingOrderCount(restaurantId, std::move(done));
+        });
+}
+
+void HybridApiService::getInProgressOrderCount(long long restaurantId, ApiCallback<int> cb) {
+    readAsync<int>(std::move(cb),
+        [this, restaurantId](ApiCallback<int> done) {
+            remote_->getInProgressOrderCount(restaurantId, std::move(done));
+        },
+        [this, restaurantId](ApiCallback<int> done) {
+            replicaAsync_.getInProgressOrderCount(restaurantId, std::move(done));
+        });
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#include "IApiService.h"
+#include "IAsyncApiService.h"
+#include "LocalApiService.h"
+#include "RestApiService.h"
+#include "ThreadedAsyncApiService.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class MetricCounter;
+class MetricGauge;
+
+// ─── ALS with a local read replica ───────────────────────────────────────────
+// Keeps a SQLite copy of ApiLogicServer's data (a LocalApiService, so the
+// schema and queries are LOCAL mode's) and answers reads from it when ALS
+// cannot:
+//   - menu reads (restaurants, categories, menu items) come from the
+//     replica once it has pulled the catalog; they rarely change and are
+//     refreshed every catalogInterval;
+//   - order and dashboard reads go to ALS while it is healthy, and to the
+//     replica while the circuit is open, the last pull failed or took
+//     longer than latencyBudget, or when the ALS call itself fails or
+//     overruns the budget.  The next good pull switches them back.
+//
+// Writes always go to ALS (or its outbox).  Order status and availability
+// changes and new orders are applied to the replica as well, and the
+// puller is woken, so a screen served locally sees its own writes.
+//
+// A background thread pulls every pullInterval: order items by id and
+// orders by updated_at (one request each, just the changes), and the
+// catalog in full when due.  Both cursors resume from the replica file.
+//
+// Exported as pos_replica_reads_total{reason}, pos_replica_pulls_total{result}
+// and pos_replica_age_seconds (since the last successful pull).
+
+class HybridApiService : public IApiService, public IAsyncApiService {
+public:
+    struct Options {
+        std::chrono::milliseconds pullInterval{1000};
+        std::chrono::seconds catalogInterval{60};
+        std::chrono::milliseconds latencyBudget{500};
+    };
+
+    HybridApiService(std::shared_ptr<RestApiService> remote, const std::string& replicaPath,
+                     Options options);
+    ~HybridApiService();
+
+    HybridApiService(const HybridApiService&) = delete;
+    HybridApiService& operator=(const HybridApiService&) = delete;
+
+    // ── IApiService ──
+    std::vector<RestaurantDto> getRestaurants() override;
+    RestaurantDto getRestaurant(long long id) override;
+
+    std::vector<CategoryDto> getCategories(long long restaurantId) override;
+
+    std::vector<MenuItemDto> getMenuItemsByCategory(long long categoryId) override;
+    std::vector<MenuItemDto> getMenuItemsByRestaurant(long long restaurantId) override;
+    MenuItemDto getMenuItem(long long id) override;
+    void updateMenuItemAvailability(long long id, bool available) override;
+
+    std::vector<OrderDto> getOrders(long long restaurantId) override;
+    std::vector<OrderDto> getOrdersByStatus(long long restaurantId,
+                                             const std::string& status) override;
+    std::vector<OrderDto> getActiveOrders(long long restaurantId) override;
+    OrderPageDto getOrdersPage(long long restaurantId, const OrderPageQuery& query) override;
+    OrderDto getOrder(long long id) override;
+    OrderDto createOrder(long long restaurantId, int tableNumber,
+                          const std::string& customerName,
+                          const std::string& notes,
+                          const std::string& idempotencyKey = "") override;
+    void addOrderItem(long long orderId, long long menuItemId,
+                      int quantity, const std::string& instructions) override;
+    void addOrderItems(long long orderId, const std::vector<NewOrderItemDto>& lines,
+                       size_t& added) override;
+    void updateOrderStatus(long long orderId, const std::string& status) override;
+    void cancelOrder(long long orderId) override;
+    OrderChangesDto getOrderChangesSince(long long restaurantId,
+                                         const std::string& cursor) override;
+
+    std::vector<OrderItemDto> getOrderItems(long long orderId) override;
+
+    int getOrderCount(long long restaurantId) override;
+    double getRevenue(long long restaurantId) override;
+    int getPendingOrderCount(long long restaurantId) override;
+    int getInProgressOrderCount(long long restaurantId) override;
+
+    // ── IAsyncApiService ──
+    void getCategories(long long restaurantId,
+                       ApiCallback<std::vector<CategoryDto>> cb) override;
+    void getMenuItemsByCategory(long long categoryId,
+                                ApiCallback<std::vector<MenuItemDto>> cb) override;
+
+    void getOrders(long long restaurantId,
+                   ApiCallback<std::vector<OrderDto>> cb) override;
+    void getOrdersByStatus(long long restaurantId, const std::string& status,
+                           ApiCallback<std::vector<OrderDto>> cb) override;
+    void getActiveOrders(long long restaurantId,
+                         ApiCallback<std::vector<OrderDto>> cb) override;
+    void updateOrderStatus(long long orderId, const std::string& status,
+                           ApiCallback<bool> cb) override;
+    void getOrderChangesSince(long long restaurantId, const std::string& cursor,
+                              ApiCallback<OrderChangesDto> cb) override;
+
+    void getOrderItems(long long orderId,
+                       ApiCallback<std::vector<OrderItemDto>> cb) override;
+
+    void getOrderCount(long long restaurantId, ApiCallback<int> cb) override;
+    void getRevenue(long long restaurantId, ApiCallback<double> cb) override;
+    void getPendingOrderCount(long long restaurantId, ApiCallback<int> cb) override;
+    void getInProgressOrderCount(long long restaurantId, ApiCallback<int> cb) override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Reason { Catalog, CircuitOpen, PullFailed, Slow, Error, Count_ };
+
+    // Why reads should not go to ALS right now; Count_ when they may
+    Reason degradedReason() const;
+
+    // Order-class read: ALS unless degraded, the replica as fallback
+    template <typename T, typename Remote, typename Local>
+    T read(Remote&& remote, Local&& local) {
+        if (hasData_) {
+            Reason why = degradedReason();
+            if (why != Reason::Count_) {
+                countReplicaRead(why);
+                return local();
+            }
+        }
+        auto start = Clock::now();
+        try {
+            T value = remote();
+            noteLatency(Clock::now() - start);
+            return value;
+        } catch (std::exception&) {
+            if (!hasData_) throw;
+            slow_ = true;
+            countReplicaRead(Reason::Error);
+            return local();
+        }
+    }
+
+    // Menu read: the replica once it holds a current catalog
+    template <typename T, typename Remote, typename Local>
+    T catalogRead(Remote&& remote, Local&& local) {
+        if (catalogPulled_) {
+            try {
+                T value = local();
+                countReplicaRead(Reason::Catalog);
+                return value;
+            } catch (std::exception&) {
+                // Not in the replica yet (added since the last catalog pull)
+            }
+        }
+        return read<T>(std::forward<Remote>(remote), std::forward<Local>(local));
+    }
+
+    template <typename T, typename Remote, typename Local>
+    void readAsync(ApiCallback<T> cb, Remote remote, Local local, bool catalog = false) {
+        if (catalog && catalogPulled_) {
+            countReplicaRead(Reason::Catalog);
+            local(std::move(cb));
+            return;
+        }
+        if (hasData_) {
+            Reason why = degradedReason();
+            if (why != Reason::Count_) {
+                countReplicaRead(why);
+                local(std::move(cb));
+                return;
+            }
+        }
+        auto start = Clock::now();
+        remote([this, cb = std::move(cb), local, start](ApiResult<T> result) mutable {
+            if (!result.ok() && hasData_) {
+                slow_ = true;
+                countReplicaRead(Reason::Error);
+                local(std::move(cb));
+                return;
+            }
+            noteLatency(Clock::now() - start);
+            cb(std::move(result));
+        });
+    }
+
+    void noteLatency(Clock::duration elapsed);
+    void countReplicaRead(Reason why);
+    void wakePuller();
+
+    // Replica bookkeeping after a write must not fail the write
+    template <typename F>
+    void applyLocally(F&& apply) {
+        try {
+            apply();
+        } catch (std::exception& e) {
+            logReplicaError(e);
+        }
+        wakePuller();
+    }
+    void logReplicaError(const std::exception& e);
+
+    void runPuller();
+    void pull(Clock::time_point& nextCatalog);
+
+    std::shared_ptr<RestApiService> remote_;
+    std::shared_ptr<LocalApiService> replica_;
+    ThreadedAsyncApiService replicaAsync_;   // replica reads off the caller's thread
+    Options options_;
+
+    std::atomic<bool> hasData_{false};       // replica holds at least one pull
+    std::atomic<bool> catalogPulled_{false}; // catalog pulled since start
+    std::atomic<bool> pullFailed_{false};
+    std::atomic<bool> slow_{false};          // cleared by a pull within budget
+
+    // Puller thread only
+    std::string orderCursor_;                // newest updated_at in the replica
+    long long itemCursor_ = 0;               // highest order_item id in the replica
+    std::chrono::system_clock::time_point lastPull_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool wakeRequested_ = false;
+    bool stop_ = false;
+    std::thread puller_;
+
+    MetricCounter* replicaReads_[static_cast<int>(Reason::Count_)];
+    MetricCounter* pullsOk_;
+    MetricCounter* pullsFailed_;
+    MetricGauge* age_;
+};
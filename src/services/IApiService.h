@@ -32,14 +32,38 @@ public:
     virtual std::vector<OrderDto> getOrdersByStatus(long long restaurantId,
                                                      const std::string& status) = 0;
     virtual std::vector<OrderDto> getActiveOrders(long long restaurantId) = 0;
+    // For paged tables; throws std::runtime_error unless
+    // OrderPageQuery::sortable(query.sortBy)
+    virtual OrderPageDto getOrdersPage(long long restaurantId, const OrderPageQuery& query) = 0;
     virtual OrderDto getOrder(long long id) = 0;
+    // With a non-empty idempotencyKey the call is safe to repeat: a key
+    // already used returns the order it created, without writing again.
     virtual OrderDto createOrder(long long restaurantId, int tableNumber,
                                   const std::string& customerName,
-                                  const std::string& notes) = 0;
+                                  const std::string& notes,
+                                  const std::string& idempotencyKey = "") = 0;
     virtual void addOrderItem(long long orderId, long long menuItemId,
                               int quantity, const std::string& instructions) = 0;
+    // Adds lines[added..], advancing `added` past each line once it is in,
+    // so after a failure the same call can be made again to resume.  Where
+    // adding a line takes several requests (ALS) the order total is set
+    // once, after the last line, and a line with a line_key that is already
+    // on the order is not added twice.
+    virtual void addOrderItems(long long orderId, const std::vector<NewOrderItemDto>& lines,
+                               size_t& added) {
+        for (; added < lines.size(); added++) {
+            auto& line = lines[added];
+            addOrderItem(orderId, line.menu_item_id, line.quantity, line.special_instructions);
+        }
+    }
     virtual void updateOrderStatus(long long orderId, const std::string& status) = 0;
     virtual void cancelOrder(long long orderId) = 0;
+    // Polling without refetching: pass "" the first time (a full snapshot,
+    // reset set), then the cursor of the previous result.  A cursor from
+    // another implementation also gets a snapshot.  Orders changed in the
+    // cursor's own instant may be repeated; applying them is idempotent.
+    virtual OrderChangesDto getOrderChangesSince(long long restaurantId,
+                                                 const std::string& cursor) = 0;
 
     // ── OrderItem ──
     virtual std::vector<OrderItemDto> getOrderItems(long long orderId) = 0;
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../models/Dto.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+// ─── Non-blocking counterpart of IApiService ─────────────────────────────────
+// Covers the calls views make on refresh timers.  Every method returns
+// immediately; the callback normally runs later on a service-owned thread
+// (a fail-fast error may be delivered before the call returns), so UI code
+// must hop back into its session before touching widgets (see
+// ui/SessionPost.h).  Implementations:
+//   RestApiService            – curl_multi event loop, no thread waits on I/O
+//   ThreadedAsyncApiService   – runs any IApiService on a small worker pool
+
+template <typename T>
+struct ApiResult {
+    T value{};
+    std::string error;      // empty on success
+
+    bool ok() const { return error.empty(); }
+};
+
+template <typename T>
+using ApiCallback = std::function<void(ApiResult<T>)>;
+
+class IAsyncApiService {
+public:
+    virtual ~IAsyncApiService() = default;
+
+    // ── Category / MenuItem ──
+    virtual void getCategories(long long restaurantId,
+                               ApiCallback<std::vector<CategoryDto>> cb) = 0;
+    virtual void getMenuItemsByCategory(long long categoryId,
+                                        ApiCallback<std::vector<MenuItemDto>> cb) = 0;
+
+    // ── Order ──
+    virtual void getOrders(long long restaurantId,
+                           ApiCallback<std::vector<OrderDto>> cb) = 0;
+    virtual void getOrdersByStatus(long long restaurantId, const std::string& status,
+                                   ApiCallback<std::vector<OrderDto>> cb) = 0;
+    virtual void getActiveOrders(long long restaurantId,
+                                 ApiCallback<std::vector<OrderDto>> cb) = 0;
+    virtual void updateOrderStatus(long long orderId, const std::string& status,
+                                   ApiCallback<bool> cb) = 0;
+    virtual void getOrderChangesSince(long long restaurantId, const std::string& cursor,
+                                      ApiCallback<OrderChangesDto> cb) = 0;
+
+    // ── OrderItem ──
+    virtual void getOrderItems(long long orderId,
+                               ApiCallback<std::vector<OrderItemDto>> cb) = 0;
+
+    // ── Dashboard / reporting ──
+    virtual void getOrderCount(long long restaurantId, ApiCallback<int> cb) = 0;
+    virtual void getRevenue(long long restaurantId, ApiCallback<double> cb) = 0;
+    virtual void getPendingOrderCount(long long restaurantId, ApiCallback<int> cb) = 0;
+    virtual void getInProgressOrderCount(long long restaurantId, ApiCallback<int> cb) = 0;
+};
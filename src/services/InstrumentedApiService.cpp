@@ -0,0 +1,159 @@
+#include "InstrumentedApiService.h"
+
+namespace {
+
+const char* kMethodNames[] = {
+    "getRestaurants", "getRestaurant", "getCategories",
+    "getMenuItemsByCategory", "getMenuItemsByRestaurant", "getMenuItem",
+    "updateMenuItemAvailability",
+    "getOrders", "getOrdersByStatus", "getActiveOrders", "getOrdersPage",
+    "getOrder", "createOrder",
+    "addOrderItem", "addOrderItems", "updateOrderStatus", "cancelOrder",
+    "getOrderChangesSince",
+    "getOrderItems",
+    "getOrderCount", "getRevenue", "getPendingOrderCount", "getInProgressOrderCount",
+};
+
+}  // namespace
+
+InstrumentedApiService::InstrumentedApiService(std::shared_ptr<IApiService> inner)
+    : inner_(std::move(inner))
+{
+    static_assert(sizeof(kMethodNames) / sizeof(kMethodNames[0]) == MethodCount,
+                  "kMethodNames out of sync with Method");
+
+    auto& registry = MetricsRegistry::instance();
+    for (int m = 0; m < MethodCount; m++) {
+        std::string labels = std::string("method=\"") + kMethodNames[m] + "\"";
+        instruments_[m].calls = &registry.counter(
+            "pos_api_calls_total", "IApiService calls", labels);
+        instruments_[m].errors = &registry.counter(
+            "pos_api_errors_total", "IApiService calls that threw", labels);
+        instruments_[m].latency = &registry.histogram(
+            "pos_api_call_duration_seconds", "IApiService call latency", labels);
+    }
+}
+
+// ─── Restaurant ──────────────────────────────────────────────────────────────
+
+std::vector<RestaurantDto> InstrumentedApiService::getRestaurants() {
+    return timed(GetRestaurants, [&] { return inner_->getRestaurants(); });
+}
+
+RestaurantDto InstrumentedApiService::getRestaurant(long long id) {
+    return timed(GetRestaurant, [&] { return inner_->getRestaurant(id); });
+}
+
+// ─── Category ────────────────────────────────────────────────────────────────
+
+std::vector<CategoryDto> InstrumentedApiService::getCategories(long long restaurantId) {
+    return timed(GetCategories, [&] { return inner_->getCategories(restaurantId); });
+}
+
+// ─── MenuItem ────────────────────────────────────────────────────────────────
+
+std::vector<MenuItemDto> InstrumentedApiService::getMenuItemsByCategory(long long categoryId) {
+    return timed(GetMenuItemsByCategory,
+                 [&] { return inner_->getMenuItemsByCategory(categoryId); });
+}
+
+std::vector<MenuItemDto> InstrumentedApiService::getMenuItemsByRestaurant(long long restaurantId) {
+    return timed(GetMenuItemsByRestaurant,
+                 [&] { return inner_->getMenuItemsByRestaurant(restaurantId); });
+}
+
+MenuItemDto InstrumentedApiService::getMenuItem(long long id) {
+    return timed(GetMenuItem, [&] { return inner_->getMenuItem(id); });
+}
+
+void InstrumentedApiService::updateMenuItemAvailability(long long id, bool available) {
+    timed(UpdateMenuItemAvailability,
+          [&] { inner_->updateMenuItemAvailability(id, available); });
+}
+
+// ─── Order ───────────────────────────────────────────────────────────────────
+
+std::vector<OrderDto> InstrumentedApiService::getOrders(long long restaurantId) {
+    return timed(GetOrders, [&] { return inner_->getOrders(restaurantId); });
+}
+
+std::vector<OrderDto> InstrumentedApiService::getOrdersByStatus(long long restaurantId,
+                                                                const std::string& status) {
+    return timed(GetOrdersByStatus,
+                 [&] { return inner_->getOrdersByStatus(restaurantId, status); });
+}
+
+std::vector<OrderDto> InstrumentedApiService::getActiveOrders(long long restaurantId) {
+    return timed(GetActiveOrders, [&] { return inner_->getActiveOrders(restaurantId); });
+}
+
+OrderPageDto InstrumentedApiService::getOrdersPage(long long restaurantId,
+                                                   const OrderPageQuery& query) {
+    return timed(GetOrdersPage, [&] { return inner_->getOrdersPage(restaurantId, query); });
+}
+
+OrderDto InstrumentedApiService::getOrder(long long id) {
+    return timed(GetOrder, [&] { return inner_->getOrder(id); });
+}
+
+OrderDto InstrumentedApiService::createOrder(long long restaurantId, int tableNumber,
+                                             const std::string& customerName,
+                                             const std::string& notes,
+                                             const std::string& idempotencyKey) {
+    return timed(CreateOrder, [&] {
+        return inner_->createOrder(restaurantId, tableNumber, customerName, notes,
+                                   idempotencyKey);
+    });
+}
+
+void InstrumentedApiService::addOrderItem(long long orderId, long long menuItemId,
+                                          int quantity, const std::string& instructions) {
+    timed(AddOrderItem,
+          [&] { inner_->addOrderItem(orderId, menuItemId, quantity, instructions); });
+}
+
+void InstrumentedApiService::addOrderItems(long long orderId,
+                                           const std::vector<NewOrderItemDto>& lines,
+                                           size_t& added) {
+    timed(AddOrderItems, [&] { inner_->addOrderItems(orderId, lines, added); });
+}
+
+void InstrumentedApiService::updateOrderStatus(long long orderId, const std::string& status) {
+    timed(UpdateOrderStatus, [&] { inner_->updateOrderStatus(orderId, status); });
+}
+
+void InstrumentedApiService::cancelOrder(long long orderId) {
+    timed(CancelOrder, [&] { inner_->cancelOrder(orderId); });
+}
+
+OrderChangesDto InstrumentedApiService::getOrderChangesSince(long long restaurantId,
+                                                             const std::string& cursor) {
+    return timed(GetOrderChangesSince,
+                 [&] { return inner_->getOrderChangesSince(restaurantId, cursor); });
+}
+
+// ─── OrderItem ───────────────────────────────────────────────────────────────
+
+std::vector<OrderItemDto> InstrumentedApiService::getOrderItems(long long orderId) {
+    return timed(GetOrderItems, [&] { return inner_->getOrderItems(orderId); });
+}
+
+// ─── Dashboard / reporting ───────────────────────────────────────────────────
+
+int InstrumentedApiService::getOrderCount(long long restaurantId) {
+    return timed(GetOrderCount, [&] { return inner_->getOrderCount(restaurantId); });
+}
+
+double InstrumentedApiService::getRevenue(long long restaurantId) {
+    return timed(GetRevenue, [&] { return inner_->getRevenue(restaurantId); });
+}
+
+int InstrumentedApiService::getPendingOrderCount(long long restaurantId) {
+    return timed(GetPendingOrderCount,
+                 [&] { return inner_->getPendingOrderCount(restaurantId); });
+}
+
+int InstrumentedApiService::getInProgressOrderCount(long long restaurantId) {
+    return timed(GetInProgressOrderCount,
+                 [&] { return inner_->getInProgressOrderCount(restaurantId); });
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "IApiService.h"
+#include "Metrics.h"
+
+#include <memory>
+#include <string>
+
+// ─── Metrics decorator for any IApiService ───────────────────────────────────
+// Forwards every call to the wrapped service and records, per method:
+//   pos_api_calls_total{method}             calls
+//   pos_api_errors_total{method}            calls that threw
+//   pos_api_call_duration_seconds{method}   latency histogram
+// Instruments are resolved once in the constructor; recording is lock-free.
+
+class InstrumentedApiService : public IApiService {
+public:
+    explicit InstrumentedApiService(std::shared_ptr<IApiService> inner);
+
+    std::shared_ptr<IApiService> inner() const { return inner_; }
+
+    // ── IApiService ──
+    std::vector<RestaurantDto> getRestaurants() override;
+    RestaurantDto getRestaurant(long long id) override;
+
+    std::vector<CategoryDto> getCategories(long long restaurantId) override;
+
+    std::vector<MenuItemDto> getMenuItemsByCategory(long long categoryId) override;
+    std::vector<MenuItemDto> getMenuItemsByRestaurant(long long restaurantId) override;
+    MenuItemDto getMenuItem(long long id) override;
+    void updateMenuItemAvailability(long long id, bool available) override;
+
+    std::vector<OrderDto> getOrders(long long restaurantId) override;
+    std::vector<OrderDto> getOrdersByStatus(long long restaurantId,
+                                             const std::string& status) override;
+    std::vector<OrderDto> getActiveOrders(long long restaurantId) override;
+    OrderPageDto getOrdersPage(long long restaurantId, const OrderPageQuery& query) override;
+    OrderDto getOrder(long long id) override;
+    OrderDto createOrder(long long restaurantId, int tableNumber,
+                          const std::string& customerName,
+                          const std::string& notes,
+                          const std::string& idempotencyKey = "") override;
+    void addOrderItem(long long orderId, long long menuItemId,
+                      int quantity, const std::string& instructions) override;
+    void addOrderItems(long long orderId, const std::vector<NewOrderItemDto>& lines,
+                       size_t& added) override;
+    void updateOrderStatus(long long orderId, const std::string& status) override;
+    void cancelOrder(long long orderId) override;
+    OrderChangesDto getOrderChangesSince(long long restaurantId,
+                                         const std::string& cursor) override;
+
+    std::vector<OrderItemDto> getOrderItems(long long orderId) override;
+
+    int getOrderCount(long long restaurantId) override;
+    double getRevenue(long long restaurantId) override;
+    int getPendingOrderCount(long long restaurantId) override;
+    int getInProgressOrderCount(long long restaurantId) override;
+
+private:
+    enum Method {
+        GetRestaurants, GetRestaurant, GetCategories,
+        GetMenuItemsByCategory, GetMenuItemsByRestaurant, GetMenuItem,
+        UpdateMenuItemAvailability,
+        GetOrders, GetOrdersByStatus, GetActiveOrders, GetOrdersPage, GetOrder, CreateOrder,
+        AddOrderItem, AddOrderItems, UpdateOrderStatus, CancelOrder, GetOrderChangesSince,
+        GetOrderItems,
+        GetOrderCount, GetRevenue, GetPendingOrderCount, GetInProgressOrderCount,
+        MethodCount
+    };
+
+    struct Instruments {
+        MetricCounter* calls = nullptr;
+        MetricCounter* errors = nullptr;
+        LatencyHistogram* latency = nullptr;
+    };
+
+    template <typename F>
+    auto timed(Method m, F&& call) -> decltype(call()) {
+        Instruments& in = instruments_[m];
+        in.calls->inc();
+        ScopedLatency timer(*in.latency);
+        try {
+            return call();
+        } catch (...) {
+            in.errors->inc();
+            throw;
+        }
+    }
+
+    std::shared_ptr<IApiService> inner_;
+    Instruments instruments_[MethodCount];
+};
@@ -0,0 +1,271 @@
+#include "JsonApi.h"
+#include "JsonWriter.h"
+
+#include <Wt/Json/Parser.h>
+#include <Wt/Json/Value.h>
+
+#include <cmath>
+#include <string>
+
+namespace JsonApi {
+
+long long jsonId(const Wt::Json::Object& resource) {
+    // JSON:API id is a string
+    if (resource.contains("id")) {
+        auto& val = resource.get("id");
+        if (val.type() == Wt::Json::Type::String) {
+            return std::stoll(static_cast<const Wt::WString&>(val).toUTF8());
+        }
+        if (val.type() == Wt::Json::Type::Number) {
+            return static_cast<long long>(static_cast<double>(val));
+        }
+    }
+    return 0;
+}
+
+std::string jsonStr(const Wt::Json::Object& obj, const std::string& key) {
+    if (!obj.contains(key)) return "";
+    auto& val = obj.get(key);
+    if (val.type() == Wt::Json::Type::String)
+        return static_cast<const Wt::WString&>(val).toUTF8();
+    if (val.isNull()) return "";
+    return "";
+}
+
+double jsonNum(const Wt::Json::Object& obj, const std::string& key) {
+    if (!obj.contains(key)) return 0.0;
+    auto& val = obj.get(key);
+    if (val.type() == Wt::Json::Type::Number) return static_cast<double>(val);
+    if (val.type() == Wt::Json::Type::String) {
+        try { return std::stod(static_cast<const Wt::WString&>(val).toUTF8()); }
+        catch (...) { return 0.0; }
+    }
+    return 0.0;
+}
+
+int jsonInt(const Wt::Json::Object& obj, const std::string& key) {
+    return static_cast<int>(std::round(jsonNum(obj, key)));
+}
+
+bool jsonBool(const Wt::Json::Object& obj, const std::string& key) {
+    if (!obj.contains(key)) return false;
+    auto& val = obj.get(key);
+    if (val.type() == Wt::Json::Type::Bool) return static_cast<bool>(val);
+    return false;
+}
+
+long long jsonFk(const Wt::Json::Object& attrs, const std::string& key) {
+    return static_cast<long long>(std::round(jsonNum(attrs, key)));
+}
+
+// Parse a JSON:API resource object into DTOs
+
+RestaurantDto parseRestaurant(const Wt::Json::Object& res) {
+    RestaurantDto d;
+    d.id = jsonId(res);
+    const Wt::Json::Object& a = res.get("attributes");
+    d.name         = jsonStr(a, "name");
+    d.cuisine_type = jsonStr(a, "cuisine_type");
+    d.description  = jsonStr(a, "description");
+    return d;
+}
+
+CategoryDto parseCategory(const Wt::Json::Object& res) {
+    CategoryDto d;
+    d.id = jsonId(res);
+    const Wt::Json::Object& a = res.get("attributes");
+    d.name          = jsonStr(a, "name");
+    d.sort_order    = jsonInt(a, "sort_order");
+    d.restaurant_id = jsonFk(a, "restaurant_id");
+    return d;
+}
+
+MenuItemDto parseMenuItem(const Wt::Json::Object& res) {
+    MenuItemDto d;
+    d.id = jsonId(res);
+    const Wt::Json::Object& a = res.get("attributes");
+    d.name        = jsonStr(a, "name");
+    d.description = jsonStr(a, "description");
+    d.price       = jsonNum(a, "price");
+    d.available   = jsonBool(a, "available");
+    d.category_id = jsonFk(a, "category_id");
+    return d;
+}
+
+OrderDto parseOrder(const Wt::Json::Object& res) {
+    OrderDto d;
+    d.id = jsonId(res);
+    const Wt::Json::Object& a = res.get("attributes");
+    d.table_number  = jsonInt(a, "table_number");
+    d.status        = jsonStr(a, "status");
+    d.customer_name = jsonStr(a, "customer_name");
+    d.notes         = jsonStr(a, "notes");
+    d.total         = jsonNum(a, "total");
+    d.restaurant_id = jsonFk(a, "restaurant_id");
+    d.created_at    = jsonStr(a, "created_at");
+    d.updated_at    = jsonStr(a, "updated_at");
+    return d;
+}
+
+OrderItemDto parseOrderItem(const Wt::Json::Object& res) {
+    OrderItemDto d;
+    d.id = jsonId(res);
+    const Wt::Json::Object& a = res.get("attributes");
+    d.quantity             = jsonInt(a, "quantity");
+    d.unit_price           = jsonNum(a, "unit_price");
+    d.special_instructions = jsonStr(a, "special_instructions");
+    d.order_id             = jsonFk(a, "order_id");
+    d.menu_item_id         = jsonFk(a, "menu_item_id");
+    // menu_item_name may come from include; caller resolves it
+    return d;
+}
+
+// Parse a JSON:API collection response → vector of Json::Object resources
+Wt::Json::Array parseDataArray(const std::string& json) {
+    long long metaCount;
+    return parseDataArray(json, metaCount);
+}
+
+Wt::Json::Array parseDataArray(const std::string& json, long long& metaCount) {
+    Wt::Json::Object root;
+    Wt::Json::parse(json, root);
+    metaCount = -1;
+    if (root.contains("meta") && root.get("meta").type() == Wt::Json::Type::Object) {
+        const Wt::Json::Object& meta = root.get("meta");
+        if (meta.contains("count")) metaCount = (long long)jsonNum(meta, "count");
+    }
+    if (root.contains("data")) {
+        auto& data = root.get("data");
+        if (data.type() == Wt::Json::Type::Array)
+            return static_cast<const Wt::Json::Array&>(data);
+    }
+    return Wt::Json::Array();
+}
+
+// Parse a single JSON:API resource → Json::Object
+Wt::Json::Object parseDataObject(const std::string& json) {
+    Wt::Json::Object root;
+    Wt::Json::parse(json, root);
+    if (root.contains("data")) {
+        auto& data = root.get("data");
+        if (data.type() == Wt::Json::Type::Object)
+            return static_cast<const Wt::Json::Object&>(data);
+    }
+    return Wt::Json::Object();
+}
+
+// Build an "included" lookup: type+id → Object
+std::map<std::string, Wt::Json::Object>
+buildIncludedMap(const std::string& json) {
+    std::map<std::string, Wt::Json::Object> m;
+    Wt::Json::Object root;
+    Wt::Json::parse(json, root);
+    if (root.contains("included")) {
+        auto& inc = root.get("included");
+        if (inc.type() == Wt::Json::Type::Array) {
+            const Wt::Json::Array& arr = inc;
+            for (int i = 0; i < (int)arr.size(); i++) {
+                const Wt::Json::Object& obj = arr[i];
+                std::string key = jsonStr(obj, "type") + ":" +
+                    std::to_string(jsonId(obj));
+                m[key] = obj;
+            }
+        }
+    }
+    return m;
+}
+
+std::vector<OrderItemDto> parseOrderItemList(const std::string& json) {
+    Wt::Json::Object root;
+    Wt::Json::parse(json, root);
+
+    std::map<long long, std::string> menuItemNames;
+    if (root.contains("included") && root.get("included").type() == Wt::Json::Type::Array) {
+        const Wt::Json::Array& inc = root.get("included");
+        for (int i = 0; i < (int)inc.size(); i++) {
+            const Wt::Json::Object& obj = inc[i];
+            if (jsonStr(obj, "type") != "menu_item") continue;
+            const Wt::Json::Object& attrs = obj.get("attributes");
+            menuItemNames[jsonId(obj)] = jsonStr(attrs, "name");
+        }
+    }
+
+    std::vector<OrderItemDto> out;
+    if (!root.contains("data") || root.get("data").type() != Wt::Json::Type::Array) return out;
+    const Wt::Json::Array& arr = root.get("data");
+    out.reserve(arr.size());
+    for (int i = 0; i < (int)arr.size(); i++) {
+        const Wt::Json::Object& obj = arr[i];
+        auto dto = parseOrderItem(obj);
+        auto it = menuItemNames.find(dto.menu_item_id);
+        if (it != menuItemNames.end()) dto.menu_item_name = it->second;
+        out.push_back(dto);
+    }
+    return out;
+}
+
+// ─── Request documents ───────────────────────────────────────────────────────
+
+namespace {
+
+// {"data":{"type":…,"id":"…","attributes":{ — closed by endResource()
+JsonWriter& beginResource(JsonWriter& w, const char* type, long long id = 0) {
+    w.beginObject().key("data").beginObject().key("type").value(type);
+    if (id) w.key("id").quoted(id);
+    return w.key("attributes").beginObject();
+}
+
+std::string endResource(JsonWriter& w) {
+    return w.endObject().endObject().endObject().str();
+}
+
+}  // namespace
+
+std::string orderStatusBody(long long orderId, const std::string& status) {
+    JsonWriter w;
+    beginResource(w, "orders", orderId).key("status").value(status);
+    return endResource(w);
+}
+
+std::string newOrderBody(long long restaurantId, int tableNumber,
+                         const std::string& customerName, const std::string& notes,
+                         const std::string& idempotencyKey) {
+    JsonWriter w;
+    beginResource(w, "orders")
+        .key("restaurant_id").value(restaurantId)
+        .key("table_number").value(tableNumber)
+        .key("status").value("Pending")
+        .key("customer_name").value(customerName)
+        .key("notes").value(notes)
+        .key("total").fixed(0.0, 2);
+    if (!idempotencyKey.empty()) w.key("idempotency_key").value(idempotencyKey);
+    return endResource(w);
+}
+
+std::string orderItemBody(long long orderId, long long menuItemId, int quantity,
+                          double unitPrice, const std::string& instructions,
+                          const std::string& lineKey) {
+    JsonWriter w;
+    beginResource(w, "order_item")
+        .key("order_id").value(orderId)
+        .key("menu_item_id").value(menuItemId)
+        .key("quantity").value(quantity)
+        .key("unit_price").fixed(unitPrice, 2)
+        .key("special_instructions").value(instructions);
+    if (!lineKey.empty()) w.key("line_key").value(lineKey);
+    return endResource(w);
+}
+
+std::string orderTotalBody(long long orderId, double total) {
+    JsonWriter w;
+    beginResource(w, "orders", orderId).key("total").fixed(total, 2);
+    return endResource(w);
+}
+
+std::string availabilityBody(long long menuItemId, bool available) {
+    JsonWriter w;
+    beginResource(w, "menu_item", menuItemId).key("available").value(available);
+    return endResource(w);
+}
+
+}  // namespace JsonApi
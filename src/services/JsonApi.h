@@ -0,0 +1,95 @@
+#pragma once
+
+#include "../models/Dto.h"
+
+#include <Wt/Json/Array.h>
+#include <Wt/Json/Object.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+// ─── JSON:API response parsing helpers ───────────────────────────────────────
+// ApiLogicServer returns JSON:API format:
+//   { "data": [ { "type": "...", "id": "...", "attributes": { ... } }, ... ] }
+// or for single resources:
+//   { "data": { "type": "...", "id": "...", "attributes": { ... } } }
+//
+// Request bodies (the document types RestApiService POSTs and PATCHes) are
+// written with JsonWriter, so user-entered text is always escaped.
+//
+// Shared by RestApiService and the benchmarks in tools/bench.
+
+namespace JsonApi {
+
+// Scalar accessors (missing / null / mistyped values yield 0, "" or false)
+long long jsonId(const Wt::Json::Object& resource);
+std::string jsonStr(const Wt::Json::Object& obj, const std::string& key);
+double jsonNum(const Wt::Json::Object& obj, const std::string& key);
+int jsonInt(const Wt::Json::Object& obj, const std::string& key);
+bool jsonBool(const Wt::Json::Object& obj, const std::string& key);
+long long jsonFk(const Wt::Json::Object& attrs, const std::string& key);
+
+// Resource object → DTO
+RestaurantDto parseRestaurant(const Wt::Json::Object& res);
+CategoryDto parseCategory(const Wt::Json::Object& res);
+MenuItemDto parseMenuItem(const Wt::Json::Object& res);
+OrderDto parseOrder(const Wt::Json::Object& res);
+OrderItemDto parseOrderItem(const Wt::Json::Object& res);
+
+// Document level
+Wt::Json::Array parseDataArray(const std::string& json);
+// Also reads "meta": {"count": N}, the matching resources over all pages
+// (ALS adds it to collections); -1 when absent
+Wt::Json::Array parseDataArray(const std::string& json, long long& metaCount);
+Wt::Json::Object parseDataObject(const std::string& json);
+std::map<std::string, Wt::Json::Object> buildIncludedMap(const std::string& json);
+
+// Collection document → DTOs
+template <typename Dto>
+std::vector<Dto> parseList(const std::string& json, Dto (*parse)(const Wt::Json::Object&)) {
+    auto arr = parseDataArray(json);
+    std::vector<Dto> out;
+    out.reserve(arr.size());
+    for (int i = 0; i < (int)arr.size(); i++) {
+        const Wt::Json::Object& obj = arr[i];
+        out.push_back(parse(obj));
+    }
+    return out;
+}
+
+template <typename Dto>
+std::vector<Dto> parseList(const std::string& json, Dto (*parse)(const Wt::Json::Object&),
+                           long long& metaCount) {
+    auto arr = parseDataArray(json, metaCount);
+    std::vector<Dto> out;
+    out.reserve(arr.size());
+    for (int i = 0; i < (int)arr.size(); i++) {
+        const Wt::Json::Object& obj = arr[i];
+        out.push_back(parse(obj));
+    }
+    return out;
+}
+
+// order_item collection fetched with ?include=menu_item; menu_item_name is
+// resolved from "included" (one parse of the document)
+std::vector<OrderItemDto> parseOrderItemList(const std::string& json);
+
+// ─── Request documents ───────────────────────────────────────────────────────
+// Money is written with two decimals.  Order documents never carry
+// updated_at: the database stamps it (sql/schema.sql), so the change feed's
+// cursor follows one clock.
+
+std::string orderStatusBody(long long orderId, const std::string& status);
+// A non-empty idempotencyKey is stored on the order (orders.idempotency_key)
+std::string newOrderBody(long long restaurantId, int tableNumber,
+                         const std::string& customerName, const std::string& notes,
+                         const std::string& idempotencyKey = "");
+// A non-empty lineKey is stored on the item (order_item.line_key)
+std::string orderItemBody(long long orderId, long long menuItemId, int quantity,
+                          double unitPrice, const std::string& instructions,
+                          const std::string& lineKey = "");
+std::string orderTotalBody(long long orderId, double total);
+std::string availabilityBody(long long menuItemId, bool available);
+
+}  // namespace JsonApi
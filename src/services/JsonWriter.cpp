@@ -0,0 +1,202 @@
+#include "JsonWriter.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+
+// A one-off huge document should not pin its buffer for the thread's lifetime
+constexpr size_t kMaxRetainedBytes = 64 * 1024;
+
+std::string& scratchBuffer() {
+    thread_local std::string buffer;
+    if (buffer.capacity() > kMaxRetainedBytes) std::string().swap(buffer);
+    buffer.clear();
+    return buffer;
+}
+
+constexpr long long kPow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000,
+                                10000000, 100000000, 1000000000};
+constexpr int kMaxFixedDecimals = 9;
+
+const char kHex[] = "0123456789abcdef";
+
+}  // namespace
+
+JsonWriter::JsonWriter() : out_(scratchBuffer()) {}
+
+JsonWriter::JsonWriter(std::string& out) : out_(out) {}
+
+// ─── Structure ───────────────────────────────────────────────────────────────
+
+void JsonWriter::separate() {
+    if (afterKey_) {
+        afterKey_ = false;
+        return;
+    }
+    if (depth_ == 0) return;
+    uint64_t bit = uint64_t(1) << (depth_ - 1);
+    if (hasItems_ & bit) out_ += ',';
+    hasItems_ |= bit;
+}
+
+void JsonWriter::push(char open) {
+    separate();
+    if (depth_ == 64) throw std::runtime_error("JsonWriter: nesting deeper than 64");
+    out_ += open;
+    hasItems_ &= ~(uint64_t(1) << depth_);
+    depth_++;
+}
+
+void JsonWriter::pop(char close) {
+    if (depth_ == 0) throw std::runtime_error("JsonWriter: unbalanced close");
+    depth_--;
+    out_ += close;
+}
+
+JsonWriter& JsonWriter::beginObject() { push('{'); return *this; }
+JsonWriter& JsonWriter::endObject()   { pop('}');  return *this; }
+JsonWriter& JsonWriter::beginArray()  { push('['); return *this; }
+JsonWriter& JsonWriter::endArray()    { pop(']');  return *this; }
+
+JsonWriter& JsonWriter::key(std::string_view name) {
+    separate();
+    appendEscaped(name);
+    out_ += ':';
+    afterKey_ = true;
+    return *this;
+}
+
+// ─── Values ──────────────────────────────────────────────────────────────────
+
+JsonWriter& JsonWriter::value(std::string_view s) {
+    separate();
+    appendEscaped(s);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(long long n) {
+    separate();
+    appendInt(n);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool b) {
+    separate();
+    out_ += b ? "true" : "false";
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double d) {
+    separate();
+    if (!std::isfinite(d)) {
+        out_ += "null";
+        return *this;
+    }
+    char buf[32];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto res = std::to_chars(buf, buf + sizeof buf, d);
+    out_.append(buf, res.ptr - buf);
+#else
+    int n = std::snprintf(buf, sizeof buf, "%.17g", d);
+    out_.append(buf, n);
+#endif
+    return *this;
+}
+
+JsonWriter& JsonWriter::fixed(double d, int decimals) {
+    separate();
+    if (!std::isfinite(d)) {
+        out_ += "null";
+        return *this;
+    }
+    if (decimals < 0) decimals = 0;
+    if (decimals > kMaxFixedDecimals) decimals = kMaxFixedDecimals;
+
+    // Beyond 2^53 the double holds no fractional digits anyway: printf
+    if (std::fabs(d) * kPow10[decimals] >= 9.0e15) {
+        char buf[400];
+        int n = std::snprintf(buf, sizeof buf, "%.*f", decimals, d);
+        out_.append(buf, n);
+        return *this;
+    }
+
+    // Round the decimal the double stands for, not its binary value: 1.005
+    // is stored as 1.00499999999999989..., which scaling and std::round
+    // would take to 1.00.  Fifteen significant digits give back any decimal
+    // of up to fifteen digits exactly, so round on those.
+    char sci[32];
+    std::snprintf(sci, sizeof sci, "%.14e", std::fabs(d));   // d.dddddddddddddde±XX
+    char digits[15];
+    digits[0] = sci[0];
+    for (int i = 0; i < 14; i++) digits[i + 1] = sci[i + 2];
+    int keep = std::atoi(sci + 17) + 1 + decimals;          // digits left of the cut
+
+    long long units = 0;
+    if (keep >= 0) {
+        for (int i = 0; i < keep; i++) units = units * 10 + (i < 15 ? digits[i] - '0' : 0);
+        if (keep < 15 && digits[keep] >= '5') units++;
+    }
+    if (std::signbit(d) && units > 0) out_ += '-';
+    appendInt(units / kPow10[decimals]);
+    if (decimals > 0) {
+        char frac[kMaxFixedDecimals];
+        long long f = units % kPow10[decimals];
+        for (int i = decimals - 1; i >= 0; i--, f /= 10) frac[i] = char('0' + f % 10);
+        out_ += '.';
+        out_.append(frac, decimals);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::quoted(long long n) {
+    separate();
+    out_ += '"';
+    appendInt(n);
+    out_ += '"';
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separate();
+    out_ += "null";
+    return *this;
+}
+
+// ─── Encoding ────────────────────────────────────────────────────────────────
+
+void JsonWriter::appendInt(long long n) {
+    char buf[24];
+    auto res = std::to_chars(buf, buf + sizeof buf, n);
+    out_.append(buf, res.ptr - buf);
+}
+
+void JsonWriter::appendEscaped(std::string_view s) {
+    out_ += '"';
+    // Copy unescaped runs in one append; most strings are a single run
+    size_t run = 0;
+    for (size_t i = 0; i < s.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        out_.append(s.data() + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"':  out_ += "\\\""; break;
+            case '\\': out_ += "\\\\"; break;
+            case '\b': out_ += "\\b"; break;
+            case '\f': out_ += "\\f"; break;
+            case '\n': out_ += "\\n"; break;
+            case '\r': out_ += "\\r"; break;
+            case '\t': out_ += "\\t"; break;
+            default: {
+                char u[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xf]};
+                out_.append(u, sizeof u);
+            }
+        }
+    }
+    out_.append(s.data() + run, s.size() - run);
+    out_ += '"';
+}
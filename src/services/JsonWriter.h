@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// ─── Streaming JSON writer ───────────────────────────────────────────────────
+// Appends JSON text straight to a std::string: commas and colons are placed
+// automatically, strings are escaped (quote, backslash, control characters;
+// UTF-8 passes through) and numbers are formatted without iostreams.
+//
+//   JsonWriter w;
+//   w.beginObject().key("notes").value(notes).key("total").fixed(total, 2).endObject();
+//   return w.str();
+//
+// The default constructor writes into a per-thread scratch buffer whose
+// capacity is kept from one document to the next, so once it has grown to
+// the usual body size, building a body does not allocate; str() makes the
+// one copy the caller keeps.  Only one such writer per thread at a time.
+
+class JsonWriter {
+public:
+    JsonWriter();                                   // this thread's scratch buffer, cleared
+    explicit JsonWriter(std::string& out);          // appends to `out`
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& value(std::string_view s);
+    JsonWriter& value(const char* s) { return value(std::string_view(s)); }
+    JsonWriter& value(const std::string& s) { return value(std::string_view(s)); }
+    JsonWriter& value(long long n);
+    JsonWriter& value(int n) { return value(static_cast<long long>(n)); }
+    JsonWriter& value(bool b);
+    JsonWriter& value(double d);                    // shortest round-trip; NaN/inf → null
+    // e.g. money: fixed(price, 2) → 4.50.  Rounds the decimal the double was
+    // parsed from (to 15 significant digits) half away from zero: 1.005 →
+    // 1.01 and 0.015 → 0.02, where printf's %.2f gives 1.00 and 0.01
+    JsonWriter& fixed(double d, int decimals);
+    JsonWriter& quoted(long long n);                // integer as a string (JSON:API ids)
+    JsonWriter& null();
+
+    const std::string& text() const { return out_; }
+    std::string str() const { return out_; }
+
+private:
+    void separate();
+    void push(char open);
+    void pop(char close);
+    void appendEscaped(std::string_view s);
+    void appendInt(long long n);
+
+    std::string& out_;
+    uint64_t hasItems_ = 0;     // bit d: container at depth d already has a member
+    int depth_ = 0;
+    bool afterKey_ = false;
+};
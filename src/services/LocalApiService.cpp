@@ -1,71 +1,25 @@
 #include "LocalApiService.h"
+#include "DtoMapping.h"
 
 LocalApiService::LocalApiService(const std::string& dbPath)
-    : dbo_(std::make_unique<ApiService>(dbPath))
+    : dbo_(std::make_unique<ApiService>(dbPath)),
+      recentKeys_(4096)
 {}
 
-void LocalApiService::initializeDatabase() { dbo_->initializeDatabase(); }
-void LocalApiService::seedDatabase()       { dbo_->seedDatabase(); }
-
-// ─── Helpers: Wt::Dbo::ptr<T> → DTO ─────────────────────────────────────────
-
-static RestaurantDto toDto(const Wt::Dbo::ptr<Restaurant>& p) {
-    RestaurantDto d;
-    d.id           = p.id();
-    d.name         = p->name;
-    d.cuisine_type = p->cuisine_type;
-    d.description  = p->description;
-    return d;
-}
-
-static CategoryDto toDto(const Wt::Dbo::ptr<Category>& p) {
-    CategoryDto d;
-    d.id            = p.id();
-    d.name          = p->name;
-    d.sort_order    = p->sort_order;
-    d.restaurant_id = p->restaurant.id();
-    return d;
-}
-
-static MenuItemDto toDto(const Wt::Dbo::ptr<MenuItem>& p) {
-    MenuItemDto d;
-    d.id          = p.id();
-    d.name        = p->name;
-    d.description = p->description;
-    d.price       = p->price;
-    d.available   = p->available;
-    d.category_id = p->category.id();
-    return d;
-}
-
-static OrderDto toDto(const Wt::Dbo::ptr<Order>& p) {
-    OrderDto d;
-    d.id            = p.id();
-    d.table_number  = p->table_number;
-    d.status        = p->status;
-    d.customer_name = p->customer_name;
-    d.notes         = p->notes;
-    d.total         = p->total;
-    d.restaurant_id = p->restaurant.id();
-    d.created_at    = p->created_at;
-    return d;
-}
-
-static OrderItemDto toDto(const Wt::Dbo::ptr<OrderItem>& p) {
-    OrderItemDto d;
-    d.id                   = p.id();
-    d.quantity             = p->quantity;
-    d.unit_price           = p->unit_price;
-    d.special_instructions = p->special_instructions;
-    d.order_id             = p->order.id();
-    d.menu_item_id         = p->menu_item.id();
-    d.menu_item_name       = p->menu_item->name;
-    return d;
+void LocalApiService::initializeDatabase() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dbo_->initializeDatabase();
+}
+
+void LocalApiService::seedDatabase() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dbo_->seedDatabase();
 }
 
 // ─── IApiService implementation ──────────────────────────────────────────────
 
 std::vector<RestaurantDto> LocalApiService::getRestaurants() {
+    std::lock_guard<std::mutex> lock(mutex_);
     Wt::Dbo::Transaction t(dbo_->session());
     auto src = dbo_->getRestaurants();
     std::vector<RestaurantDto> out;
@@ -75,11 +29,13 @@ std::vector<RestaurantDto> LocalApiService::getRestaurants() {
 }
 
 RestaurantDto LocalApiService::getRestaurant(long long id) {
+    std::lock_guard<std::mutex> lock(mutex_);
     Wt::Dbo::Transaction t(dbo_->session());
     return toDto(dbo_->getRestaurant(id));
 }
 
 std::vector<CategoryDto> LocalApiService::getCategories(long long restaurantId) {
+    std::lock_guard<std::mutex> lock(mutex_);
     Wt::Dbo::Transaction t(dbo_->session());
     auto src = dbo_->getCategories(restaurantId);
     std::vector<CategoryDto> out;
@@ -89,6 +45,7 @@ std::vector<CategoryDto> LocalApiService::getCategories(long long restaurantId)
 }
 
 std::vector<MenuItemDto> LocalApiService::getMenuItemsByCategory(long long categoryId) {
+    std::lock_guard<std::mutex> lock(mutex_);
     Wt::Dbo::Transaction t(dbo_->session());
     auto src = dbo_->getMenuItemsByCategory(categoryId);
     std::vector<MenuItemDto> out;
@@ -98,6 +55,7 @@ std::vector<MenuItemDto> LocalApiService::getMenuItemsByCategory(long long categ
 }
 
 std::vector<MenuItemDto> LocalApiService::getMenuItemsByRestaurant(long long restaurantId) {
+    std::lock_guard<std::mutex> lock(mutex_);
     Wt::Dbo::Transaction t(dbo_->session());
     auto src = dbo_->getMenuItemsByRestaurant(restaurantId);
     std::vector<MenuItemDto> out;
@@ -107,15 +65,18 @@ std::vector<MenuItemDto> LocalApiService::getMenuItemsByRestaurant(long long res
 }
 
 MenuItemDto LocalApiService::getMenuItem(long long id) {
+    std::lock_guard<std::mutex> lock(mutex_);
     Wt::Dbo::Transaction t(dbo_->session());
     return toDto(dbo_->getMenuItem(id));
 }
 
 void LocalApiService::updateMenuItemAvailability(long long id, bool available) {
+    std::lock_guard<std::mutex> lock(mutex_);
     dbo_->updateMenuItemAvailability(id, available);
 }
 
 std::vector<OrderDto> LocalApiService::getOrders(long long restaurantId) {
+    std::lock_guard<std::mutex> lock(mutex_);
     Wt::Dbo::Transaction t(dbo_->session());
     auto src = dbo_->getOrders(restaurantId);
     std::vector<OrderDto> out;
@@ -127,6 +88,7 @@ std::vector<OrderDto> LocalApiService::getOrders(long long restaurantId) {
 std::vector<OrderDto> LocalApiService::getOrdersByStatus(
     long long restaurantId, const std::string& status)
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     Wt::Dbo::Transaction t(dbo_->session());
     auto src = dbo_->getOrdersByStatus(restaurantId, status);
     std::vector<OrderDto> out;
@@ -136,6 +98,7 @@ std::vector<OrderDto> LocalApiService::getOrdersByStatus(
 }
 
 std::vector<OrderDto> LocalApiService::getActiveOrders(long long restaurantId) {
+    std::lock_guard<std::mutex> lock(mutex_);
     Wt::Dbo::Transaction t(dbo_->session());
     auto src = dbo_->getActiveOrders(restaurantId);
     std::vector<OrderDto> out;
@@ -144,35 +107,91 @@ std::vector<OrderDto> LocalApiService::getActiveOrders(long long restaurantId) {
     return out;
 }
 
+OrderPageDto LocalApiService::getOrdersPage(long long restaurantId,
+                                           const OrderPageQuery& query) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Wt::Dbo::Transaction t(dbo_->session());
+    OrderPageDto out;
+    auto src = dbo_->getOrdersPage(restaurantId, query, out.total);
+    out.orders.reserve(src.size());
+    for (auto& p : src) out.orders.push_back(toDto(p));
+    return out;
+}
+
 OrderDto LocalApiService::getOrder(long long id) {
+    std::lock_guard<std::mutex> lock(mutex_);
     Wt::Dbo::Transaction t(dbo_->session());
     return toDto(dbo_->getOrder(id));
 }
 
 OrderDto LocalApiService::createOrder(long long restaurantId, int tableNumber,
                                        const std::string& customerName,
-                                       const std::string& notes)
+                                       const std::string& notes,
+                                       const std::string& idempotencyKey)
 {
-    auto p = dbo_->createOrder(restaurantId, tableNumber, customerName, notes);
+    std::lock_guard<std::mutex> lock(mutex_);
+    long long orderId;
+    if (!idempotencyKey.empty() && recentKeys_.get(idempotencyKey, orderId)) {
+        Wt::Dbo::Transaction t(dbo_->session());
+        return toDto(dbo_->getOrder(orderId));
+    }
+
+    // Keys the LRU has dropped are still caught by the table
+    auto p = dbo_->createOrder(restaurantId, tableNumber, customerName, notes, idempotencyKey);
     Wt::Dbo::Transaction t(dbo_->session());
+    if (!idempotencyKey.empty()) recentKeys_.put(idempotencyKey, p.id());
     return toDto(p);
 }
 
 void LocalApiService::addOrderItem(long long orderId, long long menuItemId,
                                     int quantity, const std::string& instructions)
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     dbo_->addOrderItem(orderId, menuItemId, quantity, instructions);
 }
 
 void LocalApiService::updateOrderStatus(long long orderId, const std::string& status) {
+    std::lock_guard<std::mutex> lock(mutex_);
     dbo_->updateOrderStatus(orderId, status);
 }
 
 void LocalApiService::cancelOrder(long long orderId) {
+    std::lock_guard<std::mutex> lock(mutex_);
     dbo_->cancelOrder(orderId);
 }
 
+OrderChangesDto LocalApiService::getOrderChangesSince(long long restaurantId,
+                                                      const std::string& cursor) {
+    // Cursor: "s:" + the change number read up to
+    long long since = -1;
+    if (cursor.compare(0, 2, "s:") == 0) {
+        try {
+            since = std::stoll(cursor.substr(2));
+        } catch (std::exception&) {
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Wt::Dbo::Transaction t(dbo_->session());
+    OrderChangesDto out;
+    long long upTo = 0;
+    std::vector<Wt::Dbo::ptr<Order>> src;
+    if (since < 0) {
+        // Counter first: a change landing in between is sent again, not lost
+        upTo = dbo_->orderChangeSeq();
+        src = dbo_->getActiveOrders(restaurantId);
+        out.reset = true;
+    } else {
+        src = dbo_->getOrderChangesSince(restaurantId, since, upTo);
+    }
+    out.orders.reserve(src.size());
+    for (auto& p : src) out.orders.push_back(toDto(p));
+    out.cursor = "s:" + std::to_string(upTo);
+    return out;
+}
+
 std::vector<OrderItemDto> LocalApiService::getOrderItems(long long orderId) {
+    std::lock_guard<std::mutex> lock(mutex_);
     Wt::Dbo::Transaction t(dbo_->session());
     auto src = dbo_->getOrderItems(orderId);
     std::vector<OrderItemDto> out;
@@ -181,7 +200,60 @@ std::vector<OrderItemDto> LocalApiService::getOrderItems(long long orderId) {
     return out;
 }
 
-int    LocalApiService::getOrderCount(long long rid)        { return dbo_->getOrderCount(rid); }
-double LocalApiService::getRevenue(long long rid)           { return dbo_->getRevenue(rid); }
-int    LocalApiService::getPendingOrderCount(long long rid) { return dbo_->getPendingOrderCount(rid); }
-int    LocalApiService::getInProgressOrderCount(long long rid) { return dbo_->getInProgressOrderCount(rid); }
+int LocalApiService::getOrderCount(long long rid) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dbo_->getOrderCount(rid);
+}
+
+double LocalApiService::getRevenue(long long rid) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dbo_->getRevenue(rid);
+}
+
+int LocalApiService::getPendingOrderCount(long long rid) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dbo_->getPendingOrderCount(rid);
+}
+
+int LocalApiService::getInProgressOrderCount(long long rid) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dbo_->getInProgressOrderCount(rid);
+}
+
+// ─── Replica maintenance ─────────────────────────────────────────────────────
+
+void LocalApiService::applyCatalog(const std::vector<RestaurantDto>& restaurants,
+                                   const std::vector<CategoryDto>& categories,
+                                   const std::vector<MenuItemDto>& menuItems) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    {
+        Wt::Dbo::Transaction t(dbo_->session());
+        for (auto& r : restaurants) dbo_->upsertRestaurant(r);
+        for (auto& c : categories) dbo_->upsertCategory(c);
+        for (auto& m : menuItems) dbo_->upsertMenuItem(m);
+        t.commit();
+    }
+    dbo_->session().rereadAll();
+}
+
+void LocalApiService::applyOrders(const std::vector<OrderDto>& orders,
+                                  const std::vector<OrderItemDto>& items) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    {
+        Wt::Dbo::Transaction t(dbo_->session());
+        for (auto& o : orders) dbo_->upsertOrder(o);
+        for (auto& i : items) dbo_->upsertOrderItem(i);
+        t.commit();
+    }
+    dbo_->session().rereadAll();
+}
+
+std::string LocalApiService::latestOrderUpdate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dbo_->latestOrderUpdate();
+}
+
+long long LocalApiService::latestOrderItemId() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dbo_->latestOrderItemId();
+}
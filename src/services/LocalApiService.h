@@ -2,10 +2,18 @@
 
 #include "IApiService.h"
 #include "ApiService.h"
+#include "LruCache.h"
 #include <memory>
+#include <mutex>
 
 // ─── Local (SQLite / Wt::Dbo) implementation of IApiService ─────────────────
 // Delegates to the existing ApiService and converts Wt::Dbo::ptr<T> → DTO.
+// Thread-safe: the single Wt::Dbo::Session is shared by every Wt worker
+// thread, so each call holds mutex_ for its duration.
+//
+// createOrder idempotency keys are checked against an in-memory LRU of
+// recent keys before the order_idempotency table, so a repeated submit
+// costs one lookup by primary key and no write.
 
 class LocalApiService : public IApiService {
 public:
@@ -29,14 +37,18 @@ public:
     std::vector<OrderDto> getOrdersByStatus(long long restaurantId,
                                              const std::string& status) override;
     std::vector<OrderDto> getActiveOrders(long long restaurantId) override;
+    OrderPageDto getOrdersPage(long long restaurantId, const OrderPageQuery& query) override;
     OrderDto getOrder(long long id) override;
     OrderDto createOrder(long long restaurantId, int tableNumber,
                           const std::string& customerName,
-                          const std::string& notes) override;
+                          const std::string& notes,
+                          const std::string& idempotencyKey = "") override;
     void addOrderItem(long long orderId, long long menuItemId,
                       int quantity, const std::string& instructions) override;
     void updateOrderStatus(long long orderId, const std::string& status) override;
     void cancelOrder(long long orderId) override;
+    OrderChangesDto getOrderChangesSince(long long restaurantId,
+                                         const std::string& cursor) override;
 
     std::vector<OrderItemDto> getOrderItems(long long orderId) override;
 
@@ -45,6 +57,19 @@ public:
     int getPendingOrderCount(long long restaurantId) override;
     int getInProgressOrderCount(long long restaurantId) override;
 
+    // ── Replica maintenance (HybridApiService) ──
+    // Upsert rows under the server's ids, each call in one transaction
+    void applyCatalog(const std::vector<RestaurantDto>& restaurants,
+                      const std::vector<CategoryDto>& categories,
+                      const std::vector<MenuItemDto>& menuItems);
+    void applyOrders(const std::vector<OrderDto>& orders,
+                     const std::vector<OrderItemDto>& items);
+    // Where the incremental pulls resume after a restart
+    std::string latestOrderUpdate();
+    long long latestOrderItemId();
+
 private:
     std::unique_ptr<ApiService> dbo_;
+    LruCache<std::string, long long> recentKeys_;   // idempotency key → order id
+    std::mutex mutex_;
 };
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// ─── Bounded least-recently-used map ─────────────────────────────────────────
+// O(1) get / put; the least recently used entry is evicted once `capacity`
+// is exceeded.  Not thread-safe: owners guard it with their own mutex.
+
+template <typename K, typename V, typename Hash = std::hash<K>>
+class LruCache {
+public:
+    explicit LruCache(size_t capacity) : capacity_(capacity) {}
+
+    // Copies the value out and marks the entry most recently used
+    bool get(const K& key, V& value) {
+        auto it = index_.find(key);
+        if (it == index_.end()) return false;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        value = it->second->second;
+        return true;
+    }
+
+    void put(const K& key, V value) {
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            it->second->second = std::move(value);
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        entries_.emplace_front(key, std::move(value));
+        index_[key] = entries_.begin();
+        if (entries_.size() > capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+    }
+
+    void erase(const K& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) return;
+        entries_.erase(it->second);
+        index_.erase(it);
+    }
+
+    void clear() {
+        index_.clear();
+        entries_.clear();
+    }
+
+    size_t size() const { return entries_.size(); }
+
+private:
+    using Entry = std::pair<K, V>;
+
+    size_t capacity_;
+    std::list<Entry> entries_;   // most recently used first
+    std::unordered_map<K, typename std::list<Entry>::iterator, Hash> index_;
+};
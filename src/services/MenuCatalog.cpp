@@ -0,0 +1,137 @@
+#include "MenuCatalog.h"
+#include "Metrics.h"
+
+#include <iostream>
+
+// ─── MenuSnapshot ────────────────────────────────────────────────────────────
+
+const std::vector<MenuItemDto>& MenuSnapshot::items(long long categoryId) const {
+    static const std::vector<MenuItemDto> none;
+    auto it = itemsByCategory.find(categoryId);
+    return it != itemsByCategory.end() ? it->second : none;
+}
+
+int MenuSnapshot::availableCount(long long categoryId) const {
+    int count = 0;
+    for (auto& item : items(categoryId)) {
+        if (item.available) count++;
+    }
+    return count;
+}
+
+const MenuItemDto* MenuSnapshot::item(long long menuItemId) const {
+    for (auto& entry : itemsByCategory) {
+        for (auto& item : entry.second) {
+            if (item.id == menuItemId) return &item;
+        }
+    }
+    return nullptr;
+}
+
+// ─── MenuCatalog ─────────────────────────────────────────────────────────────
+
+MenuCatalog::MenuCatalog(std::shared_ptr<IApiService> api, std::chrono::seconds maxAge)
+    : api_(std::move(api)), maxAge_(maxAge),
+      loads_(MetricsRegistry::instance().counter(
+          "pos_menu_snapshot_loads_total",
+          "Menu snapshots read from the backend (first use and expiry)", "")),
+      loader_(1, "menu-prefetch")
+{}
+
+MenuCatalog::Slot& MenuCatalog::slot(long long restaurantId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& s = slots_[restaurantId];
+    if (!s) s = std::make_unique<Slot>();
+    return *s;
+}
+
+std::shared_ptr<const MenuSnapshot> MenuCatalog::load(long long restaurantId) {
+    auto snapshot = std::make_shared<MenuSnapshot>();
+    snapshot->restaurantId = restaurantId;
+    snapshot->loadedAt = std::chrono::steady_clock::now();
+    snapshot->categories = api_->getCategories(restaurantId);
+    for (auto& item : api_->getMenuItemsByRestaurant(restaurantId)) {
+        snapshot->itemsByCategory[item.category_id].push_back(std::move(item));
+    }
+    loads_.inc();
+    return snapshot;
+}
+
+std::shared_ptr<const MenuSnapshot> MenuCatalog::current(long long restaurantId) {
+    Slot& s = slot(restaurantId);
+    auto snapshot = std::atomic_load(&s.snapshot);
+    auto fresh = [this](const std::shared_ptr<const MenuSnapshot>& p) {
+        return p && std::chrono::steady_clock::now() - p->loadedAt < maxAge_;
+    };
+    if (fresh(snapshot)) return snapshot;
+
+    // Nothing to serve yet: wait for whoever is loading
+    if (!snapshot) {
+        std::lock_guard<std::mutex> lock(s.writeMutex);
+        snapshot = std::atomic_load(&s.snapshot);
+        if (!snapshot) {
+            snapshot = load(restaurantId);
+            std::atomic_store(&s.snapshot, snapshot);
+        }
+        return snapshot;
+    }
+
+    // Expired: one reader reloads, the rest keep the old menu
+    std::unique_lock<std::mutex> lock(s.writeMutex, std::try_to_lock);
+    if (!lock.owns_lock()) return snapshot;
+    snapshot = std::atomic_load(&s.snapshot);
+    if (fresh(snapshot)) return snapshot;
+    try {
+        auto reloaded = load(restaurantId);
+        std::atomic_store(&s.snapshot, reloaded);
+        return reloaded;
+    } catch (std::exception& e) {
+        std::cerr << "[MenuCatalog] Reloading restaurant " << restaurantId
+                  << " failed, serving the old menu: " << e.what() << std::endl;
+        return snapshot;
+    }
+}
+
+void MenuCatalog::prefetch(long long restaurantId) {
+    loader_.post([this, restaurantId] {
+        try {
+            current(restaurantId);
+        } catch (std::exception& e) {
+            std::cerr << "[MenuCatalog] Prefetching restaurant " << restaurantId
+                      << " failed: " << e.what() << std::endl;
+        }
+    });
+}
+
+void MenuCatalog::setAvailability(long long restaurantId, long long menuItemId,
+                                  bool available) {
+    api_->updateMenuItemAvailability(menuItemId, available);
+
+    Slot& s = slot(restaurantId);
+    std::lock_guard<std::mutex> lock(s.writeMutex);
+    auto published = std::atomic_load(&s.snapshot);
+    if (!published) return;   // the first reader loads it, change included
+
+    auto next = std::make_shared<MenuSnapshot>(*published);
+    bool found = false;
+    for (auto& entry : next->itemsByCategory) {
+        for (auto& item : entry.second) {
+            if (item.id == menuItemId) {
+                item.available = available;
+                found = true;
+            }
+        }
+    }
+    if (found) {
+        std::atomic_store(&s.snapshot, std::shared_ptr<const MenuSnapshot>(std::move(next)));
+        return;
+    }
+
+    // An item this snapshot predates: read the menu again
+    try {
+        std::atomic_store(&s.snapshot, load(restaurantId));
+    } catch (std::exception& e) {
+        std::cerr << "[MenuCatalog] Reloading restaurant " << restaurantId
+                  << " failed: " << e.what() << std::endl;
+    }
+}
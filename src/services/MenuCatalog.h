@@ -0,0 +1,77 @@
+#pragma once
+
+#include "IApiService.h"
+#include "TaskPool.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class MetricCounter;
+
+// ─── One restaurant's menu, frozen ───────────────────────────────────────────
+// Never modified once published: a change produces a new snapshot, so a
+// view can keep and render from the one it holds without locking.
+
+struct MenuSnapshot {
+    long long restaurantId = 0;
+    std::vector<CategoryDto> categories;                             // sort order
+    std::map<long long, std::vector<MenuItemDto>> itemsByCategory;   // by category id
+    std::chrono::steady_clock::time_point loadedAt;                  // read from the backend
+
+    // Unavailable items included
+    const std::vector<MenuItemDto>& items(long long categoryId) const;
+    int availableCount(long long categoryId) const;
+
+    // Any category; nullptr if the item is not on this menu
+    const MenuItemDto* item(long long menuItemId) const;
+};
+
+// ─── Process-wide menu snapshots, one per restaurant ─────────────────────────
+// Every session of a restaurant renders from the same snapshot, so moving
+// between menu screens costs no backend calls.  A snapshot is loaded on
+// first use (getCategories + getMenuItemsByRestaurant) and replaced
+// read-copy-update style: readers std::atomic_load the current pointer,
+// setAvailability() writes through to the backend, then publishes a copy
+// carrying the change with std::atomic_store.
+//
+// Edits made outside this process (another server on the same ALS) show
+// up once a snapshot is older than `maxAge`: the first reader to notice
+// reloads it, while readers arriving meanwhile get the old one.  prefetch()
+// does the same on a worker thread, for screens that know they will need
+// the menu soon.
+//
+// Exported as pos_menu_snapshot_loads_total.
+
+class MenuCatalog {
+public:
+    MenuCatalog(std::shared_ptr<IApiService> api, std::chrono::seconds maxAge);
+
+    // Throws if the restaurant has no snapshot yet and loading it fails
+    std::shared_ptr<const MenuSnapshot> current(long long restaurantId);
+
+    // Load (or reload, if expired) in the background; never blocks
+    void prefetch(long long restaurantId);
+
+    void setAvailability(long long restaurantId, long long menuItemId, bool available);
+
+private:
+    struct Slot {
+        std::shared_ptr<const MenuSnapshot> snapshot;   // std::atomic_load/store only
+        std::mutex writeMutex;                          // one loader or writer at a time
+    };
+
+    Slot& slot(long long restaurantId);
+    std::shared_ptr<const MenuSnapshot> load(long long restaurantId);
+
+    std::shared_ptr<IApiService> api_;
+    std::chrono::seconds maxAge_;
+    MetricCounter& loads_;
+
+    std::mutex mutex_;                                  // guards slots_, not the snapshots
+    std::map<long long, std::unique_ptr<Slot>> slots_;
+
+    TaskPool loader_;   // last: joined before the members its tasks use go
+};
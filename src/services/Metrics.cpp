@@ -0,0 +1,191 @@
+#include "Metrics.h"
+
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+
+// ─── LatencyHistogram ────────────────────────────────────────────────────────
+
+int LatencyHistogram::bucketIndex(uint64_t us) {
+    if (us < (uint64_t)kSubBuckets) return (int)us;
+    int msb = 63 - __builtin_clzll(us);
+    int shift = msb - kSubBucketBits;
+    int sub = (int)((us >> shift) & (kSubBuckets - 1));
+    int index = kSubBuckets + shift * kSubBuckets + sub;
+    return index < kBuckets ? index : kBuckets - 1;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int index) {
+    if (index < kSubBuckets) return (uint64_t)index + 1;
+    int shift = (index - kSubBuckets) / kSubBuckets;
+    int sub = (index - kSubBuckets) % kSubBuckets;
+    return (uint64_t)(kSubBuckets + sub + 1) << shift;
+}
+
+void LatencyHistogram::recordMicros(uint64_t us) {
+    buckets_[bucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(us, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::quantileMicros(double q) const {
+    // Sum the buckets rather than trusting count_: a concurrent record may
+    // have bumped one but not yet the other.
+    uint64_t total = 0;
+    for (int i = 0; i < kBuckets; i++) total += buckets_[i].load(std::memory_order_relaxed);
+    if (total == 0) return 0;
+
+    if (q < 0) q = 0;
+    if (q > 1) q = 1;
+    uint64_t rank = (uint64_t)(q * (double)(total - 1)) + 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; i++) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) return bucketUpperBound(i);
+    }
+    return bucketUpperBound(kBuckets - 1);
+}
+
+uint64_t LatencyHistogram::countAtOrBelow(uint64_t us) const {
+    uint64_t n = 0;
+    for (int i = 0; i < kBuckets && bucketUpperBound(i) <= us + 1; i++)
+        n += buckets_[i].load(std::memory_order_relaxed);
+    return n;
+}
+
+// ─── MetricsRegistry ─────────────────────────────────────────────────────────
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name,
+                                                 const std::string& help, Type type) {
+    for (auto& f : families_) {
+        if (f->name != name) continue;
+        if (f->type != type)
+            throw std::runtime_error("metric family " + name + " registered with another type");
+        return *f;
+    }
+    families_.push_back(std::unique_ptr<Family>(new Family{name, help, type, {}, {}, {}}));
+    return *families_.back();
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string& familyName,
+                                             const std::string& help,
+                                             const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Family& f = family(familyName, help, Type::Histogram);
+    for (auto& h : f.histograms)
+        if (h.first == labels) return *h.second;
+    f.histograms.emplace_back(labels, std::make_unique<LatencyHistogram>());
+    return *f.histograms.back().second;
+}
+
+MetricCounter& MetricsRegistry::counter(const std::string& familyName,
+                                        const std::string& help,
+                                        const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Family& f = family(familyName, help, Type::Counter);
+    for (auto& c : f.counters)
+        if (c.first == labels) return *c.second;
+    f.counters.emplace_back(labels, std::make_unique<MetricCounter>());
+    return *f.counters.back().second;
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& familyName,
+                                    const std::string& help,
+                                    const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Family& f = family(familyName, help, Type::Gauge);
+    for (auto& g : f.gauges)
+        if (g.first == labels) return *g.second;
+    f.gauges.emplace_back(labels, std::make_unique<MetricGauge>());
+    return *f.gauges.back().second;
+}
+
+namespace {
+
+// Prometheus-style boundaries exported for histograms (seconds)
+const double kExportBounds[] = {
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+    0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0
+};
+
+const double kExportQuantiles[] = {0.5, 0.9, 0.95, 0.99, 0.999};
+
+std::string withLabel(const std::string& labels, const std::string& extra) {
+    std::string body = labels.empty() ? extra : labels + "," + extra;
+    return "{" + body + "}";
+}
+
+std::string braced(const std::string& labels) {
+    return labels.empty() ? "" : "{" + labels + "}";
+}
+
+std::string fmt(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", v);
+    return buf;
+}
+
+// pos_x_duration_seconds -> pos_x_duration_quantile_seconds
+std::string quantileFamily(const std::string& name) {
+    const std::string unit = "_seconds";
+    if (name.size() > unit.size() &&
+        name.compare(name.size() - unit.size(), unit.size(), unit) == 0) {
+        return name.substr(0, name.size() - unit.size()) + "_quantile" + unit;
+    }
+    return name + "_quantile";
+}
+
+}  // namespace
+
+std::string MetricsRegistry::renderPrometheus() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream out;
+
+    for (auto& f : families_) {
+        if (f->type == Type::Counter) {
+            out << "# HELP " << f->name << " " << f->help << "\n";
+            out << "# TYPE " << f->name << " counter\n";
+            for (auto& c : f->counters)
+                out << f->name << braced(c.first) << " " << c.second->value() << "\n";
+            continue;
+        }
+        if (f->type == Type::Gauge) {
+            out << "# HELP " << f->name << " " << f->help << "\n";
+            out << "# TYPE " << f->name << " gauge\n";
+            for (auto& g : f->gauges)
+                out << f->name << braced(g.first) << " " << g.second->value() << "\n";
+            continue;
+        }
+
+        out << "# HELP " << f->name << " " << f->help << "\n";
+        out << "# TYPE " << f->name << " histogram\n";
+        for (auto& h : f->histograms) {
+            const LatencyHistogram& hist = *h.second;
+            uint64_t count = hist.count();
+            for (double le : kExportBounds) {
+                uint64_t n = hist.countAtOrBelow((uint64_t)(le * 1e6));
+                out << f->name << "_bucket" << withLabel(h.first, "le=\"" + fmt(le) + "\"")
+                    << " " << (n < count ? n : count) << "\n";
+            }
+            out << f->name << "_bucket" << withLabel(h.first, "le=\"+Inf\"") << " " << count << "\n";
+            out << f->name << "_sum" << braced(h.first) << " " << fmt(hist.sumMicros() / 1e6) << "\n";
+            out << f->name << "_count" << braced(h.first) << " " << count << "\n";
+        }
+
+        std::string qname = quantileFamily(f->name);
+        out << "# HELP " << qname << " " << f->help << " (quantiles)\n";
+        out << "# TYPE " << qname << " gauge\n";
+        for (auto& h : f->histograms) {
+            for (double q : kExportQuantiles) {
+                out << qname << withLabel(h.first, "quantile=\"" + fmt(q) + "\"") << " "
+                    << fmt(h.second->quantileMicros(q) / 1e6) << "\n";
+            }
+        }
+    }
+    return out.str();
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ─── Process-wide metrics, exported in Prometheus text format ───────────────
+// Instruments are registered once (mutex-protected) and then recorded into
+// with relaxed atomics only, so hot paths never take a lock.  Callers keep
+// the returned reference; registering the same family + labels again returns
+// the same instrument.
+//
+//   auto& h = MetricsRegistry::instance().histogram(
+//       "pos_api_call_duration_seconds", "IApiService call latency",
+//       "method=\"getOrders\"");
+//   h.recordMicros(elapsed);
+
+// Monotonic counter
+class MetricCounter {
+public:
+    void inc(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+// Point-in-time value that can go up and down (states, sizes, queue depths)
+class MetricGauge {
+public:
+    void set(int64_t v) { value_.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+// HDR-style log-linear histogram over microseconds.  Each power of two is
+// split into 16 linear sub-buckets, so any recorded value is reproduced to
+// within ~6% from 1 µs up to ~12 days.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kBuckets = kSubBuckets + 37 * kSubBuckets;
+
+    void recordMicros(uint64_t us);
+    void record(std::chrono::steady_clock::duration d) {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+        recordMicros(us > 0 ? (uint64_t)us : 0);
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sumMicros() const { return sum_.load(std::memory_order_relaxed); }
+
+    // Value (µs) at quantile q in [0,1]: upper edge of the bucket holding it
+    uint64_t quantileMicros(double q) const;
+
+    // Recorded values <= us (bucket-granular, never over-counts)
+    uint64_t countAtOrBelow(uint64_t us) const;
+
+    static int bucketIndex(uint64_t us);
+    static uint64_t bucketUpperBound(int index);   // exclusive
+
+private:
+    std::atomic<uint64_t> buckets_[kBuckets] = {};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+};
+
+// Records elapsed time into a histogram when it goes out of scope
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram& h)
+        : hist_(h), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() { hist_.record(std::chrono::steady_clock::now() - start_); }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyHistogram& hist_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    // `labels` is the Prometheus label body without braces, e.g.
+    // method="getOrders",phase="dns" (empty for an unlabelled series).
+    // Histogram families should be named *_seconds.
+    LatencyHistogram& histogram(const std::string& family, const std::string& help,
+                                const std::string& labels);
+    MetricCounter& counter(const std::string& family, const std::string& help,
+                           const std::string& labels);
+    MetricGauge& gauge(const std::string& family, const std::string& help,
+                       const std::string& labels);
+
+    // Text exposition format 0.0.4.  Histograms additionally export
+    // p50/p90/p95/p99/p999 gauges under <family>_quantile (e.g.
+    // pos_api_call_duration_quantile_seconds), computed from the full-resolution buckets.
+    std::string renderPrometheus();
+
+private:
+    MetricsRegistry() = default;
+
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Family {
+        std::string name;
+        std::string help;
+        Type type;
+        std::vector<std::pair<std::string, std::unique_ptr<MetricCounter>>> counters;
+        std::vector<std::pair<std::string, std::unique_ptr<MetricGauge>>> gauges;
+        std::vector<std::pair<std::string, std::unique_ptr<LatencyHistogram>>> histograms;
+    };
+
+    Family& family(const std::string& name, const std::string& help, Type type);
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<Family>> families_;   // registration order
+};
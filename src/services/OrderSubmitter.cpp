@@ -0,0 +1,60 @@
+#include "OrderSubmitter.h"
+#include "Metrics.h"
+
+#include <iostream>
+
+OrderSubmitter::OrderSubmitter(std::shared_ptr<IApiService> api, int threads)
+    : api_(std::move(api)),
+      succeeded_(MetricsRegistry::instance().counter(
+          "pos_order_submissions_total", "Orders submitted from the front desk, by outcome",
+          "result=\"ok\"")),
+      failed_(MetricsRegistry::instance().counter(
+          "pos_order_submissions_total", "Orders submitted from the front desk, by outcome",
+          "result=\"failed\"")),
+      inFlight_(MetricsRegistry::instance().gauge(
+          "pos_order_submissions_in_flight", "Order submissions queued or running", "")),
+      duration_(MetricsRegistry::instance().histogram(
+          "pos_order_submit_duration_seconds",
+          "Time to place an order with all its items, queueing included", "")),
+      workers_(threads, "order-submit")
+{}
+
+void OrderSubmitter::submit(OrderSubmission submission, ApiCallback<OrderSubmission> done) {
+    inFlight_.add(1);
+    auto queued = std::chrono::steady_clock::now();
+    workers_.post([this, submission = std::move(submission), done = std::move(done),
+                   queued]() mutable {
+        ApiResult<OrderSubmission> result;
+        try {
+            run(submission);
+            succeeded_.inc();
+        } catch (std::exception& e) {
+            std::cerr << "[OrderSubmitter] Table " << submission.tableNumber << ": "
+                      << e.what() << std::endl;
+            result.error = e.what();
+            failed_.inc();
+        }
+        duration_.record(std::chrono::steady_clock::now() - queued);
+        inFlight_.add(-1);
+        result.value = std::move(submission);
+        done(std::move(result));
+    });
+}
+
+void OrderSubmitter::run(OrderSubmission& s) {
+    if (s.orderId == 0) {
+        s.orderId = api_->createOrder(s.restaurantId, s.tableNumber, s.customerName,
+                                      s.notes, s.idempotencyKey).id;
+    }
+
+    // Keyed by position, so two identical lines are still two lines
+    std::vector<NewOrderItemDto> lines;
+    lines.reserve(s.lines.size());
+    for (size_t i = 0; i < s.lines.size(); i++) {
+        auto& line = s.lines[i];
+        lines.push_back({line.menuItemId, line.quantity, line.instructions,
+                         s.idempotencyKey.empty() ? ""
+                                                  : s.idempotencyKey + "/" + std::to_string(i)});
+    }
+    api_->addOrderItems(s.orderId, lines, s.linesAdded);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "IApiService.h"
+#include "IAsyncApiService.h"
+#include "TaskPool.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class LatencyHistogram;
+class MetricCounter;
+class MetricGauge;
+
+// ─── An order to place, and how far placing it has got ───────────────────────
+
+struct OrderSubmission {
+    struct Line {
+        long long menuItemId = 0;
+        int quantity = 0;
+        std::string instructions;
+    };
+
+    long long restaurantId = 0;
+    int tableNumber = 0;
+    std::string customerName;
+    std::string notes;
+    std::vector<Line> lines;
+    std::string idempotencyKey;     // kept across retries
+
+    // Progress: a failed submission comes back with these set, and
+    // submitting it again resumes from there instead of starting over.
+    // Each line goes out keyed by idempotencyKey and its position, so a
+    // line that landed just before the failure is not added twice.
+    long long orderId = 0;          // 0 until created; provisional (< 0) if queued
+    size_t linesAdded = 0;
+
+    bool done() const { return orderId != 0 && linesAdded == lines.size(); }
+};
+
+// ─── Places orders off the request thread ────────────────────────────────────
+// createOrder and addOrderItems run on a small worker pool, so the click
+// that placed the order returns at once; in ALS mode the whole sequence is
+// several round trips.  The callback runs on the worker, with
+// the submission as far as it got (and the error if it stopped short);
+// views wrap it with sessionCallback().
+//
+// Exported as pos_order_submissions_total{result}, pos_order_submissions_in_flight
+// and pos_order_submit_duration_seconds.
+
+class OrderSubmitter {
+public:
+    OrderSubmitter(std::shared_ptr<IApiService> api, int threads);
+
+    void submit(OrderSubmission submission, ApiCallback<OrderSubmission> done);
+
+private:
+    void run(OrderSubmission& submission);
+
+    std::shared_ptr<IApiService> api_;
+    MetricCounter& succeeded_;
+    MetricCounter& failed_;
+    MetricGauge& inFlight_;
+    LatencyHistogram& duration_;
+
+    TaskPool workers_;   // last: joined before the members its tasks use go
+};
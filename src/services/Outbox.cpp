@@ -0,0 +1,363 @@
+#include "Outbox.h"
+#include "Metrics.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+constexpr const char* kSchema =
+    "create table if not exists outbox ("
+    "  seq integer primary key autoincrement,"
+    "  idempotency_key text not null unique,"
+    "  enqueued_ms integer not null,"
+    "  op integer not null,"
+    "  target_id integer not null default 0,"
+    "  restaurant_id integer not null default 0,"
+    "  menu_item_id integer not null default 0,"
+    "  table_number integer not null default 0,"
+    "  quantity integer not null default 0,"
+    "  available integer not null default 0,"
+    "  customer_name text not null default '',"
+    "  notes text not null default '',"
+    "  status text not null default '',"
+    "  failed integer not null default 0,"
+    "  error text"
+    ");"
+    "create table if not exists outbox_ids ("
+    "  provisional integer primary key,"
+    "  real_id integer not null"
+    ");";
+
+constexpr const char* kColumns =
+    "seq, idempotency_key, enqueued_ms, op, target_id, restaurant_id, menu_item_id,"
+    " table_number, quantity, available, customer_name, notes, status";
+
+// Retry backoff while the head entry keeps failing: 100 ms doubling to 5 s
+std::chrono::milliseconds replayBackoff(int attempt) {
+    return std::chrono::milliseconds(std::min(5000, 100 << std::min(attempt - 1, 6)));
+}
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string newIdempotencyKey() {
+    thread_local std::mt19937_64 rng(std::random_device{}());
+    static const char* hex = "0123456789abcdef";
+    std::string key = "ob-";
+    for (int i = 0; i < 2; i++) {
+        uint64_t v = rng();
+        for (int n = 0; n < 16; n++, v >>= 4) key += hex[v & 0xf];
+    }
+    return key;
+}
+
+class Stmt {
+public:
+    Stmt(sqlite3* db, const char* sql) : db_(db) {
+        if (sqlite3_prepare_v2(db, sql, -1, &st_, nullptr) != SQLITE_OK)
+            throw std::runtime_error(std::string(sqlite3_errmsg(db)) + " in: " + sql);
+    }
+    ~Stmt() { sqlite3_finalize(st_); }
+
+    Stmt& bind(int idx, long long v) { sqlite3_bind_int64(st_, idx, v); return *this; }
+    Stmt& bind(int idx, const std::string& v) {
+        sqlite3_bind_text(st_, idx, v.c_str(), (int)v.size(), SQLITE_TRANSIENT);
+        return *this;
+    }
+
+    bool step() {
+        int rc = sqlite3_step(st_);
+        if (rc == SQLITE_ROW) return true;
+        if (rc == SQLITE_DONE) return false;
+        throw std::runtime_error(sqlite3_errmsg(db_));
+    }
+
+    long long integer(int col) { return sqlite3_column_int64(st_, col); }
+    std::string text(int col) {
+        auto p = sqlite3_column_text(st_, col);
+        return p ? reinterpret_cast<const char*>(p) : "";
+    }
+
+private:
+    sqlite3* db_;
+    sqlite3_stmt* st_ = nullptr;
+};
+
+const char* opName(OutboxEntry::Op op) {
+    switch (op) {
+        case OutboxEntry::Op::CreateOrder:                return "createOrder";
+        case OutboxEntry::Op::AddOrderItem:               return "addOrderItem";
+        case OutboxEntry::Op::UpdateOrderStatus:          return "updateOrderStatus";
+        case OutboxEntry::Op::UpdateMenuItemAvailability: return "updateMenuItemAvailability";
+    }
+    return "?";
+}
+
+}  // namespace
+
+Outbox::Outbox(const std::string& path, Apply apply)
+    : apply_(std::move(apply))
+{
+    if (sqlite3_open(path.c_str(), &db_) != SQLITE_OK) {
+        std::string msg = db_ ? sqlite3_errmsg(db_) : "out of memory";
+        sqlite3_close(db_);
+        throw std::runtime_error("cannot open outbox " + path + ": " + msg);
+    }
+    sqlite3_busy_timeout(db_, 5000);
+
+    auto& r = MetricsRegistry::instance();
+    depthGauge_ = &r.gauge("pos_outbox_depth", "ALS writes waiting for replay", "");
+    enqueued_ = &r.counter("pos_outbox_enqueued_total", "ALS writes queued", "");
+    replayed_ = &r.counter("pos_outbox_replayed_total", "Queued ALS writes applied", "");
+    rejected_ = &r.counter("pos_outbox_rejected_total",
+                           "Queued ALS writes refused by the server and set aside", "");
+    retries_ = &r.counter("pos_outbox_retries_total", "Replay attempts that will be repeated", "");
+    enqueueLatency_ = &r.histogram("pos_outbox_enqueue_duration_seconds",
+                                   "Time to make an ALS write durable locally", "");
+    replayLag_ = &r.histogram("pos_outbox_replay_lag_seconds",
+                              "Time from enqueue until the write reached ALS", "");
+
+    try {
+        // WAL keeps each append to one fsync; FULL makes that fsync happen on commit
+        exec("pragma journal_mode = wal");
+        exec("pragma synchronous = full");
+        exec(kSchema);
+        load();
+    } catch (...) {
+        sqlite3_close(db_);
+        throw;
+    }
+
+    if (!pending_.empty()) {
+        std::cout << "[Outbox] Resuming " << pending_.size() << " queued writes from "
+                  << path << std::endl;
+    }
+    replay_ = std::thread([this] { runReplay(); });
+}
+
+Outbox::~Outbox() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (replay_.joinable()) replay_.join();
+    sqlite3_close(db_);
+}
+
+void Outbox::exec(const char* sql) {
+    char* err = nullptr;
+    if (sqlite3_exec(db_, sql, nullptr, nullptr, &err) != SQLITE_OK) {
+        std::string msg = err ? err : "unknown error";
+        sqlite3_free(err);
+        throw std::runtime_error("outbox: " + msg);
+    }
+}
+
+void Outbox::load() {
+    // Mappings only matter while a queued entry still refers to them
+    exec("delete from outbox_ids where provisional not in "
+         "(select target_id from outbox where failed = 0 and target_id < 0)");
+
+    Stmt ids(db_, "select provisional, real_id from outbox_ids");
+    while (ids.step()) realIds_[ids.integer(0)] = ids.integer(1);
+
+    Stmt rejected(db_, "select seq from outbox where failed = 1 and op = 1");
+    while (rejected.step()) rejectedOrders_.insert(-rejected.integer(0));
+
+    Stmt st(db_, (std::string("select ") + kColumns +
+                  " from outbox where failed = 0 order by seq").c_str());
+    while (st.step()) {
+        OutboxEntry e;
+        e.seq = st.integer(0);
+        e.idempotencyKey = st.text(1);
+        e.enqueuedMs = st.integer(2);
+        e.op = (OutboxEntry::Op)st.integer(3);
+        e.targetId = st.integer(4);
+        e.restaurantId = st.integer(5);
+        e.menuItemId = st.integer(6);
+        e.tableNumber = (int)st.integer(7);
+        e.quantity = (int)st.integer(8);
+        e.available = st.integer(9) != 0;
+        e.customerName = st.text(10);
+        e.notes = st.text(11);
+        e.status = st.text(12);
+        pending_.push_back(std::move(e));
+    }
+    depthGauge_->set((int64_t)pending_.size());
+}
+
+long long Outbox::enqueue(OutboxEntry e, Done done) {
+    ScopedLatency timer(*enqueueLatency_);
+    if (e.idempotencyKey.empty()) e.idempotencyKey = newIdempotencyKey();
+    e.enqueuedMs = nowMs();
+
+    // dbMutex_ spans the push as well, so pending_ stays in seq order
+    std::lock_guard<std::mutex> dbLock(dbMutex_);
+    Stmt st(db_, "insert or ignore into outbox (idempotency_key, enqueued_ms, op, target_id,"
+                 " restaurant_id, menu_item_id, table_number, quantity, available,"
+                 " customer_name, notes, status) values (?,?,?,?,?,?,?,?,?,?,?,?)");
+    st.bind(1, e.idempotencyKey).bind(2, (long long)e.enqueuedMs).bind(3, (long long)e.op)
+      .bind(4, e.targetId).bind(5, e.restaurantId).bind(6, e.menuItemId)
+      .bind(7, (long long)e.tableNumber).bind(8, (long long)e.quantity)
+      .bind(9, (long long)e.available)
+      .bind(10, e.customerName).bind(11, e.notes).bind(12, e.status);
+    st.step();
+    if (sqlite3_changes(db_) == 0) {
+        Stmt existing(db_, "select seq from outbox where idempotency_key = ?");
+        existing.bind(1, e.idempotencyKey);
+        if (existing.step()) return existing.integer(0);
+        throw std::runtime_error("outbox: cannot queue " + e.idempotencyKey);
+    }
+    e.seq = sqlite3_last_insert_rowid(db_);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (done) done_[e.seq] = std::move(done);
+        pending_.push_back(e);
+        depthGauge_->set((int64_t)pending_.size());
+    }
+    enqueued_->inc();
+    wake_.notify_one();
+    return e.seq;
+}
+
+long long Outbox::resolve(long long orderId) const {
+    if (orderId >= 0) return orderId;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = realIds_.find(orderId);
+    return it == realIds_.end() ? 0 : it->second;
+}
+
+size_t Outbox::depth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+bool Outbox::waitDrained(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return drained_.wait_for(lock, timeout, [this] { return pending_.empty(); });
+}
+
+bool Outbox::resolveRefs(OutboxEntry& e, std::string& error) const {
+    if (e.op == OutboxEntry::Op::CreateOrder || e.op == OutboxEntry::Op::UpdateMenuItemAvailability ||
+        e.targetId >= 0) {
+        return true;
+    }
+    auto it = realIds_.find(e.targetId);
+    if (it != realIds_.end()) {
+        e.targetId = it->second;
+        return true;
+    }
+    error = rejectedOrders_.count(e.targetId)
+        ? "queued order " + std::to_string(e.targetId) + " was rejected"
+        : "unknown queued order " + std::to_string(e.targetId);
+    return false;
+}
+
+void Outbox::runReplay() {
+    int attempt = 0;
+    for (;;) {
+        OutboxEntry entry;
+        OutboxOutcome outcome;
+        bool resolved;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+            if (stop_) return;
+            entry = pending_.front();
+            resolved = resolveRefs(entry, outcome.error);
+        }
+
+        if (!resolved) {
+            outcome.kind = OutboxOutcome::Kind::Rejected;
+        } else {
+            try {
+                outcome = apply_(entry);
+            } catch (std::exception& e) {
+                outcome.kind = OutboxOutcome::Kind::Retry;
+                outcome.error = e.what();
+            }
+        }
+
+        if (outcome.kind == OutboxOutcome::Kind::Retry) {
+            attempt++;
+            retries_->inc();
+            if (attempt == 1 || attempt % 10 == 0) {
+                std::cerr << "[Outbox] " << opName(entry.op) << " #" << entry.seq
+                          << " not delivered (" << outcome.error << "), attempt " << attempt
+                          << ", " << depth() << " queued" << std::endl;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait_for(lock, replayBackoff(attempt), [this] { return stop_; });
+            continue;
+        }
+
+        if (attempt > 0) {
+            std::cout << "[Outbox] " << opName(entry.op) << " #" << entry.seq
+                      << " delivered after " << attempt << " retries" << std::endl;
+        }
+        attempt = 0;
+        finish(entry, outcome);
+    }
+}
+
+void Outbox::finish(const OutboxEntry& e, const OutboxOutcome& outcome) {
+    bool applied = outcome.kind == OutboxOutcome::Kind::Applied;
+    bool created = e.op == OutboxEntry::Op::CreateOrder;
+
+    // A failed write here only risks a repeat after restart, which the
+    // idempotency key makes harmless; keep the in-memory queue moving.
+    try {
+        std::lock_guard<std::mutex> dbLock(dbMutex_);
+        if (applied) {
+            exec("begin");
+            Stmt(db_, "delete from outbox where seq = ?").bind(1, e.seq).step();
+            if (created) {
+                Stmt(db_, "insert or replace into outbox_ids (provisional, real_id) values (?, ?)")
+                    .bind(1, -e.seq).bind(2, outcome.createdId).step();
+            }
+            exec("commit");
+        } else {
+            Stmt(db_, "update outbox set failed = 1, error = ? where seq = ?")
+                .bind(1, outcome.error).bind(2, e.seq).step();
+        }
+    } catch (std::exception& ex) {
+        sqlite3_exec(db_, "rollback", nullptr, nullptr, nullptr);
+        std::cerr << "[Outbox] Cannot record #" << e.seq << ": " << ex.what() << std::endl;
+    }
+
+    Done done;
+    bool empty;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.pop_front();
+        if (created && applied) realIds_[-e.seq] = outcome.createdId;
+        if (created && !applied) rejectedOrders_.insert(-e.seq);
+        auto it = done_.find(e.seq);
+        if (it != done_.end()) {
+            done = std::move(it->second);
+            done_.erase(it);
+        }
+        depthGauge_->set((int64_t)pending_.size());
+        empty = pending_.empty();
+    }
+    if (empty) drained_.notify_all();
+
+    if (applied) {
+        replayed_->inc();
+        replayLag_->recordMicros((uint64_t)std::max<int64_t>(0, nowMs() - e.enqueuedMs) * 1000);
+    } else {
+        rejected_->inc();
+        std::cerr << "[Outbox] " << opName(e.op) << " #" << e.seq << " rejected: "
+                  << outcome.error << std::endl;
+    }
+    if (done) done(outcome);
+}
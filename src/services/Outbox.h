@@ -0,0 +1,119 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+struct sqlite3;
+class LatencyHistogram;
+class MetricCounter;
+class MetricGauge;
+
+// ─── Durable store-and-forward queue for ApiLogicServer writes ──────────────
+// RestApiService appends each mutation here (an SQLite file, fsynced before
+// enqueue() returns) and acknowledges it at once; one background thread
+// replays the entries to the server strictly in order.
+//
+// A queued createOrder gets the provisional order id -seq.  Later entries
+// may refer to it; the replay thread substitutes the real id once the
+// order exists (the mapping is kept in the same file, so it survives a
+// restart).  Every entry carries an idempotency key that is sent with each
+// attempt, so a replay after a lost response is not applied twice.
+//
+// Transient failures (transport errors, 5xx, open circuit) keep the entry
+// at the head and retry with backoff.  Permanent ones (other 4xx, or a
+// reference to an order that was itself rejected) mark the entry failed
+// and move on; failed rows stay in the file for inspection.
+//
+// Exported as pos_outbox_depth, pos_outbox_{enqueued,replayed,rejected}_total,
+// pos_outbox_retries_total, pos_outbox_enqueue_duration_seconds and
+// pos_outbox_replay_lag_seconds (enqueue to applied).
+
+struct OutboxEntry {
+    enum class Op { CreateOrder = 1, AddOrderItem, UpdateOrderStatus, UpdateMenuItemAvailability };
+
+    long long seq = 0;                 // set by enqueue()
+    std::string idempotencyKey;        // generated by enqueue() if empty
+    int64_t enqueuedMs = 0;            // set by enqueue(); system clock
+
+    Op op = Op::CreateOrder;
+    long long targetId = 0;            // order (provisional if < 0) or menu item
+    long long restaurantId = 0;        // CreateOrder
+    long long menuItemId = 0;          // AddOrderItem
+    int tableNumber = 0;               // CreateOrder
+    int quantity = 0;                  // AddOrderItem
+    bool available = false;            // UpdateMenuItemAvailability
+    std::string customerName;          // CreateOrder
+    std::string notes;                 // CreateOrder notes / AddOrderItem instructions
+    std::string status;                // UpdateOrderStatus
+};
+
+struct OutboxOutcome {
+    enum class Kind { Applied, Retry, Rejected };
+
+    Kind kind = Kind::Applied;
+    long long createdId = 0;           // CreateOrder: the server's order id
+    std::string error;
+};
+
+class Outbox {
+public:
+    // Sends one entry (ids already resolved).  Runs on the replay thread.
+    using Apply = std::function<OutboxOutcome(const OutboxEntry&)>;
+    // Notified once an entry is applied or rejected (replay thread)
+    using Done = std::function<void(const OutboxOutcome&)>;
+
+    // Opens or creates the file and resumes replaying what it holds
+    Outbox(const std::string& path, Apply apply);
+    ~Outbox();   // stops replay; unsent entries stay on disk
+
+    Outbox(const Outbox&) = delete;
+    Outbox& operator=(const Outbox&) = delete;
+
+    // Durable when it returns.  Returns the entry's seq; if an entry with
+    // the same idempotency key is still in the file, that entry's seq
+    // (and `done` is dropped).
+    long long enqueue(OutboxEntry entry, Done done = nullptr);
+
+    // Real id of a provisional order once replayed, 0 before; other ids unchanged
+    long long resolve(long long orderId) const;
+
+    size_t depth() const;
+    bool waitDrained(std::chrono::milliseconds timeout);
+
+private:
+    void load();
+    void runReplay();
+    bool resolveRefs(OutboxEntry& entry, std::string& error) const;   // mutex_ held
+    void finish(const OutboxEntry& entry, const OutboxOutcome& outcome);
+    void exec(const char* sql);
+
+    sqlite3* db_ = nullptr;            // guarded by dbMutex_
+    std::mutex dbMutex_;
+    Apply apply_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable drained_;
+    std::deque<OutboxEntry> pending_;
+    std::unordered_map<long long, Done> done_;            // by seq
+    std::unordered_map<long long, long long> realIds_;    // provisional → real
+    std::unordered_set<long long> rejectedOrders_;        // provisional ids
+    bool stop_ = false;
+    std::thread replay_;
+
+    MetricGauge* depthGauge_;
+    MetricCounter* enqueued_;
+    MetricCounter* replayed_;
+    MetricCounter* rejected_;
+    MetricCounter* retries_;
+    LatencyHistogram* enqueueLatency_;
+    LatencyHistogram* replayLag_;
+};
@@ -0,0 +1,217 @@
+#include "Resilience.h"
+#include "Metrics.h"
+
+#include <algorithm>
+#include <iostream>
+
+// ─── CircuitBreaker ──────────────────────────────────────────────────────────
+
+CircuitBreaker::CircuitBreaker(const std::string& name, Options options)
+    : options_(options)
+{
+    auto& r = MetricsRegistry::instance();
+    std::string label = "breaker=\"" + name + "\"";
+    const char* transitions = "pos_circuit_transitions_total";
+    const char* transitionsHelp = "Circuit breaker state changes";
+    stateGauge_ = &r.gauge("pos_circuit_state",
+                           "Circuit breaker state (0 closed, 1 open, 2 half-open)", label);
+    toClosed_   = &r.counter(transitions, transitionsHelp, label + ",to=\"closed\"");
+    toOpen_     = &r.counter(transitions, transitionsHelp, label + ",to=\"open\"");
+    toHalfOpen_ = &r.counter(transitions, transitionsHelp, label + ",to=\"half_open\"");
+    rejected_   = &r.counter("pos_circuit_rejected_total",
+                             "Calls failed fast by an open circuit", label);
+    stateGauge_->set((int64_t)State::Closed);
+}
+
+bool CircuitBreaker::allow() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ == State::Open &&
+        std::chrono::steady_clock::now() - openedAt_ >= options_.openFor) {
+        transition(State::HalfOpen);
+    }
+
+    if (state_ == State::Closed) return true;
+    if (state_ == State::HalfOpen && !probeInFlight_) {
+        probeInFlight_ = true;
+        return true;
+    }
+    rejected_->inc();
+    return false;
+}
+
+void CircuitBreaker::onSuccess() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    consecutiveFailures_ = 0;
+    if (state_ != State::Closed) transition(State::Closed);
+}
+
+void CircuitBreaker::onFailure() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    consecutiveFailures_++;
+    if (state_ == State::HalfOpen ||
+        (state_ == State::Closed && consecutiveFailures_ >= options_.failureThreshold)) {
+        transition(State::Open);
+    }
+}
+
+void CircuitBreaker::release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ == State::HalfOpen) probeInFlight_ = false;
+}
+
+CircuitBreaker::State CircuitBreaker::state() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+void CircuitBreaker::transition(State to) {
+    state_ = to;
+    probeInFlight_ = false;
+    stateGauge_->set((int64_t)to);
+    switch (to) {
+        case State::Closed:
+            toClosed_->inc();
+            std::cout << "[CircuitBreaker] Closed" << std::endl;
+            break;
+        case State::Open:
+            openedAt_ = std::chrono::steady_clock::now();
+            toOpen_->inc();
+            std::cerr << "[CircuitBreaker] Open after " << consecutiveFailures_
+                      << " consecutive failures" << std::endl;
+            break;
+        case State::HalfOpen:
+            toHalfOpen_->inc();
+            break;
+    }
+}
+
+// ─── RetryBudget ─────────────────────────────────────────────────────────────
+
+RetryBudget::RetryBudget(Options options)
+    : options_(options), tokens_(options.maxTokens),
+      lastRefill_(std::chrono::steady_clock::now())
+{
+}
+
+void RetryBudget::deposit() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tokens_ = std::min(options_.maxTokens, tokens_ + options_.ratio);
+}
+
+bool RetryBudget::tryWithdraw() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refill();
+    if (tokens_ < 1.0) return false;
+    tokens_ -= 1.0;
+    return true;
+}
+
+void RetryBudget::refill() {
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - lastRefill_).count();
+    lastRefill_ = now;
+    tokens_ = std::min(options_.maxTokens, tokens_ + seconds * options_.minPerSecond);
+}
+
+// ─── LastKnownGood ───────────────────────────────────────────────────────────
+
+LastKnownGood::LastKnownGood(size_t capacity)
+    : entries_(capacity)
+{
+}
+
+void LastKnownGood::put(const std::string& key, const std::string& body) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.put(key, body);
+}
+
+bool LastKnownGood::get(const std::string& key, std::string& body) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.get(key, body);
+}
+
+// ─── Hedger ──────────────────────────────────────────────────────────────────
+
+struct Hedger::Endpoint {
+    std::mutex mutex;
+    std::unique_ptr<LatencyHistogram> current = std::make_unique<LatencyHistogram>();
+    std::unique_ptr<LatencyHistogram> previous = std::make_unique<LatencyHistogram>();
+    std::chrono::steady_clock::time_point rotatedAt = std::chrono::steady_clock::now();
+
+    MetricCounter* hedges;
+    MetricCounter* wins;
+    MetricGauge* delay;
+
+    // mutex held
+    void rotate(std::chrono::seconds window) {
+        auto now = std::chrono::steady_clock::now();
+        if (now - rotatedAt < window) return;
+        previous = std::move(current);
+        current = std::make_unique<LatencyHistogram>();
+        rotatedAt = now;
+    }
+};
+
+Hedger::Hedger(Options options)
+    : options_(options),
+      budget_(RetryBudget::Options{options.maxRatio, 0.0, 10.0})
+{
+    budgetExhausted_ = &MetricsRegistry::instance().counter(
+        "pos_als_hedge_budget_exhausted_total",
+        "Hedges skipped because the hedge budget was empty", "");
+}
+
+Hedger::~Hedger() = default;
+
+Hedger::Endpoint& Hedger::endpoint(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = endpoints_[name];
+    if (!slot) {
+        auto& r = MetricsRegistry::instance();
+        std::string label = "endpoint=\"" + name + "\"";
+        slot = std::make_unique<Endpoint>();
+        slot->hedges = &r.counter("pos_als_hedges_total", "Duplicate GETs sent", label);
+        slot->wins = &r.counter("pos_als_hedge_wins_total",
+                                "Hedged GETs answered first by the duplicate", label);
+        slot->delay = &r.gauge("pos_als_hedge_delay_ms", "Current hedge delay", label);
+    }
+    return *slot;
+}
+
+long Hedger::delayMs(const std::string& name, double quantile, long fixedMs) {
+    budget_.deposit();
+    Endpoint& ep = endpoint(name);
+
+    long delay = fixedMs;
+    if (quantile > 0) {
+        std::lock_guard<std::mutex> lock(ep.mutex);
+        ep.rotate(options_.window);
+        const LatencyHistogram* h =
+            ep.previous->count() >= (uint64_t)options_.minSamples ? ep.previous.get() :
+            ep.current->count() >= (uint64_t)options_.minSamples ? ep.current.get() : nullptr;
+        delay = h ? (long)((h->quantileMicros(quantile) + 999) / 1000) : 0;
+    }
+    ep.delay->set(delay);
+    return delay;
+}
+
+std::function<bool()> Hedger::admission(const std::string& name) {
+    Endpoint* ep = &endpoint(name);
+    return [this, ep] {
+        if (!budget_.tryWithdraw()) {
+            budgetExhausted_->inc();
+            return false;
+        }
+        ep->hedges->inc();
+        return true;
+    };
+}
+
+void Hedger::record(const std::string& name, std::chrono::steady_clock::duration elapsed,
+                    bool hedgeWon) {
+    Endpoint& ep = endpoint(name);
+    if (hedgeWon) ep.wins->inc();
+    std::lock_guard<std::mutex> lock(ep.mutex);
+    ep.rotate(options_.window);
+    ep.current->record(elapsed);
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "LruCache.h"
+
+class LatencyHistogram;
+class MetricCounter;
+class MetricGauge;
+
+// ─── Failure handling for calls to a remote backend ─────────────────────────
+// Used by RestApiService so a slow or failing ApiLogicServer costs callers a
+// bounded amount of time instead of a full transport timeout per request.
+// All classes here are thread-safe.
+
+// Closed → (N consecutive failures) → Open → (cool-down) → HalfOpen.
+// HalfOpen admits a single probe: success closes the circuit, failure
+// re-opens it.  While open, allow() fails fast without touching the network.
+//
+// Exported as pos_circuit_state{breaker} (0 closed, 1 open, 2 half-open),
+// pos_circuit_transitions_total{breaker,to} and pos_circuit_rejected_total.
+class CircuitBreaker {
+public:
+    enum class State { Closed = 0, Open = 1, HalfOpen = 2 };
+
+    struct Options {
+        int failureThreshold = 5;
+        std::chrono::milliseconds openFor{5000};
+    };
+
+    CircuitBreaker(const std::string& name, Options options);
+
+    // False while open (or while a half-open probe is already in flight).
+    // Every call allowed must end in onSuccess(), onFailure() or release().
+    bool allow();
+    void onSuccess();
+    void onFailure();
+    // The allowed call was never sent: frees the half-open probe, no verdict
+    void release();
+
+    State state() const;
+
+private:
+    void transition(State to);   // mutex_ held
+
+    Options options_;
+    State state_ = State::Closed;
+    int consecutiveFailures_ = 0;
+    bool probeInFlight_ = false;
+    std::chrono::steady_clock::time_point openedAt_;
+    mutable std::mutex mutex_;
+
+    MetricGauge* stateGauge_;
+    MetricCounter* toClosed_;
+    MetricCounter* toOpen_;
+    MetricCounter* toHalfOpen_;
+    MetricCounter* rejected_;
+};
+
+// Caps retries to a fraction of live traffic so retries cannot multiply
+// load on a backend that is already struggling.  Every first attempt
+// deposits `ratio` tokens, a retry spends one, and `minPerSecond` tokens
+// trickle in regardless so low-traffic periods can still retry.
+class RetryBudget {
+public:
+    struct Options {
+        double ratio = 0.2;
+        double minPerSecond = 2.0;
+        double maxTokens = 20.0;
+    };
+
+    explicit RetryBudget(Options options);
+
+    void deposit();
+    bool tryWithdraw();
+
+private:
+    void refill();   // mutex_ held
+
+    Options options_;
+    double tokens_;
+    std::chrono::steady_clock::time_point lastRefill_;
+    std::mutex mutex_;
+};
+
+// Last successful response body per key (URL), bounded LRU.  Read paths
+// fall back to it when the backend is unavailable.
+class LastKnownGood {
+public:
+    explicit LastKnownGood(size_t capacity);
+
+    void put(const std::string& key, const std::string& body);
+    bool get(const std::string& key, std::string& body);
+
+private:
+    LruCache<std::string, std::string> entries_;
+    std::mutex mutex_;
+};
+
+// Picks the hedge delay for idempotent GETs: the configured latency quantile
+// of the endpoint's recent answers (two rotating windows, so it follows
+// the server as it speeds up or slows down), or a fixed delay.  Extra load is
+// capped by a budget of `maxRatio` duplicates per request.
+//
+// Exported as pos_als_hedges_total{endpoint}, pos_als_hedge_wins_total
+// (duplicate answered first), pos_als_hedge_budget_exhausted_total and
+// pos_als_hedge_delay_ms{endpoint}.
+class Hedger {
+public:
+    struct Options {
+        double maxRatio = 0.1;
+        int minSamples = 20;                 // adaptive delay needs this many answers
+        std::chrono::seconds window{60};
+    };
+
+    explicit Hedger(Options options);
+    ~Hedger();
+
+    // Delay (ms) after which to hedge, 0 for no hedge.  quantile > 0 selects
+    // the adaptive delay, otherwise fixedMs is used.  Counts the request
+    // towards the budget.
+    long delayMs(const std::string& endpoint, double quantile, long fixedMs);
+
+    // HttpRequest::hedgeAllowed for this endpoint: spends budget
+    std::function<bool()> admission(const std::string& endpoint);
+
+    // Feed an answered request back (elapsed from first send)
+    void record(const std::string& endpoint, std::chrono::steady_clock::duration elapsed,
+                bool hedgeWon);
+
+private:
+    struct Endpoint;
+    Endpoint& endpoint(const std::string& name);
+
+    Options options_;
+    RetryBudget budget_;
+    MetricCounter* budgetExhausted_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Endpoint>> endpoints_;
+};
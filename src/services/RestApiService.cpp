@@ -1,35 +1,210 @@
 #include "RestApiService.h"
+#include "JsonApi.h"
+#include "Metrics.h"
 
-#include <Wt/Json/Parser.h>
 #include <Wt/Json/Object.h>
 #include <Wt/Json/Array.h>
 #include <Wt/Json/Value.h>
 
 #include <curl/curl.h>
 
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <mutex>
 #include <iostream>
-#include <sstream>
+#include <random>
+#include <thread>
 #include <stdexcept>
 #include <cmath>
-#include <iomanip>
 
-// ─── libcurl helpers ─────────────────────────────────────────────────────────
+using namespace JsonApi;
 
-static size_t writeCallback(char* ptr, size_t size, size_t nmemb, void* userdata) {
-    auto* buf = static_cast<std::string*>(userdata);
-    buf->append(ptr, size * nmemb);
-    return size * nmemb;
+// ─── Response shaping shared by the sync and async paths ────────────────────
+
+namespace {
+
+std::vector<OrderDto> parseOrders(const std::string& json) {
+    return parseList(json, &parseOrder);
+}
+
+// JSON:API doesn't have != filter natively; fetch all and client-filter
+std::vector<OrderDto> activeOnly(const std::vector<OrderDto>& all) {
+    std::vector<OrderDto> out;
+    for (auto& o : all) {
+        if (o.status != "Served" && o.status != "Cancelled") {
+            out.push_back(o);
+        }
+    }
+    // Sort by id ascending (ordersUrl sorts DESC)
+    std::sort(out.begin(), out.end(),
+              [](const OrderDto& a, const OrderDto& b) { return a.id < b.id; });
+    return out;
+}
+
+double servedRevenue(const std::vector<OrderDto>& all) {
+    double total = 0.0;
+    for (auto& o : all) {
+        if (o.status == "Served") total += o.total;
+    }
+    return total;
+}
+
+int countOrders(const std::string& json) {
+    return (int)parseOrders(json).size();
+}
+
+// getOrderChangesSince cursor: "t:" + the newest updated_at seen ("" before
+// the restaurant has any order)
+const char kChangeCursorTag[] = "t:";
+
+std::string newestUpdate(const std::vector<OrderDto>& orders, std::string newest) {
+    for (auto& o : orders) {
+        if (o.updated_at > newest) newest = o.updated_at;
+    }
+    return newest;
+}
+
+// First poll: the active orders are read one status at a time (no != or
+// "in" filter to ask for them at once), and the cursor comes from a probe
+// for the newest updated_at, so neither grows with the order history.
+// The probe goes first: a change made while the statuses are read is at or
+// after the cursor, and the next poll reads it again.
+const char* const kActiveStatuses[] = {"Pending", "In Progress", "Ready"};
+
+std::string parseNewestUpdate(const std::string& json) {
+    return newestUpdate(parseOrders(json), "");
+}
+
+OrderChangesDto orderSnapshot(std::vector<OrderDto> active, const std::string& newest) {
+    std::sort(active.begin(), active.end(),
+              [](const OrderDto& a, const OrderDto& b) { return a.id < b.id; });
+    OrderChangesDto out;
+    out.cursor = kChangeCursorTag + newest;
+    out.orders = std::move(active);
+    out.reset = true;
+    return out;
+}
+
+OrderChangesDto orderDelta(std::vector<OrderDto> changed, const std::string& since) {
+    OrderChangesDto out;
+    out.cursor = kChangeCursorTag + newestUpdate(changed, since);
+    out.orders = std::move(changed);
+    return out;
+}
+
+bool isChangeCursor(const std::string& cursor) {
+    return cursor.compare(0, 2, kChangeCursorTag) == 0;
+}
+
+// ─── Sparse fieldsets ────────────────────────────────────────────────────────
+// JSON:API fields[type] for call sites that use only some attributes.  Each
+// keeps at least one attribute: the parsers expect an attributes object.
+
+const char* const kOrderStatusOnly = "fields%5Borders%5D=status";          // counts
+const char* const kOrderRevenue    = "fields%5Borders%5D=status,total";    // getRevenue
+const char* const kMenuItemName    = "fields%5Bmenu_item%5D=name";         // included names
+const char* const kMenuItemPrice   = "fields%5Bmenu_item%5D=price";        // addOrderItem
+
+std::string withFields(std::string url, const char* fields) {
+    if (!fields) return url;
+    url += url.find('?') == std::string::npos ? '?' : '&';
+    return url + fields;
+}
+
+// ─── Resilience policy ───────────────────────────────────────────────────────
+
+constexpr int kMaxAttempts = 3;
+
+// Less than this left before the deadline is not worth another attempt
+constexpr std::chrono::milliseconds kMinAttempt{10};
+
+struct ResilienceMetrics {
+    MetricCounter* retries;
+    MetricCounter* budgetExhausted;
+    MetricCounter* deadlineExceeded;
+    MetricCounter* staleReads;
+};
+
+ResilienceMetrics& resilienceMetrics() {
+    static ResilienceMetrics m = [] {
+        auto& r = MetricsRegistry::instance();
+        ResilienceMetrics t;
+        t.retries = &r.counter("pos_als_retries_total",
+                               "ApiLogicServer requests retried", "");
+        t.budgetExhausted = &r.counter("pos_als_retry_budget_exhausted_total",
+                                       "Retries skipped because the retry budget was empty", "");
+        t.deadlineExceeded = &r.counter("pos_als_deadline_exceeded_total",
+                                        "Calls abandoned at their endpoint deadline", "");
+        t.staleReads = &r.counter("pos_als_stale_reads_total",
+                                  "Reads answered from last known good data", "");
+        return t;
+    }();
+    return m;
+}
+
+// Transport errors (including our own timeouts), 5xx and 429 count against
+// the server; other 4xx are the request's fault and leave the breaker alone.
+bool isBackendFailure(const HttpResponse& res) {
+    return !res.error.empty() || res.status >= 500 || res.status == 429;
+}
+
+HttpResponse failed(const std::string& error) {
+    HttpResponse res;
+    res.error = error;
+    return res;
+}
+
+std::string describe(const HttpResponse& res) {
+    return res.error.empty() ? "HTTP " + std::to_string(res.status) : res.error;
+}
+
+// Outbox replay: backend failures are worth repeating, other errors never succeed
+OutboxOutcome deliveryOutcome(const HttpResponse& res) {
+    OutboxOutcome out;
+    if (isBackendFailure(res)) {
+        out.kind = OutboxOutcome::Kind::Retry;
+        out.error = describe(res);
+    } else if (res.status >= 400) {
+        out.kind = OutboxOutcome::Kind::Rejected;
+        out.error = describe(res) + ": " + res.body;
+    }
+    return out;
 }
 
+// Full jitter: uniform in [0, min(1s, 50ms · 2^attempt))
+std::chrono::milliseconds jitteredBackoff(int attempt) {
+    thread_local std::mt19937 rng(std::random_device{}());
+    int cap = std::min(1000, 50 << std::min(attempt, 5));
+    return std::chrono::milliseconds(std::uniform_int_distribution<int>(0, cap - 1)(rng));
+}
+
+}  // namespace
+
 RestApiService::RestApiService(std::shared_ptr<SiteConfig> config)
-    : config_(std::move(config))
+    : RestApiService(std::move(config), Policy{})
+{}
+
+RestApiService::RestApiService(std::shared_ptr<SiteConfig> config, Policy policy)
+    : config_(std::move(config)),
+      breaker_("als", policy.breaker),
+      retryBudget_(policy.retries),
+      lastGood_(256),
+      hedger_(Hedger::Options{config_->apiHedgeMaxRatio()}),
+      recentOrders_(4096),
+      unsettledKeys_(4096)
 {
-    curl_global_init(CURL_GLOBAL_DEFAULT);
+    std::string outboxPath = config_->apiOutboxPath();
+    if (!outboxPath.empty()) {
+        outbox_ = std::make_unique<Outbox>(outboxPath,
+            [this](const OutboxEntry& entry) { return replay(entry); });
+        std::cout << "[RestApi] Queuing writes in " << outboxPath << std::endl;
+    }
 }
 
-RestApiService::~RestApiService() {
-    curl_global_cleanup();
-}
+RestApiService::~RestApiService() = default;
+
+// ─── HTTP helpers ────────────────────────────────────────────────────────────
 
 std::string RestApiService::baseUrl() const {
     std::string url = config_->apiBaseUrl();
@@ -48,300 +223,292 @@ std::string RestApiService::urlEncode(const std::string& value) const {
     return result;
 }
 
-std::string RestApiService::httpGet(const std::string& url) {
-    CURL* curl = curl_easy_init();
-    if (!curl) throw std::runtime_error("Failed to init curl");
-
-    std::string response;
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Accept: application/vnd.api+json");
-    headers = curl_slist_append(headers, "Content-Type: application/vnd.api+json");
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
-
-    CURLcode res = curl_easy_perform(curl);
-    long httpCode = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
+HttpRequest RestApiService::jsonApiRequest(const std::string& endpoint, const std::string& method,
+                                           const std::string& url,
+                                           const std::string& body) const {
+    HttpRequest req;
+    req.method = method;
+    req.url = url;
+    req.body = body;
+    req.headers = {"Accept: application/vnd.api+json",
+                   "Content-Type: application/vnd.api+json"};
+    req.timeoutMs = config_->apiDeadlineMs(endpoint, method != "GET");
+    req.compressed = config_->apiCompression();
+    return req;
+}
 
-    if (res != CURLE_OK) {
-        throw std::runtime_error(std::string("HTTP GET failed: ") + curl_easy_strerror(res));
+HttpResponse RestApiService::send(const std::string& endpoint, HttpRequest req) {
+    ResilienceMetrics& m = resilienceMetrics();
+    // PATCH bodies carry absolute values, so repeating one is harmless
+    bool retryable = req.method != "POST";
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(req.timeoutMs);
+
+    retryBudget_.deposit();
+    for (int attempt = 1;; attempt++) {
+        // Before allow(): a half-open probe taken here must be sent
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining < kMinAttempt.count()) {
+            m.deadlineExceeded->inc();
+            return failed("deadline exceeded");
+        }
+        if (!breaker_.allow()) return failed("circuit open");
+        req.timeoutMs = (long)remaining;
+        bool hedged = applyHedging(endpoint, req);
+
+        auto sent = std::chrono::steady_clock::now();
+        HttpResponse res = http_.perform(req);
+        if (!isBackendFailure(res)) {
+            breaker_.onSuccess();
+            if (hedged) hedger_.record(endpoint, std::chrono::steady_clock::now() - sent,
+                                       res.hedged);
+            return res;
+        }
+        breaker_.onFailure();
+
+        if (std::chrono::steady_clock::now() + kMinAttempt >= deadline) {
+            m.deadlineExceeded->inc();
+            return res;
+        }
+        if (!retryable || attempt >= kMaxAttempts ||
+            breaker_.state() == CircuitBreaker::State::Open) {
+            return res;
+        }
+        auto backoff = jitteredBackoff(attempt);
+        if (std::chrono::steady_clock::now() + backoff >= deadline) return res;
+        if (!retryBudget_.tryWithdraw()) {
+            m.budgetExhausted->inc();
+            return res;
+        }
+        m.retries->inc();
+        std::cerr << "[RestApi] " << req.method << " " << endpoint << " attempt " << attempt
+                  << " failed (" << (res.error.empty() ? std::to_string(res.status) : res.error)
+                  << "), retrying" << std::endl;
+        std::this_thread::sleep_for(backoff);
     }
-    if (httpCode >= 400) {
-        std::cerr << "[RestApi] GET " << url << " → " << httpCode << std::endl;
+}
+
+bool RestApiService::applyHedging(const std::string& endpoint, HttpRequest& req) {
+    double quantile = 0;
+    long fixedMs = 0;
+    if (req.method != "GET" || !config_->apiHedging(endpoint, quantile, fixedMs)) return false;
+
+    // No delay yet (too few samples), or one the deadline would cut off first
+    long delay = hedger_.delayMs(endpoint, quantile, fixedMs);
+    if (delay > 0 && delay < req.timeoutMs) {
+        req.hedgeAfterMs = delay;
+        req.hedgeAllowed = hedger_.admission(endpoint);
     }
-    return response;
+    return true;
 }
 
-std::string RestApiService::httpPost(const std::string& url, const std::string& jsonBody) {
-    CURL* curl = curl_easy_init();
-    if (!curl) throw std::runtime_error("Failed to init curl");
-
-    std::string response;
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Accept: application/vnd.api+json");
-    headers = curl_slist_append(headers, "Content-Type: application/vnd.api+json");
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, jsonBody.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
-
-    CURLcode res = curl_easy_perform(curl);
-    long httpCode = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
+std::string RestApiService::httpGet(const std::string& endpoint, const std::string& url) {
+    HttpResponse res = send(endpoint, jsonApiRequest(endpoint, "GET", url));
+    if (res.ok()) {
+        lastGood_.put(url, res.body);
+        return res.body;
+    }
 
-    if (res != CURLE_OK) {
-        throw std::runtime_error(std::string("HTTP POST failed: ") + curl_easy_strerror(res));
+    std::string stale;
+    if (isBackendFailure(res) && lastGood_.get(url, stale)) {
+        resilienceMetrics().staleReads->inc();
+        std::cerr << "[RestApi] GET " << url << " unavailable ("
+                  << (res.error.empty() ? std::to_string(res.status) : res.error)
+                  << "), serving last known good" << std::endl;
+        return stale;
     }
-    if (httpCode >= 400) {
-        std::cerr << "[RestApi] POST " << url << " → " << httpCode << "\n" << response << std::endl;
+    if (!res.error.empty()) {
+        throw std::runtime_error("HTTP GET failed: " + res.error);
     }
-    return response;
+    std::cerr << "[RestApi] GET " << url << " → " << res.status << std::endl;
+    return res.body;
 }
 
-std::string RestApiService::httpPatch(const std::string& url, const std::string& jsonBody) {
-    CURL* curl = curl_easy_init();
-    if (!curl) throw std::runtime_error("Failed to init curl");
-
-    std::string response;
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Accept: application/vnd.api+json");
-    headers = curl_slist_append(headers, "Content-Type: application/vnd.api+json");
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PATCH");
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, jsonBody.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
-
-    CURLcode res = curl_easy_perform(curl);
-    long httpCode = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
+std::string RestApiService::httpGetFresh(const std::string& endpoint, const std::string& url) {
+    HttpResponse res = send(endpoint, jsonApiRequest(endpoint, "GET", url));
+    if (!res.ok()) throw std::runtime_error("HTTP GET " + url + " failed: " + describe(res));
+    return res.body;
+}
 
-    if (res != CURLE_OK) {
-        throw std::runtime_error(std::string("HTTP PATCH failed: ") + curl_easy_strerror(res));
+std::string RestApiService::httpPost(const std::string& endpoint, const std::string& url,
+                                     const std::string& jsonBody,
+                                     const std::string& idempotencyKey) {
+    HttpRequest req = jsonApiRequest(endpoint, "POST", url, jsonBody);
+    if (!idempotencyKey.empty()) req.headers.push_back("Idempotency-Key: " + idempotencyKey);
+    HttpResponse res = send(endpoint, std::move(req));
+    if (!res.error.empty()) {
+        throw std::runtime_error("HTTP POST failed: " + res.error);
     }
-    if (httpCode >= 400) {
-        std::cerr << "[RestApi] PATCH " << url << " → " << httpCode << "\n" << response << std::endl;
+    if (res.status >= 400) {
+        std::cerr << "[RestApi] POST " << url << " → " << res.status << "\n" << res.body << std::endl;
     }
-    return response;
+    return res.body;
 }
 
-// ─── JSON:API response parsing helpers ───────────────────────────────────────
-// ApiLogicServer returns JSON:API format:
-//   { "data": [ { "type": "...", "id": "...", "attributes": { ... } }, ... ] }
-// or for single resources:
-//   { "data": { "type": "...", "id": "...", "attributes": { ... } } }
+std::string RestApiService::httpPatch(const std::string& endpoint, const std::string& url,
+                                      const std::string& jsonBody) {
+    HttpResponse res = send(endpoint, jsonApiRequest(endpoint, "PATCH", url, jsonBody));
+    if (!res.error.empty()) {
+        throw std::runtime_error("HTTP PATCH failed: " + res.error);
+    }
+    if (res.status >= 400) {
+        std::cerr << "[RestApi] PATCH " << url << " → " << res.status << "\n" << res.body << std::endl;
+    }
+    return res.body;
+}
 
-static long long jsonId(const Wt::Json::Object& resource) {
-    // JSON:API id is a string
-    if (resource.contains("id")) {
-        auto& val = resource.get("id");
-        if (val.type() == Wt::Json::Type::String) {
-            return std::stoll(static_cast<const Wt::WString&>(val).toUTF8());
+template <typename T>
+void RestApiService::getAsync(const std::string& endpoint, const std::string& url,
+                              ApiCallback<T> cb, std::function<T(const std::string&)> parse,
+                              bool lastGood) {
+    // Shared by the fail-fast path and the completion handler
+    auto complete = [this, url, cb, parse, lastGood](HttpResponse res) {
+        ApiResult<T> result;
+        std::string body;
+        if (res.ok()) {
+            if (lastGood) lastGood_.put(url, res.body);
+            body = std::move(res.body);
+        } else if (lastGood && isBackendFailure(res) && lastGood_.get(url, body)) {
+            resilienceMetrics().staleReads->inc();
+        } else if (!res.error.empty()) {
+            result.error = "HTTP GET failed: " + res.error;
+        } else {
+            std::cerr << "[RestApi] GET " << url << " → " << res.status << std::endl;
+            result.error = "HTTP " + std::to_string(res.status);
         }
-        if (val.type() == Wt::Json::Type::Number) {
-            return static_cast<long long>(static_cast<double>(val));
+        if (result.error.empty()) {
+            try {
+                result.value = parse(body);
+            } catch (std::exception& e) {
+                result.error = e.what();
+            }
         }
+        cb(std::move(result));
+    };
+
+    HttpRequest req = jsonApiRequest(endpoint, "GET", url);
+    // Breaker first, as in send(): a refused call spends no hedge allowance
+    if (!breaker_.allow()) {
+        complete(failed("circuit open"));
+        return;
+    }
+    bool hedged = applyHedging(endpoint, req);
+    auto sent = std::chrono::steady_clock::now();
+    try {
+        http_.performAsync(std::move(req),
+            [this, complete, endpoint, hedged, sent](HttpResponse res) {
+                if (isBackendFailure(res)) {
+                    breaker_.onFailure();
+                } else {
+                    breaker_.onSuccess();
+                    if (hedged) hedger_.record(endpoint, std::chrono::steady_clock::now() - sent,
+                                               res.hedged);
+                }
+                complete(std::move(res));
+            });
+    } catch (std::exception& e) {
+        breaker_.release();
+        complete(failed(e.what()));
     }
-    return 0;
 }
-
-static std::string jsonStr(const Wt::Json::Object& obj, const std::string& key) {
-    if (!obj.contains(key)) return "";
-    auto& val = obj.get(key);
-    if (val.type() == Wt::Json::Type::String)
-        return static_cast<const Wt::WString&>(val).toUTF8();
-    if (val.isNull()) return "";
-    return "";
+
+// ─── URL builders ────────────────────────────────────────────────────────────
+
+std::string RestApiService::categoriesUrl(long long restaurantId) const {
+    return baseUrl() + "/category/?filter%5Brestaurant_id%5D=" +
+           std::to_string(restaurantId) + "&sort=sort_order";
 }
 
-static double jsonNum(const Wt::Json::Object& obj, const std::string& key) {
-    if (!obj.contains(key)) return 0.0;
-    auto& val = obj.get(key);
-    if (val.type() == Wt::Json::Type::Number) return static_cast<double>(val);
-    if (val.type() == Wt::Json::Type::String) {
-        try { return std::stod(static_cast<const Wt::WString&>(val).toUTF8()); }
-        catch (...) { return 0.0; }
-    }
-    return 0.0;
+std::string RestApiService::menuItemsByCategoryUrl(long long categoryId) const {
+    return baseUrl() + "/menu_item/?filter%5Bcategory_id%5D=" + std::to_string(categoryId);
 }
 
-static int jsonInt(const Wt::Json::Object& obj, const std::string& key) {
-    return static_cast<int>(std::round(jsonNum(obj, key)));
+std::string RestApiService::ordersUrl(long long restaurantId, const char* fields) const {
+    return withFields(baseUrl() + "/orders/?filter%5Brestaurant_id%5D=" +
+                      std::to_string(restaurantId) + "&sort=-id", fields);
 }
-
-static bool jsonBool(const Wt::Json::Object& obj, const std::string& key) {
-    if (!obj.contains(key)) return false;
-    auto& val = obj.get(key);
-    if (val.type() == Wt::Json::Type::Bool) return static_cast<bool>(val);
-    return false;
-}
-
-static long long jsonFk(const Wt::Json::Object& attrs, const std::string& key) {
-    return static_cast<long long>(std::round(jsonNum(attrs, key)));
-}
-
-// Parse a JSON:API resource object into DTOs
-
-static RestaurantDto parseRestaurant(const Wt::Json::Object& res) {
-    RestaurantDto d;
-    d.id = jsonId(res);
-    const Wt::Json::Object& a = res.get("attributes");
-    d.name         = jsonStr(a, "name");
-    d.cuisine_type = jsonStr(a, "cuisine_type");
-    d.description  = jsonStr(a, "description");
-    return d;
-}
-
-static CategoryDto parseCategory(const Wt::Json::Object& res) {
-    CategoryDto d;
-    d.id = jsonId(res);
-    const Wt::Json::Object& a = res.get("attributes");
-    d.name          = jsonStr(a, "name");
-    d.sort_order    = jsonInt(a, "sort_order");
-    d.restaurant_id = jsonFk(a, "restaurant_id");
-    return d;
-}
-
-static MenuItemDto parseMenuItem(const Wt::Json::Object& res) {
-    MenuItemDto d;
-    d.id = jsonId(res);
-    const Wt::Json::Object& a = res.get("attributes");
-    d.name        = jsonStr(a, "name");
-    d.description = jsonStr(a, "description");
-    d.price       = jsonNum(a, "price");
-    d.available   = jsonBool(a, "available");
-    d.category_id = jsonFk(a, "category_id");
-    return d;
-}
-
-static OrderDto parseOrder(const Wt::Json::Object& res) {
-    OrderDto d;
-    d.id = jsonId(res);
-    const Wt::Json::Object& a = res.get("attributes");
-    d.table_number  = jsonInt(a, "table_number");
-    d.status        = jsonStr(a, "status");
-    d.customer_name = jsonStr(a, "customer_name");
-    d.notes         = jsonStr(a, "notes");
-    d.total         = jsonNum(a, "total");
-    d.restaurant_id = jsonFk(a, "restaurant_id");
-    d.created_at    = jsonStr(a, "created_at");
-    return d;
-}
-
-static OrderItemDto parseOrderItem(const Wt::Json::Object& res) {
-    OrderItemDto d;
-    d.id = jsonId(res);
-    const Wt::Json::Object& a = res.get("attributes");
-    d.quantity             = jsonInt(a, "quantity");
-    d.unit_price           = jsonNum(a, "unit_price");
-    d.special_instructions = jsonStr(a, "special_instructions");
-    d.order_id             = jsonFk(a, "order_id");
-    d.menu_item_id         = jsonFk(a, "menu_item_id");
-    // menu_item_name may come from include; caller resolves it
-    return d;
-}
-
-// Parse a JSON:API collection response → vector of Json::Object resources
-static Wt::Json::Array parseDataArray(const std::string& json) {
-    Wt::Json::Object root;
-    Wt::Json::parse(json, root);
-    if (root.contains("data")) {
-        auto& data = root.get("data");
-        if (data.type() == Wt::Json::Type::Array)
-            return static_cast<const Wt::Json::Array&>(data);
-    }
-    return Wt::Json::Array();
-}
-
-// Parse a single JSON:API resource → Json::Object
-static Wt::Json::Object parseDataObject(const std::string& json) {
-    Wt::Json::Object root;
-    Wt::Json::parse(json, root);
-    if (root.contains("data")) {
-        auto& data = root.get("data");
-        if (data.type() == Wt::Json::Type::Object)
-            return static_cast<const Wt::Json::Object&>(data);
-    }
-    return Wt::Json::Object();
-}
-
-// Build an "included" lookup: type+id → Object
-static std::map<std::string, Wt::Json::Object>
-buildIncludedMap(const std::string& json) {
-    std::map<std::string, Wt::Json::Object> m;
-    Wt::Json::Object root;
-    Wt::Json::parse(json, root);
-    if (root.contains("included")) {
-        auto& inc = root.get("included");
-        if (inc.type() == Wt::Json::Type::Array) {
-            const Wt::Json::Array& arr = inc;
-            for (int i = 0; i < (int)arr.size(); i++) {
-                const Wt::Json::Object& obj = arr[i];
-                std::string key = jsonStr(obj, "type") + ":" +
-                    std::to_string(jsonId(obj));
-                m[key] = obj;
-            }
-        }
+
+std::string RestApiService::ordersByStatusUrl(long long restaurantId,
+                                              const std::string& status,
+                                              const char* fields) const {
+    return withFields(baseUrl() + "/orders/?filter%5Brestaurant_id%5D=" +
+                      std::to_string(restaurantId) +
+                      "&filter%5Bstatus%5D=" + urlEncode(status) +
+                      "&sort=id", fields);
+}
+
+std::string RestApiService::orderChangesUrl(long long restaurantId,
+                                            const std::string& since) const {
+    // >= rather than >, as in pullOrdersUpdatedSince
+    std::string url = baseUrl() + "/orders/?filter%5Brestaurant_id%5D=" +
+                      std::to_string(restaurantId) + "&sort=updated_at,id";
+    if (!since.empty()) url += "&filter%5Bupdated_at%5D%5Bge%5D=" + urlEncode(since);
+    return url;
+}
+
+std::string RestApiService::orderByKeyUrl(const std::string& idempotencyKey) const {
+    return baseUrl() + "/orders/?filter%5Bidempotency_key%5D=" + urlEncode(idempotencyKey) +
+           "&page%5Blimit%5D=1";
+}
+
+std::string RestApiService::orderLineUrl(long long orderId, const std::string& lineKey) const {
+    return baseUrl() + "/order_item/?filter%5Border_id%5D=" + std::to_string(orderId) +
+           "&filter%5Bline_key%5D=" + urlEncode(lineKey) + "&page%5Blimit%5D=1";
+}
+
+std::string RestApiService::newestOrderUpdateUrl(long long restaurantId) const {
+    return baseUrl() + "/orders/?filter%5Brestaurant_id%5D=" + std::to_string(restaurantId) +
+           "&sort=-updated_at&page%5Blimit%5D=1&fields%5Borders%5D=updated_at";
+}
+
+std::string RestApiService::ordersPageUrl(long long restaurantId,
+                                          const OrderPageQuery& query) const {
+    if (!OrderPageQuery::sortable(query.sortBy)) {
+        throw std::runtime_error("Orders cannot be sorted by " + query.sortBy);
     }
-    return m;
+    std::string dir = query.descending ? "-" : "";
+    std::string url = baseUrl() + "/orders/?filter%5Brestaurant_id%5D=" +
+                      std::to_string(restaurantId);
+    if (!query.status.empty()) url += "&filter%5Bstatus%5D=" + urlEncode(query.status);
+    url += "&sort=" + dir + query.sortBy;
+    if (query.sortBy != "id") url += "," + dir + "id";
+    return url + "&page%5Boffset%5D=" + std::to_string(query.offset) +
+           "&page%5Blimit%5D=" + std::to_string(query.limit);
+}
+
+std::string RestApiService::orderUrl(long long orderId) const {
+    return baseUrl() + "/orders/" + std::to_string(orderId) + "/";
+}
+
+std::string RestApiService::orderItemsUrl(long long orderId) const {
+    // Use include to get menu_item names in one request; only names are read
+    return withFields(baseUrl() + "/order_item/?filter%5Border_id%5D=" +
+                      std::to_string(orderId) + "&include=menu_item", kMenuItemName);
+}
+
+std::string RestApiService::menuItemUrl(long long menuItemId, const char* fields) const {
+    return withFields(baseUrl() + "/menu_item/" + std::to_string(menuItemId) + "/", fields);
 }
 
 // ─── IApiService implementation ──────────────────────────────────────────────
 
 std::vector<RestaurantDto> RestApiService::getRestaurants() {
-    auto json = httpGet(baseUrl() + "/restaurant/");
-    auto arr = parseDataArray(json);
-    std::vector<RestaurantDto> out;
-    for (int i = 0; i < (int)arr.size(); i++) {
-        const Wt::Json::Object& obj = arr[i];
-        out.push_back(parseRestaurant(obj));
-    }
-    return out;
+    return parseList(httpGet("getRestaurants", baseUrl() + "/restaurant/"), &parseRestaurant);
 }
 
 RestaurantDto RestApiService::getRestaurant(long long id) {
-    auto json = httpGet(baseUrl() + "/restaurant/" + std::to_string(id) + "/");
+    auto json = httpGet("getRestaurant", baseUrl() + "/restaurant/" + std::to_string(id) + "/");
     return parseRestaurant(parseDataObject(json));
 }
 
 std::vector<CategoryDto> RestApiService::getCategories(long long restaurantId) {
-    auto json = httpGet(baseUrl() + "/category/?filter%5Brestaurant_id%5D=" +
-                        std::to_string(restaurantId) + "&sort=sort_order");
-    auto arr = parseDataArray(json);
-    std::vector<CategoryDto> out;
-    for (int i = 0; i < (int)arr.size(); i++) {
-        const Wt::Json::Object& obj = arr[i];
-        out.push_back(parseCategory(obj));
-    }
-    return out;
+    return parseList(httpGet("getCategories", categoriesUrl(restaurantId)), &parseCategory);
 }
 
 std::vector<MenuItemDto> RestApiService::getMenuItemsByCategory(long long categoryId) {
-    auto json = httpGet(baseUrl() + "/menu_item/?filter%5Bcategory_id%5D=" +
-                        std::to_string(categoryId));
-    auto arr = parseDataArray(json);
-    std::vector<MenuItemDto> out;
-    for (int i = 0; i < (int)arr.size(); i++) {
-        const Wt::Json::Object& obj = arr[i];
-        out.push_back(parseMenuItem(obj));
-    }
-    return out;
+    return parseList(httpGet("getMenuItemsByCategory", menuItemsByCategoryUrl(categoryId)),
+                     &parseMenuItem);
 }
 
 std::vector<MenuItemDto> RestApiService::getMenuItemsByRestaurant(long long restaurantId) {
@@ -357,113 +524,220 @@ std::vector<MenuItemDto> RestApiService::getMenuItemsByRestaurant(long long rest
 }
 
 MenuItemDto RestApiService::getMenuItem(long long id) {
-    auto json = httpGet(baseUrl() + "/menu_item/" + std::to_string(id) + "/");
+    auto json = httpGet("getMenuItem", menuItemUrl(id));
     return parseMenuItem(parseDataObject(json));
 }
 
 void RestApiService::updateMenuItemAvailability(long long id, bool available) {
-    std::string body = "{\"data\":{\"type\":\"menu_item\",\"id\":\"" +
-        std::to_string(id) + "\",\"attributes\":{\"available\":" +
-        (available ? "true" : "false") + "}}}";
-    httpPatch(baseUrl() + "/menu_item/" + std::to_string(id) + "/", body);
+    if (outbox_) {
+        OutboxEntry e;
+        e.op = OutboxEntry::Op::UpdateMenuItemAvailability;
+        e.targetId = id;
+        e.available = available;
+        outbox_->enqueue(std::move(e));
+        return;
+    }
+    httpPatch("updateMenuItemAvailability", menuItemUrl(id), availabilityBody(id, available));
 }
 
 std::vector<OrderDto> RestApiService::getOrders(long long restaurantId) {
-    auto json = httpGet(baseUrl() + "/orders/?filter%5Brestaurant_id%5D=" +
-                        std::to_string(restaurantId) + "&sort=-id");
-    auto arr = parseDataArray(json);
-    std::vector<OrderDto> out;
-    for (int i = 0; i < (int)arr.size(); i++) {
-        const Wt::Json::Object& obj = arr[i];
-        out.push_back(parseOrder(obj));
-    }
-    return out;
+    return parseOrders(httpGet("getOrders", ordersUrl(restaurantId)));
 }
 
 std::vector<OrderDto> RestApiService::getOrdersByStatus(
     long long restaurantId, const std::string& status)
 {
-    auto json = httpGet(baseUrl() + "/orders/?filter%5Brestaurant_id%5D=" +
-                        std::to_string(restaurantId) +
-                        "&filter%5Bstatus%5D=" + urlEncode(status) +
-                        "&sort=id");
-    auto arr = parseDataArray(json);
-    std::vector<OrderDto> out;
-    for (int i = 0; i < (int)arr.size(); i++) {
-        const Wt::Json::Object& obj = arr[i];
-        out.push_back(parseOrder(obj));
+    return parseOrders(httpGet("getOrdersByStatus", ordersByStatusUrl(restaurantId, status)));
+}
+
+std::vector<OrderDto> RestApiService::getActiveOrders(long long restaurantId) {
+    return activeOnly(getOrders(restaurantId));
+}
+
+OrderPageDto RestApiService::getOrdersPage(long long restaurantId,
+                                           const OrderPageQuery& query) {
+    OrderPageDto out;
+    long long count = -1;
+    out.orders = parseList(httpGet("getOrdersPage", ordersPageUrl(restaurantId, query)),
+                           &parseOrder, count);
+    if (count < 0) {
+        // No meta.count from this server: count the statuses instead
+        std::string url = query.status.empty()
+            ? ordersUrl(restaurantId, kOrderStatusOnly)
+            : ordersByStatusUrl(restaurantId, query.status, kOrderStatusOnly);
+        count = countOrders(httpGet("getOrdersPage", url));
     }
+    out.total = (int)count;
     return out;
 }
 
-std::vector<OrderDto> RestApiService::getActiveOrders(long long restaurantId) {
-    // JSON:API doesn't have != filter natively; fetch all and client-filter
-    auto all = getOrders(restaurantId);
-    std::vector<OrderDto> out;
-    for (auto& o : all) {
-        if (o.status != "Served" && o.status != "Cancelled") {
-            out.push_back(o);
+OrderChangesDto RestApiService::getOrderChangesSince(long long restaurantId,
+                                                     const std::string& cursor) {
+    if (!isChangeCursor(cursor)) {
+        std::string newest = parseNewestUpdate(
+            httpGetFresh("getOrderChangesSince", newestOrderUpdateUrl(restaurantId)));
+        std::vector<OrderDto> active;
+        for (const char* status : kActiveStatuses) {
+            auto orders = parseOrders(httpGetFresh("getOrderChangesSince",
+                                                   ordersByStatusUrl(restaurantId, status)));
+            active.insert(active.end(), orders.begin(), orders.end());
         }
+        return orderSnapshot(std::move(active), newest);
     }
-    // Sort by id ascending (getOrders returns DESC)
-    std::sort(out.begin(), out.end(),
-              [](const OrderDto& a, const OrderDto& b) { return a.id < b.id; });
-    return out;
+    std::string since = cursor.substr(2);
+    return orderDelta(parseOrders(httpGetFresh("getOrderChangesSince",
+                                               orderChangesUrl(restaurantId, since))),
+                      since);
 }
 
 OrderDto RestApiService::getOrder(long long id) {
-    auto json = httpGet(baseUrl() + "/orders/" + std::to_string(id) + "/");
+    auto json = httpGet("getOrder", orderUrl(id));
     return parseOrder(parseDataObject(json));
 }
 
 OrderDto RestApiService::createOrder(long long restaurantId, int tableNumber,
                                       const std::string& customerName,
-                                      const std::string& notes)
+                                      const std::string& notes,
+                                      const std::string& idempotencyKey)
 {
-    std::stringstream body;
-    body << "{\"data\":{\"type\":\"orders\",\"attributes\":{"
-         << "\"restaurant_id\":" << restaurantId << ","
-         << "\"table_number\":" << tableNumber << ","
-         << "\"status\":\"Pending\","
-         << "\"customer_name\":\"" << customerName << "\","
-         << "\"notes\":\"" << notes << "\","
-         << "\"total\":0.0"
-         << "}}}";
-    auto json = httpPost(baseUrl() + "/orders/", body.str());
-    return parseOrder(parseDataObject(json));
+    OrderDto order;
+    if (!idempotencyKey.empty()) {
+        std::lock_guard<std::mutex> lock(recentOrdersMutex_);
+        if (recentOrders_.get(idempotencyKey, order)) return order;
+    }
+
+    if (outbox_) {
+        OutboxEntry e;
+        e.idempotencyKey = idempotencyKey;
+        e.op = OutboxEntry::Op::CreateOrder;
+        e.restaurantId = restaurantId;
+        e.tableNumber = tableNumber;
+        e.customerName = customerName;
+        e.notes = notes;
+        order.id = -outbox_->enqueue(std::move(e));
+        order.restaurant_id = restaurantId;
+        order.table_number = tableNumber;
+        order.status = "Pending";
+        order.customer_name = customerName;
+        order.notes = notes;
+    } else {
+        // Stock ApiLogicServer ignores the Idempotency-Key header, so the key
+        // is also stored on the order (a unique column).  A key whose POST
+        // failed may have created its order all the same: look for it before
+        // posting again.
+        bool unsettled = false;
+        if (!idempotencyKey.empty()) {
+            std::lock_guard<std::mutex> lock(recentOrdersMutex_);
+            unsettledKeys_.get(idempotencyKey, unsettled);
+        }
+        if (!unsettled || !findOrderByKey(idempotencyKey, order)) {
+            try {
+                auto json = httpPost("createOrder", baseUrl() + "/orders/",
+                                     newOrderBody(restaurantId, tableNumber, customerName,
+                                                  notes, idempotencyKey),
+                                     idempotencyKey);
+                order = parseOrder(parseDataObject(json));
+            } catch (std::exception&) {
+                if (!idempotencyKey.empty()) {
+                    std::lock_guard<std::mutex> lock(recentOrdersMutex_);
+                    unsettledKeys_.put(idempotencyKey, true);
+                }
+                throw;
+            }
+        }
+    }
+
+    if (!idempotencyKey.empty() && order.id != 0) {
+        std::lock_guard<std::mutex> lock(recentOrdersMutex_);
+        recentOrders_.put(idempotencyKey, order);
+        unsettledKeys_.erase(idempotencyKey);
+    }
+    return order;
+}
+
+bool RestApiService::findOrderByKey(const std::string& idempotencyKey, OrderDto& order) {
+    auto found = parseOrders(httpGetFresh("createOrder", orderByKeyUrl(idempotencyKey)));
+    if (found.empty()) return false;
+    order = found.front();
+    return true;
 }
 
 void RestApiService::addOrderItem(long long orderId, long long menuItemId,
                                    int quantity, const std::string& instructions)
 {
-    // First get the menu item to know its price
-    auto mi = getMenuItem(menuItemId);
-
-    std::stringstream body;
-    body << "{\"data\":{\"type\":\"order_item\",\"attributes\":{"
-         << "\"order_id\":" << orderId << ","
-         << "\"menu_item_id\":" << menuItemId << ","
-         << "\"quantity\":" << quantity << ","
-         << "\"unit_price\":" << std::fixed << std::setprecision(2) << mi.price << ","
-         << "\"special_instructions\":\"" << instructions << "\""
-         << "}}}";
-    httpPost(baseUrl() + "/order_item/", body.str());
-
-    // Update order total
-    auto order = getOrder(orderId);
-    double newTotal = order.total + mi.price * quantity;
-    std::stringstream patchBody;
-    patchBody << "{\"data\":{\"type\":\"orders\",\"id\":\"" << orderId
-              << "\",\"attributes\":{\"total\":"
-              << std::fixed << std::setprecision(2) << newTotal << "}}}";
-    httpPatch(baseUrl() + "/orders/" + std::to_string(orderId) + "/", patchBody.str());
+    if (outbox_) {
+        OutboxEntry e;
+        e.op = OutboxEntry::Op::AddOrderItem;
+        e.targetId = orderId;
+        e.menuItemId = menuItemId;
+        e.quantity = quantity;
+        e.notes = instructions;
+        outbox_->enqueue(std::move(e));
+        return;
+    }
+    size_t added = 0;
+    addOrderItems(orderId, {{menuItemId, quantity, instructions, ""}}, added);
+}
+
+void RestApiService::addOrderItems(long long orderId, const std::vector<NewOrderItemDto>& lines,
+                                   size_t& added)
+{
+    if (outbox_) {
+        IApiService::addOrderItems(orderId, lines, added);   // one entry per line
+        return;
+    }
+    if (added >= lines.size()) return;
+
+    // A line's key is marked unsettled before its POST: if the call fails
+    // there, the POST may have landed all the same, and the retry looks the
+    // line up before posting it again.  The last line only counts as added
+    // once the total is set, so a failed PATCH is retried too.
+    for (size_t i = added; i < lines.size(); i++) {
+        auto& line = lines[i];
+        bool unsettled = false;
+        if (!line.line_key.empty()) {
+            std::lock_guard<std::mutex> lock(recentOrdersMutex_);
+            unsettledKeys_.get(line.line_key, unsettled);
+            unsettledKeys_.put(line.line_key, true);
+        }
+        if (!unsettled || !orderHasLine(orderId, line.line_key)) {
+            auto mi = parseMenuItem(parseDataObject(
+                httpGet("getMenuItem", menuItemUrl(line.menu_item_id, kMenuItemPrice))));
+            httpPost("addOrderItem", baseUrl() + "/order_item/",
+                     orderItemBody(orderId, line.menu_item_id, line.quantity, mi.price,
+                                   line.special_instructions, line.line_key));
+        }
+        if (i + 1 < lines.size()) added = i + 1;
+    }
+
+    // One total for all the lines, from the item list as replay() does
+    double total = 0;
+    for (auto& item : parseOrderItemList(httpGetFresh("getOrderItems", orderItemsUrl(orderId))))
+        total += item.unit_price * item.quantity;
+    httpPatch("addOrderItem", orderUrl(orderId), orderTotalBody(orderId, total));
+    added = lines.size();
+
+    std::lock_guard<std::mutex> lock(recentOrdersMutex_);
+    for (auto& line : lines) {
+        if (!line.line_key.empty()) unsettledKeys_.erase(line.line_key);
+    }
+}
+
+bool RestApiService::orderHasLine(long long orderId, const std::string& lineKey) {
+    return !parseOrderItemList(httpGetFresh("addOrderItem", orderLineUrl(orderId, lineKey)))
+                .empty();
 }
 
 void RestApiService::updateOrderStatus(long long orderId, const std::string& status) {
-    std::string body = "{\"data\":{\"type\":\"orders\",\"id\":\"" +
-        std::to_string(orderId) + "\",\"attributes\":{\"status\":\"" +
-        status + "\"}}}";
-    httpPatch(baseUrl() + "/orders/" + std::to_string(orderId) + "/", body);
+    if (outbox_) {
+        OutboxEntry e;
+        e.op = OutboxEntry::Op::UpdateOrderStatus;
+        e.targetId = orderId;
+        e.status = status;
+        outbox_->enqueue(std::move(e));
+        return;
+    }
+    httpPatch("updateOrderStatus", orderUrl(orderId), orderStatusBody(orderId, status));
 }
 
 void RestApiService::cancelOrder(long long orderId) {
@@ -471,50 +745,316 @@ void RestApiService::cancelOrder(long long orderId) {
 }
 
 std::vector<OrderItemDto> RestApiService::getOrderItems(long long orderId) {
-    // Use include to get menu_item names in one request
-    auto json = httpGet(baseUrl() + "/order_item/?filter%5Border_id%5D=" +
-                        std::to_string(orderId) +
-                        "&include=menu_item");
-    auto arr = parseDataArray(json);
-    auto included = buildIncludedMap(json);
-
-    std::vector<OrderItemDto> out;
-    for (int i = 0; i < (int)arr.size(); i++) {
-        const Wt::Json::Object& obj = arr[i];
-        auto dto = parseOrderItem(obj);
-
-        // Resolve menu_item name from included
-        std::string miKey = "menu_item:" + std::to_string(dto.menu_item_id);
-        auto it = included.find(miKey);
-        if (it != included.end()) {
-            const Wt::Json::Object& miAttrs = it->second.get("attributes");
-            dto.menu_item_name = jsonStr(miAttrs, "name");
+    return parseOrderItemList(httpGet("getOrderItems", orderItemsUrl(orderId)));
+}
+
+// ─── Outbox replay ───────────────────────────────────────────────────────────
+// Runs on the Outbox thread with provisional ids already resolved.  Every
+// request carries the entry's idempotency key.  addOrderItem sets the order
+// total from the server's item list rather than incrementing it, so a
+// repeat after a partial failure still ends with the right total.
+
+OutboxOutcome RestApiService::replay(const OutboxEntry& e) {
+    auto request = [&](const std::string& endpoint, const std::string& method,
+                       const std::string& url, const std::string& body = "") {
+        HttpRequest req = jsonApiRequest(endpoint, method, url, body);
+        req.headers.push_back("Idempotency-Key: " + e.idempotencyKey);
+        return send(endpoint, std::move(req));
+    };
+
+    switch (e.op) {
+        case OutboxEntry::Op::CreateOrder: {
+            HttpResponse res = request("createOrder", "POST", baseUrl() + "/orders/",
+                newOrderBody(e.restaurantId, e.tableNumber, e.customerName, e.notes,
+                             e.idempotencyKey));
+            OutboxOutcome out = deliveryOutcome(res);
+            if (out.kind != OutboxOutcome::Kind::Applied) {
+                // An earlier attempt whose response was lost created it: the
+                // repeat broke the unique key, or the server never answered
+                HttpResponse known = request("createOrder", "GET",
+                                             orderByKeyUrl(e.idempotencyKey));
+                if (!known.ok()) return out;
+                auto orders = parseOrders(known.body);
+                if (orders.empty()) return out;
+                out = OutboxOutcome();
+                out.createdId = orders.front().id;
+                return out;
+            }
+            out.createdId = parseOrder(parseDataObject(res.body)).id;
+            if (out.createdId <= 0) {
+                out.kind = OutboxOutcome::Kind::Rejected;
+                out.error = "no order id in response";
+            }
+            return out;
         }
-        out.push_back(dto);
+
+        case OutboxEntry::Op::AddOrderItem: {
+            HttpResponse res = request("getMenuItem", "GET",
+                                       menuItemUrl(e.menuItemId, kMenuItemPrice));
+            OutboxOutcome out = deliveryOutcome(res);
+            if (out.kind != OutboxOutcome::Kind::Applied) return out;
+            double price = parseMenuItem(parseDataObject(res.body)).price;
+
+            res = request("addOrderItem", "POST", baseUrl() + "/order_item/",
+                          orderItemBody(e.targetId, e.menuItemId, e.quantity, price, e.notes));
+            out = deliveryOutcome(res);
+            if (out.kind != OutboxOutcome::Kind::Applied) return out;
+
+            res = request("getOrderItems", "GET", orderItemsUrl(e.targetId));
+            out = deliveryOutcome(res);
+            if (out.kind != OutboxOutcome::Kind::Applied) return out;
+            double total = 0;
+            for (auto& item : parseOrderItemList(res.body)) total += item.unit_price * item.quantity;
+
+            return deliveryOutcome(request("addOrderItem", "PATCH", orderUrl(e.targetId),
+                                           orderTotalBody(e.targetId, total)));
+        }
+
+        case OutboxEntry::Op::UpdateOrderStatus:
+            return deliveryOutcome(request("updateOrderStatus", "PATCH", orderUrl(e.targetId),
+                                           orderStatusBody(e.targetId, e.status)));
+
+        case OutboxEntry::Op::UpdateMenuItemAvailability:
+            return deliveryOutcome(request("updateMenuItemAvailability", "PATCH",
+                menuItemUrl(e.targetId), availabilityBody(e.targetId, e.available)));
     }
+
+    OutboxOutcome out;
+    out.kind = OutboxOutcome::Kind::Rejected;
+    out.error = "unknown outbox operation";
     return out;
 }
 
 // ─── Dashboard / reporting ───────────────────────────────────────────────────
-// These aggregate on the client from the full order list.
+// These aggregate on the client from the order list, fetching only the
+// attributes they need.
 
 int RestApiService::getOrderCount(long long restaurantId) {
-    return (int)getOrders(restaurantId).size();
+    return countOrders(httpGet("getOrderCount", ordersUrl(restaurantId, kOrderStatusOnly)));
 }
 
 double RestApiService::getRevenue(long long restaurantId) {
-    auto all = getOrders(restaurantId);
-    double total = 0.0;
-    for (auto& o : all) {
-        if (o.status == "Served") total += o.total;
-    }
-    return total;
+    return servedRevenue(parseOrders(
+        httpGet("getRevenue", ordersUrl(restaurantId, kOrderRevenue))));
 }
 
 int RestApiService::getPendingOrderCount(long long restaurantId) {
-    return (int)getOrdersByStatus(restaurantId, "Pending").size();
+    return countOrders(httpGet("getPendingOrderCount",
+                               ordersByStatusUrl(restaurantId, "Pending", kOrderStatusOnly)));
 }
 
 int RestApiService::getInProgressOrderCount(long long restaurantId) {
-    return (int)getOrdersByStatus(restaurantId, "In Progress").size();
+    return countOrders(httpGet("getInProgressOrderCount",
+                               ordersByStatusUrl(restaurantId, "In Progress", kOrderStatusOnly)));
+}
+
+// ─── Replica feed ────────────────────────────────────────────────────────────
+// Endpoint names pick up the read deadline unless api_deadlines_ms sets one.
+
+std::vector<RestaurantDto> RestApiService::pullRestaurants() {
+    return parseList(httpGetFresh("pullRestaurants", baseUrl() + "/restaurant/"),
+                     &parseRestaurant);
+}
+
+std::vector<CategoryDto> RestApiService::pullCategories() {
+    return parseList(httpGetFresh("pullCategories", baseUrl() + "/category/"),
+                     &parseCategory);
+}
+
+std::vector<MenuItemDto> RestApiService::pullMenuItems() {
+    return parseList(httpGetFresh("pullMenuItems", baseUrl() + "/menu_item/"),
+                     &parseMenuItem);
+}
+
+std::vector<OrderDto> RestApiService::pullOrdersUpdatedSince(const std::string& since) {
+    // updated_at has one-second resolution, so >= re-reads the cursor's own
+    // second rather than miss an order changed later within it
+    std::string url = baseUrl() + "/orders/?sort=updated_at,id";
+    if (!since.empty()) url += "&filter%5Bupdated_at%5D%5Bge%5D=" + urlEncode(since);
+    return parseOrders(httpGetFresh("pullOrders", url));
+}
+
+std::vector<OrderItemDto> RestApiService::pullOrderItemsAfter(long long afterId) {
+    return parseList(httpGetFresh("pullOrderItems",
+                                  baseUrl() + "/order_item/?filter%5Bid%5D%5Bgt%5D=" +
+                                      std::to_string(afterId) + "&sort=id"),
+                     &parseOrderItem);
+}
+
+bool RestApiService::circuitOpen() const {
+    return breaker_.state() == CircuitBreaker::State::Open;
+}
+
+// ─── IAsyncApiService implementation ─────────────────────────────────────────
+// Callbacks run on HttpClient's loop thread (parsing happens there too), or
+// on the caller's thread when the open breaker answers immediately.
+
+void RestApiService::getCategories(long long restaurantId,
+                                   ApiCallback<std::vector<CategoryDto>> cb) {
+    getAsync<std::vector<CategoryDto>>("getCategories", categoriesUrl(restaurantId), std::move(cb),
+        [](const std::string& json) { return parseList(json, &parseCategory); });
+}
+
+void RestApiService::getMenuItemsByCategory(long long categoryId,
+                                            ApiCallback<std::vector<MenuItemDto>> cb) {
+    getAsync<std::vector<MenuItemDto>>("getMenuItemsByCategory",
+                                       menuItemsByCategoryUrl(categoryId), std::move(cb),
+        [](const std::string& json) { return parseList(json, &parseMenuItem); });
+}
+
+void RestApiService::getOrders(long long restaurantId,
+                               ApiCallback<std::vector<OrderDto>> cb) {
+    getAsync<std::vector<OrderDto>>("getOrders", ordersUrl(restaurantId), std::move(cb),
+                                    &parseOrders);
+}
+
+void RestApiService::getOrdersByStatus(long long restaurantId, const std::string& status,
+                                       ApiCallback<std::vector<OrderDto>> cb) {
+    getAsync<std::vector<OrderDto>>("getOrdersByStatus",
+                                    ordersByStatusUrl(restaurantId, status), std::move(cb),
+                                    &parseOrders);
+}
+
+void RestApiService::getActiveOrders(long long restaurantId,
+                                     ApiCallback<std::vector<OrderDto>> cb) {
+    getAsync<std::vector<OrderDto>>("getActiveOrders", ordersUrl(restaurantId), std::move(cb),
+        [](const std::string& json) { return activeOnly(parseOrders(json)); });
+}
+
+void RestApiService::updateOrderStatus(long long orderId, const std::string& status,
+                                       ApiCallback<bool> cb) {
+    if (outbox_) {
+        // Answered once delivered, so the kitchen's follow-up refresh sees it
+        OutboxEntry e;
+        e.op = OutboxEntry::Op::UpdateOrderStatus;
+        e.targetId = orderId;
+        e.status = status;
+        try {
+            outbox_->enqueue(std::move(e), [cb](const OutboxOutcome& outcome) {
+                ApiResult<bool> result;
+                result.value = outcome.kind == OutboxOutcome::Kind::Applied;
+                result.error = outcome.error;
+                cb(std::move(result));
+            });
+        } catch (std::exception& ex) {
+            ApiResult<bool> result;
+            result.error = ex.what();
+            cb(std::move(result));
+        }
+        return;
+    }
+    std::string url = orderUrl(orderId);
+    HttpRequest req =
+        jsonApiRequest("updateOrderStatus", "PATCH", url, orderStatusBody(orderId, status));
+    if (!breaker_.allow()) {
+        ApiResult<bool> result;
+        result.error = "HTTP PATCH failed: circuit open";
+        cb(std::move(result));
+        return;
+    }
+    try {
+        http_.performAsync(std::move(req), [this, url, cb](HttpResponse res) {
+            if (isBackendFailure(res)) breaker_.onFailure();
+            else breaker_.onSuccess();
+
+            ApiResult<bool> result;
+            if (!res.error.empty()) {
+                result.error = "HTTP PATCH failed: " + res.error;
+            } else if (res.status >= 400) {
+                std::cerr << "[RestApi] PATCH " << url << " → " << res.status << "\n"
+                          << res.body << std::endl;
+                result.error = "HTTP " + std::to_string(res.status);
+            } else {
+                result.value = true;
+            }
+            cb(std::move(result));
+        });
+    } catch (std::exception& e) {
+        breaker_.release();
+        ApiResult<bool> result;
+        result.error = std::string("HTTP PATCH failed: ") + e.what();
+        cb(std::move(result));
+    }
+}
+
+void RestApiService::getOrderChangesSince(long long restaurantId, const std::string& cursor,
+                                          ApiCallback<OrderChangesDto> cb) {
+    if (!isChangeCursor(cursor)) {
+        getAsync<std::string>("getOrderChangesSince", newestOrderUpdateUrl(restaurantId),
+            [this, restaurantId, cb](ApiResult<std::string> newest) {
+                if (!newest.ok()) {
+                    cb(ApiResult<OrderChangesDto>{{}, newest.error});
+                    return;
+                }
+                activeOrdersSnapshot(restaurantId, newest.value, cb);
+            },
+            &parseNewestUpdate, false);
+        return;
+    }
+    std::string since = cursor.substr(2);
+    getAsync<OrderChangesDto>("getOrderChangesSince", orderChangesUrl(restaurantId, since),
+        std::move(cb),
+        [since](const std::string& json) { return orderDelta(parseOrders(json), since); },
+        false);
+}
+
+void RestApiService::activeOrdersSnapshot(long long restaurantId, const std::string& newest,
+                                          ApiCallback<OrderChangesDto> cb) {
+    // The statuses are read concurrently; the last one back answers
+    struct Snapshot {
+        std::mutex mutex;
+        size_t outstanding = std::size(kActiveStatuses);
+        std::vector<OrderDto> active;
+        std::string error;
+    };
+    auto state = std::make_shared<Snapshot>();
+    for (const char* status : kActiveStatuses) {
+        getAsync<std::vector<OrderDto>>("getOrderChangesSince",
+            ordersByStatusUrl(restaurantId, status),
+            [state, newest, cb](ApiResult<std::vector<OrderDto>> orders) {
+                ApiResult<OrderChangesDto> out;
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (!orders.ok()) {
+                        if (state->error.empty()) state->error = orders.error;
+                    } else {
+                        state->active.insert(state->active.end(), orders.value.begin(),
+                                             orders.value.end());
+                    }
+                    if (--state->outstanding > 0) return;
+                    out.error = state->error;
+                    if (out.ok()) out.value = orderSnapshot(std::move(state->active), newest);
+                }
+                cb(std::move(out));
+            },
+            &parseOrders, false);
+    }
+}
+
+void RestApiService::getOrderItems(long long orderId,
+                                   ApiCallback<std::vector<OrderItemDto>> cb) {
+    getAsync<std::vector<OrderItemDto>>("getOrderItems", orderItemsUrl(orderId), std::move(cb),
+                                        &parseOrderItemList);
+}
+
+void RestApiService::getOrderCount(long long restaurantId, ApiCallback<int> cb) {
+    getAsync<int>("getOrderCount", ordersUrl(restaurantId, kOrderStatusOnly), std::move(cb),
+                  &countOrders);
+}
+
+void RestApiService::getRevenue(long long restaurantId, ApiCallback<double> cb) {
+    getAsync<double>("getRevenue", ordersUrl(restaurantId, kOrderRevenue), std::move(cb),
+        [](const std::string& json) { return servedRevenue(parseOrders(json)); });
+}
+
+void RestApiService::getPendingOrderCount(long long restaurantId, ApiCallback<int> cb) {
+    getAsync<int>("getPendingOrderCount",
+                  ordersByStatusUrl(restaurantId, "Pending", kOrderStatusOnly),
+                  std::move(cb), &countOrders);
+}
+
+void RestApiService::getInProgressOrderCount(long long restaurantId, ApiCallback<int> cb) {
+    getAsync<int>("getInProgressOrderCount",
+                  ordersByStatusUrl(restaurantId, "In Progress", kOrderStatusOnly),
+                  std::move(cb), &countOrders);
 }
@@ -1,17 +1,62 @@
 #pragma once
 
 #include "IApiService.h"
+#include "IAsyncApiService.h"
+#include "HttpClient.h"
+#include "LruCache.h"
+#include "Outbox.h"
+#include "Resilience.h"
 #include "SiteConfig.h"
+#include <functional>
 #include <memory>
 #include <string>
 
 // ─── REST (ApiLogicServer / JSON:API) implementation of IApiService ──────────
-// Uses libcurl for synchronous HTTP and Wt::Json for response parsing.
+// Uses libcurl (via HttpClient) for HTTP and Wt::Json for response parsing.
 // Endpoint base URL is read from SiteConfig::apiBaseUrl().
+//
+// The IApiService methods block the calling thread.  The IAsyncApiService
+// overloads share the same URLs and parsers but run on HttpClient's
+// curl_multi loop, so no thread waits on the network.
+//
+// Every call is bounded by a per-endpoint deadline (SiteConfig
+// api_deadlines_ms) and goes through one circuit breaker for the server.
+// Blocking GETs and PATCHes are retried with jittered backoff inside the
+// deadline while the retry budget allows; POSTs are never retried.  Reads
+// that fail, or are refused by the open breaker, return the last good
+// response for the same URL when there is one.
+//
+// GETs of endpoints listed in SiteConfig api_hedging are hedged: a duplicate
+// goes out if the first request has not been answered by the endpoint's
+// tracked latency percentile (or a fixed delay), within a load cap.
+//
+// With SiteConfig api_outbox set, writes are queued in a local Outbox and
+// return as soon as they are on disk; the server sees them when the replay
+// thread delivers them.  A queued createOrder returns a provisional negative
+// order id, which later calls may use.  Reads do not see queued writes.
+//
+// Call sites that read only a few attributes ask for just those with a
+// JSON:API sparse fieldset (fields[type]=...), and with SiteConfig
+// api_compression on (the default) responses may come gzip- or
+// brotli-encoded; libcurl decodes them before parsing.
+//
+// createOrder sends its idempotency key as an Idempotency-Key header (and
+// uses it as the outbox entry's key); keys used recently are answered from
+// an in-memory LRU without contacting the server.  Stock ApiLogicServer
+// ignores the header, so the key is also written to orders.idempotency_key
+// (unique, sql/schema.sql): after a failed POST the order is looked up by
+// key before it is posted again.
 
-class RestApiService : public IApiService {
+class RestApiService : public IApiService, public IAsyncApiService {
 public:
+    // Breaker and retry budget settings; the server runs with the defaults
+    struct Policy {
+        CircuitBreaker::Options breaker;
+        RetryBudget::Options retries;
+    };
+
     explicit RestApiService(std::shared_ptr<SiteConfig> config);
+    RestApiService(std::shared_ptr<SiteConfig> config, Policy policy);
     ~RestApiService();
 
     // ── IApiService ──
@@ -29,14 +74,20 @@ public:
     std::vector<OrderDto> getOrdersByStatus(long long restaurantId,
                                              const std::string& status) override;
     std::vector<OrderDto> getActiveOrders(long long restaurantId) override;
+    OrderPageDto getOrdersPage(long long restaurantId, const OrderPageQuery& query) override;
     OrderDto getOrder(long long id) override;
     OrderDto createOrder(long long restaurantId, int tableNumber,
                           const std::string& customerName,
-                          const std::string& notes) override;
+                          const std::string& notes,
+                          const std::string& idempotencyKey = "") override;
     void addOrderItem(long long orderId, long long menuItemId,
                       int quantity, const std::string& instructions) override;
+    void addOrderItems(long long orderId, const std::vector<NewOrderItemDto>& lines,
+                       size_t& added) override;
     void updateOrderStatus(long long orderId, const std::string& status) override;
     void cancelOrder(long long orderId) override;
+    OrderChangesDto getOrderChangesSince(long long restaurantId,
+                                         const std::string& cursor) override;
 
     std::vector<OrderItemDto> getOrderItems(long long orderId) override;
 
@@ -45,15 +96,104 @@ public:
     int getPendingOrderCount(long long restaurantId) override;
     int getInProgressOrderCount(long long restaurantId) override;
 
+    // ── IAsyncApiService ──
+    void getCategories(long long restaurantId,
+                       ApiCallback<std::vector<CategoryDto>> cb) override;
+    void getMenuItemsByCategory(long long categoryId,
+                                ApiCallback<std::vector<MenuItemDto>> cb) override;
+
+    void getOrders(long long restaurantId,
+                   ApiCallback<std::vector<OrderDto>> cb) override;
+    void getOrdersByStatus(long long restaurantId, const std::string& status,
+                           ApiCallback<std::vector<OrderDto>> cb) override;
+    void getActiveOrders(long long restaurantId,
+                         ApiCallback<std::vector<OrderDto>> cb) override;
+    void updateOrderStatus(long long orderId, const std::string& status,
+                           ApiCallback<bool> cb) override;
+    void getOrderChangesSince(long long restaurantId, const std::string& cursor,
+                              ApiCallback<OrderChangesDto> cb) override;
+
+    void getOrderItems(long long orderId,
+                       ApiCallback<std::vector<OrderItemDto>> cb) override;
+
+    void getOrderCount(long long restaurantId, ApiCallback<int> cb) override;
+    void getRevenue(long long restaurantId, ApiCallback<double> cb) override;
+    void getPendingOrderCount(long long restaurantId, ApiCallback<int> cb) override;
+    void getInProgressOrderCount(long long restaurantId, ApiCallback<int> cb) override;
+
+    // ── Replica feed (HybridApiService) ──
+    // Straight from the server: a failure throws instead of falling back to
+    // last-known-good, so the caller knows its copy is not current.
+    std::vector<RestaurantDto> pullRestaurants();
+    std::vector<CategoryDto> pullCategories();          // every restaurant
+    std::vector<MenuItemDto> pullMenuItems();           // every restaurant
+    // Orders whose updated_at >= since ("" for all), oldest change first
+    std::vector<OrderDto> pullOrdersUpdatedSince(const std::string& since);
+    // Order items with id > afterId, ascending (items are never modified)
+    std::vector<OrderItemDto> pullOrderItemsAfter(long long afterId);
+
+    bool circuitOpen() const;
+
 private:
-    // HTTP helpers
-    std::string httpGet(const std::string& url);
-    std::string httpPost(const std::string& url, const std::string& jsonBody);
-    std::string httpPatch(const std::string& url, const std::string& jsonBody);
+    // HTTP helpers (blocking).  `endpoint` names the IApiService method
+    // for deadline lookup.
+    std::string httpGet(const std::string& endpoint, const std::string& url);
+    std::string httpGetFresh(const std::string& endpoint, const std::string& url);
+    std::string httpPost(const std::string& endpoint, const std::string& url,
+                         const std::string& jsonBody, const std::string& idempotencyKey = "");
+    std::string httpPatch(const std::string& endpoint, const std::string& url,
+                          const std::string& jsonBody);
+    HttpResponse send(const std::string& endpoint, HttpRequest request);
+    bool applyHedging(const std::string& endpoint, HttpRequest& request);
+    HttpRequest jsonApiRequest(const std::string& endpoint, const std::string& method,
+                               const std::string& url, const std::string& body = "") const;
+
+    // The order createOrder stored `idempotencyKey` on, if there is one
+    bool findOrderByKey(const std::string& idempotencyKey, OrderDto& order);
+    // Whether addOrderItems already posted the line with `lineKey`
+    bool orderHasLine(long long orderId, const std::string& lineKey);
+
+    // Delivers one queued write (Outbox::Apply)
+    OutboxOutcome replay(const OutboxEntry& entry);
+
+    // HTTP helpers (event loop); parse runs on the loop thread.  Not
+    // retried: the views that use them refresh periodically anyway.
+    // `lastGood` false: no fallback, and the URL is not remembered (URLs
+    // that carry a cursor would only crowd the others out).
+    template <typename T>
+    void getAsync(const std::string& endpoint, const std::string& url, ApiCallback<T> cb,
+                  std::function<T(const std::string&)> parse, bool lastGood = true);
+
+    // Async getOrderChangesSince without a cursor, once the probe is back
+    void activeOrdersSnapshot(long long restaurantId, const std::string& newest,
+                              ApiCallback<OrderChangesDto> cb);
 
-    // URL builder
+    // URL builders shared by both paths
     std::string baseUrl() const;
     std::string urlEncode(const std::string& value) const;
+    std::string categoriesUrl(long long restaurantId) const;
+    std::string menuItemsByCategoryUrl(long long categoryId) const;
+    // `fields`: a sparse fieldset such as kOrderStatusOnly, or nullptr for all
+    std::string ordersUrl(long long restaurantId, const char* fields = nullptr) const;
+    std::string ordersByStatusUrl(long long restaurantId, const std::string& status,
+                                  const char* fields = nullptr) const;
+    std::string orderChangesUrl(long long restaurantId, const std::string& since) const;
+    std::string newestOrderUpdateUrl(long long restaurantId) const;
+    std::string orderByKeyUrl(const std::string& idempotencyKey) const;
+    std::string orderLineUrl(long long orderId, const std::string& lineKey) const;
+    std::string ordersPageUrl(long long restaurantId, const OrderPageQuery& query) const;
+    std::string orderUrl(long long orderId) const;
+    std::string orderItemsUrl(long long orderId) const;
+    std::string menuItemUrl(long long menuItemId, const char* fields = nullptr) const;
 
     std::shared_ptr<SiteConfig> config_;
+    CircuitBreaker breaker_;
+    RetryBudget retryBudget_;
+    LastKnownGood lastGood_;
+    Hedger hedger_;
+    LruCache<std::string, OrderDto> recentOrders_;   // createOrder idempotency key → order
+    LruCache<std::string, bool> unsettledKeys_;      // order and line keys whose POST failed
+    std::mutex recentOrdersMutex_;
+    HttpClient http_;   // its loop thread is joined before the members above go
+    std::unique_ptr<Outbox> outbox_;   // after http_: replay stops before the client goes
 };
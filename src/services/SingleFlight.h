@@ -0,0 +1,103 @@
+#pragma once
+
+#include "IAsyncApiService.h"
+
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ─── Single-flight call coalescing ───────────────────────────────────────────
+// Calls made under the same key while one is already running do not start
+// another: they wait for the running one and get its result (or exception).
+// A key is free again as soon as its call completes, so nothing is cached.
+//
+// forget() detaches every running call from its key: callers already
+// waiting still get that result, later ones start afresh.  Used after a
+// write so a read issued after it never receives data fetched before it.
+
+class SingleFlight {
+public:
+    // Blocking: the first caller runs fn(), the others wait on it
+    template <typename T, typename F>
+    T run(const std::string& key, F&& fn, bool* shared = nullptr) {
+        std::shared_ptr<Call<T>> call;
+        bool leader = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& slot = calls_[key];
+            if (slot) {
+                call = std::static_pointer_cast<Call<T>>(slot);
+            } else {
+                call = std::make_shared<Call<T>>();
+                slot = call;
+                leader = true;
+            }
+        }
+        if (shared) *shared = !leader;
+        if (leader) {
+            try {
+                call->promise.set_value(fn());
+            } catch (...) {
+                call->promise.set_exception(std::current_exception());
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = calls_.find(key);
+            if (it != calls_.end() && it->second == call) calls_.erase(it);
+        }
+        return call->result.get();
+    }
+
+    // Callback style: the first caller's start(done) issues the request,
+    // later callers are queued; done() delivers to all of them.
+    // Returns true if this call joined one already in flight.
+    template <typename T, typename Start>
+    bool join(const std::string& key, ApiCallback<T> cb, Start&& start) {
+        auto waiters = std::make_shared<Waiters<T>>();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& slot = pending_[key];
+            if (slot) {
+                std::static_pointer_cast<Waiters<T>>(slot)->callbacks.push_back(std::move(cb));
+                return true;
+            }
+            waiters->callbacks.push_back(std::move(cb));
+            slot = waiters;
+        }
+        start([this, key, waiters](ApiResult<T> result) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = pending_.find(key);
+                if (it != pending_.end() && it->second == waiters) pending_.erase(it);
+            }
+            // No one can join once the key is gone, so callbacks is stable
+            for (auto& cb : waiters->callbacks) cb(result);
+        });
+        return false;
+    }
+
+    void forget() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        calls_.clear();
+        pending_.clear();
+    }
+
+private:
+    template <typename T>
+    struct Call {
+        std::promise<T> promise;
+        std::shared_future<T> result{promise.get_future().share()};
+    };
+
+    template <typename T>
+    struct Waiters {
+        std::vector<ApiCallback<T>> callbacks;   // guarded by mutex_ until delivery
+    };
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<void>> calls_;     // run()
+    std::unordered_map<std::string, std::shared_ptr<void>> pending_;   // join()
+};
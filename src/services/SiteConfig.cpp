@@ -69,6 +69,39 @@ static std::string jsonGet(const std::string& json, const std::string& key) {
     return jsonUnescape(json.substr(start, end - start));
 }
 
+static std::string trim(const std::string& s) {
+    auto first = s.find_first_not_of(' ');
+    if (first == std::string::npos) return "";
+    return s.substr(first, s.find_last_not_of(' ') - first + 1);
+}
+
+// "key=value,key=value" → map (entries without '=' ignored)
+static std::map<std::string, std::string> parseSpec(const std::string& spec) {
+    std::map<std::string, std::string> out;
+    std::stringstream ss(spec);
+    std::string entry;
+    while (std::getline(ss, entry, ',')) {
+        auto eq = entry.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = trim(entry.substr(0, eq));
+        if (!key.empty()) out[key] = trim(entry.substr(eq + 1));
+    }
+    return out;
+}
+
+// As parseSpec, keeping only positive integer values (ms)
+static std::map<std::string, int> parseIntMap(const std::string& spec) {
+    std::map<std::string, int> out;
+    for (auto& kv : parseSpec(spec)) {
+        try {
+            int value = std::stoi(kv.second);
+            if (value > 0) out[kv.first] = value;
+        } catch (std::exception&) {
+        }
+    }
+    return out;
+}
+
 // Ensure parent directory exists
 static void ensureDir(const std::string& path) {
     auto slash = path.rfind('/');
@@ -101,6 +134,16 @@ void SiteConfig::load() {
         if (!url.empty()) apiBaseUrl_ = url;
         std::string dst = jsonGet(json, "data_source_type");
         if (!dst.empty()) dataSourceType_ = dst;
+        apiDeadlines_ = jsonGet(json, "api_deadlines_ms");
+        apiDeadlinesMs_ = parseIntMap(apiDeadlines_);
+        apiHedging_ = jsonGet(json, "api_hedging");
+        apiHedgingByEndpoint_ = parseSpec(apiHedging_);
+        apiHedgeMaxRatio_ = jsonGet(json, "api_hedge_max_ratio");
+        apiOutboxPath_ = jsonGet(json, "api_outbox");
+        apiCompression_ = jsonGet(json, "api_compression");
+        apiReplicaPath_ = jsonGet(json, "api_replica");
+        apiReplicaBudgetMs_ = jsonGet(json, "api_replica_budget_ms");
+        sessionBudgetKb_ = jsonGet(json, "session_budget_kb");
     }
 
     // Environment variable overrides config file (always checked)
@@ -127,8 +170,24 @@ void SiteConfig::save() const {
          << "  \"store_name\": \"" << jsonEscape(storeName_) << "\",\n"
          << "  \"store_logo\": \"" << jsonEscape(storeLogo_) << "\",\n"
          << "  \"api_base_url\": \"" << jsonEscape(apiBaseUrl_) << "\",\n"
-         << "  \"data_source_type\": \"" << jsonEscape(dataSourceType_) << "\"\n"
-         << "}\n";
+         << "  \"data_source_type\": \"" << jsonEscape(dataSourceType_) << "\"";
+    if (!apiDeadlines_.empty())
+        file << ",\n  \"api_deadlines_ms\": \"" << jsonEscape(apiDeadlines_) << "\"";
+    if (!apiHedging_.empty())
+        file << ",\n  \"api_hedging\": \"" << jsonEscape(apiHedging_) << "\"";
+    if (!apiHedgeMaxRatio_.empty())
+        file << ",\n  \"api_hedge_max_ratio\": \"" << jsonEscape(apiHedgeMaxRatio_) << "\"";
+    if (!apiOutboxPath_.empty())
+        file << ",\n  \"api_outbox\": \"" << jsonEscape(apiOutboxPath_) << "\"";
+    if (!apiCompression_.empty())
+        file << ",\n  \"api_compression\": \"" << jsonEscape(apiCompression_) << "\"";
+    if (!apiReplicaPath_.empty())
+        file << ",\n  \"api_replica\": \"" << jsonEscape(apiReplicaPath_) << "\"";
+    if (!apiReplicaBudgetMs_.empty())
+        file << ",\n  \"api_replica_budget_ms\": \"" << jsonEscape(apiReplicaBudgetMs_) << "\"";
+    if (!sessionBudgetKb_.empty())
+        file << ",\n  \"session_budget_kb\": \"" << jsonEscape(sessionBudgetKb_) << "\"";
+    file << "\n}\n";
 
     file.close();
     std::cout << "[SiteConfig] Saved config to " << configPath_ << std::endl;
@@ -161,6 +220,76 @@ std::string SiteConfig::dataSourceType() const {
     return dataSourceType_;
 }
 
+int SiteConfig::apiDeadlineMs(const std::string& endpoint, bool write) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = apiDeadlinesMs_.find(endpoint);
+    if (it != apiDeadlinesMs_.end()) return it->second;
+    it = apiDeadlinesMs_.find(write ? "write" : "read");
+    if (it != apiDeadlinesMs_.end()) return it->second;
+    return write ? 5000 : 2000;
+}
+
+bool SiteConfig::apiHedging(const std::string& endpoint, double& quantile,
+                            long& delayMs) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = apiHedgingByEndpoint_.find(endpoint);
+    if (it == apiHedgingByEndpoint_.end()) it = apiHedgingByEndpoint_.find("read");
+    if (it == apiHedgingByEndpoint_.end()) return false;
+
+    const std::string& v = it->second;
+    quantile = 0;
+    delayMs = 0;
+    try {
+        if (!v.empty() && v[0] == 'p') quantile = std::stod(v.substr(1)) / 100.0;
+        else delayMs = std::stol(v);
+    } catch (std::exception&) {
+        return false;
+    }
+    return (quantile > 0 && quantile < 1) || delayMs > 0;
+}
+
+double SiteConfig::apiHedgeMaxRatio() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    try {
+        if (!apiHedgeMaxRatio_.empty()) return std::stod(apiHedgeMaxRatio_);
+    } catch (std::exception&) {
+    }
+    return 0.1;
+}
+
+std::string SiteConfig::apiOutboxPath() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return apiOutboxPath_;
+}
+
+bool SiteConfig::apiCompression() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return apiCompression_ != "off";
+}
+
+std::string SiteConfig::apiReplicaPath() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return apiReplicaPath_;
+}
+
+int SiteConfig::apiReplicaBudgetMs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    try {
+        if (!apiReplicaBudgetMs_.empty()) return std::stoi(apiReplicaBudgetMs_);
+    } catch (std::exception&) {
+    }
+    return 500;
+}
+
+int SiteConfig::sessionBudgetKb() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    try {
+        if (!sessionBudgetKb_.empty()) return std::stoi(sessionBudgetKb_);
+    } catch (std::exception&) {
+    }
+    return 512;
+}
+
 // ── Setters ──
 
 void SiteConfig::setStoreName(const std::string& name) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <map>
 #include <string>
 #include <mutex>
 
@@ -17,6 +18,36 @@ public:
     std::string apiBaseUrl() const;
     std::string dataSourceType() const;   // "LOCAL" or "ALS"
 
+    // ALS call deadline for an endpoint (IApiService method name), from
+    // "api_deadlines_ms": "read=2000,write=5000,getOrderItems=1500".
+    // Falls back to the read / write class value.
+    int apiDeadlineMs(const std::string& endpoint, bool write) const;
+
+    // Hedging for ALS GETs, from "api_hedging": "read=p95,getOrders=250".
+    // "pNN" hedges at that latency percentile of the endpoint, a number at a
+    // fixed delay (ms).  Returns false when the endpoint is not hedged.
+    bool apiHedging(const std::string& endpoint, double& quantile, long& delayMs) const;
+    // Duplicates per request allowed ("api_hedge_max_ratio", default 0.1)
+    double apiHedgeMaxRatio() const;
+
+    // SQLite file for queuing ALS writes while the server is unreachable
+    // ("api_outbox"); empty sends writes directly.
+    std::string apiOutboxPath() const;
+
+    // Ask ApiLogicServer for compressed responses ("api_compression",
+    // default "on"; "off" requests identity encoding)
+    bool apiCompression() const;
+
+    // SQLite file for a local replica of ALS that serves reads while ALS is
+    // slow or down ("api_replica"); empty disables it.  Reads fail over once
+    // ALS answers take longer than "api_replica_budget_ms" (default 500).
+    std::string apiReplicaPath() const;
+    int apiReplicaBudgetMs() const;
+
+    // Estimated memory a session may hold before its hidden panels are
+    // evicted ("session_budget_kb", default 512; 0 never evicts)
+    int sessionBudgetKb() const;
+
     // Setters (auto-save to disk)
     void setStoreName(const std::string& name);
     void setStoreLogo(const std::string& logoPath);
@@ -42,6 +73,16 @@ private:
     std::string storeLogo_;
     std::string apiBaseUrl_ = "http://localhost:5656/api";
     std::string dataSourceType_ = "LOCAL";  // "LOCAL" or "ALS"
+    std::string apiDeadlines_;              // raw spec, saved back verbatim
+    std::map<std::string, int> apiDeadlinesMs_;
+    std::string apiHedging_;
+    std::map<std::string, std::string> apiHedgingByEndpoint_;
+    std::string apiHedgeMaxRatio_;
+    std::string apiOutboxPath_;
+    std::string apiCompression_;
+    std::string apiReplicaPath_;
+    std::string apiReplicaBudgetMs_;
+    std::string sessionBudgetKb_;
 
     mutable std::mutex mutex_;
 };
@@ -0,0 +1,50 @@
+#include "TaskPool.h"
+
+#include <iostream>
+
+TaskPool::TaskPool(int threads, const std::string& name)
+    : name_(name)
+{
+    if (threads < 1) threads = 1;
+    for (int i = 0; i < threads; i++) workers_.emplace_back(&TaskPool::run, this);
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+void TaskPool::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+size_t TaskPool::queued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+}
+
+void TaskPool::run() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+            if (tasks_.empty()) return;   // stop_ and drained
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        try {
+            task();
+        } catch (std::exception& e) {
+            std::cerr << "[" << name_ << "] Task threw: " << e.what() << std::endl;
+        }
+    }
+}
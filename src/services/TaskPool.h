@@ -0,0 +1,37 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ─── Fixed-size worker pool ──────────────────────────────────────────────────
+// FIFO queue drained by `threads` workers.  The destructor finishes every
+// task already queued, then joins.
+
+class TaskPool {
+public:
+    TaskPool(int threads, const std::string& name);
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    void post(std::function<void()> task);
+
+    // Tasks waiting for a worker (excludes the ones running)
+    size_t queued() const;
+
+private:
+    void run();
+
+    std::string name_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+};
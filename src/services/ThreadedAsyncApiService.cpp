@@ -0,0 +1,91 @@
+#include "ThreadedAsyncApiService.h"
+
+ThreadedAsyncApiService::ThreadedAsyncApiService(std::shared_ptr<IApiService> api, int threads)
+    : api_(std::move(api)), pool_(threads, "ThreadedAsyncApiService")
+{
+}
+
+// ─── Category / MenuItem ─────────────────────────────────────────────────────
+
+void ThreadedAsyncApiService::getCategories(long long restaurantId,
+                                            ApiCallback<std::vector<CategoryDto>> cb) {
+    auto api = api_;
+    run(std::move(cb), [api, restaurantId] { return api->getCategories(restaurantId); });
+}
+
+void ThreadedAsyncApiService::getMenuItemsByCategory(long long categoryId,
+                                                     ApiCallback<std::vector<MenuItemDto>> cb) {
+    auto api = api_;
+    run(std::move(cb), [api, categoryId] { return api->getMenuItemsByCategory(categoryId); });
+}
+
+// ─── Order ───────────────────────────────────────────────────────────────────
+
+void ThreadedAsyncApiService::getOrders(long long restaurantId,
+                                        ApiCallback<std::vector<OrderDto>> cb) {
+    auto api = api_;
+    run(std::move(cb), [api, restaurantId] { return api->getOrders(restaurantId); });
+}
+
+void ThreadedAsyncApiService::getOrdersByStatus(long long restaurantId, const std::string& status,
+                                                ApiCallback<std::vector<OrderDto>> cb) {
+    auto api = api_;
+    run(std::move(cb), [api, restaurantId, status] {
+        return api->getOrdersByStatus(restaurantId, status);
+    });
+}
+
+void ThreadedAsyncApiService::getActiveOrders(long long restaurantId,
+                                              ApiCallback<std::vector<OrderDto>> cb) {
+    auto api = api_;
+    run(std::move(cb), [api, restaurantId] { return api->getActiveOrders(restaurantId); });
+}
+
+void ThreadedAsyncApiService::updateOrderStatus(long long orderId, const std::string& status,
+                                                ApiCallback<bool> cb) {
+    auto api = api_;
+    run(std::move(cb), [api, orderId, status] {
+        api->updateOrderStatus(orderId, status);
+        return true;
+    });
+}
+
+void ThreadedAsyncApiService::getOrderChangesSince(long long restaurantId,
+                                                   const std::string& cursor,
+                                                   ApiCallback<OrderChangesDto> cb) {
+    auto api = api_;
+    run(std::move(cb), [api, restaurantId, cursor] {
+        return api->getOrderChangesSince(restaurantId, cursor);
+    });
+}
+
+// ─── OrderItem ───────────────────────────────────────────────────────────────
+
+void ThreadedAsyncApiService::getOrderItems(long long orderId,
+                                            ApiCallback<std::vector<OrderItemDto>> cb) {
+    auto api = api_;
+    run(std::move(cb), [api, orderId] { return api->getOrderItems(orderId); });
+}
+
+// ─── Dashboard / reporting ───────────────────────────────────────────────────
+
+void ThreadedAsyncApiService::getOrderCount(long long restaurantId, ApiCallback<int> cb) {
+    auto api = api_;
+    run(std::move(cb), [api, restaurantId] { return api->getOrderCount(restaurantId); });
+}
+
+void ThreadedAsyncApiService::getRevenue(long long restaurantId, ApiCallback<double> cb) {
+    auto api = api_;
+    run(std::move(cb), [api, restaurantId] { return api->getRevenue(restaurantId); });
+}
+
+void ThreadedAsyncApiService::getPendingOrderCount(long long restaurantId, ApiCallback<int> cb) {
+    auto api = api_;
+    run(std::move(cb), [api, restaurantId] { return api->getPendingOrderCount(restaurantId); });
+}
+
+void ThreadedAsyncApiService::getInProgressOrderCount(long long restaurantId,
+                                                      ApiCallback<int> cb) {
+    auto api = api_;
+    run(std::move(cb), [api, restaurantId] { return api->getInProgressOrderCount(restaurantId); });
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "IApiService.h"
+#include "IAsyncApiService.h"
+#include "TaskPool.h"
+
+#include <memory>
+#include <string>
+
+// ─── IAsyncApiService over any blocking IApiService ──────────────────────────
+// Each call runs the synchronous method on a private worker pool, so Wt's
+// request threads return immediately.  Used in LOCAL mode, where SQLite
+// calls are short and CPU-bound; RestApiService has a real event loop.
+
+class ThreadedAsyncApiService : public IAsyncApiService {
+public:
+    ThreadedAsyncApiService(std::shared_ptr<IApiService> api, int threads);
+
+    void getCategories(long long restaurantId,
+                       ApiCallback<std::vector<CategoryDto>> cb) override;
+    void getMenuItemsByCategory(long long categoryId,
+                                ApiCallback<std::vector<MenuItemDto>> cb) override;
+
+    void getOrders(long long restaurantId,
+                   ApiCallback<std::vector<OrderDto>> cb) override;
+    void getOrdersByStatus(long long restaurantId, const std::string& status,
+                           ApiCallback<std::vector<OrderDto>> cb) override;
+    void getActiveOrders(long long restaurantId,
+                         ApiCallback<std::vector<OrderDto>> cb) override;
+    void updateOrderStatus(long long orderId, const std::string& status,
+                           ApiCallback<bool> cb) override;
+    void getOrderChangesSince(long long restaurantId, const std::string& cursor,
+                              ApiCallback<OrderChangesDto> cb) override;
+
+    void getOrderItems(long long orderId,
+                       ApiCallback<std::vector<OrderItemDto>> cb) override;
+
+    void getOrderCount(long long restaurantId, ApiCallback<int> cb) override;
+    void getRevenue(long long restaurantId, ApiCallback<double> cb) override;
+    void getPendingOrderCount(long long restaurantId, ApiCallback<int> cb) override;
+    void getInProgressOrderCount(long long restaurantId, ApiCallback<int> cb) override;
+
+private:
+    template <typename T, typename F>
+    void run(ApiCallback<T> cb, F call) {
+        pool_.post([cb = std::move(cb), call = std::move(call)] {
+            ApiResult<T> result;
+            try {
+                result.value = call();
+            } catch (std::exception& e) {
+                result.error = e.what();
+            }
+            cb(std::move(result));
+        });
+    }
+
+    std::shared_ptr<IApiService> api_;
+    TaskPool pool_;
+};
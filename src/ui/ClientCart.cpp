@@ -0,0 +1,211 @@
+#include "ClientCart.h"
+#include "../services/MenuCatalog.h"
+
+#include <Wt/WApplication.h>
+#include <Wt/WInteractWidget.h>
+#include <Wt/WWebWidget.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace {
+
+// Bounds on what a cart payload may ask for; the browser's cart keeps to
+// them too, so only a forged payload is cut short
+const int kMaxQuantity = 99;
+const size_t kMaxLines = 100;
+
+} // namespace
+
+ClientCart::ClientCart(Wt::WWidget* root, std::shared_ptr<MenuCatalog> menus,
+                       long long restaurantId)
+    : menus_(std::move(menus)), restaurantId_(restaurantId), rootId_(root->id()),
+      payload_(this, "cart")
+{
+    payload_.connect(this, &ClientCart::receive);
+
+    // The listener is on the root, so buttons the server or a renderer
+    // draws later need no wiring of their own
+    Wt::WApplication::instance()->doJavaScript(
+        "(function(){"
+        "  var root = document.getElementById('" + rootId_ + "');"
+        "  var cart = root.posCart = {"
+        "    root: root, lines: [], renderers: [],"
+        "    maxQty: " + std::to_string(kMaxQuantity) + ","
+        "    maxLines: " + std::to_string(kMaxLines) + ","
+        "    find: function(id) {"
+        "      for (var i = 0; i < this.lines.length; i++)"
+        "        if (this.lines[i].id === id) return this.lines[i];"
+        "      return null;"
+        "    },"
+        "    count: function() {"
+        "      return this.lines.reduce(function(n, l) { return n + l.qty; }, 0);"
+        "    },"
+        "    total: function() {"
+        "      return this.lines.reduce(function(t, l) { return t + l.price * l.qty; }, 0);"
+        "    },"
+        "    money: function(v) { return '$' + v.toFixed(2); },"
+        "    esc: function(s) {"
+        "      return String(s).replace(/[&<>\"']/g, function(c) {"
+        "        return '&#' + c.charCodeAt(0) + ';';"
+        "      });"
+        "    },"
+        "    payload: function() {"
+        "      return this.lines.map(function(l) { return l.id + 'x' + l.qty; }).join(',');"
+        "    },"
+        "    render: function() {"
+        "      var self = this;"
+        "      this.renderers.forEach(function(r) { r(self); });"
+        "    }"
+        "  };"
+        "  root.addEventListener('click', function(e) {"
+        "    var b = e.target.closest('[data-cart]');"
+        "    if (!b || !root.contains(b)) return;"
+        "    var op = b.getAttribute('data-cart');"
+        "    var id = Number(b.getAttribute('data-item'));"
+        "    var line = cart.find(id);"
+        "    if (op === 'add') {"
+        "      if (line) line.qty = Math.min(line.qty + 1, cart.maxQty);"
+        "      else if (cart.lines.length < cart.maxLines)"
+        "        cart.lines.push({id: id, name: b.getAttribute('data-name'),"
+        "                            price: Number(b.getAttribute('data-price')), qty: 1});"
+        "    } else if (op === 'clear') {"
+        "      cart.lines = [];"
+        "    } else if (!line) {"
+        "      return;"
+        "    } else if (op === 'inc') {"
+        "      line.qty = Math.min(line.qty + 1, cart.maxQty);"
+        "    } else if (op === 'dec') {"
+        "      if (line.qty > 1) line.qty--;"
+        "    } else if (op === 'remove') {"
+        "      cart.lines.splice(cart.lines.indexOf(line), 1);"
+        "    }"
+        "    cart.render();"
+        "  });"
+        "})();");
+
+    std::string emit = payload_.createCall({"p"});
+    send_.setJavaScript(
+        "function(o, e) {"
+        "  var cart = " + cart() + ";"
+        "  if (!cart.lines.length) return;"
+        "  var p = cart.payload();"
+        "  " + emit + ";"
+        "}");
+    take_.setJavaScript(
+        "function(o, e) {"
+        "  var cart = " + cart() + ";"
+        "  if (!cart.lines.length) return;"
+        "  var p = cart.payload();"
+        "  cart.lines = [];"
+        "  cart.render();"
+        "  " + emit + ";"
+        "}");
+}
+
+std::string ClientCart::cart() const {
+    return "document.getElementById('" + rootId_ + "').posCart";
+}
+
+void ClientCart::bindAdd(Wt::WWebWidget* button, const MenuItemDto& item) {
+    std::ostringstream price;
+    price << std::fixed << std::setprecision(2) << item.price;
+    button->setAttributeValue("data-cart", "add");
+    button->setAttributeValue("data-item", std::to_string(item.id));
+    button->setAttributeValue("data-name", Wt::WString::fromUTF8(item.name));
+    button->setAttributeValue("data-price", price.str());
+}
+
+void ClientCart::bindClear(Wt::WWebWidget* button) {
+    button->setAttributeValue("data-cart", "clear");
+}
+
+void ClientCart::addRenderer(const std::string& js) {
+    Wt::WApplication::instance()->doJavaScript(
+        "(function(cart, render) {"
+        "  cart.renderers.push(render);"
+        "  render(cart);"
+        "})(" + cart() + ", " + js + ");");
+}
+
+void ClientCart::render() {
+    Wt::WApplication::instance()->doJavaScript(cart() + ".render();");
+}
+
+void ClientCart::clear() {
+    lines_.clear();
+    unavailable_.clear();
+    Wt::WApplication::instance()->doJavaScript(
+        "(function(cart) { cart.lines = []; cart.render(); })(" + cart() + ");");
+}
+
+void ClientCart::sendOn(Wt::WInteractWidget* button, bool take) {
+    button->clicked().connect(take ? take_ : send_);
+}
+
+std::string ClientCart::unavailableNotice() const {
+    if (unavailable_.empty()) return "";
+    std::string notice = "No longer available, left out of the order: ";
+    for (size_t i = 0; i < unavailable_.size(); i++) {
+        if (i > 0) notice += ", ";
+        notice += unavailable_[i];
+    }
+    return notice;
+}
+
+double ClientCart::total() const {
+    double total = 0;
+    for (auto& line : lines_) total += line.price * line.quantity;
+    return total;
+}
+
+void ClientCart::receive(const std::string& payload) {
+    // Only ids and quantities are taken from the browser
+    auto menu = menus_->current(restaurantId_);
+    lines_.clear();
+    unavailable_.clear();
+    std::string dropped;    // ids, for the browser's cart
+
+    std::map<long long, size_t> lineOf;   // menu item id → index in lines_
+
+    std::istringstream in(payload);
+    std::string entry;
+    while (std::getline(in, entry, ',')) {
+        std::istringstream fields(entry);
+        long long id = 0;
+        char x = 0;
+        int quantity = 0;
+        if (!(fields >> id >> x >> quantity) || x != 'x' || quantity < 1) continue;
+
+        const MenuItemDto* item = menu->item(id);
+        if (!item) continue;   // not on this restaurant's menu
+        if (!item->available) {
+            unavailable_.push_back(item->name);
+            dropped += (dropped.empty() ? "" : ",") + std::to_string(item->id);
+            continue;
+        }
+        quantity = std::min(quantity, kMaxQuantity);
+
+        // An id listed twice is one line
+        auto it = lineOf.find(item->id);
+        if (it != lineOf.end()) {
+            CartLine& line = lines_[it->second];
+            line.quantity = std::min(line.quantity + quantity, kMaxQuantity);
+            continue;
+        }
+        if (lines_.size() == kMaxLines) continue;
+        lineOf[item->id] = lines_.size();
+        lines_.push_back({item->id, item->name, item->price, quantity});
+    }
+
+    if (!dropped.empty()) {
+        Wt::WApplication::instance()->doJavaScript(
+            "(function(cart, ids) {"
+            "  cart.lines = cart.lines.filter(function(l) { return ids.indexOf(l.id) < 0; });"
+            "  cart.render();"
+            "})(" + cart() + ", [" + dropped + "]);");
+    }
+    received_.emit();
+}
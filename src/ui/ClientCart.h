@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Wt/WJavaScript.h>
+#include <Wt/WObject.h>
+#include <Wt/WSignal.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../models/Dto.h"
+
+class MenuCatalog;
+
+namespace Wt {
+class WInteractWidget;
+class WWebWidget;
+class WWidget;
+}
+
+struct CartLine {
+    long long menuItemId;
+    std::string name;
+    double price;
+    int quantity;
+};
+
+// ─── A cart kept in the browser ──────────────────────────────────────────────
+// Adding items, changing quantities and clearing the cart run in the
+// browser, against a small JavaScript object kept on the view's element,
+// so a tap costs no round trip.  The server hears about the cart only when
+// a button bound with sendOn() is pressed: one request carrying
+// "id x quantity" pairs.  Those are resolved against the restaurant's menu
+// snapshot, so names and prices are never taken from the browser, and
+// items the snapshot has as unavailable (added before they ran out, or
+// never offered) are dropped from both carts and listed by unavailable().
+// The payload is not trusted further: quantities are capped at 99, lines
+// at 100, and an item listed twice becomes one line.
+//
+// Views draw the cart with renderers, JavaScript functions of the cart
+// object run after every change.  Buttons inside what they draw act on the
+// cart through data-cart attributes: data-cart="inc|dec|remove" with
+// data-item="<menu item id>"; "dec" stops at one.
+
+class ClientCart : public Wt::WObject {
+public:
+    // The cart lives on `root`'s element, which must outlive the screens
+    // showing it
+    ClientCart(Wt::WWidget* root, std::shared_ptr<MenuCatalog> menus, long long restaurantId);
+
+    // Clicking `button` adds one `item` in the browser
+    void bindAdd(Wt::WWebWidget* button, const MenuItemDto& item);
+    // Clicking `button` empties the cart in the browser
+    void bindClear(Wt::WWebWidget* button);
+
+    // `js` is a function(cart); cart.root is the view's element and
+    // cart.money(v) formats a price.  Runs at once, then after each change.
+    void addRenderer(const std::string& js);
+    // Runs the renderers again, e.g. after the server rebuilt a cart screen
+    void render();
+    void clear();
+
+    // Clicking `button` sends the browser's cart, unless it is empty; with
+    // `take`, the browser's cart is emptied as it goes.  received() is
+    // emitted once lines() holds it.
+    void sendOn(Wt::WInteractWidget* button, bool take);
+    Wt::Signal<>& received() { return received_; }
+
+    const std::vector<CartLine>& lines() const { return lines_; }
+    // Names of the items received() dropped as unavailable, and a line
+    // telling the user so ("" when none were)
+    const std::vector<std::string>& unavailable() const { return unavailable_; }
+    std::string unavailableNotice() const;
+    double total() const;
+
+private:
+    void receive(const std::string& payload);
+    std::string cart() const;   // JavaScript expression for the cart object
+
+    std::shared_ptr<MenuCatalog> menus_;
+    long long restaurantId_;
+    std::string rootId_;
+
+    std::vector<CartLine> lines_;   // as last sent
+    std::vector<std::string> unavailable_;
+
+    Wt::JSignal<std::string> payload_;  // "12x2,15x1"
+    Wt::JSlot send_;
+    Wt::JSlot take_;
+    Wt::Signal<> received_;
+};
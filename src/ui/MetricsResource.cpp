@@ -0,0 +1,17 @@
+#include "MetricsResource.h"
+
+#include <Wt/Http/Request.h>
+#include <Wt/Http/Response.h>
+
+#include "../services/Metrics.h"
+
+MetricsResource::~MetricsResource() {
+    beingDeleted();
+}
+
+void MetricsResource::handleRequest(const Wt::Http::Request& /*request*/,
+                                    Wt::Http::Response& response) {
+    response.setMimeType("text/plain; version=0.0.4; charset=utf-8");
+    response.addHeader("Cache-Control", "no-store");
+    response.out() << MetricsRegistry::instance().renderPrometheus();
+}
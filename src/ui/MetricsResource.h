@@ -0,0 +1,17 @@
+#pragma once
+
+#include <Wt/WResource.h>
+
+// ─── /metrics endpoint ───────────────────────────────────────────────────────
+// Serves MetricsRegistry in Prometheus text format.  Registered on the
+// WServer in main.cpp, independent of any session.
+
+class MetricsResource : public Wt::WResource {
+public:
+    MetricsResource() = default;
+    ~MetricsResource() override;
+
+protected:
+    void handleRequest(const Wt::Http::Request& request,
+                       Wt::Http::Response& response) override;
+};
@@ -0,0 +1,197 @@
+#include "OrderCardCache.h"
+#include "../services/Metrics.h"
+
+#include <Wt/Utils.h>
+#include <Wt/WString.h>
+#include <Wt/WTemplate.h>
+
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+namespace {
+
+// A card reading its markup from the shared fragment each time it renders,
+// so no session holds a copy of it
+class SharedTemplate : public Wt::WTemplate {
+public:
+    explicit SharedTemplate(std::shared_ptr<const std::string> markup)
+        : markup_(std::move(markup)) {}
+
+    void renderTemplate(std::ostream& result) override {
+        renderTemplateText(result, Wt::WString::fromUTF8(*markup_));
+    }
+
+private:
+    std::shared_ptr<const std::string> markup_;
+};
+
+std::string money(double amount) {
+    std::ostringstream ss;
+    ss << "$" << std::fixed << std::setprecision(2) << amount;
+    return ss.str();
+}
+
+// HTML-escaped, and "${" doubled so WTemplate does not take it for a slot
+std::string esc(const std::string& text) {
+    std::string html = Wt::Utils::htmlEncode(text);
+    std::string out;
+    out.reserve(html.size());
+    for (size_t i = 0; i < html.size(); ++i) {
+        if (html[i] == '$' && i + 1 < html.size() && html[i + 1] == '{') out += '$';
+        out += html[i];
+    }
+    return out;
+}
+
+std::string statusClass(const std::string& status) {
+    if (status == "Pending") return "status-pending";
+    if (status == "In Progress") return "status-progress";
+    if (status == "Ready") return "status-ready";
+    return "status-other";
+}
+
+std::string kitchenCard(const OrderDto& order, const std::vector<OrderItemDto>& items) {
+    bool pending = order.status == "Pending";
+    std::string out;
+    out += "<div class=\"kitchen-card-header\">"
+           "<span class=\"order-id\">Order #" + std::to_string(order.id) + "</span>"
+           "<span class=\"order-table\">Table " + std::to_string(order.table_number) + "</span>"
+           "</div>";
+    if (pending && !order.notes.empty()) {
+        out += "<span class=\"order-notes\">Notes: " + esc(order.notes) + "</span>";
+    }
+    out += "<div class=\"kitchen-items\">";
+    for (auto& oi : items) {
+        out += "<div class=\"kitchen-item-line\">"
+               "<span>" + std::to_string(oi.quantity) + "x </span>"
+               "<span class=\"item-name-bold\">" + esc(oi.menu_item_name) + "</span>";
+        if (pending && !oi.special_instructions.empty()) {
+            out += "<span class=\"item-instructions\"> (" + esc(oi.special_instructions) +
+                   ")</span>";
+        }
+        out += "</div>";
+    }
+    out += "</div>${action}";
+    return out;
+}
+
+std::string frontDeskCard(const OrderDto& order, const std::vector<OrderItemDto>& items) {
+    std::string out;
+    out += "<div class=\"order-card-header\">"
+           "<span class=\"order-id\">Order #" + std::to_string(order.id) + "</span>"
+           "<span class=\"order-table\">Table " + std::to_string(order.table_number) + "</span>"
+           "<span class=\"status-badge " + statusClass(order.status) + "\">" +
+           esc(order.status) + "</span>"
+           "</div>";
+    for (auto& oi : items) {
+        out += "<div class=\"order-item-line\">"
+               "<span>" + std::to_string(oi.quantity) + "x " + esc(oi.menu_item_name) + "</span>"
+               "<span class=\"item-price\">" + money(oi.unit_price * oi.quantity) + "</span>"
+               "</div>";
+    }
+    out += "<div class=\"order-card-footer\">"
+           "<span class=\"order-total\">Total: " + money(order.total) + "</span>"
+           "${action}</div>";
+    return out;
+}
+
+std::string mobileCard(const OrderDto& order, const std::vector<OrderItemDto>& items) {
+    std::string badge = statusClass(order.status);
+    if (badge == "status-other") badge.clear();
+    std::string out;
+    out += "<div class=\"m-order-card-header\"><div>"
+           "<span class=\"m-order-id\">Order #" + std::to_string(order.id) + "</span>"
+           "<span class=\"m-order-table-num\">Table " + std::to_string(order.table_number) +
+           "</span></div>"
+           "<span class=\"m-status-badge " + badge + "\">" + esc(order.status) + "</span>"
+           "</div>";
+    out += "<div class=\"m-order-items\">";
+    for (auto& oi : items) {
+        out += "<div class=\"m-order-item-line\">"
+               "<span>" + std::to_string(oi.quantity) + "x " + esc(oi.menu_item_name) + "</span>"
+               "<span class=\"m-order-item-price\">" + money(oi.unit_price * oi.quantity) +
+               "</span></div>";
+    }
+    out += "</div>";
+    out += "<div class=\"m-order-card-footer\">"
+           "<span class=\"m-order-total\">Total: " + money(order.total) + "</span>"
+           "${action}</div>";
+    return out;
+}
+
+} // namespace
+
+OrderCardCache& OrderCardCache::instance() {
+    static OrderCardCache cache;
+    return cache;
+}
+
+OrderCardCache::OrderCardCache()
+    : fragments_(4096),
+      hits_(MetricsRegistry::instance().counter(
+          "pos_order_cards_total", "Order cards shown, by whether the markup was cached",
+          "result=\"hit\"")),
+      renders_(MetricsRegistry::instance().counter(
+          "pos_order_cards_total", "Order cards shown, by whether the markup was cached",
+          "result=\"render\""))
+{}
+
+std::string OrderCardCache::render(Layout layout, const OrderDto& order,
+                                   const std::vector<OrderItemDto>& items) {
+    switch (layout) {
+    case Layout::Kitchen:   return kitchenCard(order, items);
+    case Layout::FrontDesk: return frontDeskCard(order, items);
+    case Layout::Mobile:    return mobileCard(order, items);
+    }
+    return std::string();
+}
+
+std::shared_ptr<const std::string> OrderCardCache::fragment(Layout layout,
+                                                           const OrderDto& order,
+                                                           const ItemsSource& items) {
+    std::ostringstream key;
+    key << static_cast<int>(layout) << ':' << order.id << ':' << order.updated_at << ':'
+        << order.status << ':' << std::fixed << std::setprecision(2) << order.total;
+
+    std::shared_ptr<const std::string> markup;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (fragments_.get(key.str(), markup)) {
+            hits_.inc();
+            return markup;
+        }
+    }
+
+    // Rendered unlocked: two sessions missing at once both render, harmlessly
+    auto orderItems = items();
+    markup = std::make_shared<const std::string>(render(layout, order, orderItems));
+    renders_.inc();
+
+    // An order still being submitted has no items yet; its next version will
+    if (!orderItems.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fragments_.put(key.str(), markup);
+    }
+    return markup;
+}
+
+std::unique_ptr<Wt::WTemplate> OrderCardCache::card(Layout layout, const OrderDto& order,
+                                                    const ItemsSource& items) {
+    // Escaped when built (see esc()), so it is not filtered again
+    std::unique_ptr<Wt::WTemplate> card =
+        std::make_unique<SharedTemplate>(fragment(layout, order, items));
+    switch (layout) {
+    case Layout::Kitchen:
+        card->addStyleClass(order.status == "Pending" ? "kitchen-card pending-card"
+                                                      : "kitchen-card progress-card");
+        break;
+    case Layout::FrontDesk:
+        card->addStyleClass("order-card");
+        break;
+    case Layout::Mobile:
+        card->addStyleClass("m-order-card");
+        break;
+    }
+    return card;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../models/Dto.h"
+#include "../services/LruCache.h"
+
+class MetricCounter;
+
+namespace Wt { class WTemplate; }
+
+// ─── Order cards rendered once, shared by every session ──────────────────────
+// An order card is a single WTemplate over an XHTML fragment instead of a
+// tree of a dozen containers and texts.  Fragments are kept process-wide,
+// keyed by layout, order id and version (updated_at, status and total, all
+// of which change with every item added and every status change), so the
+// kitchen screens and front desks of a restaurant render each version of
+// an order once between them.  The card widgets do not copy the markup:
+// they hold the shared fragment and read it whenever they render, so a
+// hundred screens showing an order keep one copy of its card.  User-entered
+// text is escaped when the fragment is built, so Wt's XHTML filtering,
+// which only setTemplateText() applies, is not needed.
+//
+// Every fragment has an ${action} slot for the view's button; views with
+// nothing to offer bind it empty.
+//
+// Exported as pos_order_cards_total{result="hit"|"render"}.
+
+class OrderCardCache {
+public:
+    enum class Layout { Kitchen, FrontDesk, Mobile };
+
+    // Called on a miss only: a cached card needs no items
+    using ItemsSource = std::function<std::vector<OrderItemDto>()>;
+
+    static OrderCardCache& instance();
+
+    std::shared_ptr<const std::string> fragment(Layout layout, const OrderDto& order,
+                                               const ItemsSource& items);
+
+    // The card widget, styled for `layout` and the order's status
+    std::unique_ptr<Wt::WTemplate> card(Layout layout, const OrderDto& order,
+                                        const ItemsSource& items);
+
+private:
+    OrderCardCache();
+
+    static std::string render(Layout layout, const OrderDto& order,
+                              const std::vector<OrderItemDto>& items);
+
+    std::mutex mutex_;
+    LruCache<std::string, std::shared_ptr<const std::string>> fragments_;
+    MetricCounter& hits_;
+    MetricCounter& renders_;
+};
@@ -0,0 +1,287 @@
+#include "OrderFeed.h"
+#include "../services/Metrics.h"
+
+#include <Wt/WApplication.h>
+#include <Wt/WObject.h>
+#include <Wt/WServer.h>
+
+#include <iostream>
+
+namespace {
+
+bool onKitchenBoard(const OrderDto& order) {
+    return order.status == "Pending" || order.status == "In Progress";
+}
+
+} // namespace
+
+// ─── Channel ─────────────────────────────────────────────────────────────────
+
+OrderFeed::Channel::Channel(std::chrono::milliseconds interval)
+    : tracker(onKitchenBoard), interval(interval), due(Clock::now())
+{}
+
+bool OrderFeed::Channel::watched() const {
+    for (auto& entry : subscribers) {
+        if (entry.second.visible) return true;
+    }
+    return false;
+}
+
+// ─── OrderFeed ───────────────────────────────────────────────────────────────
+
+OrderFeed::OrderFeed(std::shared_ptr<IAsyncApiService> api, PollPolicy policy)
+    : api_(std::move(api)), policy_(policy),
+      polls_(MetricsRegistry::instance().counter(
+          "pos_order_feed_polls_total",
+          "Kitchen polls run by the order feed (one per restaurant per tick)", "")),
+      deliveries_(MetricsRegistry::instance().counter(
+          "pos_order_feed_deliveries_total",
+          "Kitchen boards and errors posted to sessions", "")),
+      subscribers_(MetricsRegistry::instance().gauge(
+          "pos_order_feed_subscribers", "Kitchen screens subscribed to the order feed", ""))
+{
+    scheduler_ = std::thread(&OrderFeed::run, this);
+}
+
+OrderFeed::~OrderFeed() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_ = true;
+    wake_.notify_all();
+    lock.unlock();
+    if (scheduler_.joinable()) scheduler_.join();
+
+    // Callbacks of polls in flight still refer to this
+    lock.lock();
+    wake_.wait(lock, [this] {
+        for (auto& entry : channels_) {
+            if (entry.second->polling) return false;
+        }
+        return true;
+    });
+}
+
+long long OrderFeed::subscribe(Wt::WObject* owner, long long restaurantId, Handler handler) {
+    Subscriber subscriber;
+    subscriber.sessionId = Wt::WApplication::instance()->sessionId();
+    subscriber.deliver = owner->bindSafe(std::move(handler));
+
+    Delivery current;
+    long long id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& slot = channels_[restaurantId];
+        if (!slot) slot = std::make_unique<Channel>(policy_.fastest);
+        Channel& channel = *slot;
+
+        if (!channel.watched() && !channel.polling) {
+            channel.interval = policy_.fastest;
+            channel.due = Clock::now();
+        }
+        if (channel.published.value || !channel.published.ok()) {
+            current.result = channel.published;
+            current.to.emplace_back(subscriber.sessionId, subscriber.deliver);
+        }
+
+        id = ++lastSubscription_;
+        channel.subscribers.emplace(id, std::move(subscriber));
+        subscriptions_[id] = restaurantId;
+        wake_.notify_all();
+    }
+    subscribers_.add(1);
+    post(current);
+    return id;
+}
+
+void OrderFeed::unsubscribe(long long subscription) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = subscriptions_.find(subscription);
+    if (it == subscriptions_.end()) return;
+    channels_[it->second]->subscribers.erase(subscription);
+    subscriptions_.erase(it);
+    subscribers_.add(-1);
+}
+
+void OrderFeed::setVisible(long long subscription, bool visible) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = subscriptions_.find(subscription);
+    if (it == subscriptions_.end()) return;
+    Channel& channel = *channels_[it->second];
+    Subscriber& subscriber = channel.subscribers[subscription];
+    if (subscriber.visible == visible) return;
+
+    // Nobody was looking: catch up now rather than after the backed-off delay
+    if (visible && !channel.watched() && !channel.polling) {
+        channel.interval = policy_.fastest;
+        channel.due = Clock::now();
+    }
+    subscriber.visible = visible;
+    wake_.notify_all();
+}
+
+void OrderFeed::pollNow(long long restaurantId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = channels_.find(restaurantId);
+    if (it == channels_.end()) return;
+    Channel& channel = *it->second;
+    channel.interval = policy_.fastest;
+    if (channel.polling) {
+        channel.pollAgain = true;   // its result may predate the change
+    } else {
+        channel.due = Clock::now();
+        wake_.notify_all();
+    }
+}
+
+// ─── Scheduler ───────────────────────────────────────────────────────────────
+
+void OrderFeed::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        auto now = Clock::now();
+        auto wakeAt = Clock::time_point::max();
+        std::vector<std::pair<long long, std::string>> due;   // restaurant, cursor
+        for (auto& entry : channels_) {
+            Channel& channel = *entry.second;
+            if (channel.polling || !channel.watched()) continue;
+            if (channel.due <= now) {
+                channel.polling = true;
+                channel.changed = false;
+                due.emplace_back(entry.first, channel.tracker.cursor());
+            } else {
+                wakeAt = std::min(wakeAt, channel.due);
+            }
+        }
+
+        if (!due.empty()) {
+            // A fail-fast error may call back before the call returns
+            lock.unlock();
+            for (auto& poll : due) startPoll(poll.first, poll.second);
+            lock.lock();
+            continue;
+        }
+        if (wakeAt == Clock::time_point::max()) {
+            wake_.wait(lock);
+        } else {
+            wake_.wait_until(lock, wakeAt);
+        }
+    }
+}
+
+void OrderFeed::startPoll(long long restaurantId, const std::string& cursor) {
+    polls_.inc();
+    api_->getOrderChangesSince(restaurantId, cursor,
+        [this, restaurantId](ApiResult<OrderChangesDto> changes) {
+            changesArrived(restaurantId, std::move(changes));
+        });
+}
+
+void OrderFeed::changesArrived(long long restaurantId, ApiResult<OrderChangesDto> changes) {
+    std::vector<OrderDto> stale;
+    Delivery delivery;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Channel& channel = *channels_[restaurantId];
+        if (!changes.ok()) {
+            std::cerr << "[OrderFeed] Restaurant " << restaurantId << ": "
+                      << changes.error << std::endl;
+            // The cursor stays: the next poll asks for the same changes again
+            delivery = finish(channel, changes.error);
+        } else {
+            channel.changed = channel.tracker.apply(std::move(changes.value), stale);
+
+            // Orders whose items could not be fetched last time, unless this
+            // poll lists them anyway
+            for (long long id : channel.needsItems) {
+                auto it = channel.tracker.orders().find(id);
+                if (it == channel.tracker.orders().end()) continue;
+                bool listed = std::any_of(stale.begin(), stale.end(),
+                                          [id](const OrderDto& o) { return o.id == id; });
+                if (!listed) stale.push_back(it->second);
+                channel.changed = true;
+            }
+            channel.needsItems.clear();
+
+            channel.itemsInFlight = static_cast<int>(stale.size());
+            if (stale.empty()) delivery = finish(channel, "");
+        }
+    }
+    post(delivery);
+
+    // Items of new and changed orders, concurrently; published once all are back
+    for (auto& order : stale) {
+        api_->getOrderItems(order.id,
+            [this, restaurantId, order](ApiResult<std::vector<OrderItemDto>> items) {
+                itemsArrived(restaurantId, order, std::move(items));
+            });
+    }
+}
+
+void OrderFeed::itemsArrived(long long restaurantId, const OrderDto& order,
+                             ApiResult<std::vector<OrderItemDto>> items) {
+    Delivery delivery;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Channel& channel = *channels_[restaurantId];
+        if (items.ok()) {
+            channel.tracker.setItems(order, std::move(items.value));
+        } else {
+            // Not an empty list: this order alone is fetched again next poll
+            std::cerr << "[OrderFeed] Order " << order.id << " items: " << items.error
+                      << std::endl;
+            channel.tracker.forgetItems(order.id);
+            channel.needsItems.insert(order.id);
+            if (channel.itemsError.empty()) channel.itemsError = items.error;
+        }
+        if (--channel.itemsInFlight == 0) {
+            std::string error;
+            error.swap(channel.itemsError);
+            delivery = finish(channel, error);
+        }
+    }
+    post(delivery);
+}
+
+OrderFeed::Delivery OrderFeed::finish(Channel& channel, const std::string& error) {
+    bool changed = error.empty() && channel.changed;
+    channel.polling = false;
+    channel.interval = policy_.next(channel.interval, changed);
+    channel.due = Clock::now() + channel.interval;
+    if (channel.pollAgain) {
+        channel.pollAgain = false;
+        channel.due = Clock::now();
+    }
+    wake_.notify_all();
+
+    // Screens hear about a board that changed, and about an error once
+    Delivery delivery;
+    if (!error.empty()) {
+        if (error == channel.published.error) return delivery;
+        channel.published.value = nullptr;
+        channel.published.error = error;
+    } else if (changed || !channel.published.value) {
+        channel.published.value = std::make_shared<const OrderTracker>(channel.tracker);
+        channel.published.error.clear();
+    } else {
+        return delivery;
+    }
+
+    delivery.result = channel.published;
+    for (auto& entry : channel.subscribers) {
+        delivery.to.emplace_back(entry.second.sessionId, entry.second.deliver);
+    }
+    return delivery;
+}
+
+void OrderFeed::post(const Delivery& delivery) {
+    if (delivery.to.empty()) return;
+    Wt::WServer* server = Wt::WServer::instance();
+    if (!server) return;    // shutting down
+    deliveries_.inc(delivery.to.size());
+    for (auto& target : delivery.to) {
+        server->post(target.first, [deliver = target.second, result = delivery.result] {
+            deliver(result);
+            Wt::WApplication::instance()->triggerUpdate();
+        });
+    }
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../services/IAsyncApiService.h"
+#include "OrderTracker.h"
+
+class MetricCounter;
+class MetricGauge;
+
+namespace Wt { class WObject; }
+
+// ─── How often a restaurant's orders are polled ──────────────────────────────
+// A poll that found a change brings the next one to `fastest`, so busy
+// screens keep up; each one that found nothing doubles the delay up to
+// `slowest`, so an idle restaurant barely costs anything.
+
+struct PollPolicy {
+    std::chrono::milliseconds fastest{std::chrono::seconds(5)};
+    std::chrono::milliseconds slowest{std::chrono::seconds(60)};
+
+    std::chrono::milliseconds next(std::chrono::milliseconds current, bool changed) const {
+        return changed ? fastest : std::min(current * 2, slowest);
+    }
+};
+
+// ─── Kitchen orders, polled once per restaurant for every screen ─────────────
+// Each restaurant with a screen open has one channel: an OrderTracker kept
+// current with getOrderChangesSince, the items of its orders, and the
+// screens subscribed to it.  One scheduler thread polls the channels that
+// are due, following PollPolicy; a channel whose screens are all in hidden
+// tabs is not polled at all.  When a poll changes anything, the channel
+// publishes an immutable copy of its tracker (a board), which is posted
+// to every subscribed session with WServer::post.  Backend load therefore
+// depends on the number of restaurants, not of open screens.
+//
+// Channels are kept once created, so a screen opening later resumes from
+// the channel's cursor.  A failed poll keeps the cursor, and an order whose
+// items could not be fetched is fetched alone on the next poll, so an error
+// never turns the next tick into a snapshot.
+//
+// Exported as pos_order_feed_polls_total, pos_order_feed_deliveries_total
+// and pos_order_feed_subscribers.
+
+class OrderFeed {
+public:
+    // Pending and In Progress orders with their items; never modified
+    using Board = std::shared_ptr<const OrderTracker>;
+    using Handler = std::function<void(ApiResult<Board>)>;
+
+    explicit OrderFeed(std::shared_ptr<IAsyncApiService> api, PollPolicy policy = PollPolicy());
+    ~OrderFeed();
+
+    OrderFeed(const OrderFeed&) = delete;
+    OrderFeed& operator=(const OrderFeed&) = delete;
+
+    // From inside a session.  `handler` runs in that session, under its
+    // lock, with each new board or error, starting with the current one.
+    // Deliveries stop once `owner` is deleted; returns the id to pass to
+    // unsubscribe() and setVisible().
+    long long subscribe(Wt::WObject* owner, long long restaurantId, Handler handler);
+    void unsubscribe(long long subscription);
+
+    // A channel is polled while at least one of its screens is visible;
+    // the first one to become visible polls at once
+    void setVisible(long long subscription, bool visible);
+
+    // Poll as soon as possible (Refresh, or a status change made here)
+    void pollNow(long long restaurantId);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Subscriber {
+        std::string sessionId;
+        Handler deliver;            // bound to the owner with bindSafe
+        bool visible = true;
+    };
+
+    struct Channel {
+        explicit Channel(std::chrono::milliseconds interval);
+
+        OrderTracker tracker;
+        std::map<long long, Subscriber> subscribers;   // by subscription id
+
+        ApiResult<Board> published;     // last delivered; empty board before the first
+        std::chrono::milliseconds interval;
+        Clock::time_point due;          // next poll
+        bool polling = false;           // a poll is in flight
+        bool pollAgain = false;         // pollNow() during that poll
+        bool changed = false;           // what the poll in flight has found so far
+        int itemsInFlight = 0;
+        std::string itemsError;         // first item fetch of the poll that failed
+        std::set<long long> needsItems; // orders whose item fetch failed
+
+        bool watched() const;
+    };
+
+    // Sessions to post a result to, gathered under the lock
+    struct Delivery {
+        ApiResult<Board> result;
+        std::vector<std::pair<std::string, Handler>> to;
+    };
+
+    void run();
+    void startPoll(long long restaurantId, const std::string& cursor);
+    void changesArrived(long long restaurantId, ApiResult<OrderChangesDto> changes);
+    void itemsArrived(long long restaurantId, const OrderDto& order,
+                      ApiResult<std::vector<OrderItemDto>> items);
+    Delivery finish(Channel& channel, const std::string& error);
+    void post(const Delivery& delivery);
+
+    std::shared_ptr<IAsyncApiService> api_;
+    PollPolicy policy_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;      // scheduler, and the destructor waiting for polls
+    std::map<long long, std::unique_ptr<Channel>> channels_;   // by restaurant id
+    std::map<long long, long long> subscriptions_;             // id → restaurant id
+    long long lastSubscription_ = 0;
+    bool stop_ = false;
+
+    MetricCounter& polls_;
+    MetricCounter& deliveries_;
+    MetricGauge& subscribers_;
+
+    std::thread scheduler_;   // last: started once everything above exists
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../models/Dto.h"
+
+// ─── A view's copy of the orders it shows ────────────────────────────────────
+// Follows IApiService::getOrderChangesSince: pass cursor() to the call and
+// the result to apply().  Orders the `shows` predicate rejects (Served,
+// say) are dropped as their changes arrive.  apply() lists the orders that
+// are new or have changed, whose items the view fetches and hands to
+// setItems(); items are otherwise kept from poll to poll.
+//
+// Not thread-safe: used from its view's session only.
+
+class OrderTracker {
+public:
+    explicit OrderTracker(std::function<bool(const OrderDto&)> shows)
+        : shows_(std::move(shows)) {}
+
+    const std::string& cursor() const { return cursor_; }
+
+    // Forget the cursor: the next poll is a snapshot (e.g. after an error)
+    void restart() { cursor_.clear(); }
+
+    // Returns whether what the view shows has changed; `stale` receives the
+    // orders whose items need fetching.  A snapshot always counts as a change.
+    bool apply(OrderChangesDto changes, std::vector<OrderDto>& stale) {
+        bool changed = changes.reset;
+        std::map<long long, OrderDto> previous;
+        if (changes.reset) previous.swap(orders_);
+        cursor_ = std::move(changes.cursor);
+
+        for (auto& order : changes.orders) {
+            if (!shows_(order)) {
+                changed |= orders_.erase(order.id) > 0;
+                items_.erase(order.id);
+                continue;
+            }
+            const OrderDto* known = find(orders_, order.id);
+            if (!known) known = find(previous, order.id);
+            bool same = known && items_.count(order.id) &&
+                        known->updated_at == order.updated_at &&
+                        known->status == order.status && known->total == order.total &&
+                        known->notes == order.notes;
+            if (!same) {
+                changed = true;
+                stale.push_back(order);
+            }
+            orders_[order.id] = std::move(order);
+        }
+
+        if (changes.reset) {
+            for (auto it = items_.begin(); it != items_.end();) {
+                it = orders_.count(it->first) ? std::next(it) : items_.erase(it);
+            }
+        }
+        return changed;
+    }
+
+    // Items fetched for `order` as apply() listed it; dropped if the order
+    // has changed or gone since
+    void setItems(const OrderDto& order, std::vector<OrderItemDto> items) {
+        const OrderDto* current = find(orders_, order.id);
+        if (current && current->updated_at == order.updated_at) {
+            items_[order.id] = std::move(items);
+        }
+    }
+
+    // The items could not be fetched: none are shown, and the next apply()
+    // that carries the order lists it as stale again
+    void forgetItems(long long orderId) { items_.erase(orderId); }
+
+    // Ascending id
+    const std::map<long long, OrderDto>& orders() const { return orders_; }
+
+    const std::vector<OrderItemDto>& items(long long orderId) const {
+        static const std::vector<OrderItemDto> none;
+        auto it = items_.find(orderId);
+        return it != items_.end() ? it->second : none;
+    }
+
+private:
+    static const OrderDto* find(const std::map<long long, OrderDto>& orders, long long id) {
+        auto it = orders.find(id);
+        return it != orders.end() ? &it->second : nullptr;
+    }
+
+    std::function<bool(const OrderDto&)> shows_;
+    std::string cursor_;
+    std::map<long long, OrderDto> orders_;
+    std::map<long long, std::vector<OrderItemDto>> items_;
+};
@@ -0,0 +1,148 @@
+#include "OrdersTableModel.h"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// Backend sort key for each Column
+const char* const kSortKeys[] = {
+    "id", "table_number", "customer_name", "total", "status", "created_at",
+};
+
+const char* const kHeaders[] = {
+    "#", "Table", "Customer", "Total", "Status", "Placed",
+};
+
+// Pages kept per model: the visible window plus some scrollback
+constexpr size_t kCachedPages = 8;
+
+// A failed page is asked for again after this, not for each of its cells
+constexpr std::chrono::seconds kFailedPageRetry(1);
+
+std::string statusClass(const std::string& status) {
+    return "status-badge status-" +
+        std::string(status == "Pending" ? "pending" :
+                    status == "In Progress" ? "progress" :
+                    status == "Ready" ? "ready" :
+                    status == "Served" ? "served" : "cancelled");
+}
+
+}  // namespace
+
+OrdersTableModel::OrdersTableModel(std::shared_ptr<IApiService> api, long long restaurantId,
+                                   int pageSize)
+    : api_(std::move(api)), restaurantId_(restaurantId), pageSize_(pageSize),
+      pages_(kCachedPages)
+{
+    query_.limit = pageSize_;
+    page(0, &total_);
+}
+
+int OrdersTableModel::rowCount(const Wt::WModelIndex& parent) const {
+    return parent.isValid() ? 0 : total_;
+}
+
+int OrdersTableModel::columnCount(const Wt::WModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+OrdersTableModel::Page OrdersTableModel::page(int number, int* total) const {
+    Page cached;
+    if (!total && pages_.get(number, cached)) return cached;
+
+    auto now = std::chrono::steady_clock::now();
+    auto failed = failedAt_.find(number);
+    if (!total && failed != failedAt_.end() && now - failed->second < kFailedPageRetry)
+        return std::make_shared<const std::vector<OrderDto>>();
+
+    OrderPageQuery query = query_;
+    query.offset = number * pageSize_;
+    try {
+        OrderPageDto result = api_->getOrdersPage(restaurantId_, query);
+        if (total) *total = result.total;
+        cached = std::make_shared<const std::vector<OrderDto>>(std::move(result.orders));
+    } catch (std::exception& e) {
+        // Shown empty but not cached: a later data() call fetches it again
+        std::cerr << "[OrdersTableModel] Loading orders " << query.offset << ".."
+                  << query.offset + pageSize_ << " failed: " << e.what() << std::endl;
+        if (total) *total = 0;
+        failedAt_[number] = now;
+        return std::make_shared<const std::vector<OrderDto>>();
+    }
+    failedAt_.erase(number);
+    pages_.put(number, cached);
+    return cached;
+}
+
+const OrderDto* OrdersTableModel::order(int row) const {
+    if (row < 0 || row >= total_) return nullptr;
+    Page p = page(row / pageSize_);
+    size_t i = row % pageSize_;
+    return i < p->size() ? &(*p)[i] : nullptr;
+}
+
+size_t OrdersTableModel::heldBytes() const {
+    // The strings are short enough to stay inside the DTO; 64 for the
+    // occasional note or name that is not
+    return pages_.size() * pageSize_ * (sizeof(OrderDto) + 64);
+}
+
+Wt::cpp17::any OrdersTableModel::data(const Wt::WModelIndex& index,
+                                      Wt::ItemDataRole role) const {
+    if (role != Wt::ItemDataRole::Display && role != Wt::ItemDataRole::StyleClass)
+        return Wt::cpp17::any();
+    const OrderDto* o = order(index.row());
+    if (!o) return Wt::cpp17::any();
+
+    if (role == Wt::ItemDataRole::StyleClass) {
+        if (index.column() == Status) return Wt::WString::fromUTF8(statusClass(o->status));
+        return Wt::cpp17::any();
+    }
+
+    switch (index.column()) {
+        case Id:       return Wt::WString::fromUTF8(std::to_string(o->id));
+        case Table:    return Wt::WString::fromUTF8(std::to_string(o->table_number));
+        case Customer: return Wt::WString::fromUTF8(o->customer_name);
+        case Total: {
+            std::stringstream ss;
+            ss << "$" << std::fixed << std::setprecision(2) << o->total;
+            return Wt::WString::fromUTF8(ss.str());
+        }
+        case Status:   return Wt::WString::fromUTF8(o->status);
+        case Created:  return Wt::WString::fromUTF8(o->created_at);
+        default:       return Wt::cpp17::any();
+    }
+}
+
+Wt::cpp17::any OrdersTableModel::headerData(int section, Wt::Orientation orientation,
+                                            Wt::ItemDataRole role) const {
+    if (orientation != Wt::Orientation::Horizontal || role != Wt::ItemDataRole::Display ||
+        section < 0 || section >= ColumnCount)
+        return Wt::cpp17::any();
+    return Wt::WString::fromUTF8(kHeaders[section]);
+}
+
+void OrdersTableModel::sort(int column, Wt::SortOrder order) {
+    if (column < 0 || column >= ColumnCount) return;
+    layoutAboutToBeChanged().emit();
+    query_.sortBy = kSortKeys[column];
+    query_.descending = order == Wt::SortOrder::Descending;
+    pages_.clear();
+    failedAt_.clear();
+    page(0, &total_);
+    layoutChanged().emit();
+}
+
+void OrdersTableModel::setStatusFilter(const std::string& status) {
+    query_.status = status;
+    refresh();
+}
+
+void OrdersTableModel::refresh() {
+    pages_.clear();
+    failedAt_.clear();
+    page(0, &total_);
+    reset();
+}
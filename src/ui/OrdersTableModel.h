@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Wt/WAbstractTableModel.h>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../services/IApiService.h"
+#include "../services/LruCache.h"
+
+// ─── A restaurant's orders as a lazily paged table model ─────────────────────
+// For Wt::WTableView, which asks only for the rows it is displaying.  Rows
+// are fetched a page at a time with IApiService::getOrdersPage as data()
+// first touches them; the most recent pages are kept, so scrolling back
+// costs nothing and a session holds a few pages however long the history.
+// A page that fails to load shows empty and is fetched again on a later
+// data() call.
+// Sorting and the status filter are done by the backend.
+//
+// rowCount() is counted on the first page by refresh() and sort(); orders
+// placed in between appear on the next refresh().
+
+class OrdersTableModel : public Wt::WAbstractTableModel {
+public:
+    enum Column { Id, Table, Customer, Total, Status, Created, ColumnCount };
+
+    OrdersTableModel(std::shared_ptr<IApiService> api, long long restaurantId,
+                     int pageSize = 50);
+
+    int rowCount(const Wt::WModelIndex& parent = Wt::WModelIndex()) const override;
+    int columnCount(const Wt::WModelIndex& parent = Wt::WModelIndex()) const override;
+    Wt::cpp17::any data(const Wt::WModelIndex& index,
+                        Wt::ItemDataRole role = Wt::ItemDataRole::Display) const override;
+    Wt::cpp17::any headerData(int section,
+                              Wt::Orientation orientation = Wt::Orientation::Horizontal,
+                              Wt::ItemDataRole role = Wt::ItemDataRole::Display) const override;
+    void sort(int column, Wt::SortOrder order = Wt::SortOrder::Ascending) override;
+
+    // "" shows every status
+    void setStatusFilter(const std::string& status);
+    // Drop the cached pages and count again (after a write, or on demand)
+    void refresh();
+
+    // The order on `row`, fetching its page if needed; nullptr past the end
+    const OrderDto* order(int row) const;
+
+    // Roughly what the cached pages hold, taking every page as full
+    size_t heldBytes() const;
+
+private:
+    using Page = std::shared_ptr<const std::vector<OrderDto>>;
+
+    // `total`, if given, receives the matching row count (0 on failure)
+    Page page(int number, int* total = nullptr) const;
+
+    std::shared_ptr<IApiService> api_;
+    long long restaurantId_;
+    int pageSize_;
+    OrderPageQuery query_;
+
+    int total_ = 0;
+    mutable LruCache<int, Page> pages_;    // by page number; filled in by data()
+    // Pages whose fetch failed, and when: not cached, so they are fetched
+    // again once a second has passed
+    mutable std::map<int, std::chrono::steady_clock::time_point> failedAt_;
+};
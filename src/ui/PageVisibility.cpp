@@ -0,0 +1,44 @@
+#include "PageVisibility.h"
+#include "../services/Metrics.h"
+
+#include <Wt/WApplication.h>
+#include <Wt/WWidget.h>
+
+PageVisibility::PageVisibility(Wt::WWidget* page, const std::string& name)
+    : state_(this, "visibility"),
+      hiddenViews_(MetricsRegistry::instance().gauge(
+          "pos_ui_views_hidden", "Auto-refreshing views paused in a hidden browser tab",
+          "view=\"" + name + "\""))
+{
+    state_.connect(this, &PageVisibility::report);
+
+    // One listener per view, dropped once the view's element is gone (the
+    // user switched views) so a long-lived page does not collect them
+    std::string call = state_.createCall({"state"});
+    Wt::WApplication::instance()->doJavaScript(
+        "(function(){"
+        "  var id = '" + page->id() + "';"
+        "  function report(){"
+        "    if (!document.getElementById(id)){"
+        "      document.removeEventListener('visibilitychange', report);"
+        "      return;"
+        "    }"
+        "    var state = document.hidden ? 'hidden' : 'visible';"
+        "    " + call + ";"
+        "  }"
+        "  document.addEventListener('visibilitychange', report);"
+        "  if (document.hidden) report();"
+        "})();");
+}
+
+PageVisibility::~PageVisibility() {
+    if (hidden_) hiddenViews_.add(-1);
+}
+
+void PageVisibility::report(const std::string& state) {
+    bool hidden = state == "hidden";
+    if (hidden == hidden_) return;
+    hidden_ = hidden;
+    hiddenViews_.add(hidden ? 1 : -1);
+    changed_.emit(!hidden);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Wt/WJavaScript.h>
+#include <Wt/WObject.h>
+#include <Wt/WSignal.h>
+
+#include <string>
+
+class MetricGauge;
+
+namespace Wt { class WWidget; }
+
+// ─── Whether the browser tab showing a view is in front ──────────────────────
+// The Page Visibility API's visibilitychange events, reported over a
+// JSignal.  Views that refresh on their own stop asking for data while
+// nobody can see them.
+//
+// `name` labels pos_ui_views_hidden.
+
+class PageVisibility : public Wt::WObject {
+public:
+    // The browser-side listener goes away with `page`'s DOM element
+    PageVisibility(Wt::WWidget* page, const std::string& name);
+    ~PageVisibility() override;
+
+    bool hidden() const { return hidden_; }
+
+    // Emitted on each change: true once visible again, false when hidden
+    Wt::Signal<bool>& changed() { return changed_; }
+
+private:
+    void report(const std::string& state);
+
+    bool hidden_ = false;
+    Wt::JSignal<std::string> state_;    // "visible" | "hidden"
+    Wt::Signal<bool> changed_;
+    MetricGauge& hiddenViews_;
+};
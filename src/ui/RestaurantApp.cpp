@@ -8,21 +8,31 @@
 #include <Wt/WPushButton.h>
 #include <Wt/WText.h>
 
-#include <sstream>
-#include <iomanip>
-
 #include "../widgets/ManagerView.h"
 #include "../widgets/FrontDeskView.h"
 #include "../widgets/MobileFrontDeskView.h"
 #include "../widgets/KitchenView.h"
+#include "../services/Metrics.h"
+
+#include <algorithm>
 
 std::shared_ptr<IApiService> RestaurantApp::sharedApiService = nullptr;
+std::shared_ptr<IAsyncApiService> RestaurantApp::sharedAsyncApiService = nullptr;
 std::shared_ptr<SiteConfig> RestaurantApp::sharedSiteConfig = nullptr;
+std::shared_ptr<MenuCatalog> RestaurantApp::sharedMenuCatalog = nullptr;
+std::shared_ptr<OrderFeed> RestaurantApp::sharedOrderFeed = nullptr;
+std::shared_ptr<OrderSubmitter> RestaurantApp::sharedOrderSubmitter = nullptr;
 
 RestaurantApp::RestaurantApp(const Wt::WEnvironment& env,
                              std::shared_ptr<IApiService> apiService,
-                             std::shared_ptr<SiteConfig> siteConfig)
-    : Wt::WApplication(env), api_(apiService), siteConfig_(siteConfig),
+                             std::shared_ptr<IAsyncApiService> asyncApiService,
+                             std::shared_ptr<SiteConfig> siteConfig,
+                             std::shared_ptr<MenuCatalog> menuCatalog,
+                             std::shared_ptr<OrderFeed> orderFeed,
+                             std::shared_ptr<OrderSubmitter> orderSubmitter)
+    : Wt::WApplication(env), api_(apiService), asyncApi_(asyncApiService),
+      siteConfig_(siteConfig), menuCatalog_(menuCatalog), orderFeed_(orderFeed),
+      orderSubmitter_(orderSubmitter),
       touchDetected_(this, "touchDetected"),
       themeChanged_(this, "themeChanged")
 {
@@ -34,6 +44,13 @@ RestaurantApp::RestaurantApp(const Wt::WEnvironment& env,
     // Use custom stylesheet
     useStyleSheet("resources/style.css");
 
+    // Server push: async API results are posted back into the session
+    enableUpdates(true);
+
+    // 0 in the config measures without evicting
+    int budgetKb = siteConfig_ ? std::max(0, siteConfig_->sessionBudgetKb()) : 512;
+    footprint_ = std::make_unique<SessionFootprint>(root(), static_cast<size_t>(budgetKb) * 1024);
+
     // Add mobile class to root for CSS targeting
     if (isMobile_) {
         root()->addStyleClass("is-mobile");
@@ -49,6 +66,22 @@ RestaurantApp::RestaurantApp(const Wt::WEnvironment& env,
     showLoginScreen();
 }
 
+void RestaurantApp::notify(const Wt::WEvent& event) {
+    static LatencyHistogram& latency = MetricsRegistry::instance().histogram(
+        "pos_wt_event_duration_seconds", "Wt session event handling time", "");
+    static MetricCounter& errors = MetricsRegistry::instance().counter(
+        "pos_wt_event_errors_total", "Wt session events that threw", "");
+
+    ScopedLatency timer(latency);
+    try {
+        footprint_->sample();
+        Wt::WApplication::notify(event);
+    } catch (...) {
+        errors.inc();
+        throw;
+    }
+}
+
 bool RestaurantApp::detectMobileDevice() {
     const std::string& ua = environment().userAgent();
 
@@ -288,6 +321,7 @@ void RestaurantApp::showLoginScreen() {
     headerCartBubble_->setHidden(true);
     headerRefreshBtn_->setHidden(true);
     refreshClickCallback_ = nullptr;
+    footprint_->setView("login");
 
     auto loginPanel = workspace_->addWidget(std::make_unique<Wt::WContainerWidget>());
     loginPanel->addStyleClass("login-panel");
@@ -364,7 +398,9 @@ void RestaurantApp::showManagerView(long long restaurantId) {
     headerLogoutBtn_->setHidden(false);
     headerCartBubble_->setHidden(true);
 
-    workspace_->addWidget(std::make_unique<ManagerView>(api_, restaurantId, this));
+    footprint_->setView("manager");
+
+    workspace_->addWidget(std::make_unique<ManagerView>(api_, menuCatalog_, restaurantId, this));
 }
 
 void RestaurantApp::showFrontDeskView(long long restaurantId) {
@@ -374,12 +410,15 @@ void RestaurantApp::showFrontDeskView(long long restaurantId) {
     headerCartBubble_->setHidden(true);
     headerRefreshBtn_->setHidden(true);
     refreshClickCallback_ = nullptr;
+    footprint_->setView("frontdesk");
 
     if (isMobile_) {
         workspace_->addWidget(
-            std::make_unique<MobileFrontDeskView>(api_, restaurantId, this, isTablet_));
+            std::make_unique<MobileFrontDeskView>(api_, menuCatalog_, orderSubmitter_,
+                                                  restaurantId, this, isTablet_));
     } else {
-        workspace_->addWidget(std::make_unique<FrontDeskView>(api_, restaurantId));
+        workspace_->addWidget(std::make_unique<FrontDeskView>(api_, menuCatalog_, orderSubmitter_,
+                                                              restaurantId));
     }
 }
 
@@ -390,8 +429,9 @@ void RestaurantApp::showKitchenView(long long restaurantId) {
     headerCartBubble_->setHidden(true);
     headerRefreshBtn_->setHidden(true);
     refreshClickCallback_ = nullptr;
+    footprint_->setView("kitchen");
 
-    workspace_->addWidget(std::make_unique<KitchenView>(api_, restaurantId));
+    workspace_->addWidget(std::make_unique<KitchenView>(asyncApi_, orderFeed_, restaurantId));
 }
 
 void RestaurantApp::logout() {
@@ -401,21 +441,21 @@ void RestaurantApp::logout() {
     showLoginScreen();
 }
 
-void RestaurantApp::updateHeaderCart(int itemCount, double total) {
-    if (itemCount > 0) {
-        headerCartCount_->setText(std::to_string(itemCount));
-        std::stringstream ts;
-        ts << "$" << std::fixed << std::setprecision(2) << total;
-        headerCartTotal_->setText(ts.str());
-        headerCartBubble_->setHidden(false);
-        // Trigger bounce animation
-        doJavaScript(
-            "var b = document.querySelector('.header-cart-bubble');"
-            "if(b){b.classList.remove('bounce');"
-            "void b.offsetWidth; b.classList.add('bounce');}");
-    } else {
-        headerCartBubble_->setHidden(true);
-    }
+std::string RestaurantApp::headerCartRenderer() const {
+    // Bounces when the count changes, not on every redraw
+    return "function(cart) {"
+           "  var b = document.getElementById('" + headerCartBubble_->id() + "');"
+           "  if (!b) return;"
+           "  var n = cart.count();"
+           "  b.classList.toggle('cart-empty', n === 0);"
+           "  document.getElementById('" + headerCartCount_->id() + "').textContent = n;"
+           "  document.getElementById('" + headerCartTotal_->id() + "').textContent ="
+           "    cart.money(cart.total());"
+           "  if (n > 0 && n !== b.cartCount) {"
+           "    b.classList.remove('bounce'); void b.offsetWidth; b.classList.add('bounce');"
+           "  }"
+           "  b.cartCount = n;"
+           "}";
 }
 
 void RestaurantApp::setHeaderCartVisible(bool visible) {
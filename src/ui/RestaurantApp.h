@@ -11,19 +11,33 @@
 #include <memory>
 
 #include "../services/IApiService.h"
+#include "../services/IAsyncApiService.h"
+#include "../services/MenuCatalog.h"
+#include "../services/OrderSubmitter.h"
 #include "../services/SiteConfig.h"
+#include "OrderFeed.h"
+#include "SessionFootprint.h"
 
 class RestaurantApp : public Wt::WApplication {
 public:
     RestaurantApp(const Wt::WEnvironment& env,
                   std::shared_ptr<IApiService> apiService,
-                  std::shared_ptr<SiteConfig> siteConfig);
+                  std::shared_ptr<IAsyncApiService> asyncApiService,
+                  std::shared_ptr<SiteConfig> siteConfig,
+                  std::shared_ptr<MenuCatalog> menuCatalog,
+                  std::shared_ptr<OrderFeed> orderFeed,
+                  std::shared_ptr<OrderSubmitter> orderSubmitter);
 
     static std::shared_ptr<IApiService> sharedApiService;
+    static std::shared_ptr<IAsyncApiService> sharedAsyncApiService;
     static std::shared_ptr<SiteConfig> sharedSiteConfig;
+    static std::shared_ptr<MenuCatalog> sharedMenuCatalog;
+    static std::shared_ptr<OrderFeed> sharedOrderFeed;
+    static std::shared_ptr<OrderSubmitter> sharedOrderSubmitter;
 
-    // Called by MobileFrontDeskView to update the header cart bubble
-    void updateHeaderCart(int itemCount, double total);
+    // The header cart bubble, drawn by the browser: a ClientCart renderer
+    // for MobileFrontDeskView.  Hidden while the cart is empty.
+    std::string headerCartRenderer() const;
     void setHeaderCartVisible(bool visible);
 
     // Called by MobileFrontDeskView to register itself for header cart clicks
@@ -37,6 +51,15 @@ public:
     void refreshHeaderBranding();
 
     std::shared_ptr<SiteConfig> siteConfig() const { return siteConfig_; }
+    std::shared_ptr<IAsyncApiService> asyncApi() const { return asyncApi_; }
+
+    // This session's memory estimate; views register their evictable panels
+    SessionFootprint& footprint() { return *footprint_; }
+
+protected:
+    // Times every request/event dispatched to this session (pos_wt_event_*),
+    // and samples its footprint first
+    void notify(const Wt::WEvent& event) override;
 
 private:
     void setupLayout();
@@ -51,9 +74,14 @@ private:
     void onTouchDetected(const std::string& info);
 
     std::shared_ptr<IApiService> api_;
+    std::shared_ptr<IAsyncApiService> asyncApi_;
     std::shared_ptr<SiteConfig> siteConfig_;
+    std::shared_ptr<MenuCatalog> menuCatalog_;
+    std::shared_ptr<OrderFeed> orderFeed_;
+    std::shared_ptr<OrderSubmitter> orderSubmitter_;
     bool isMobile_ = false;
     bool isTablet_ = false;  // tablet vs phone (for split-panel vs sequential menu)
+    std::unique_ptr<SessionFootprint> footprint_;
 
     // JS -> C++ signal for client-side touch detection
     Wt::JSignal<std::string> touchDetected_;
@@ -0,0 +1,151 @@
+#include "SessionFootprint.h"
+#include "../services/Metrics.h"
+
+#include <Wt/WTemplate.h>
+#include <Wt/WText.h>
+#include <Wt/WWidget.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+// A widget's own server-side state (the object, its signals, DOM change
+// tracking), averaged over the widget types the views use
+constexpr size_t kWidgetBytes = 512;
+
+MetricGauge& sessionsGauge(const std::string& view) {
+    return MetricsRegistry::instance().gauge(
+        "pos_sessions", "Live sessions, by the view on screen", "view=\"" + view + "\"");
+}
+
+MetricGauge& widgetsGauge(const std::string& view) {
+    return MetricsRegistry::instance().gauge(
+        "pos_session_widgets", "Widgets held by live sessions, by view",
+        "view=\"" + view + "\"");
+}
+
+MetricGauge& bytesGauge(const std::string& view) {
+    return MetricsRegistry::instance().gauge(
+        "pos_session_bytes", "Estimated memory held by live sessions, by view",
+        "view=\"" + view + "\"");
+}
+
+MetricCounter& evictionsCounter(const std::string& panel) {
+    return MetricsRegistry::instance().counter(
+        "pos_session_evictions_total", "Hidden panels emptied to bring a session under budget",
+        "panel=\"" + panel + "\"");
+}
+
+} // namespace
+
+SessionFootprint::SessionFootprint(Wt::WWidget* root, size_t budgetBytes)
+    : root_(root), budget_(budgetBytes)
+{}
+
+SessionFootprint::~SessionFootprint() {
+    if (view_.empty()) return;
+    sessionsGauge(view_).add(-1);
+    widgetsGauge(view_).add(-static_cast<int64_t>(widgets_));
+    bytesGauge(view_).add(-static_cast<int64_t>(bytes_));
+}
+
+void SessionFootprint::setView(const std::string& view) {
+    if (view == view_) return;
+    if (!view_.empty()) {
+        sessionsGauge(view_).add(-1);
+        widgetsGauge(view_).add(-static_cast<int64_t>(widgets_));
+        bytesGauge(view_).add(-static_cast<int64_t>(bytes_));
+    }
+    view_ = view;
+    sessionsGauge(view_).add(1);
+    widgetsGauge(view_).add(static_cast<int64_t>(widgets_));
+    bytesGauge(view_).add(static_cast<int64_t>(bytes_));
+
+    // The tree has just been replaced: measure on the next event
+    measuredAt_ = std::chrono::steady_clock::time_point();
+}
+
+void SessionFootprint::addPanel(Wt::WWidget* panel, const std::string& name,
+                                std::function<bool()> evictable, std::function<void()> evict,
+                                std::function<size_t()> heldBytes) {
+    panels_.push_back({panel, name, std::move(evictable), std::move(evict),
+                       std::move(heldBytes)});
+}
+
+void SessionFootprint::sample(std::chrono::milliseconds every) {
+    if (std::chrono::steady_clock::now() - measuredAt_ >= every) measure();
+}
+
+void SessionFootprint::measure() {
+    measuredAt_ = std::chrono::steady_clock::now();
+    panels_.erase(std::remove_if(panels_.begin(), panels_.end(),
+                                 [](const Panel& panel) { return !panel.widget; }),
+                  panels_.end());
+
+    Tally now = tally();
+    if (budget_ > 0 && now.bytes > budget_) {
+        evict();
+        now = tally();
+    }
+    publish(now);
+}
+
+void SessionFootprint::count(const Wt::WWidget* widget, Tally& tally) {
+    tally.widgets++;
+    tally.bytes += kWidgetBytes;
+    if (auto text = dynamic_cast<const Wt::WText*>(widget)) {
+        tally.bytes += text->text().toUTF8().size();
+    } else if (auto markup = dynamic_cast<const Wt::WTemplate*>(widget)) {
+        tally.bytes += markup->templateText().toUTF8().size();
+    }
+    for (auto child : widget->children()) count(child, tally);
+}
+
+SessionFootprint::Tally SessionFootprint::tally() {
+    Tally total;
+    count(root_, total);
+    for (auto& panel : panels_) {
+        if (panel.heldBytes) total.bytes += panel.heldBytes();
+    }
+    return total;
+}
+
+void SessionFootprint::evict() {
+    std::vector<std::pair<size_t, Panel*>> candidates;    // size, panel
+    for (auto& panel : panels_) {
+        if (!panel.evictable()) continue;
+        Tally size;
+        count(panel.widget.get(), size);
+        if (panel.heldBytes) size.bytes += panel.heldBytes();
+        candidates.emplace_back(size.bytes, &panel);
+    }
+
+    // Largest first, so as few panels as possible are built again
+    std::sort(candidates.begin(), candidates.end(),
+              [](const std::pair<size_t, Panel*>& a, const std::pair<size_t, Panel*>& b) {
+                  return a.first > b.first;
+              });
+
+    size_t over = tally().bytes;
+    for (auto& candidate : candidates) {
+        if (over <= budget_) break;
+        Panel& panel = *candidate.second;
+        std::cerr << "[SessionFootprint] " << view_ << " session at " << over / 1024
+                  << " KB, budget " << budget_ / 1024 << " KB: evicting " << panel.name
+                  << " (" << candidate.first / 1024 << " KB)" << std::endl;
+        panel.evict();
+        evictionsCounter(panel.name).inc();
+        over -= std::min(over, candidate.first);
+    }
+}
+
+void SessionFootprint::publish(const Tally& now) {
+    if (!view_.empty()) {
+        widgetsGauge(view_).add(static_cast<int64_t>(now.widgets) -
+                                static_cast<int64_t>(widgets_));
+        bytesGauge(view_).add(static_cast<int64_t>(now.bytes) - static_cast<int64_t>(bytes_));
+    }
+    widgets_ = now.widgets;
+    bytes_ = now.bytes;
+}
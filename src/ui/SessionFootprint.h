@@ -0,0 +1,87 @@
+#pragma once
+
+#include <Wt/Core/observing_ptr.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Wt { class WWidget; }
+
+// ─── A session's approximate memory, and shedding it ─────────────────────────
+// Wt keeps a session's widget tree for as long as the session lives, which
+// is up to wt_config.xml's timeout after its tab has gone, so how many
+// terminals a host carries depends on how heavy those trees are.  A
+// footprint is estimated by walking the tree: a fixed cost per widget,
+// plus the text and template markup widgets hold, plus what registered
+// panels report holding outside widgets (an order page cache, say).
+// It is an estimate for budgeting and comparing views, not a heap count.
+//
+// Views register panels that are cheap to build again.  When the estimate
+// is over budget, evictable panels (built, and not on screen) are emptied,
+// largest first, until it is back under; each builds itself again the next
+// time it is shown.
+//
+// Exported as pos_sessions, pos_session_widgets and pos_session_bytes, all
+// by view and summed over live sessions, and pos_session_evictions_total
+// by panel.
+
+class SessionFootprint {
+public:
+    // `budgetBytes` 0 measures but never evicts
+    SessionFootprint(Wt::WWidget* root, size_t budgetBytes);
+    ~SessionFootprint();
+
+    SessionFootprint(const SessionFootprint&) = delete;
+    SessionFootprint& operator=(const SessionFootprint&) = delete;
+
+    // The view on screen ("login", "manager", ...), for the metric labels
+    void setView(const std::string& view);
+
+    // `panel` is part of the tree; `name` labels its evictions.  `evictable`
+    // says whether it can go now, `evict` empties it, and `heldBytes`, if
+    // given, adds what it keeps outside widgets.  Dropped once `panel` is
+    // deleted.
+    void addPanel(Wt::WWidget* panel, const std::string& name,
+                  std::function<bool()> evictable, std::function<void()> evict,
+                  std::function<size_t()> heldBytes = nullptr);
+
+    // Measures (and evicts) if the last measurement is older than `every`;
+    // called before each event, so evictions go out with its response
+    void sample(std::chrono::milliseconds every = std::chrono::seconds(5));
+    void measure();
+
+    size_t widgets() const { return widgets_; }
+    size_t bytes() const { return bytes_; }
+
+private:
+    struct Panel {
+        Wt::Core::observing_ptr<Wt::WWidget> widget;
+        std::string name;
+        std::function<bool()> evictable;
+        std::function<void()> evict;
+        std::function<size_t()> heldBytes;
+    };
+
+    struct Tally {
+        size_t widgets = 0;
+        size_t bytes = 0;
+    };
+
+    static void count(const Wt::WWidget* widget, Tally& tally);
+    Tally tally();
+    void evict();
+    void publish(const Tally& now);
+
+    Wt::WWidget* root_;
+    size_t budget_;
+    std::vector<Panel> panels_;
+    std::chrono::steady_clock::time_point measuredAt_;
+
+    // What this session currently adds to its view's gauges
+    std::string view_;
+    size_t widgets_ = 0;
+    size_t bytes_ = 0;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Wt/WApplication.h>
+#include <Wt/WObject.h>
+#include <Wt/WServer.h>
+
+#include <functional>
+#include <string>
+#include <utility>
+
+#include "../services/IAsyncApiService.h"
+
+// ─── Deliver async results into a Wt session ─────────────────────────────────
+// IAsyncApiService callbacks fire on a service thread.  sessionCallback()
+// must be called from inside a session (an event handler or constructor);
+// it captures that session's id and returns an ApiCallback which posts the
+// result back via WServer::post.  The handler then runs under the session
+// lock, and triggerUpdate() pushes the DOM changes over the server-push
+// channel (RestaurantApp enables updates).
+//
+// The handler is dropped silently if the session has ended or `owner` has
+// been deleted in the meantime (e.g. the user switched views).
+
+template <typename T>
+ApiCallback<T> sessionCallback(Wt::WObject* owner,
+                               std::function<void(ApiResult<T>)> handler)
+{
+    std::string sessionId = Wt::WApplication::instance()->sessionId();
+    auto safe = owner->bindSafe(std::move(handler));
+
+    return [sessionId, safe](ApiResult<T> result) {
+        Wt::WServer* server = Wt::WServer::instance();
+        if (!server) return;    // shutting down
+        server->post(sessionId, [safe, result = std::move(result)]() mutable {
+            safe(std::move(result));
+            Wt::WApplication::instance()->triggerUpdate();
+        });
+    };
+}
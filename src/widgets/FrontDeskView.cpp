@@ -1,14 +1,24 @@
 #include "FrontDeskView.h"
+#include "../ui/OrderCardCache.h"
+#include "../ui/SessionPost.h"
 
 #include <Wt/WBreak.h>
 #include <Wt/WMessageBox.h>
+#include <Wt/WRandom.h>
+#include <Wt/WTemplate.h>
 #include <sstream>
 #include <iomanip>
 
-FrontDeskView::FrontDeskView(std::shared_ptr<IApiService> api, long long restaurantId)
-    : api_(api), restaurantId_(restaurantId)
+FrontDeskView::FrontDeskView(std::shared_ptr<IApiService> api,
+                             std::shared_ptr<MenuCatalog> menus,
+                             std::shared_ptr<OrderSubmitter> submitter, long long restaurantId)
+    : api_(api), menus_(menus), submitter_(submitter), restaurantId_(restaurantId),
+      activeOrders_([](const OrderDto& o) {
+          return o.status != "Served" && o.status != "Cancelled";
+      })
 {
     addStyleClass("frontdesk-view");
+    cart_ = addChild(std::make_unique<ClientCart>(this, menus_, restaurantId_));
 
     auto workspace = addWidget(std::make_unique<Wt::WContainerWidget>());
     workspace->addStyleClass("split-workspace");
@@ -37,9 +47,9 @@ void FrontDeskView::buildMenuBrowser(Wt::WContainerWidget* parent) {
     menuItemsContainer_->addStyleClass("menu-items-grid");
 
     // Load categories
-    auto categories = api_->getCategories(restaurantId_);
+    auto menu = menus_->current(restaurantId_);
     bool first = true;
-    for (auto& cat : categories) {
+    for (auto& cat : menu->categories) {
         long long catId = cat.id;
         auto btn = categoryContainer_->addWidget(
             std::make_unique<Wt::WPushButton>(cat.name));
@@ -58,15 +68,12 @@ void FrontDeskView::buildMenuBrowser(Wt::WContainerWidget* parent) {
 void FrontDeskView::showCategoryItems(long long categoryId) {
     menuItemsContainer_->clear();
 
-    auto items = api_->getMenuItemsByCategory(categoryId);
+    // Latest shared snapshot: picks up availability changes, no backend call
+    auto menu = menus_->current(restaurantId_);
 
-    for (auto& item : items) {
+    for (auto& item : menu->items(categoryId)) {
         if (!item.available) continue;
 
-        long long itemId = item.id;
-        std::string itemName = item.name;
-        double itemPrice = item.price;
-
         auto card = menuItemsContainer_->addWidget(std::make_unique<Wt::WContainerWidget>());
         card->addStyleClass("menu-card");
 
@@ -82,96 +89,8 @@ void FrontDeskView::showCategoryItems(long long categoryId) {
 
         auto addBtn = card->addWidget(std::make_unique<Wt::WPushButton>("+ Add"));
         addBtn->addStyleClass("btn btn-primary btn-sm");
-        addBtn->clicked().connect([this, itemId, itemName, itemPrice] {
-            addToCart(itemId, itemName, itemPrice);
-        });
-    }
-}
-
-void FrontDeskView::addToCart(long long menuItemId, const std::string& name, double price) {
-    // Check if already in cart, increment quantity
-    for (auto& ci : cart_) {
-        if (ci.menuItemId == menuItemId) {
-            ci.quantity++;
-            refreshCart();
-            return;
-        }
+        cart_->bindAdd(addBtn, item);
     }
-    cart_.push_back({menuItemId, name, price, 1});
-    refreshCart();
-}
-
-void FrontDeskView::removeFromCart(int index) {
-    if (index >= 0 && index < (int)cart_.size()) {
-        cart_.erase(cart_.begin() + index);
-    }
-    refreshCart();
-}
-
-void FrontDeskView::refreshCart() {
-    cartContainer_->clear();
-
-    if (cart_.empty()) {
-        cartContainer_->addWidget(std::make_unique<Wt::WText>(
-            "<p class='empty-msg'>Cart is empty. Select items from the menu.</p>"));
-        cartTotal_->setText("$0.00");
-        return;
-    }
-
-    auto table = cartContainer_->addWidget(std::make_unique<Wt::WTable>());
-    table->addStyleClass("data-table cart-table");
-    table->setHeaderCount(1);
-    table->elementAt(0, 0)->addWidget(std::make_unique<Wt::WText>("Item"));
-    table->elementAt(0, 1)->addWidget(std::make_unique<Wt::WText>("Qty"));
-    table->elementAt(0, 2)->addWidget(std::make_unique<Wt::WText>("Price"));
-    table->elementAt(0, 3)->addWidget(std::make_unique<Wt::WText>(""));
-
-    double total = 0.0;
-    for (int i = 0; i < (int)cart_.size(); i++) {
-        int row = i + 1;
-        auto& ci = cart_[i];
-        table->elementAt(row, 0)->addWidget(std::make_unique<Wt::WText>(ci.name));
-
-        // Quantity controls
-        auto qtyContainer = table->elementAt(row, 1)->addWidget(
-            std::make_unique<Wt::WContainerWidget>());
-        qtyContainer->addStyleClass("qty-controls");
-
-        auto minusBtn = qtyContainer->addWidget(std::make_unique<Wt::WPushButton>("-"));
-        minusBtn->addStyleClass("btn btn-sm btn-qty");
-        minusBtn->clicked().connect([this, i] {
-            if (cart_[i].quantity > 1) {
-                cart_[i].quantity--;
-                refreshCart();
-            }
-        });
-
-        qtyContainer->addWidget(std::make_unique<Wt::WText>(
-            " " + std::to_string(ci.quantity) + " "));
-
-        auto plusBtn = qtyContainer->addWidget(std::make_unique<Wt::WPushButton>("+"));
-        plusBtn->addStyleClass("btn btn-sm btn-qty");
-        plusBtn->clicked().connect([this, i] {
-            cart_[i].quantity++;
-            refreshCart();
-        });
-
-        double lineTotal = ci.price * ci.quantity;
-        std::stringstream ss;
-        ss << "$" << std::fixed << std::setprecision(2) << lineTotal;
-        table->elementAt(row, 2)->addWidget(std::make_unique<Wt::WText>(ss.str()));
-
-        auto rmBtn = table->elementAt(row, 3)->addWidget(
-            std::make_unique<Wt::WPushButton>("X"));
-        rmBtn->addStyleClass("btn btn-danger btn-sm");
-        rmBtn->clicked().connect([this, i] { removeFromCart(i); });
-
-        total += lineTotal;
-    }
-
-    std::stringstream ts;
-    ts << "$" << std::fixed << std::setprecision(2) << total;
-    cartTotal_->setText(ts.str());
 }
 
 void FrontDeskView::buildOrderPanel(Wt::WContainerWidget* parent) {
@@ -213,120 +132,180 @@ void FrontDeskView::buildOrderPanel(Wt::WContainerWidget* parent) {
     cartTotal_ = cartHeader->addWidget(std::make_unique<Wt::WText>("$0.00"));
     cartTotal_->addStyleClass("cart-total-value");
 
+    // Filled by the browser; the server never touches its contents
     cartContainer_ = parent->addWidget(std::make_unique<Wt::WContainerWidget>());
     cartContainer_->addStyleClass("cart-items");
-    cartContainer_->addWidget(std::make_unique<Wt::WText>(
-        "<p class='empty-msg'>Cart is empty. Select items from the menu.</p>"));
-
-    // Submit button
+    cart_->addRenderer(
+        "function(cart) {"
+        "  var items = document.getElementById('" + cartContainer_->id() + "');"
+        "  document.getElementById('" + cartTotal_->id() + "').textContent ="
+        "    cart.money(cart.total());"
+        "  if (!cart.lines.length) {"
+        "    items.innerHTML ="
+        "      \"<p class='empty-msg'>Cart is empty. Select items from the menu.</p>\";"
+        "    return;"
+        "  }"
+        "  var html = '<table class=\"data-table cart-table\"><thead><tr>' +"
+        "    '<th>Item</th><th>Qty</th><th>Price</th><th></th></tr></thead><tbody>';"
+        "  cart.lines.forEach(function(l) {"
+        "    var item = ' data-item=\"' + l.id + '\"';"
+        "    html += '<tr><td>' + cart.esc(l.name) + '</td>' +"
+        "      '<td><div class=\"qty-controls\">' +"
+        "      '<button type=\"button\" class=\"btn btn-sm btn-qty\" data-cart=\"dec\"' +"
+        "        item + '>-</button>' +"
+        "      '<span> ' + l.qty + ' </span>' +"
+        "      '<button type=\"button\" class=\"btn btn-sm btn-qty\" data-cart=\"inc\"' +"
+        "        item + '>+</button>' +"
+        "      '</div></td>' +"
+        "      '<td>' + cart.money(l.price * l.qty) + '</td>' +"
+        "      '<td><button type=\"button\" class=\"btn btn-danger btn-sm\" data-cart=\"remove\"' +"
+        "        item + '>X</button></td></tr>';"
+        "  });"
+        "  items.innerHTML = html + '</tbody></table>';"
+        "}");
+
+    cartNotice_ = parent->addWidget(std::make_unique<Wt::WText>("", Wt::TextFormat::Plain));
+    cartNotice_->addStyleClass("send-error");
+    cartNotice_->hide();
+
+    // Submit button: the one request the cart costs
     auto btnRow = parent->addWidget(std::make_unique<Wt::WContainerWidget>());
     btnRow->addStyleClass("btn-row");
     auto submitBtn = btnRow->addWidget(std::make_unique<Wt::WPushButton>("Place Order"));
     submitBtn->addStyleClass("btn btn-primary btn-lg");
-    submitBtn->clicked().connect(this, &FrontDeskView::submitOrder);
+    cart_->sendOn(submitBtn, true);
+    cart_->received().connect(this, &FrontDeskView::submitOrder);
 
     auto clearBtn = btnRow->addWidget(std::make_unique<Wt::WPushButton>("Clear Cart"));
     clearBtn->addStyleClass("btn btn-secondary btn-lg");
-    clearBtn->clicked().connect([this] {
-        cart_.clear();
-        refreshCart();
-    });
+    cart_->bindClear(clearBtn);
 
     // Active orders section
     parent->addWidget(std::make_unique<Wt::WText>("<h3>Active Orders</h3>"))
         ->addStyleClass("panel-title");
+    sendingContainer_ = parent->addWidget(std::make_unique<Wt::WContainerWidget>());
+    sendingContainer_->addStyleClass("active-orders");
     activeOrdersContainer_ = parent->addWidget(std::make_unique<Wt::WContainerWidget>());
     activeOrdersContainer_->addStyleClass("active-orders");
     refreshActiveOrders();
 }
 
 void FrontDeskView::submitOrder() {
-    if (cart_.empty()) return;
-
-    std::string custName = customerNameEdit_->text().toUTF8();
-    if (custName.empty()) custName = "Walk-In Guest";
-    int tableNum = tableNumberEdit_->value();
-    std::string notes = notesEdit_->text().toUTF8();
-
-    auto order = api_->createOrder(restaurantId_, tableNum, custName, notes);
-    long long orderId = order.id;
-
-    for (auto& ci : cart_) {
-        api_->addOrderItem(orderId, ci.menuItemId, ci.quantity, "");
+    std::string notice = cart_->unavailableNotice();
+    cartNotice_->setText(notice);
+    cartNotice_->setHidden(notice.empty());
+    if (cart_->lines().empty()) return;
+
+    OrderSubmission submission;
+    submission.restaurantId = restaurantId_;
+    submission.customerName = customerNameEdit_->text().toUTF8();
+    if (submission.customerName.empty()) submission.customerName = "Walk-In Guest";
+    submission.tableNumber = tableNumberEdit_->value();
+    submission.notes = notesEdit_->text().toUTF8();
+    for (auto& line : cart_->lines()) {
+        submission.lines.push_back({line.menuItemId, line.quantity, ""});
     }
+    submission.idempotencyKey = Wt::WRandom::generateId();
+
+    std::string key = submission.idempotencyKey;
+    Sending& entry = sending_[key];
+    entry.submission = std::move(submission);
+    entry.row = sendingContainer_->addWidget(std::make_unique<Wt::WContainerWidget>());
 
-    cart_.clear();
+    // The form is free for the next order while this one is sent; the
+    // browser emptied the cart when it sent it
     customerNameEdit_->setText("");
     tableNumberEdit_->setValue(1);
     notesEdit_->setText("");
-    refreshCart();
+    send(key);
+}
+
+void FrontDeskView::send(const std::string& key) {
+    renderSending(key, "");
+    submitter_->submit(sending_.at(key).submission,
+        sessionCallback<OrderSubmission>(this, [this, key](ApiResult<OrderSubmission> result) {
+            submitted(key, std::move(result));
+        }));
+}
+
+void FrontDeskView::submitted(const std::string& key, ApiResult<OrderSubmission> result) {
+    auto it = sending_.find(key);
+    if (it == sending_.end()) return;
+    it->second.submission = std::move(result.value);
+    if (!result.ok()) {
+        renderSending(key, result.error);
+        return;
+    }
+    sendingContainer_->removeWidget(it->second.row);
+    sending_.erase(it);
     refreshActiveOrders();
 }
 
+void FrontDeskView::renderSending(const std::string& key, const std::string& error) {
+    Sending& entry = sending_.at(key);
+    const OrderSubmission& submission = entry.submission;
+    bool failed = !error.empty();
+
+    Wt::WContainerWidget* row = entry.row;
+    row->clear();
+    row->setStyleClass(failed ? "order-card sending-card send-failed" : "order-card sending-card");
+
+    auto headerRow = row->addWidget(std::make_unique<Wt::WContainerWidget>());
+    headerRow->addStyleClass("order-card-header");
+    headerRow->addWidget(std::make_unique<Wt::WText>(
+        "Table " + std::to_string(submission.tableNumber) + " · " + submission.customerName,
+        Wt::TextFormat::Plain))->addStyleClass("order-table");
+    headerRow->addWidget(std::make_unique<Wt::WText>(failed ? "Not sent" : "Sending"))
+        ->addStyleClass(failed ? "status-badge status-cancelled" : "status-badge status-sending");
+    if (!failed) return;
+
+    auto footerRow = row->addWidget(std::make_unique<Wt::WContainerWidget>());
+    footerRow->addStyleClass("order-card-footer");
+    footerRow->addWidget(std::make_unique<Wt::WText>(error, Wt::TextFormat::Plain))
+        ->addStyleClass("send-error");
+    auto retryBtn = footerRow->addWidget(std::make_unique<Wt::WPushButton>("Retry"));
+    retryBtn->addStyleClass("btn btn-primary btn-sm");
+    retryBtn->clicked().connect([this, key] { send(key); });
+}
+
 void FrontDeskView::refreshActiveOrders() {
-    activeOrdersContainer_->clear();
+    // Only new and changed orders are fetched; nothing changed, nothing redrawn
+    std::vector<OrderDto> stale;
+    if (!activeOrders_.apply(api_->getOrderChangesSince(restaurantId_, activeOrders_.cursor()),
+                             stale)) {
+        return;
+    }
+    for (auto& order : stale) activeOrders_.setItems(order, api_->getOrderItems(order.id));
+    renderActiveOrders();
+}
 
-    auto orders = api_->getActiveOrders(restaurantId_);
+void FrontDeskView::renderActiveOrders() {
+    activeOrdersContainer_->clear();
 
+    auto& orders = activeOrders_.orders();
     if (orders.empty()) {
         activeOrdersContainer_->addWidget(std::make_unique<Wt::WText>(
             "<p class='empty-msg'>No active orders</p>"));
         return;
     }
 
-    for (auto& order : orders) {
+    for (auto& entry : orders) {
+        const OrderDto& order = entry.second;
         long long oid = order.id;
-        auto card = activeOrdersContainer_->addWidget(
-            std::make_unique<Wt::WContainerWidget>());
-        card->addStyleClass("order-card");
-
-        auto headerRow = card->addWidget(std::make_unique<Wt::WContainerWidget>());
-        headerRow->addStyleClass("order-card-header");
-
-        headerRow->addWidget(std::make_unique<Wt::WText>(
-            "Order #" + std::to_string(oid)))
-            ->addStyleClass("order-id");
-        headerRow->addWidget(std::make_unique<Wt::WText>(
-            "Table " + std::to_string(order.table_number)))
-            ->addStyleClass("order-table");
-
-        auto statusBadge = headerRow->addWidget(std::make_unique<Wt::WText>(order.status));
-        statusBadge->addStyleClass("status-badge status-" +
-            std::string(order.status == "Pending" ? "pending" :
-                       order.status == "In Progress" ? "progress" :
-                       order.status == "Ready" ? "ready" : "other"));
-
-        // Show items
-        auto items = api_->getOrderItems(oid);
-        for (auto& oi : items) {
-            auto itemLine = card->addWidget(std::make_unique<Wt::WContainerWidget>());
-            itemLine->addStyleClass("order-item-line");
-            itemLine->addWidget(std::make_unique<Wt::WText>(
-                std::to_string(oi.quantity) + "x " + oi.menu_item_name));
-
-            std::stringstream ss;
-            ss << "$" << std::fixed << std::setprecision(2)
-               << (oi.unit_price * oi.quantity);
-            itemLine->addWidget(std::make_unique<Wt::WText>(ss.str()))
-                ->addStyleClass("item-price");
-        }
-
-        auto footerRow = card->addWidget(std::make_unique<Wt::WContainerWidget>());
-        footerRow->addStyleClass("order-card-footer");
-
-        std::stringstream ss;
-        ss << "Total: $" << std::fixed << std::setprecision(2) << order.total;
-        footerRow->addWidget(std::make_unique<Wt::WText>(ss.str()))
-            ->addStyleClass("order-total");
+        auto card = activeOrdersContainer_->addWidget(OrderCardCache::instance().card(
+            OrderCardCache::Layout::FrontDesk, order,
+            [&] { return activeOrders_.items(oid); }));
 
         if (order.status == "Ready") {
-            auto serveBtn = footerRow->addWidget(
+            auto serveBtn = card->bindWidget("action",
                 std::make_unique<Wt::WPushButton>("Mark Served"));
             serveBtn->addStyleClass("btn btn-success btn-sm");
             serveBtn->clicked().connect([this, oid] {
                 api_->updateOrderStatus(oid, "Served");
                 refreshActiveOrders();
             });
+        } else {
+            card->bindEmpty("action");
         }
     }
 }
@@ -2,39 +2,41 @@
 
 #include <Wt/WContainerWidget.h>
 #include <Wt/WText.h>
-#include <Wt/WTable.h>
 #include <Wt/WPushButton.h>
 #include <Wt/WLineEdit.h>
 #include <Wt/WSpinBox.h>
 #include <Wt/WComboBox.h>
 #include <Wt/WTextArea.h>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "../services/IApiService.h"
-
-struct CartItem {
-    long long menuItemId;
-    std::string name;
-    double price;
-    int quantity;
-};
+#include "../services/MenuCatalog.h"
+#include "../services/OrderSubmitter.h"
+#include "../ui/ClientCart.h"
+#include "../ui/OrderTracker.h"
 
 class FrontDeskView : public Wt::WContainerWidget {
 public:
-    FrontDeskView(std::shared_ptr<IApiService> api, long long restaurantId);
+    FrontDeskView(std::shared_ptr<IApiService> api, std::shared_ptr<MenuCatalog> menus,
+                  std::shared_ptr<OrderSubmitter> submitter, long long restaurantId);
 
 private:
     void buildMenuBrowser(Wt::WContainerWidget* parent);
     void buildOrderPanel(Wt::WContainerWidget* parent);
     void showCategoryItems(long long categoryId);
-    void addToCart(long long menuItemId, const std::string& name, double price);
-    void removeFromCart(int index);
-    void refreshCart();
     void submitOrder();
+    void send(const std::string& key);
+    void submitted(const std::string& key, ApiResult<OrderSubmission> result);
+    void renderSending(const std::string& key, const std::string& error);
     void refreshActiveOrders();
+    void renderActiveOrders();
 
     std::shared_ptr<IApiService> api_;
+    std::shared_ptr<MenuCatalog> menus_;
+    std::shared_ptr<OrderSubmitter> submitter_;
     long long restaurantId_;
 
     // Menu browsing
@@ -44,10 +46,22 @@ private:
     // Order panel
     Wt::WContainerWidget* cartContainer_ = nullptr;
     Wt::WText* cartTotal_ = nullptr;
+    Wt::WText* cartNotice_ = nullptr;   // items left out of the last order
     Wt::WLineEdit* customerNameEdit_ = nullptr;
     Wt::WSpinBox* tableNumberEdit_ = nullptr;
     Wt::WTextArea* notesEdit_ = nullptr;
     Wt::WContainerWidget* activeOrdersContainer_ = nullptr;
+    OrderTracker activeOrders_;
+
+    ClientCart* cart_ = nullptr;     // drawn into cartContainer_ and cartTotal_ by the browser
 
-    std::vector<CartItem> cart_;
+    // Orders handed to the submitter, by idempotency key.  Each shows above
+    // the active orders until placed; one that failed keeps its progress,
+    // so Retry resumes it instead of creating a second order.
+    struct Sending {
+        OrderSubmission submission;
+        Wt::WContainerWidget* row = nullptr;
+    };
+    std::map<std::string, Sending> sending_;
+    Wt::WContainerWidget* sendingContainer_ = nullptr;
 };
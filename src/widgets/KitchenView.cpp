@@ -1,11 +1,17 @@
 #include "KitchenView.h"
+#include "../ui/OrderCardCache.h"
+#include "../ui/SessionPost.h"
 
+#include <Wt/Core/observing_ptr.hpp>
 #include <Wt/WBreak.h>
+#include <Wt/WTemplate.h>
+#include <iostream>
 #include <sstream>
 #include <iomanip>
 
-KitchenView::KitchenView(std::shared_ptr<IApiService> api, long long restaurantId)
-    : api_(api), restaurantId_(restaurantId)
+KitchenView::KitchenView(std::shared_ptr<IAsyncApiService> api,
+                         std::shared_ptr<OrderFeed> feed, long long restaurantId)
+    : api_(api), feed_(feed), restaurantId_(restaurantId)
 {
     addStyleClass("kitchen-view");
 
@@ -17,7 +23,7 @@ KitchenView::KitchenView(std::shared_ptr<IApiService> api, long long restaurantI
 
     auto refreshBtn = topBar->addWidget(std::make_unique<Wt::WPushButton>("Refresh"));
     refreshBtn->addStyleClass("btn btn-refresh");
-    refreshBtn->clicked().connect(this, &KitchenView::refreshOrders);
+    refreshBtn->clicked().connect([this] { feed_->pollNow(restaurantId_); });
 
     // Two-column: Pending | In Progress
     auto workspace = addWidget(std::make_unique<Wt::WContainerWidget>());
@@ -31,14 +37,27 @@ KitchenView::KitchenView(std::shared_ptr<IApiService> api, long long restaurantI
     rightPanel->addStyleClass("panel right-panel kitchen-inprogress");
     buildInProgressPanel(rightPanel);
 
-    // Initial data load (both containers must exist before calling refresh)
-    refreshOrders();
+    // Orders arrive from the restaurant's feed, shared with every other
+    // kitchen screen (both containers must exist before the first board)
+    subscription_ = feed_->subscribe(this, restaurantId_,
+        [this](ApiResult<OrderFeed::Board> board) {
+            if (!board.ok()) {
+                showLoadError(board.error);
+                return;
+            }
+            board_ = std::move(board.value);
+            renderColumns();
+        });
+
+    // A screen in a hidden tab does not keep the feed polling
+    visibility_ = addChild(std::make_unique<PageVisibility>(this, "kitchen"));
+    visibility_->changed().connect([this](bool visible) {
+        feed_->setVisible(subscription_, visible);
+    });
+}
 
-    // Auto-refresh timer (every 10 seconds)
-    refreshTimer_ = addChild(std::make_unique<Wt::WTimer>());
-    refreshTimer_->setInterval(std::chrono::seconds(10));
-    refreshTimer_->timeout().connect(this, &KitchenView::refreshOrders);
-    refreshTimer_->start();
+KitchenView::~KitchenView() {
+    feed_->unsubscribe(subscription_);
 }
 
 void KitchenView::buildPendingPanel(Wt::WContainerWidget* parent) {
@@ -46,6 +65,8 @@ void KitchenView::buildPendingPanel(Wt::WContainerWidget* parent) {
         ->addStyleClass("panel-title");
     pendingContainer_ = parent->addWidget(std::make_unique<Wt::WContainerWidget>());
     pendingContainer_->addStyleClass("kitchen-orders");
+    pendingContainer_->addWidget(std::make_unique<Wt::WText>(
+        "<p class='loading-msg'>Loading orders…</p>"));
 }
 
 void KitchenView::buildInProgressPanel(Wt::WContainerWidget* parent) {
@@ -53,111 +74,97 @@ void KitchenView::buildInProgressPanel(Wt::WContainerWidget* parent) {
         ->addStyleClass("panel-title");
     inProgressContainer_ = parent->addWidget(std::make_unique<Wt::WContainerWidget>());
     inProgressContainer_->addStyleClass("kitchen-orders");
+    inProgressContainer_->addWidget(std::make_unique<Wt::WText>(
+        "<p class='loading-msg'>Loading orders…</p>"));
 }
 
-void KitchenView::refreshOrders() {
-    // Refresh pending
-    pendingContainer_->clear();
-    {
-        auto pending = api_->getOrdersByStatus(restaurantId_, "Pending");
-
-        if (pending.empty()) {
-            pendingContainer_->addWidget(std::make_unique<Wt::WText>(
-                "<p class='empty-msg'>No pending orders</p>"));
-        }
-
-        for (auto& order : pending) {
-            long long oid = order.id;
-            auto card = pendingContainer_->addWidget(
-                std::make_unique<Wt::WContainerWidget>());
-            card->addStyleClass("kitchen-card pending-card");
-
-            auto hdr = card->addWidget(std::make_unique<Wt::WContainerWidget>());
-            hdr->addStyleClass("kitchen-card-header");
-            hdr->addWidget(std::make_unique<Wt::WText>(
-                "Order #" + std::to_string(oid)))->addStyleClass("order-id");
-            hdr->addWidget(std::make_unique<Wt::WText>(
-                "Table " + std::to_string(order.table_number)))->addStyleClass("order-table");
-
-            if (!order.notes.empty()) {
-                auto notesEl = card->addWidget(std::make_unique<Wt::WText>(
-                    "Notes: " + order.notes));
-                notesEl->addStyleClass("order-notes");
-            }
-
-            auto items = api_->getOrderItems(oid);
-            auto itemsList = card->addWidget(std::make_unique<Wt::WContainerWidget>());
-            itemsList->addStyleClass("kitchen-items");
-            for (auto& oi : items) {
-                auto line = itemsList->addWidget(std::make_unique<Wt::WContainerWidget>());
-                line->addStyleClass("kitchen-item-line");
-                line->addWidget(std::make_unique<Wt::WText>(
-                    std::to_string(oi.quantity) + "x "));
-                line->addWidget(std::make_unique<Wt::WText>(oi.menu_item_name))
-                    ->addStyleClass("item-name-bold");
-                if (!oi.special_instructions.empty()) {
-                    line->addWidget(std::make_unique<Wt::WText>(
-                        " (" + oi.special_instructions + ")"))
-                        ->addStyleClass("item-instructions");
-                }
-            }
+void KitchenView::renderColumns() {
+    renderColumn("Pending", pendingContainer_);
+    renderColumn("In Progress", inProgressContainer_);
+}
 
-            auto acceptBtn = card->addWidget(
-                std::make_unique<Wt::WPushButton>("Accept Order"));
-            acceptBtn->addStyleClass("btn btn-primary btn-block");
-            acceptBtn->clicked().connect([this, oid] { acceptOrder(oid); });
-        }
+void KitchenView::showLoadError(const std::string& error) {
+    for (auto container : {pendingContainer_, inProgressContainer_}) {
+        container->clear();
+        container->addWidget(std::make_unique<Wt::WText>(
+            "<p class='empty-msg load-error'>Could not load orders</p>"));
     }
+    std::cerr << "[KitchenView] " << error << std::endl;
+}
 
-    // Refresh in-progress
-    inProgressContainer_->clear();
-    {
-        auto inProgress = api_->getOrdersByStatus(restaurantId_, "In Progress");
+void KitchenView::renderColumn(const std::string& status, Wt::WContainerWidget* container)
+{
+    bool pending = status == "Pending";
+    container->clear();
 
-        if (inProgress.empty()) {
-            inProgressContainer_->addWidget(std::make_unique<Wt::WText>(
-                "<p class='empty-msg'>No orders in progress</p>"));
-        }
+    std::vector<const OrderDto*> orders;
+    for (auto& entry : board_->orders()) {
+        if (entry.second.status == status) orders.push_back(&entry.second);
+    }
+    if (orders.empty()) {
+        container->addWidget(std::make_unique<Wt::WText>(pending
+            ? "<p class='empty-msg'>No pending orders</p>"
+            : "<p class='empty-msg'>No orders in progress</p>"));
+        return;
+    }
 
-        for (auto& order : inProgress) {
-            long long oid = order.id;
-            auto card = inProgressContainer_->addWidget(
-                std::make_unique<Wt::WContainerWidget>());
-            card->addStyleClass("kitchen-card progress-card");
-
-            auto hdr = card->addWidget(std::make_unique<Wt::WContainerWidget>());
-            hdr->addStyleClass("kitchen-card-header");
-            hdr->addWidget(std::make_unique<Wt::WText>(
-                "Order #" + std::to_string(oid)))->addStyleClass("order-id");
-            hdr->addWidget(std::make_unique<Wt::WText>(
-                "Table " + std::to_string(order.table_number)))->addStyleClass("order-table");
-
-            auto items = api_->getOrderItems(oid);
-            auto itemsList = card->addWidget(std::make_unique<Wt::WContainerWidget>());
-            itemsList->addStyleClass("kitchen-items");
-            for (auto& oi : items) {
-                auto line = itemsList->addWidget(std::make_unique<Wt::WContainerWidget>());
-                line->addStyleClass("kitchen-item-line");
-                line->addWidget(std::make_unique<Wt::WText>(
-                    std::to_string(oi.quantity) + "x "));
-                line->addWidget(std::make_unique<Wt::WText>(oi.menu_item_name))
-                    ->addStyleClass("item-name-bold");
-            }
+    for (const OrderDto* o : orders) {
+        long long oid = o->id;
+        auto card = container->addWidget(OrderCardCache::instance().card(
+            OrderCardCache::Layout::Kitchen, *o, [&] { return board_->items(oid); }));
 
-            auto readyBtn = card->addWidget(
+        // The button, and under it the error if the change fails
+        auto action = card->bindWidget("action", std::make_unique<Wt::WContainerWidget>());
+        if (pending) {
+            auto acceptBtn = action->addWidget(
+                std::make_unique<Wt::WPushButton>("Accept Order"));
+            acceptBtn->addStyleClass("btn btn-primary btn-block");
+            acceptBtn->clicked().connect([this, oid, acceptBtn] {
+                acceptBtn->disable();
+                acceptOrder(oid, acceptBtn);
+            });
+        } else {
+            auto readyBtn = action->addWidget(
                 std::make_unique<Wt::WPushButton>("Mark Ready"));
             readyBtn->addStyleClass("btn btn-success btn-block");
-            readyBtn->clicked().connect([this, oid] { markReady(oid); });
+            readyBtn->clicked().connect([this, oid, readyBtn] {
+                readyBtn->disable();
+                markReady(oid, readyBtn);
+            });
         }
     }
 }
 
-void KitchenView::acceptOrder(long long orderId) {
-    api_->updateOrderStatus(orderId, "In Progress");
-    refreshOrders();
+void KitchenView::acceptOrder(long long orderId, Wt::WPushButton* button) {
+    setStatus(orderId, "In Progress", button);
 }
 
-void KitchenView::markReady(long long orderId) {
-    api_->updateOrderStatus(orderId, "Ready");
-    refreshOrders();
+void KitchenView::markReady(long long orderId, Wt::WPushButton* button) {
+    setStatus(orderId, "Ready", button);
+}
+
+void KitchenView::setStatus(long long orderId, const std::string& status,
+                            Wt::WPushButton* button) {
+    // A board published meanwhile redraws the card and deletes the button
+    Wt::Core::observing_ptr<Wt::WPushButton> pressed(button);
+    api_->updateOrderStatus(orderId, status,
+        sessionCallback<bool>(this, [this, orderId, pressed](ApiResult<bool> result) {
+            if (!result.ok()) {
+                std::cerr << "[KitchenView] Order #" << orderId << ": "
+                          << result.error << std::endl;
+                // The feed only redraws on a change, so undo the click here
+                if (pressed) showActionError(pressed.get());
+            }
+            // Every kitchen screen sees the change, not only this one
+            feed_->pollNow(restaurantId_);
+        }));
+}
+
+void KitchenView::showActionError(Wt::WPushButton* button) {
+    button->enable();
+    auto action = static_cast<Wt::WContainerWidget*>(button->parent());
+    if (action->count() == 1) {
+        action->addWidget(std::make_unique<Wt::WText>("Could not update the order, try again"))
+            ->addStyleClass("action-error");
+    }
 }
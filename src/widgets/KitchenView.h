@@ -3,26 +3,39 @@
 #include <Wt/WContainerWidget.h>
 #include <Wt/WText.h>
 #include <Wt/WPushButton.h>
-#include <Wt/WTimer.h>
 #include <memory>
+#include <string>
+#include <vector>
 
-#include "../services/IApiService.h"
+#include "../services/IAsyncApiService.h"
+#include "../ui/OrderFeed.h"
+#include "../ui/PageVisibility.h"
 
 class KitchenView : public Wt::WContainerWidget {
 public:
-    KitchenView(std::shared_ptr<IApiService> api, long long restaurantId);
+    KitchenView(std::shared_ptr<IAsyncApiService> api, std::shared_ptr<OrderFeed> feed,
+                long long restaurantId);
+    ~KitchenView() override;
 
 private:
     void buildPendingPanel(Wt::WContainerWidget* parent);
     void buildInProgressPanel(Wt::WContainerWidget* parent);
-    void refreshOrders();
-    void acceptOrder(long long orderId);
-    void markReady(long long orderId);
+    void showLoadError(const std::string& error);
+    void renderColumns();
+    void renderColumn(const std::string& status, Wt::WContainerWidget* container);
+    void acceptOrder(long long orderId, Wt::WPushButton* button);
+    void markReady(long long orderId, Wt::WPushButton* button);
+    void setStatus(long long orderId, const std::string& status, Wt::WPushButton* button);
+    void showActionError(Wt::WPushButton* button);
 
-    std::shared_ptr<IApiService> api_;
+    std::shared_ptr<IAsyncApiService> api_;
+    std::shared_ptr<OrderFeed> feed_;
     long long restaurantId_;
+    long long subscription_ = 0;
+
+    OrderFeed::Board board_;    // Pending and In Progress, as last published
 
     Wt::WContainerWidget* pendingContainer_ = nullptr;
     Wt::WContainerWidget* inProgressContainer_ = nullptr;
-    Wt::WTimer* refreshTimer_ = nullptr;
+    PageVisibility* visibility_ = nullptr;
 };
@@ -1,14 +1,18 @@
 #include "ManagerView.h"
 #include "../ui/RestaurantApp.h"
+#include "../ui/SessionFootprint.h"
+#include "../ui/SessionPost.h"
 
 #include <Wt/WBreak.h>
 #include <Wt/WTemplate.h>
+#include <Wt/WTimer.h>
 #include <sstream>
 #include <iomanip>
 
-ManagerView::ManagerView(std::shared_ptr<IApiService> api, long long restaurantId,
+ManagerView::ManagerView(std::shared_ptr<IApiService> api,
+                         std::shared_ptr<MenuCatalog> menus, long long restaurantId,
                          RestaurantApp* app)
-    : api_(api), restaurantId_(restaurantId), app_(app)
+    : api_(api), menus_(menus), restaurantId_(restaurantId), app_(app)
 {
     addStyleClass("manager-view");
 
@@ -17,27 +21,73 @@ ManagerView::ManagerView(std::shared_ptr<IApiService> api, long long restaurantI
     dashRow->addStyleClass("dashboard-stats");
     buildDashboard(dashRow);
 
-    // Tab widget for main content areas
+    // Tab widget for main content areas.  Panels are built when their tab
+    // is first shown and kept afterwards, unless the session goes over its
+    // memory budget while they are hidden.  Settings is never evicted, as
+    // it may hold unsaved edits.
     auto tabs = addWidget(std::make_unique<Wt::WTabWidget>());
     tabs->addStyleClass("manager-tabs");
+    tabWidget_ = tabs;
+    int orders = addLazyTab(tabs, "Orders", &ManagerView::buildOrdersPanel,
+                            &ManagerView::dropOrdersPanel);
+    int menu = addLazyTab(tabs, "Menu", &ManagerView::buildMenuPanel,
+                          &ManagerView::dropMenuPanel);
+    addLazyTab(tabs, "Settings", &ManagerView::buildConfigPanel);
+    evictWhenHidden(orders, "manager_orders",
+                    [this] { return ordersModel_ ? ordersModel_->heldBytes() : 0; });
+    evictWhenHidden(menu, "manager_menu");
+    tabs->currentChanged().connect(this, &ManagerView::showTab);
+
+    // Even the open tab waits until after the first paint, which then
+    // carries the dashboard only; the menu loads meanwhile
+    menus_->prefetch(restaurantId_);
+    Wt::WTimer::singleShot(std::chrono::milliseconds(0), bindSafe([this, tabs] {
+        showTab(tabs->currentIndex());
+    }));
+}
+
+int ManagerView::addLazyTab(Wt::WTabWidget* tabs, const char* label, PanelBuilder build,
+                            PanelDropper drop) {
+    auto panel = std::make_unique<Wt::WContainerWidget>();
+    panel->addStyleClass("panel manager-panel");
+    tabs_.push_back({panel.get(), build, drop, false});
+    tabs->addTab(std::move(panel), label);
+    return (int)tabs_.size() - 1;
+}
+
+void ManagerView::evictWhenHidden(int index, const std::string& name,
+                                  std::function<size_t()> heldBytes) {
+    if (!app_) return;
+    app_->footprint().addPanel(
+        tabs_[index].panel, name,
+        [this, index] { return tabs_[index].built && tabWidget_->currentIndex() != index; },
+        [this, index] { evictTab(index); }, std::move(heldBytes));
+}
+
+void ManagerView::showTab(int index) {
+    if (index < 0 || index >= (int)tabs_.size() || tabs_[index].built) return;
+    tabs_[index].built = true;
+    (this->*tabs_[index].build)(tabs_[index].panel);
+}
+
+void ManagerView::evictTab(int index) {
+    LazyTab& tab = tabs_[index];
+    if (!tab.built || !tab.drop) return;
+    (this->*tab.drop)();
+    tab.panel->clear();
+    tab.built = false;
+}
+
+void ManagerView::dropOrdersPanel() {
+    ordersTable_ = nullptr;
+    ordersModel_.reset();
+    ordersFilter_ = nullptr;
+    cancelOrderBtn_ = nullptr;
+    serveOrderBtn_ = nullptr;
+}
 
-    // Orders tab
-    auto ordersTab = std::make_unique<Wt::WContainerWidget>();
-    ordersTab->addStyleClass("panel manager-panel");
-    buildOrdersPanel(ordersTab.get());
-    tabs->addTab(std::move(ordersTab), "Orders");
-
-    // Menu Management tab
-    auto menuTab = std::make_unique<Wt::WContainerWidget>();
-    menuTab->addStyleClass("panel manager-panel");
-    buildMenuPanel(menuTab.get());
-    tabs->addTab(std::move(menuTab), "Menu");
-
-    // Site Configuration tab
-    auto configTab = std::make_unique<Wt::WContainerWidget>();
-    configTab->addStyleClass("panel manager-panel");
-    buildConfigPanel(configTab.get());
-    tabs->addTab(std::move(configTab), "Settings");
+void ManagerView::dropMenuPanel() {
+    menuContainer_ = nullptr;
 }
 
 void ManagerView::buildDashboard(Wt::WContainerWidget* parent) {
@@ -61,99 +111,130 @@ void ManagerView::buildDashboard(Wt::WContainerWidget* parent) {
     if (app_) {
         app_->setRefreshClickTarget([this] {
             refreshDashboard();
-            refreshOrders();
-            refreshMenu();
+            if (ordersModel_) refreshOrders();
+            if (menuContainer_) refreshMenu();
         });
         app_->setHeaderRefreshVisible(true);
     }
 }
 
 void ManagerView::refreshDashboard() {
-    statTotalOrders_->setText(std::to_string(api_->getOrderCount(restaurantId_)));
+    auto money = [](double v) {
+        std::stringstream ss;
+        ss << "$" << std::fixed << std::setprecision(2) << v;
+        return ss.str();
+    };
+
+    std::shared_ptr<IAsyncApiService> async = app_ ? app_->asyncApi() : nullptr;
+    if (!async) {
+        setStat(statTotalOrders_, std::to_string(api_->getOrderCount(restaurantId_)));
+        setStat(statRevenue_, money(api_->getRevenue(restaurantId_)));
+        setStat(statPending_, std::to_string(api_->getPendingOrderCount(restaurantId_)));
+        setStat(statInProgress_, std::to_string(api_->getInProgressOrderCount(restaurantId_)));
+        return;
+    }
 
-    std::stringstream ss;
-    ss << "$" << std::fixed << std::setprecision(2) << api_->getRevenue(restaurantId_);
-    statRevenue_->setText(ss.str());
+    // All four in flight at once; each card fills in as its result arrives
+    for (auto stat : {statTotalOrders_, statRevenue_, statPending_, statInProgress_})
+        stat->addStyleClass("stat-loading");
 
-    statPending_->setText(std::to_string(api_->getPendingOrderCount(restaurantId_)));
-    statInProgress_->setText(std::to_string(api_->getInProgressOrderCount(restaurantId_)));
+    auto intStat = [this](Wt::WText* stat) {
+        return sessionCallback<int>(this, [this, stat](ApiResult<int> r) {
+            setStat(stat, r.ok() ? std::to_string(r.value) : "--");
+        });
+    };
+    async->getOrderCount(restaurantId_, intStat(statTotalOrders_));
+    async->getPendingOrderCount(restaurantId_, intStat(statPending_));
+    async->getInProgressOrderCount(restaurantId_, intStat(statInProgress_));
+    async->getRevenue(restaurantId_,
+        sessionCallback<double>(this, [this, money](ApiResult<double> r) {
+            setStat(statRevenue_, r.ok() ? money(r.value) : "--");
+        }));
+}
+
+void ManagerView::setStat(Wt::WText* stat, const std::string& text) {
+    stat->setText(text);
+    stat->removeStyleClass("stat-loading");
 }
 
 void ManagerView::buildOrdersPanel(Wt::WContainerWidget* parent) {
     auto header = parent->addWidget(std::make_unique<Wt::WText>("<h3>Orders</h3>"));
     header->addStyleClass("panel-title");
 
-    ordersContainer_ = parent->addWidget(std::make_unique<Wt::WContainerWidget>());
-    ordersContainer_->addStyleClass("orders-list");
-    refreshOrders();
-}
+    // Toolbar: status filter, then actions on the selected order
+    auto toolbar = parent->addWidget(std::make_unique<Wt::WContainerWidget>());
+    toolbar->addStyleClass("orders-toolbar");
 
-void ManagerView::refreshOrders() {
-    ordersContainer_->clear();
+    ordersFilter_ = toolbar->addWidget(std::make_unique<Wt::WComboBox>());
+    ordersFilter_->addStyleClass("form-control orders-filter");
+    for (const char* label : {"All statuses", "Pending", "In Progress", "Ready",
+                              "Served", "Cancelled"}) {
+        ordersFilter_->addItem(label);
+    }
+    ordersFilter_->changed().connect([this] {
+        ordersModel_->setStatusFilter(ordersFilter_->currentIndex() == 0
+                                          ? "" : ordersFilter_->currentText().toUTF8());
+        updateOrderActions();
+    });
 
-    auto orders = api_->getOrders(restaurantId_);
+    cancelOrderBtn_ = toolbar->addWidget(std::make_unique<Wt::WPushButton>("Cancel"));
+    cancelOrderBtn_->addStyleClass("btn btn-danger btn-sm");
+    cancelOrderBtn_->clicked().connect([this] {
+        if (const OrderDto* order = selectedOrder()) {
+            api_->cancelOrder(order->id);
+            refreshOrders();
+            refreshDashboard();
+        }
+    });
 
-    if (orders.empty()) {
-        ordersContainer_->addWidget(std::make_unique<Wt::WText>(
-            "<p class='empty-msg'>No orders yet</p>"));
-        return;
-    }
+    serveOrderBtn_ = toolbar->addWidget(std::make_unique<Wt::WPushButton>("Mark Served"));
+    serveOrderBtn_->addStyleClass("btn btn-success btn-sm");
+    serveOrderBtn_->clicked().connect([this] {
+        if (const OrderDto* order = selectedOrder()) {
+            api_->updateOrderStatus(order->id, "Served");
+            refreshOrders();
+            refreshDashboard();
+        }
+    });
 
-    auto table = ordersContainer_->addWidget(std::make_unique<Wt::WTable>());
-    table->addStyleClass("data-table");
-    table->setHeaderCount(1);
-    table->elementAt(0, 0)->addWidget(std::make_unique<Wt::WText>("#"));
-    table->elementAt(0, 1)->addWidget(std::make_unique<Wt::WText>("Table"));
-    table->elementAt(0, 2)->addWidget(std::make_unique<Wt::WText>("Customer"));
-    table->elementAt(0, 3)->addWidget(std::make_unique<Wt::WText>("Total"));
-    table->elementAt(0, 4)->addWidget(std::make_unique<Wt::WText>("Status"));
-    table->elementAt(0, 5)->addWidget(std::make_unique<Wt::WText>("Actions"));
-
-    int row = 1;
-    for (auto& order : orders) {
-        long long oid = order.id;
-        table->elementAt(row, 0)->addWidget(
-            std::make_unique<Wt::WText>(std::to_string(oid)));
-        table->elementAt(row, 1)->addWidget(
-            std::make_unique<Wt::WText>(std::to_string(order.table_number)));
-        table->elementAt(row, 2)->addWidget(
-            std::make_unique<Wt::WText>(order.customer_name));
+    // Newest first until a header is clicked; sorting is done by the backend
+    ordersModel_ = std::make_shared<OrdersTableModel>(api_, restaurantId_);
+    ordersTable_ = parent->addWidget(std::make_unique<Wt::WTableView>());
+    ordersTable_->addStyleClass("orders-table");
+    ordersTable_->setModel(ordersModel_);
+    ordersTable_->setSortingEnabled(true);
+    ordersTable_->setSelectionMode(Wt::SelectionMode::Single);
+    ordersTable_->setSelectionBehavior(Wt::SelectionBehavior::Rows);
+    ordersTable_->setAlternatingRowColors(true);
+    ordersTable_->setHeaderHeight(36);
+    ordersTable_->setRowHeight(36);
+    ordersTable_->setHeight(480);
+    ordersTable_->setColumnWidth(OrdersTableModel::Id, 80);
+    ordersTable_->setColumnWidth(OrdersTableModel::Table, 70);
+    ordersTable_->setColumnWidth(OrdersTableModel::Customer, 220);
+    ordersTable_->setColumnWidth(OrdersTableModel::Total, 100);
+    ordersTable_->setColumnWidth(OrdersTableModel::Status, 130);
+    ordersTable_->setColumnWidth(OrdersTableModel::Created, 170);
+    ordersTable_->selectionChanged().connect(this, &ManagerView::updateOrderActions);
+
+    updateOrderActions();
+}
 
-        std::stringstream ss;
-        ss << "$" << std::fixed << std::setprecision(2) << order.total;
-        table->elementAt(row, 3)->addWidget(std::make_unique<Wt::WText>(ss.str()));
-
-        auto statusText = table->elementAt(row, 4)->addWidget(
-            std::make_unique<Wt::WText>(order.status));
-        statusText->addStyleClass("status-badge status-" +
-            std::string(order.status == "Pending" ? "pending" :
-                       order.status == "In Progress" ? "progress" :
-                       order.status == "Ready" ? "ready" :
-                       order.status == "Served" ? "served" : "cancelled"));
-
-        if (order.status != "Served" && order.status != "Cancelled") {
-            auto cancelBtn = table->elementAt(row, 5)->addWidget(
-                std::make_unique<Wt::WPushButton>("Cancel"));
-            cancelBtn->addStyleClass("btn btn-danger btn-sm");
-            cancelBtn->clicked().connect([this, oid] {
-                api_->cancelOrder(oid);
-                refreshOrders();
-                refreshDashboard();
-            });
+void ManagerView::refreshOrders() {
+    ordersModel_->refresh();    // also clears the selection
+    updateOrderActions();
+}
 
-            if (order.status == "Ready") {
-                auto serveBtn = table->elementAt(row, 5)->addWidget(
-                    std::make_unique<Wt::WPushButton>("Mark Served"));
-                serveBtn->addStyleClass("btn btn-success btn-sm");
-                serveBtn->clicked().connect([this, oid] {
-                    api_->updateOrderStatus(oid, "Served");
-                    refreshOrders();
-                    refreshDashboard();
-                });
-            }
-        }
-        row++;
-    }
+const OrderDto* ManagerView::selectedOrder() const {
+    auto selected = ordersTable_->selectedIndexes();
+    return selected.empty() ? nullptr : ordersModel_->order(selected.begin()->row());
+}
+
+void ManagerView::updateOrderActions() {
+    const OrderDto* order = selectedOrder();
+    bool open = order && order->status != "Served" && order->status != "Cancelled";
+    cancelOrderBtn_->setEnabled(open);
+    serveOrderBtn_->setEnabled(open && order->status == "Ready");
 }
 
 void ManagerView::buildMenuPanel(Wt::WContainerWidget* parent) {
@@ -168,16 +249,15 @@ void ManagerView::buildMenuPanel(Wt::WContainerWidget* parent) {
 void ManagerView::refreshMenu() {
     menuContainer_->clear();
 
-    auto categories = api_->getCategories(restaurantId_);
+    auto menu = menus_->current(restaurantId_);
 
-    for (auto& cat : categories) {
+    for (auto& cat : menu->categories) {
         auto catBlock = menuContainer_->addWidget(std::make_unique<Wt::WContainerWidget>());
         catBlock->addStyleClass("menu-category-block");
         catBlock->addWidget(std::make_unique<Wt::WText>(
             "<h4>" + cat.name + "</h4>"))->addStyleClass("category-title");
 
-        auto items = api_->getMenuItemsByCategory(cat.id);
-        for (auto& item : items) {
+        for (auto& item : menu->items(cat.id)) {
             long long itemId = item.id;
             auto itemRow = catBlock->addWidget(std::make_unique<Wt::WContainerWidget>());
             itemRow->addStyleClass("menu-item-row");
@@ -194,7 +274,8 @@ void ManagerView::refreshMenu() {
             toggle->setChecked(item.available);
             toggle->addStyleClass("menu-item-toggle");
             toggle->changed().connect([this, itemId, toggle] {
-                api_->updateMenuItemAvailability(itemId, toggle->isChecked());
+                // Through the catalog, so every session's menu sees it
+                menus_->setAvailability(restaurantId_, itemId, toggle->isChecked());
             });
         }
     }
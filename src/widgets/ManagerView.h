@@ -2,43 +2,83 @@
 
 #include <Wt/WContainerWidget.h>
 #include <Wt/WText.h>
-#include <Wt/WTable.h>
+#include <Wt/WTableView.h>
 #include <Wt/WPushButton.h>
 #include <Wt/WComboBox.h>
 #include <Wt/WCheckBox.h>
 #include <Wt/WLineEdit.h>
 #include <Wt/WTabWidget.h>
+#include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "../services/IApiService.h"
+#include "../services/IAsyncApiService.h"
+#include "../services/MenuCatalog.h"
+#include "../ui/OrdersTableModel.h"
 
 class RestaurantApp;
 
 class ManagerView : public Wt::WContainerWidget {
 public:
-    ManagerView(std::shared_ptr<IApiService> api, long long restaurantId,
-                RestaurantApp* app = nullptr);
+    ManagerView(std::shared_ptr<IApiService> api, std::shared_ptr<MenuCatalog> menus,
+                long long restaurantId, RestaurantApp* app = nullptr);
 
 private:
+    using PanelBuilder = void (ManagerView::*)(Wt::WContainerWidget*);
+    using PanelDropper = void (ManagerView::*)();
+    // Returns the tab's index; `drop` is needed for evictWhenHidden()
+    int addLazyTab(Wt::WTabWidget* tabs, const char* label, PanelBuilder build,
+                   PanelDropper drop = nullptr);
+    // Lets the session's footprint empty the panel while another tab is shown
+    void evictWhenHidden(int index, const std::string& name,
+                         std::function<size_t()> heldBytes = nullptr);
+    void showTab(int index);    // builds the tab's panel the first time
+    void evictTab(int index);   // empties it; the next showTab() builds it again
+    void dropOrdersPanel();
+    void dropMenuPanel();
+
     void buildDashboard(Wt::WContainerWidget* parent);
     void buildOrdersPanel(Wt::WContainerWidget* parent);
     void buildMenuPanel(Wt::WContainerWidget* parent);
     void buildConfigPanel(Wt::WContainerWidget* parent);
     void refreshDashboard();
+    void setStat(Wt::WText* stat, const std::string& text);
     void refreshOrders();
+    const OrderDto* selectedOrder() const;
+    void updateOrderActions();
     void refreshMenu();
 
     std::shared_ptr<IApiService> api_;
+    std::shared_ptr<MenuCatalog> menus_;
     long long restaurantId_;
     RestaurantApp* app_ = nullptr;
 
+    // Tab panels, in tab order; each is empty until its tab is first shown
+    // (or shown again after an eviction)
+    struct LazyTab {
+        Wt::WContainerWidget* panel;
+        PanelBuilder build;
+        PanelDropper drop;      // forgets the members pointing into the panel
+        bool built;
+    };
+    Wt::WTabWidget* tabWidget_ = nullptr;
+    std::vector<LazyTab> tabs_;
+
     // Dashboard stat widgets
     Wt::WText* statTotalOrders_ = nullptr;
     Wt::WText* statRevenue_ = nullptr;
     Wt::WText* statPending_ = nullptr;
     Wt::WText* statInProgress_ = nullptr;
 
-    Wt::WContainerWidget* ordersContainer_ = nullptr;
+    // Orders: only the rows on screen are rendered, pages come from the model
+    std::shared_ptr<OrdersTableModel> ordersModel_;
+    Wt::WTableView* ordersTable_ = nullptr;
+    Wt::WComboBox* ordersFilter_ = nullptr;
+    Wt::WPushButton* cancelOrderBtn_ = nullptr;
+    Wt::WPushButton* serveOrderBtn_ = nullptr;
+
     Wt::WContainerWidget* menuContainer_ = nullptr;
 
     // Config form fields
@@ -1,24 +1,68 @@
 #include "MobileFrontDeskView.h"
+#include "../ui/OrderCardCache.h"
 #include "../ui/RestaurantApp.h"
+#include "../ui/SessionFootprint.h"
+#include "../ui/SessionPost.h"
 
 #include <Wt/WBreak.h>
+#include <Wt/WRandom.h>
 #include <Wt/WTable.h>
+#include <Wt/WTemplate.h>
 #include <sstream>
 #include <iomanip>
 
 // ─── Constructor ─────────────────────────────────────────────────────────────
 
 MobileFrontDeskView::MobileFrontDeskView(
-    std::shared_ptr<IApiService> api, long long restaurantId,
+    std::shared_ptr<IApiService> api, std::shared_ptr<MenuCatalog> menus,
+    std::shared_ptr<OrderSubmitter> submitter, long long restaurantId,
     RestaurantApp* app, bool isTablet)
-    : api_(api), restaurantId_(restaurantId), app_(app), isTablet_(isTablet)
+    : api_(api), menus_(menus), submitter_(submitter), restaurantId_(restaurantId), app_(app),
+      isTablet_(isTablet)
 {
     addStyleClass("m-frontdesk");
+    cart_ = addChild(std::make_unique<ClientCart>(this, menus_, restaurantId_));
+    cart_->received().connect([this] {
+        // The order form also says what was left out as unavailable
+        if (!cart_->lines().empty() || !cart_->unavailable().empty())
+            navigateTo(MobileScreen::OrderForm);
+    });
 
     // Screen area (fills between header and tab bar)
     screenContainer_ = addWidget(std::make_unique<Wt::WContainerWidget>());
     screenContainer_->addStyleClass("m-screen-container");
 
+    // Tablet menu browser: built on first visit, then only shown and hidden
+    if (isTablet_) {
+        menuScreen_ = addWidget(std::make_unique<Wt::WContainerWidget>());
+        menuScreen_->addStyleClass("m-screen-container m-split-mode");
+        menuScreen_->hide();
+
+        // Category tap: move "active" to the row and its items pane
+        selectCategory_.setJavaScript(
+            "function(o, e) {"
+            "  var split = o.closest('.m-menu-split');"
+            "  split.querySelectorAll('.m-cat-item.active, .m-items-panel.active')"
+            "    .forEach(function(el) { el.classList.remove('active'); });"
+            "  o.classList.add('active');"
+            "  document.getElementById(o.getAttribute('data-pane')).classList.add('active');"
+            "}");
+
+        // The heaviest screen here; over the session's budget it is dropped
+        // while another screen is up, and built again on the next visit
+        if (app_) {
+            app_->footprint().addPanel(
+                menuScreen_, "tablet_menu",
+                [this] { return menuScreen_->count() > 0 && menuScreen_->isHidden(); },
+                [this] {
+                    menuScreen_->clear();
+                    menuCards_.clear();
+                    categoryCounts_.clear();
+                    menu_.reset();
+                });
+        }
+    }
+
     // Register header cart bubble click to navigate to cart
     if (app_) {
         app_->setCartClickTarget([this] {
@@ -29,6 +73,40 @@ MobileFrontDeskView::MobileFrontDeskView(
     // Bottom tab bar
     buildTabBar();
 
+    // Cart counts, and the cart screen while it is up, follow every tap in
+    // the browser
+    cart_->addRenderer(
+        "function(cart) {"
+        "  var n = cart.count();"
+        "  document.getElementById('" + cartBadge_->id() + "').textContent = n ? n : '';"
+        "}");
+    cart_->addRenderer(
+        "function(cart) {"
+        "  var list = cart.root.querySelector('.m-cart-list');"
+        "  if (!list) return;"
+        "  var empty = !cart.lines.length;"
+        "  cart.root.querySelector('.m-cart-empty').style.display = empty ? '' : 'none';"
+        "  cart.root.querySelector('.m-cart-footer').style.display = empty ? 'none' : '';"
+        "  cart.root.querySelector('.m-cart-total-amount').textContent ="
+        "    cart.money(cart.total());"
+        "  list.innerHTML = cart.lines.map(function(l) {"
+        "    var item = ' data-item=\"' + l.id + '\"';"
+        "    return '<div class=\"m-cart-row\"><div class=\"m-cart-item-info\">' +"
+        "      '<span class=\"m-cart-item-name\">' + cart.esc(l.name) + '</span>' +"
+        "      '<span class=\"m-cart-item-price\">' + cart.money(l.price * l.qty) +"
+        "      '</span></div><div class=\"m-stepper\">' +"
+        "      '<button type=\"button\" class=\"m-stepper-btn\" data-cart=\"' +"
+        "        (l.qty > 1 ? 'dec' : 'remove') + '\"' + item + '>-</button>' +"
+        "      '<span class=\"m-stepper-value\">' + l.qty + '</span>' +"
+        "      '<button type=\"button\" class=\"m-stepper-btn\" data-cart=\"inc\"' +"
+        "        item + '>+</button></div></div>';"
+        "  }).join('');"
+        "}");
+    if (app_) {
+        app_->setHeaderCartVisible(true);
+        cart_->addRenderer(app_->headerCartRenderer());
+    }
+
     // Start on Categories screen
     navigateTo(MobileScreen::Categories);
 }
@@ -64,9 +142,8 @@ void MobileFrontDeskView::buildTabBar() {
         "<svg width='22' height='22' viewBox='0 0 24 24' fill='none' stroke='currentColor' stroke-width='2'>"
         "<circle cx='9' cy='21' r='1'/><circle cx='20' cy='21' r='1'/>"
         "<path d='M1 1h4l2.68 13.39a2 2 0 0 0 2 1.61h9.72a2 2 0 0 0 2-1.61L23 6H6'/></svg>"));
-    cartBadge_ = cartIconWrap->addWidget(std::make_unique<Wt::WText>("0"));
-    cartBadge_->addStyleClass("m-cart-badge");
-    cartBadge_->setHidden(true);
+    cartBadge_ = cartIconWrap->addWidget(std::make_unique<Wt::WText>());
+    cartBadge_->addStyleClass("m-cart-badge");    // hidden while empty
     cartInner->addWidget(std::make_unique<Wt::WText>("Cart"));
     tabCart_->clicked().connect([this] {
         navigateTo(MobileScreen::Cart);
@@ -118,18 +195,19 @@ void MobileFrontDeskView::navigateTo(MobileScreen screen) {
             break;
     }
 
-    // Show/hide floating cart bubble based on screen
-    updateCartBubble();
-
-    // Clear and rebuild screen
+    // Clear and rebuild screen; the tablet menu browser is kept instead
+    bool menuBrowser = isTablet_ && (screen == MobileScreen::Categories ||
+                                     screen == MobileScreen::MenuItems);
     screenContainer_->clear();
-    screenContainer_->removeStyleClass("m-split-mode");
+    screenContainer_->setHidden(menuBrowser);
+    if (menuScreen_) menuScreen_->setHidden(!menuBrowser);
 
     switch (screen) {
         case MobileScreen::Categories:
             screenHistory_.clear(); // root screen
             if (isTablet_) {
-                buildMenuBrowserScreen();
+                if (menuScreen_->count() == 0) buildMenuBrowserScreen();
+                else refreshMenuAvailability();
             } else {
                 buildCategoriesScreen();
             }
@@ -137,7 +215,8 @@ void MobileFrontDeskView::navigateTo(MobileScreen screen) {
         case MobileScreen::MenuItems:
             if (isTablet_) {
                 screenHistory_.clear();
-                buildMenuBrowserScreen();
+                if (menuScreen_->count() == 0) buildMenuBrowserScreen();
+                else refreshMenuAvailability();
             } else {
                 buildMenuItemsScreen();
             }
@@ -149,7 +228,7 @@ void MobileFrontDeskView::navigateTo(MobileScreen screen) {
             buildOrderFormScreen();
             break;
         case MobileScreen::Confirmation:
-            buildConfirmationScreen(lastOrderId_);
+            buildConfirmationScreen();
             break;
         case MobileScreen::ActiveOrders:
             buildActiveOrdersScreen();
@@ -171,72 +250,124 @@ void MobileFrontDeskView::navigateBack() {
 }
 
 // ─── Menu Browser (split panel: categories left, items right) ────────────────
+// The whole menu goes to the browser once: one items pane per category, all
+// but the selected one hidden by CSS.  Category taps run selectCategory_ in
+// the browser.  Unavailable items are rendered hidden, so an availability
+// change in the MenuCatalog snapshot is a show/hide rather than a redraw.
 
 void MobileFrontDeskView::buildMenuBrowserScreen() {
+    menuScreen_->clear();
+    menuCards_.clear();
+    categoryCounts_.clear();
+    menu_ = menus_->current(restaurantId_);
+
     // Screen header
-    auto header = screenContainer_->addWidget(std::make_unique<Wt::WContainerWidget>());
+    auto header = menuScreen_->addWidget(std::make_unique<Wt::WContainerWidget>());
     header->addStyleClass("m-screen-header");
     header->addWidget(std::make_unique<Wt::WText>("Menu"))
         ->addStyleClass("m-screen-title");
 
-    // Mark container for split-mode CSS (fallback for :has())
-    screenContainer_->addStyleClass("m-split-mode");
-
     // Split container: categories left, items right
-    auto split = screenContainer_->addWidget(std::make_unique<Wt::WContainerWidget>());
+    auto split = menuScreen_->addWidget(std::make_unique<Wt::WContainerWidget>());
     split->addStyleClass("m-menu-split");
 
     // ── Left: Category list ──
     auto catPanel = split->addWidget(std::make_unique<Wt::WContainerWidget>());
     catPanel->addStyleClass("m-cat-panel");
 
-    auto categories = api_->getCategories(restaurantId_);
+    if (menu_->categories.empty()) {
+        auto empty = split->addWidget(std::make_unique<Wt::WContainerWidget>());
+        empty->addStyleClass("m-items-panel active");
+        empty->addWidget(std::make_unique<Wt::WText>("No menu categories"))
+            ->addStyleClass("m-empty-title");
+        return;
+    }
 
     bool firstCat = true;
-    for (auto& cat : categories) {
-        long long catId = cat.id;
-        std::string catName = cat.name;
+    for (auto& cat : menu_->categories) {
+        // ── Right: this category's items pane ──
+        auto pane = split->addWidget(std::make_unique<Wt::WContainerWidget>());
+        pane->addStyleClass(firstCat ? "m-items-panel active" : "m-items-panel");
+        pane->addWidget(std::make_unique<Wt::WText>(cat.name))
+            ->addStyleClass("m-items-panel-title");
+
+        auto list = pane->addWidget(std::make_unique<Wt::WContainerWidget>());
+        list->addStyleClass("m-items-list");
+
+        for (auto& item : menu_->items(cat.id)) {
+            auto card = list->addWidget(std::make_unique<Wt::WContainerWidget>());
+            card->addStyleClass("m-item-card");
+            card->setHidden(!item.available);
+            menuCards_[item.id] = {card, cat.id, item.available};
+
+            auto info = card->addWidget(std::make_unique<Wt::WContainerWidget>());
+            info->addStyleClass("m-item-info");
+
+            info->addWidget(std::make_unique<Wt::WText>(item.name))
+                ->addStyleClass("m-item-name");
+            info->addWidget(std::make_unique<Wt::WText>(item.description))
+                ->addStyleClass("m-item-desc");
 
-        // Auto-select first category if none selected
-        if (firstCat && currentCategoryId_ < 0) {
-            currentCategoryId_ = catId;
-            currentCategoryName_ = catName;
+            std::stringstream ss;
+            ss << "$" << std::fixed << std::setprecision(2) << item.price;
+            info->addWidget(std::make_unique<Wt::WText>(ss.str()))
+                ->addStyleClass("m-item-price");
+
+            auto addBtn = card->addWidget(
+                std::make_unique<Wt::WPushButton>("+ Add"));
+            addBtn->addStyleClass("m-add-btn");
+            cart_->bindAdd(addBtn, item);
         }
 
+        // ── Left: its row ──
         auto row = catPanel->addWidget(std::make_unique<Wt::WContainerWidget>());
-        row->addStyleClass("m-cat-item");
-        if (catId == currentCategoryId_) {
-            row->addStyleClass("active");
-        }
+        row->addStyleClass(firstCat ? "m-cat-item active" : "m-cat-item");
+        row->setAttributeValue("data-pane", pane->id());
 
-        row->addWidget(std::make_unique<Wt::WText>(catName))
+        row->addWidget(std::make_unique<Wt::WText>(cat.name))
             ->addStyleClass("m-cat-name");
+        categoryCounts_[cat.id] = row->addWidget(
+            std::make_unique<Wt::WText>(std::to_string(menu_->availableCount(cat.id))));
+        categoryCounts_[cat.id]->addStyleClass("m-cat-count");
 
-        // Count available items
-        auto items = api_->getMenuItemsByCategory(catId);
-        int availCount = 0;
-        for (auto& item : items) {
-            if (item.available) availCount++;
-        }
-        row->addWidget(std::make_unique<Wt::WText>(std::to_string(availCount)))
-            ->addStyleClass("m-cat-count");
-
-        row->clicked().connect([this, catId, catName] {
-            currentCategoryId_ = catId;
-            currentCategoryName_ = catName;
-            // Rebuild entire browser to update active state and items
-            screenContainer_->clear();
-            buildMenuBrowserScreen();
-        });
-
+        row->clicked().connect(selectCategory_);
         firstCat = false;
     }
+}
 
-    // ── Right: Items panel ──
-    itemsPanel_ = split->addWidget(std::make_unique<Wt::WContainerWidget>());
-    itemsPanel_->addStyleClass("m-items-panel");
+void MobileFrontDeskView::refreshMenuAvailability() {
+    auto latest = menus_->current(restaurantId_);
+    if (latest == menu_) return;
+
+    // Categories or items added, removed or moved: draw the menu again
+    bool sameLayout = latest->categories.size() == menu_->categories.size();
+    for (size_t i = 0; sameLayout && i < latest->categories.size(); i++) {
+        long long catId = latest->categories[i].id;
+        sameLayout = catId == menu_->categories[i].id &&
+                     latest->items(catId).size() == menu_->items(catId).size();
+        for (size_t j = 0; sameLayout && j < latest->items(catId).size(); j++) {
+            sameLayout = latest->items(catId)[j].id == menu_->items(catId)[j].id;
+        }
+    }
+    if (!sameLayout) {
+        buildMenuBrowserScreen();
+        return;
+    }
 
-    refreshItemsPanel();
+    menu_ = latest;
+    for (auto& cat : menu_->categories) {
+        bool changed = false;
+        for (auto& item : menu_->items(cat.id)) {
+            MenuCard& mc = menuCards_[item.id];
+            if (mc.available == item.available) continue;
+            mc.available = item.available;
+            mc.card->setHidden(!item.available);
+            changed = true;
+        }
+        if (changed) {
+            categoryCounts_[cat.id]->setText(std::to_string(menu_->availableCount(cat.id)));
+        }
+    }
 }
 
 void MobileFrontDeskView::showCategoryItems(
@@ -244,63 +375,7 @@ void MobileFrontDeskView::showCategoryItems(
 {
     currentCategoryId_ = categoryId;
     currentCategoryName_ = categoryName;
-    // Rebuild the browser screen to update active category + items
-    screenContainer_->clear();
-    buildMenuBrowserScreen();
-}
-
-void MobileFrontDeskView::refreshItemsPanel() {
-    if (!itemsPanel_) return;
-    itemsPanel_->clear();
-
-    if (currentCategoryId_ < 0) {
-        auto empty = itemsPanel_->addWidget(std::make_unique<Wt::WContainerWidget>());
-        empty->addStyleClass("m-empty-state");
-        empty->addWidget(std::make_unique<Wt::WText>("Select a category"))
-            ->addStyleClass("m-empty-title");
-        return;
-    }
-
-    // Category title above items
-    itemsPanel_->addWidget(std::make_unique<Wt::WText>(currentCategoryName_))
-        ->addStyleClass("m-items-panel-title");
-
-    auto list = itemsPanel_->addWidget(std::make_unique<Wt::WContainerWidget>());
-    list->addStyleClass("m-items-list");
-
-    auto items = api_->getMenuItemsByCategory(currentCategoryId_);
-
-    for (auto& item : items) {
-        if (!item.available) continue;
-
-        long long itemId = item.id;
-        std::string itemName = item.name;
-        std::string itemDesc = item.description;
-        double itemPrice = item.price;
-
-        auto card = list->addWidget(std::make_unique<Wt::WContainerWidget>());
-        card->addStyleClass("m-item-card");
-
-        auto info = card->addWidget(std::make_unique<Wt::WContainerWidget>());
-        info->addStyleClass("m-item-info");
-
-        info->addWidget(std::make_unique<Wt::WText>(itemName))
-            ->addStyleClass("m-item-name");
-        info->addWidget(std::make_unique<Wt::WText>(itemDesc))
-            ->addStyleClass("m-item-desc");
-
-        std::stringstream ss;
-        ss << "$" << std::fixed << std::setprecision(2) << itemPrice;
-        info->addWidget(std::make_unique<Wt::WText>(ss.str()))
-            ->addStyleClass("m-item-price");
-
-        auto addBtn = card->addWidget(
-            std::make_unique<Wt::WPushButton>("+ Add"));
-        addBtn->addStyleClass("m-add-btn");
-        addBtn->clicked().connect([this, itemId, itemName, itemPrice] {
-            addToCart(itemId, itemName, itemPrice);
-        });
-    }
+    navigateTo(MobileScreen::MenuItems);
 }
 
 // ─── Phone: Categories Screen (sequential flow) ─────────────────────────────
@@ -314,17 +389,12 @@ void MobileFrontDeskView::buildCategoriesScreen() {
     auto list = screenContainer_->addWidget(std::make_unique<Wt::WContainerWidget>());
     list->addStyleClass("m-list");
 
-    auto categories = api_->getCategories(restaurantId_);
+    auto menu = menus_->current(restaurantId_);
 
-    for (auto& cat : categories) {
+    for (auto& cat : menu->categories) {
         long long catId = cat.id;
         std::string catName = cat.name;
-
-        auto items = api_->getMenuItemsByCategory(catId);
-        int availCount = 0;
-        for (auto& item : items) {
-            if (item.available) availCount++;
-        }
+        int availCount = menu->availableCount(catId);
 
         auto row = list->addWidget(std::make_unique<Wt::WContainerWidget>());
         row->addStyleClass("m-list-item");
@@ -366,38 +436,31 @@ void MobileFrontDeskView::buildMenuItemsScreen() {
     auto list = screenContainer_->addWidget(std::make_unique<Wt::WContainerWidget>());
     list->addStyleClass("m-items-list");
 
-    auto items = api_->getMenuItemsByCategory(currentCategoryId_);
+    auto menu = menus_->current(restaurantId_);
 
-    for (auto& item : items) {
+    for (auto& item : menu->items(currentCategoryId_)) {
         if (!item.available) continue;
 
-        long long itemId = item.id;
-        std::string itemName = item.name;
-        std::string itemDesc = item.description;
-        double itemPrice = item.price;
-
         auto card = list->addWidget(std::make_unique<Wt::WContainerWidget>());
         card->addStyleClass("m-item-card");
 
         auto info = card->addWidget(std::make_unique<Wt::WContainerWidget>());
         info->addStyleClass("m-item-info");
 
-        info->addWidget(std::make_unique<Wt::WText>(itemName))
+        info->addWidget(std::make_unique<Wt::WText>(item.name))
             ->addStyleClass("m-item-name");
-        info->addWidget(std::make_unique<Wt::WText>(itemDesc))
+        info->addWidget(std::make_unique<Wt::WText>(item.description))
             ->addStyleClass("m-item-desc");
 
         std::stringstream ss;
-        ss << "$" << std::fixed << std::setprecision(2) << itemPrice;
+        ss << "$" << std::fixed << std::setprecision(2) << item.price;
         info->addWidget(std::make_unique<Wt::WText>(ss.str()))
             ->addStyleClass("m-item-price");
 
         auto addBtn = card->addWidget(
             std::make_unique<Wt::WPushButton>("+ Add"));
         addBtn->addStyleClass("m-add-btn");
-        addBtn->clicked().connect([this, itemId, itemName, itemPrice] {
-            addToCart(itemId, itemName, itemPrice);
-        });
+        cart_->bindAdd(addBtn, item);
     }
 }
 
@@ -409,79 +472,32 @@ void MobileFrontDeskView::buildCartScreen() {
     header->addWidget(std::make_unique<Wt::WText>("Your Cart"))
         ->addStyleClass("m-screen-title");
 
-    if (cart_.empty()) {
-        auto empty = screenContainer_->addWidget(std::make_unique<Wt::WContainerWidget>());
-        empty->addStyleClass("m-empty-state");
-        empty->addWidget(std::make_unique<Wt::WText>(
-            "<svg width='48' height='48' viewBox='0 0 24 24' fill='none' stroke='currentColor' "
-            "stroke-width='1.5' opacity='0.3'><circle cx='9' cy='21' r='1'/>"
-            "<circle cx='20' cy='21' r='1'/>"
-            "<path d='M1 1h4l2.68 13.39a2 2 0 0 0 2 1.61h9.72a2 2 0 0 0 2-1.61L23 6H6'/></svg>"))
-            ->addStyleClass("m-empty-icon");
-        empty->addWidget(std::make_unique<Wt::WText>("Your cart is empty"))
-            ->addStyleClass("m-empty-title");
-        empty->addWidget(std::make_unique<Wt::WText>("Browse the menu to add items"))
-            ->addStyleClass("m-empty-subtitle");
-
-        auto browseBtn = empty->addWidget(
-            std::make_unique<Wt::WPushButton>("Browse Menu"));
-        browseBtn->addStyleClass("m-action-btn m-btn-primary");
-        browseBtn->clicked().connect([this] {
-            navigateTo(MobileScreen::Categories);
-        });
-        return;
-    }
+    // Both the empty state and the list are built: the cart is in the
+    // browser, whose renderer shows one and fills in the other
+    auto empty = screenContainer_->addWidget(std::make_unique<Wt::WContainerWidget>());
+    empty->addStyleClass("m-empty-state m-cart-empty");
+    empty->addWidget(std::make_unique<Wt::WText>(
+        "<svg width='48' height='48' viewBox='0 0 24 24' fill='none' stroke='currentColor' "
+        "stroke-width='1.5' opacity='0.3'><circle cx='9' cy='21' r='1'/>"
+        "<circle cx='20' cy='21' r='1'/>"
+        "<path d='M1 1h4l2.68 13.39a2 2 0 0 0 2 1.61h9.72a2 2 0 0 0 2-1.61L23 6H6'/></svg>"))
+        ->addStyleClass("m-empty-icon");
+    empty->addWidget(std::make_unique<Wt::WText>("Your cart is empty"))
+        ->addStyleClass("m-empty-title");
+    empty->addWidget(std::make_unique<Wt::WText>("Browse the menu to add items"))
+        ->addStyleClass("m-empty-subtitle");
+
+    auto browseBtn = empty->addWidget(
+        std::make_unique<Wt::WPushButton>("Browse Menu"));
+    browseBtn->addStyleClass("m-action-btn m-btn-primary");
+    browseBtn->clicked().connect([this] {
+        navigateTo(MobileScreen::Categories);
+    });
 
-    // Cart items list
+    // Cart items list: rows and their steppers are drawn by the browser
     auto list = screenContainer_->addWidget(std::make_unique<Wt::WContainerWidget>());
     list->addStyleClass("m-cart-list");
 
-    for (int i = 0; i < (int)cart_.size(); i++) {
-        auto& ci = cart_[i];
-        auto row = list->addWidget(std::make_unique<Wt::WContainerWidget>());
-        row->addStyleClass("m-cart-row");
-
-        auto info = row->addWidget(std::make_unique<Wt::WContainerWidget>());
-        info->addStyleClass("m-cart-item-info");
-        info->addWidget(std::make_unique<Wt::WText>(ci.name))
-            ->addStyleClass("m-cart-item-name");
-
-        std::stringstream linePrice;
-        linePrice << "$" << std::fixed << std::setprecision(2)
-                  << (ci.price * ci.quantity);
-        info->addWidget(std::make_unique<Wt::WText>(linePrice.str()))
-            ->addStyleClass("m-cart-item-price");
-
-        // Quantity stepper
-        auto stepper = row->addWidget(std::make_unique<Wt::WContainerWidget>());
-        stepper->addStyleClass("m-stepper");
-
-        auto minusBtn = stepper->addWidget(std::make_unique<Wt::WPushButton>("-"));
-        minusBtn->addStyleClass("m-stepper-btn");
-        minusBtn->clicked().connect([this, i] {
-            if (cart_[i].quantity > 1) {
-                cart_[i].quantity--;
-            } else {
-                removeFromCart(i);
-            }
-            updateCartBadge();
-            screenContainer_->clear();
-            buildCartScreen();
-        });
-
-        stepper->addWidget(std::make_unique<Wt::WText>(std::to_string(ci.quantity)))
-            ->addStyleClass("m-stepper-value");
-
-        auto plusBtn = stepper->addWidget(std::make_unique<Wt::WPushButton>("+"));
-        plusBtn->addStyleClass("m-stepper-btn");
-        plusBtn->clicked().connect([this, i] {
-            cart_[i].quantity++;
-            updateCartBadge();
-            screenContainer_->clear();
-            buildCartScreen();
-        });
-    }
-
     // Total + action buttons (sticky at bottom of scroll area)
     auto footer = screenContainer_->addWidget(std::make_unique<Wt::WContainerWidget>());
     footer->addStyleClass("m-cart-footer");
@@ -490,27 +506,21 @@ void MobileFrontDeskView::buildCartScreen() {
     totalRow->addStyleClass("m-cart-total-row");
     totalRow->addWidget(std::make_unique<Wt::WText>("Total"))
         ->addStyleClass("m-cart-total-label");
-
-    std::stringstream ts;
-    ts << "$" << std::fixed << std::setprecision(2) << cartTotal();
-    totalRow->addWidget(std::make_unique<Wt::WText>(ts.str()))
+    totalRow->addWidget(std::make_unique<Wt::WText>())
         ->addStyleClass("m-cart-total-amount");
 
+    // Sends the cart; the order form opens once it has arrived
     auto checkoutBtn = footer->addWidget(
         std::make_unique<Wt::WPushButton>("Continue to Order"));
     checkoutBtn->addStyleClass("m-action-btn m-btn-primary");
-    checkoutBtn->clicked().connect([this] {
-        navigateTo(MobileScreen::OrderForm);
-    });
+    cart_->sendOn(checkoutBtn, false);
 
     auto clearBtn = footer->addWidget(
         std::make_unique<Wt::WPushButton>("Clear Cart"));
     clearBtn->addStyleClass("m-action-btn m-btn-secondary");
-    clearBtn->clicked().connect([this] {
-        cart_.clear();
-        updateCartBadge();
-        navigateTo(MobileScreen::Cart);
-    });
+    cart_->bindClear(clearBtn);
+
+    cart_->render();
 }
 
 // ─── Order Form Screen ───────────────────────────────────────────────────────
@@ -568,7 +578,7 @@ void MobileFrontDeskView::buildOrderFormScreen() {
     summary->addWidget(std::make_unique<Wt::WText>("Order Summary"))
         ->addStyleClass("m-summary-title");
 
-    for (auto& ci : cart_) {
+    for (auto& ci : cart_->lines()) {
         auto line = summary->addWidget(std::make_unique<Wt::WContainerWidget>());
         line->addStyleClass("m-summary-line");
         line->addWidget(std::make_unique<Wt::WText>(
@@ -581,16 +591,23 @@ void MobileFrontDeskView::buildOrderFormScreen() {
             ->addStyleClass("m-summary-price");
     }
 
+    std::string notice = cart_->unavailableNotice();
+    if (!notice.empty()) {
+        summary->addWidget(std::make_unique<Wt::WText>(notice, Wt::TextFormat::Plain))
+            ->addStyleClass("send-error");
+    }
+
     auto totalLine = summary->addWidget(std::make_unique<Wt::WContainerWidget>());
     totalLine->addStyleClass("m-summary-line m-summary-total");
     totalLine->addWidget(std::make_unique<Wt::WText>("Total"))
         ->addStyleClass("m-summary-item");
     std::stringstream ts;
-    ts << "$" << std::fixed << std::setprecision(2) << cartTotal();
+    ts << "$" << std::fixed << std::setprecision(2) << cart_->total();
     totalLine->addWidget(std::make_unique<Wt::WText>(ts.str()))
         ->addStyleClass("m-summary-price");
 
-    // Place order button
+    // Place order button; nothing to place if every item was unavailable
+    if (cart_->lines().empty()) return;
     auto placeBtn = screenContainer_->addWidget(
         std::make_unique<Wt::WPushButton>("Place Order"));
     placeBtn->addStyleClass("m-action-btn m-btn-success m-place-order-btn");
@@ -604,22 +621,48 @@ void MobileFrontDeskView::buildOrderFormScreen() {
 
 // ─── Confirmation Screen ─────────────────────────────────────────────────────
 
-void MobileFrontDeskView::buildConfirmationScreen(long long orderId) {
+void MobileFrontDeskView::buildConfirmationScreen() {
     auto content = screenContainer_->addWidget(std::make_unique<Wt::WContainerWidget>());
     content->addStyleClass("m-confirmation");
 
-    content->addWidget(std::make_unique<Wt::WText>(
-        "<svg width='64' height='64' viewBox='0 0 24 24' fill='none' stroke='#16a34a' "
-        "stroke-width='2'><path d='M22 11.08V12a10 10 0 1 1-5.93-9.14'/>"
-        "<polyline points='22 4 12 14.01 9 11.01'/></svg>"))
-        ->addStyleClass("m-confirm-icon");
-
-    content->addWidget(std::make_unique<Wt::WText>("Order Placed!"))
-        ->addStyleClass("m-confirm-title");
-
-    content->addWidget(std::make_unique<Wt::WText>(
-        "Order #" + std::to_string(orderId) + " has been sent to the kitchen"))
-        ->addStyleClass("m-confirm-subtitle");
+    auto it = sending_.find(lastSubmitKey_);
+    if (it == sending_.end()) {
+        content->addWidget(std::make_unique<Wt::WText>(
+            "<svg width='64' height='64' viewBox='0 0 24 24' fill='none' stroke='#16a34a' "
+            "stroke-width='2'><path d='M22 11.08V12a10 10 0 1 1-5.93-9.14'/>"
+            "<polyline points='22 4 12 14.01 9 11.01'/></svg>"))
+            ->addStyleClass("m-confirm-icon");
+
+        content->addWidget(std::make_unique<Wt::WText>("Order Placed!"))
+            ->addStyleClass("m-confirm-title");
+
+        // Negative ids are provisional: the order is queued until the server is back
+        content->addWidget(std::make_unique<Wt::WText>(lastOrderId_ > 0
+            ? "Order #" + std::to_string(lastOrderId_) + " has been sent to the kitchen"
+            : std::string("Order saved and will reach the kitchen shortly")))
+            ->addStyleClass("m-confirm-subtitle");
+    } else if (it->second.error.empty()) {
+        // Replaced by the outcome when it arrives (server push)
+        content->addWidget(std::make_unique<Wt::WText>("Sending Order…"))
+            ->addStyleClass("m-confirm-title");
+        content->addWidget(std::make_unique<Wt::WText>(
+            "Table " + std::to_string(it->second.submission.tableNumber) +
+            " is on its way to the kitchen. You can start the next order."))
+            ->addStyleClass("m-confirm-subtitle");
+    } else {
+        content->addWidget(std::make_unique<Wt::WText>("Order Not Sent"))
+            ->addStyleClass("m-confirm-title");
+        content->addWidget(std::make_unique<Wt::WText>(it->second.error, Wt::TextFormat::Plain))
+            ->addStyleClass("m-confirm-subtitle send-error");
+
+        std::string key = it->first;
+        auto retryBtn = content->addWidget(std::make_unique<Wt::WPushButton>("Retry"));
+        retryBtn->addStyleClass("m-action-btn m-btn-success");
+        retryBtn->clicked().connect([this, key] {
+            send(key);
+            navigateTo(MobileScreen::Confirmation);
+        });
+    }
 
     auto newBtn = content->addWidget(
         std::make_unique<Wt::WPushButton>("New Order"));
@@ -650,6 +693,8 @@ void MobileFrontDeskView::buildActiveOrdersScreen() {
         navigateTo(MobileScreen::ActiveOrders);
     });
 
+    addSendingCards(screenContainer_);
+
     auto orders = api_->getActiveOrders(restaurantId_);
 
     if (orders.empty()) {
@@ -667,137 +712,122 @@ void MobileFrontDeskView::buildActiveOrdersScreen() {
 
     for (auto& order : orders) {
         long long oid = order.id;
-        auto card = list->addWidget(std::make_unique<Wt::WContainerWidget>());
-        card->addStyleClass("m-order-card");
-
-        // Card header
-        auto cardHeader = card->addWidget(std::make_unique<Wt::WContainerWidget>());
-        cardHeader->addStyleClass("m-order-card-header");
-
-        auto leftInfo = cardHeader->addWidget(std::make_unique<Wt::WContainerWidget>());
-        leftInfo->addWidget(std::make_unique<Wt::WText>(
-            "Order #" + std::to_string(oid)))->addStyleClass("m-order-id");
-        leftInfo->addWidget(std::make_unique<Wt::WText>(
-            "Table " + std::to_string(order.table_number)))->addStyleClass("m-order-table-num");
-
-        auto statusBadge = cardHeader->addWidget(std::make_unique<Wt::WText>(order.status));
-        std::string statusClass = "m-status-badge ";
-        if (order.status == "Pending") statusClass += "status-pending";
-        else if (order.status == "In Progress") statusClass += "status-progress";
-        else if (order.status == "Ready") statusClass += "status-ready";
-        statusBadge->addStyleClass(statusClass);
-
-        // Items
-        auto items = api_->getOrderItems(oid);
-        auto itemsList = card->addWidget(std::make_unique<Wt::WContainerWidget>());
-        itemsList->addStyleClass("m-order-items");
-        for (auto& oi : items) {
-            auto line = itemsList->addWidget(std::make_unique<Wt::WContainerWidget>());
-            line->addStyleClass("m-order-item-line");
-            line->addWidget(std::make_unique<Wt::WText>(
-                std::to_string(oi.quantity) + "x " + oi.menu_item_name));
-
-            std::stringstream ss;
-            ss << "$" << std::fixed << std::setprecision(2)
-               << (oi.unit_price * oi.quantity);
-            line->addWidget(std::make_unique<Wt::WText>(ss.str()))
-                ->addStyleClass("m-order-item-price");
-        }
-
-        // Card footer with total
-        auto cardFooter = card->addWidget(std::make_unique<Wt::WContainerWidget>());
-        cardFooter->addStyleClass("m-order-card-footer");
-
-        std::stringstream totalSs;
-        totalSs << "Total: $" << std::fixed << std::setprecision(2) << order.total;
-        cardFooter->addWidget(std::make_unique<Wt::WText>(totalSs.str()))
-            ->addStyleClass("m-order-total");
+        // Items are only fetched for a version of the order not seen before
+        auto card = list->addWidget(OrderCardCache::instance().card(
+            OrderCardCache::Layout::Mobile, order,
+            [this, oid] { return api_->getOrderItems(oid); }));
 
         if (order.status == "Ready") {
-            auto serveBtn = cardFooter->addWidget(
+            auto serveBtn = card->bindWidget("action",
                 std::make_unique<Wt::WPushButton>("Mark Served"));
             serveBtn->addStyleClass("m-action-btn-sm m-btn-success");
             serveBtn->clicked().connect([this, oid] {
                 api_->updateOrderStatus(oid, "Served");
                 navigateTo(MobileScreen::ActiveOrders);
             });
+        } else {
+            card->bindEmpty("action");
         }
     }
 }
 
-// ─── Cart Operations ─────────────────────────────────────────────────────────
+// ─── Order Submission ────────────────────────────────────────────────────────
 
-void MobileFrontDeskView::addToCart(
-    long long menuItemId, const std::string& name, double price)
-{
-    for (auto& ci : cart_) {
-        if (ci.menuItemId == menuItemId) {
-            ci.quantity++;
-            updateCartBadge();
-            updateCartBubble();
-            return;
-        }
+void MobileFrontDeskView::submitOrder() {
+    if (cart_->lines().empty()) return;
+
+    OrderSubmission submission;
+    submission.restaurantId = restaurantId_;
+    submission.customerName = customerName_.empty() ? "Walk-In Guest" : customerName_;
+    submission.tableNumber = tableNumber_;
+    submission.notes = orderNotes_;
+    for (auto& line : cart_->lines()) {
+        submission.lines.push_back({line.menuItemId, line.quantity, ""});
     }
-    cart_.push_back({menuItemId, name, price, 1});
-    updateCartBadge();
-    updateCartBubble();
-}
+    submission.idempotencyKey = Wt::WRandom::generateId();
 
-void MobileFrontDeskView::removeFromCart(int index) {
-    if (index >= 0 && index < (int)cart_.size()) {
-        cart_.erase(cart_.begin() + index);
-    }
-    updateCartBadge();
-    updateCartBubble();
-}
+    lastSubmitKey_ = submission.idempotencyKey;
+    sending_[lastSubmitKey_].submission = std::move(submission);
 
-void MobileFrontDeskView::updateCartBadge() {
-    int total = 0;
-    for (auto& ci : cart_) total += ci.quantity;
+    // The cart is free for the next order while this one is sent
+    cart_->clear();
+    customerName_.clear();
+    tableNumber_ = 1;
+    orderNotes_.clear();
 
-    if (total > 0) {
-        cartBadge_->setText(std::to_string(total));
-        cartBadge_->setHidden(false);
-    } else {
-        cartBadge_->setHidden(true);
-    }
+    send(lastSubmitKey_);
+    navigateTo(MobileScreen::Confirmation);
 }
 
-void MobileFrontDeskView::updateCartBubble() {
-    if (!app_) return;
+void MobileFrontDeskView::send(const std::string& key) {
+    Sending& entry = sending_.at(key);
+    entry.error.clear();
+    tabOrders_->toggleStyleClass("m-tab-alert", false);
+    submitter_->submit(entry.submission,
+        sessionCallback<OrderSubmission>(this, [this, key](ApiResult<OrderSubmission> result) {
+            submitted(key, std::move(result));
+        }));
+}
 
-    int totalItems = 0;
-    for (auto& ci : cart_) totalItems += ci.quantity;
+void MobileFrontDeskView::submitted(const std::string& key, ApiResult<OrderSubmission> result) {
+    auto it = sending_.find(key);
+    if (it == sending_.end()) return;
+    it->second.submission = std::move(result.value);
+    it->second.error = result.error;
+    if (result.ok()) {
+        if (key == lastSubmitKey_) lastOrderId_ = it->second.submission.orderId;
+        sending_.erase(it);
+    }
 
-    // Update the header cart bubble with current totals
-    app_->updateHeaderCart(totalItems, cartTotal());
-}
+    // A failure is flagged on the Orders tab, wherever the cashier is now
+    bool failed = false;
+    for (auto& entry : sending_) failed |= !entry.second.error.empty();
+    tabOrders_->toggleStyleClass("m-tab-alert", failed);
 
-double MobileFrontDeskView::cartTotal() const {
-    double t = 0;
-    for (auto& ci : cart_) t += ci.price * ci.quantity;
-    return t;
+    // Screens showing submissions are redrawn; the others are left alone
+    if (currentScreen_ == MobileScreen::Confirmation ||
+        currentScreen_ == MobileScreen::ActiveOrders) {
+        navigateTo(currentScreen_);
+    }
 }
 
-// ─── Order Submission ────────────────────────────────────────────────────────
+void MobileFrontDeskView::addSendingCards(Wt::WContainerWidget* parent) {
+    if (sending_.empty()) return;
 
-void MobileFrontDeskView::submitOrder() {
-    if (cart_.empty()) return;
+    auto list = parent->addWidget(std::make_unique<Wt::WContainerWidget>());
+    list->addStyleClass("m-orders-list m-sending-list");
+    for (auto& entry : sending_) {
+        const std::string& key = entry.first;
+        const Sending& sending = entry.second;
+        bool failed = !sending.error.empty();
 
-    std::string name = customerName_.empty() ? "Walk-In Guest" : customerName_;
-    auto order = api_->createOrder(restaurantId_, tableNumber_, name, orderNotes_);
-    long long orderId = order.id;
-
-    for (auto& ci : cart_) {
-        api_->addOrderItem(orderId, ci.menuItemId, ci.quantity, "");
-    }
+        auto card = list->addWidget(std::make_unique<Wt::WContainerWidget>());
+        card->addStyleClass(failed ? "m-order-card sending-card send-failed"
+                                   : "m-order-card sending-card");
 
-    lastOrderId_ = orderId;
-    cart_.clear();
-    customerName_.clear();
-    tableNumber_ = 1;
-    orderNotes_.clear();
-    updateCartBadge();
+        auto cardHeader = card->addWidget(std::make_unique<Wt::WContainerWidget>());
+        cardHeader->addStyleClass("m-order-card-header");
+        auto leftInfo = cardHeader->addWidget(std::make_unique<Wt::WContainerWidget>());
+        leftInfo->addWidget(std::make_unique<Wt::WText>(
+            sending.submission.customerName, Wt::TextFormat::Plain))
+            ->addStyleClass("m-order-id");
+        leftInfo->addWidget(std::make_unique<Wt::WText>(
+            "Table " + std::to_string(sending.submission.tableNumber)))
+            ->addStyleClass("m-order-table-num");
+        cardHeader->addWidget(std::make_unique<Wt::WText>(failed ? "Not sent" : "Sending"))
+            ->addStyleClass(failed ? "m-status-badge status-cancelled"
+                                   : "m-status-badge status-sending");
+        if (!failed) continue;
 
-    navigateTo(MobileScreen::Confirmation);
+        auto cardFooter = card->addWidget(std::make_unique<Wt::WContainerWidget>());
+        cardFooter->addStyleClass("m-order-card-footer");
+        cardFooter->addWidget(std::make_unique<Wt::WText>(sending.error, Wt::TextFormat::Plain))
+            ->addStyleClass("send-error");
+        auto retryBtn = cardFooter->addWidget(std::make_unique<Wt::WPushButton>("Retry"));
+        retryBtn->addStyleClass("m-action-btn-sm m-btn-success");
+        retryBtn->clicked().connect([this, key] {
+            send(key);
+            navigateTo(MobileScreen::ActiveOrders);
+        });
+    }
 }
@@ -1,26 +1,25 @@
 #pragma once
 
 #include <Wt/WContainerWidget.h>
+#include <Wt/WJavaScript.h>
 #include <Wt/WStackedWidget.h>
 #include <Wt/WText.h>
 #include <Wt/WPushButton.h>
 #include <Wt/WLineEdit.h>
 #include <Wt/WSpinBox.h>
 #include <Wt/WTextArea.h>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "../services/IApiService.h"
+#include "../services/MenuCatalog.h"
+#include "../services/OrderSubmitter.h"
+#include "../ui/ClientCart.h"
 
 class RestaurantApp;  // forward declaration
 
-struct MobileCartItem {
-    long long menuItemId;
-    std::string name;
-    double price;
-    int quantity;
-};
-
 // Screen flow:
 //   Categories -> Menu Items -> Cart Review -> Order Confirmation
 //   Bottom tab bar: Menu | Cart (badge) | Orders
@@ -35,19 +34,21 @@ enum class MobileScreen {
 
 class MobileFrontDeskView : public Wt::WContainerWidget {
 public:
-    MobileFrontDeskView(std::shared_ptr<IApiService> api, long long restaurantId,
+    MobileFrontDeskView(std::shared_ptr<IApiService> api,
+                        std::shared_ptr<MenuCatalog> menus,
+                        std::shared_ptr<OrderSubmitter> submitter, long long restaurantId,
                         RestaurantApp* app = nullptr, bool isTablet = false);
 
 private:
     // Screen builders
     void buildTabBar();
-    void buildMenuBrowserScreen();   // tablet: split categories/items
-    void refreshItemsPanel();
+    void buildMenuBrowserScreen();   // tablet: split categories/items, built once
+    void refreshMenuAvailability();  // tablet: catch up with a newer menu snapshot
     void buildCategoriesScreen();    // phone: full-screen category list
     void buildMenuItemsScreen();     // phone: full-screen items with back
     void buildCartScreen();
     void buildOrderFormScreen();
-    void buildConfirmationScreen(long long orderId);
+    void buildConfirmationScreen();  // the last order submitted: sending, failed or placed
     void buildActiveOrdersScreen();
 
     // Navigation
@@ -57,19 +58,17 @@ private:
     // Category -> Items
     void showCategoryItems(long long categoryId, const std::string& categoryName);
 
-    // Cart operations
-    void addToCart(long long menuItemId, const std::string& name, double price);
-    void removeFromCart(int index);
-    void updateCartBadge();
-    void updateCartBubble();
-    double cartTotal() const;
-
     // Order submission
     void submitOrder();
+    void send(const std::string& key);
+    void submitted(const std::string& key, ApiResult<OrderSubmission> result);
+    void addSendingCards(Wt::WContainerWidget* parent);
 
     std::shared_ptr<IApiService> api_;
+    std::shared_ptr<MenuCatalog> menus_;
+    std::shared_ptr<OrderSubmitter> submitter_;
     long long restaurantId_;
-    RestaurantApp* app_ = nullptr;  // for header cart updates
+    RestaurantApp* app_ = nullptr;  // for the header cart bubble
     bool isTablet_ = false;         // tablet: split panel, phone: sequential
 
     // Navigation state
@@ -86,17 +85,40 @@ private:
     Wt::WContainerWidget* tabCart_ = nullptr;
     Wt::WContainerWidget* tabOrders_ = nullptr;
 
-    // Menu browser split-panel
-    Wt::WContainerWidget* itemsPanel_ = nullptr;
+    // Menu browser split-panel (tablet).  Lives beside screenContainer_ and
+    // is hidden, not destroyed, while another screen is up; every category's
+    // items are in the page and selectCategory_ switches between them in
+    // the browser, without a round trip.
+    Wt::WContainerWidget* menuScreen_ = nullptr;
+    std::shared_ptr<const MenuSnapshot> menu_;          // what menuScreen_ shows
+    Wt::JSlot selectCategory_;
+    struct MenuCard {
+        Wt::WWidget* card;
+        long long categoryId;
+        bool available;
+    };
+    std::map<long long, MenuCard> menuCards_;           // by menu item id
+    std::map<long long, Wt::WText*> categoryCounts_;    // by category id
 
     // Order form fields (persisted across nav)
     std::string customerName_;
     int tableNumber_ = 1;
     std::string orderNotes_;
 
-    // Cart
-    std::vector<MobileCartItem> cart_;
-
-    // Last confirmed order
+    // Cart: kept and drawn by the browser (tab badge, header bubble, cart
+    // screen); lines() is what it sent on "Continue to Order"
+    ClientCart* cart_ = nullptr;
+
+    // Orders handed to the submitter, by idempotency key, until placed.
+    // One that failed keeps its progress, so Retry resumes it instead of
+    // creating a second order.
+    struct Sending {
+        OrderSubmission submission;
+        std::string error;          // empty while sending
+    };
+    std::map<std::string, Sending> sending_;
+
+    // Last order submitted, and its id once placed
+    std::string lastSubmitKey_;
     long long lastOrderId_ = -1;
 };
@@ -0,0 +1,376 @@
+// ─── pos_resilience_test ─────────────────────────────────────────────────────
+// RestApiService's circuit breaker, deadlines and retry budget against a
+// restaurant_pos_mock_als injecting errors and latency: the breaker opens,
+// half-opens and closes, deadlines cut slow calls short, reads fall back to
+// the last good response, and retries stop when the budget is spent.
+//
+//   pos_resilience_test <path to restaurant_pos_mock_als>
+//
+// Builds a seeded LOCAL database in a temporary directory and restarts the
+// mock on it with different fault settings as each case needs.  Breaker
+// and budget settings are shrunk through RestApiService::Policy so the
+// run takes a few seconds.
+
+#include "services/LocalApiService.h"
+#include "services/Metrics.h"
+#include "services/RestApiService.h"
+#include "services/SiteConfig.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern char** environ;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed"  \
+                      << std::endl;                                                  \
+            failures++;                                                              \
+        }                                                                            \
+    } while (0)
+
+// ─── Mock server ─────────────────────────────────────────────────────────────
+
+int freePort() {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (fd < 0 || ::bind(fd, (sockaddr*)&addr, len) < 0 ||
+        ::getsockname(fd, (sockaddr*)&addr, &len) < 0) {
+        throw std::runtime_error("no free port");
+    }
+    ::close(fd);
+    return ntohs(addr.sin_port);
+}
+
+bool accepting(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bool ok = fd >= 0 && ::connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0;
+    if (fd >= 0) ::close(fd);
+    return ok;
+}
+
+// One restaurant_pos_mock_als process; killed when it goes out of scope
+class Mock {
+public:
+    Mock(const std::string& binary, const std::string& db, int port,
+         std::vector<std::string> faults)
+        : port_(port)
+    {
+        std::vector<std::string> args = {binary, "--db", db, "--port", std::to_string(port),
+                                         "--no-compression"};
+        args.insert(args.end(), faults.begin(), faults.end());
+        std::vector<char*> argv;
+        for (auto& a : args) argv.push_back(&a[0]);
+        argv.push_back(nullptr);
+        if (posix_spawn(&pid_, binary.c_str(), nullptr, nullptr, argv.data(), environ) != 0)
+            throw std::runtime_error("cannot start " + binary);
+
+        for (int i = 0; i < 100 && !accepting(port_); i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (!accepting(port_)) throw std::runtime_error("mock did not start");
+    }
+
+    ~Mock() {
+        ::kill(pid_, SIGKILL);
+        ::waitpid(pid_, nullptr, 0);
+    }
+
+    Mock(const Mock&) = delete;
+    Mock& operator=(const Mock&) = delete;
+
+private:
+    int port_;
+    pid_t pid_ = 0;
+};
+
+// ─── Fixtures ────────────────────────────────────────────────────────────────
+
+struct Env {
+    std::string mock;
+    std::string dir;
+    std::string db;
+    int port;
+
+    std::string configPath() const { return dir + "/site-config.json"; }
+
+    // Rewritten in place so a live RestApiService picks it up on reload()
+    void writeConfig(const std::string& deadlines) const {
+        std::ofstream out(configPath());
+        out << "{\n"
+               "  \"data_source_type\": \"ALS\",\n"
+               "  \"api_base_url\": \"http://127.0.0.1:" << port << "/api\",\n"
+               "  \"api_deadlines_ms\": \"" << deadlines << "\",\n"
+               "  \"api_compression\": \"off\"\n"
+               "}\n";
+    }
+
+    std::unique_ptr<Mock> start(std::vector<std::string> faults = {}) const {
+        return std::make_unique<Mock>(mock, db, port, std::move(faults));
+    }
+};
+
+int64_t breakerState() {
+    return MetricsRegistry::instance().gauge(
+        "pos_circuit_state", "Circuit breaker state (0 closed, 1 open, 2 half-open)",
+        "breaker=\"als\"").value();
+}
+
+uint64_t counter(const char* family, const char* help, const std::string& labels = "") {
+    return MetricsRegistry::instance().counter(family, help, labels).value();
+}
+
+uint64_t transitionsTo(const char* state) {
+    return counter("pos_circuit_transitions_total", "Circuit breaker state changes",
+                   std::string("breaker=\"als\",to=\"") + state + "\"");
+}
+
+uint64_t rejected() {
+    return counter("pos_circuit_rejected_total", "Calls failed fast by an open circuit",
+                   "breaker=\"als\"");
+}
+
+uint64_t deadlineExceeded() {
+    return counter("pos_als_deadline_exceeded_total",
+                   "Calls abandoned at their endpoint deadline");
+}
+
+uint64_t retries() {
+    return counter("pos_als_retries_total", "ApiLogicServer requests retried");
+}
+
+uint64_t staleReads() {
+    return counter("pos_als_stale_reads_total", "Reads answered from last known good data");
+}
+
+uint64_t budgetExhausted() {
+    return counter("pos_als_retry_budget_exhausted_total",
+                   "Retries skipped because the retry budget was empty");
+}
+
+// pullRestaurants has no last-known-good fallback, so failures surface
+bool read(RestApiService& api) {
+    try {
+        return !api.pullRestaurants().empty();
+    } catch (std::exception&) {
+        return false;
+    }
+}
+
+constexpr auto kOpenFor = std::chrono::milliseconds(300);
+
+RestApiService::Policy breakerPolicy() {
+    RestApiService::Policy policy;
+    policy.breaker.failureThreshold = 3;
+    policy.breaker.openFor = kOpenFor;
+    return policy;
+}
+
+// ─── Cases ───────────────────────────────────────────────────────────────────
+
+void breakerOpensAndRecovers(const Env& env) {
+    env.writeConfig("read=2000,write=2000");
+    auto config = std::make_shared<SiteConfig>(env.configPath());
+    RestApiService api(config, breakerPolicy());
+
+    {
+        auto mock = env.start({"--error-rate", "1"});
+        uint64_t opened = transitionsTo("open");
+        CHECK(!read(api));      // three failed attempts open the breaker
+        CHECK(breakerState() == 1);
+        CHECK(transitionsTo("open") == opened + 1);
+
+        uint64_t refused = rejected();
+        CHECK(!read(api));
+        CHECK(rejected() == refused + 1);
+
+        // The half-open probe fails too: straight back to open
+        std::this_thread::sleep_for(kOpenFor + std::chrono::milliseconds(50));
+        uint64_t probes = transitionsTo("half_open");
+        CHECK(!read(api));
+        CHECK(transitionsTo("half_open") == probes + 1);
+        CHECK(transitionsTo("open") == opened + 2);
+        CHECK(breakerState() == 1);
+    }
+
+    auto mock = env.start();
+    std::this_thread::sleep_for(kOpenFor + std::chrono::milliseconds(50));
+    uint64_t closed = transitionsTo("closed");
+    CHECK(read(api));           // the probe succeeds and closes the breaker
+    CHECK(breakerState() == 0);
+    CHECK(transitionsTo("closed") == closed + 1);
+    CHECK(read(api));
+}
+
+void deadlineExpires(const Env& env) {
+    env.writeConfig("read=150,write=150");
+    auto config = std::make_shared<SiteConfig>(env.configPath());
+    RestApiService api(config);
+    auto mock = env.start({"--latency-ms", "400"});
+
+    uint64_t before = deadlineExceeded();
+    auto started = std::chrono::steady_clock::now();
+    CHECK(!read(api));
+    auto took = std::chrono::steady_clock::now() - started;
+    CHECK(deadlineExceeded() == before + 1);
+    CHECK(took < std::chrono::milliseconds(400));
+}
+
+void expiredDeadlineKeepsHalfOpenProbe(const Env& env) {
+    env.writeConfig("read=2000,write=2000");
+    auto config = std::make_shared<SiteConfig>(env.configPath());
+    RestApiService api(config, breakerPolicy());
+    {
+        auto mock = env.start({"--error-rate", "1"});
+        CHECK(!read(api));
+        CHECK(breakerState() == 1);
+    }
+
+    // Half-open is due, but the deadline is too short for any attempt
+    std::this_thread::sleep_for(kOpenFor + std::chrono::milliseconds(50));
+    env.writeConfig("read=1,write=1");
+    config->reload();
+    uint64_t before = deadlineExceeded();
+    CHECK(!read(api));
+    CHECK(deadlineExceeded() == before + 1);
+
+    // The probe was not spent on that call, so a healthy server closes it
+    env.writeConfig("read=2000,write=2000");
+    config->reload();
+    auto mock = env.start();
+    CHECK(read(api));
+    CHECK(breakerState() == 0);
+}
+
+// getRestaurants falls back to the last good response, pullRestaurants not
+size_t restaurants(RestApiService& api) {
+    try {
+        return api.getRestaurants().size();
+    } catch (std::exception&) {
+        return 0;
+    }
+}
+
+void lastKnownGoodServed(const Env& env) {
+    env.writeConfig("read=2000,write=2000");
+    auto config = std::make_shared<SiteConfig>(env.configPath());
+    RestApiService api(config, breakerPolicy());
+
+    size_t good;
+    {
+        auto mock = env.start({"--latency-ms", "20"});
+        good = restaurants(api);
+        CHECK(good > 0);
+    }
+
+    // Slow and failing: the failed read is answered from the last response
+    auto mock = env.start({"--latency-ms", "20", "--error-rate", "1"});
+    uint64_t stale = staleReads();
+    uint64_t opened = transitionsTo("open");
+    CHECK(restaurants(api) == good);
+    CHECK(staleReads() == stale + 1);
+    CHECK(breakerState() == 1);
+    CHECK(transitionsTo("open") == opened + 1);
+
+    // Refused by the open breaker without a request, and still answered
+    uint64_t refused = rejected();
+    CHECK(restaurants(api) == good);
+    CHECK(rejected() == refused + 1);
+    CHECK(staleReads() == stale + 2);
+}
+
+void retryBudgetRunsOut(const Env& env) {
+    env.writeConfig("read=5000,write=5000");
+    auto config = std::make_shared<SiteConfig>(env.configPath());
+    RestApiService::Policy policy;
+    policy.breaker.failureThreshold = 1000;     // keep the breaker out of it
+    policy.retries.ratio = 0;
+    policy.retries.minPerSecond = 0;
+    policy.retries.maxTokens = 2;
+    RestApiService api(config, policy);
+    auto mock = env.start({"--error-rate", "1"});
+
+    uint64_t retried = retries();
+    uint64_t exhausted = budgetExhausted();
+    CHECK(!read(api));          // two retries spend the budget
+    CHECK(retries() == retried + 2);
+    CHECK(budgetExhausted() == exhausted);
+
+    CHECK(!read(api));          // and the next failure is not retried
+    CHECK(retries() == retried + 2);
+    CHECK(budgetExhausted() == exhausted + 1);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <restaurant_pos_mock_als>" << std::endl;
+        return 2;
+    }
+
+    char dirTemplate[] = "/tmp/pos_resilience_XXXXXX";
+    if (!::mkdtemp(dirTemplate)) {
+        std::cerr << "mkdtemp failed" << std::endl;
+        return 2;
+    }
+    Env env{argv[1], dirTemplate, std::string(dirTemplate) + "/pos.db", 0};
+
+    int status = 0;
+    try {
+        {
+            LocalApiService local(env.db);
+            local.initializeDatabase();
+            local.seedDatabase();
+        }
+        env.port = freePort();
+
+        struct Case { const char* name; void (*run)(const Env&); };
+        for (const Case& c : {Case{"breaker opens and recovers", breakerOpensAndRecovers},
+                              Case{"deadline expires", deadlineExpires},
+                              Case{"expired deadline keeps the half-open probe",
+                                   expiredDeadlineKeepsHalfOpenProbe},
+                              Case{"last known good is served", lastKnownGoodServed},
+                              Case{"retry budget runs out", retryBudgetRunsOut}}) {
+            int before = failures;
+            c.run(env);
+            std::cout << (failures == before ? "[ OK ] " : "[FAIL] ") << c.name << std::endl;
+        }
+        status = failures == 0 ? 0 : 1;
+    } catch (std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        status = 1;
+    }
+
+    for (const char* file : {"/pos.db", "/pos.db-wal", "/pos.db-shm", "/site-config.json"})
+        std::remove((env.dir + file).c_str());
+    ::rmdir(env.dir.c_str());
+    return status;
+}
@@ -0,0 +1,398 @@
+// ─── pos_single_flight_test ──────────────────────────────────────────────────
+// SingleFlight and CoalescingApiService under many threads: concurrent
+// readers share one backend call, a failure reaches every one of them,
+// and a read issued after a write never gets data fetched before it.
+//
+// Backends are in-process fakes that hold their first call open until the
+// test releases it, so every reader is known to overlap.  Worth running
+// under -fsanitize=thread as well.
+
+#include "services/CoalescingApiService.h"
+#include "services/Metrics.h"
+#include "services/SingleFlight.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed"  \
+                      << std::endl;                                                  \
+            failures++;                                                              \
+        }                                                                            \
+    } while (0)
+
+constexpr int kReaders = 32;
+
+// Closed until open() is called; wait() blocks until then
+class Gate {
+public:
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return open_; });
+    }
+    void open() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            open_ = true;
+        }
+        cv_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool open_ = false;
+};
+
+// Starts `n` threads running fn(i), and returns once each has got as far
+// as calling it and a little more, so blocking callers are inside the call
+std::vector<std::thread> startReaders(int n, std::function<void(int)> fn) {
+    auto entered = std::make_shared<std::atomic<int>>(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < n; i++) {
+        threads.emplace_back([fn, entered, i] {
+            (*entered)++;
+            fn(i);
+        });
+    }
+    while (*entered < n) std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return threads;
+}
+
+void joinAll(std::vector<std::thread>& threads) {
+    for (auto& t : threads) t.join();
+}
+
+uint64_t coalesced() {
+    return MetricsRegistry::instance().counter(
+        "pos_api_coalesced_total", "Reads answered by an identical call already in flight",
+        "").value();
+}
+
+// ─── Fake backends ───────────────────────────────────────────────────────────
+
+// getOrderCount answers with the number of writes seen when the read
+// started; the first read waits for `gate`
+class FakeApi : public IApiService {
+public:
+    Gate gate;
+    std::atomic<int> reads{0};
+    std::atomic<int> writes{0};
+
+    int getOrderCount(long long) override {
+        int version = writes;
+        if (reads++ == 0) gate.wait();
+        return version;
+    }
+    void updateOrderStatus(long long, const std::string&) override { writes++; }
+
+    std::vector<RestaurantDto> getRestaurants() override {
+        return unused<std::vector<RestaurantDto>>();
+    }
+    RestaurantDto getRestaurant(long long) override { return unused<RestaurantDto>(); }
+    std::vector<CategoryDto> getCategories(long long) override {
+        return unused<std::vector<CategoryDto>>();
+    }
+    std::vector<MenuItemDto> getMenuItemsByCategory(long long) override {
+        return unused<std::vector<MenuItemDto>>();
+    }
+    std::vector<MenuItemDto> getMenuItemsByRestaurant(long long) override {
+        return unused<std::vector<MenuItemDto>>();
+    }
+    MenuItemDto getMenuItem(long long) override { return unused<MenuItemDto>(); }
+    void updateMenuItemAvailability(long long, bool) override { unused<int>(); }
+    std::vector<OrderDto> getOrders(long long) override { return unused<std::vector<OrderDto>>(); }
+    std::vector<OrderDto> getOrdersByStatus(long long, const std::string&) override {
+        return unused<std::vector<OrderDto>>();
+    }
+    std::vector<OrderDto> getActiveOrders(long long) override {
+        return unused<std::vector<OrderDto>>();
+    }
+    OrderPageDto getOrdersPage(long long, const OrderPageQuery&) override {
+        return unused<OrderPageDto>();
+    }
+    OrderDto getOrder(long long) override { return unused<OrderDto>(); }
+    OrderDto createOrder(long long, int, const std::string&, const std::string&,
+                         const std::string&) override { return unused<OrderDto>(); }
+    void addOrderItem(long long, long long, int, const std::string&) override { unused<int>(); }
+    void cancelOrder(long long) override { unused<int>(); }
+    OrderChangesDto getOrderChangesSince(long long, const std::string&) override {
+        return unused<OrderChangesDto>();
+    }
+    std::vector<OrderItemDto> getOrderItems(long long) override {
+        return unused<std::vector<OrderItemDto>>();
+    }
+    double getRevenue(long long) override { return unused<double>(); }
+    int getPendingOrderCount(long long) override { return unused<int>(); }
+    int getInProgressOrderCount(long long) override { return unused<int>(); }
+
+private:
+    template <typename T>
+    static T unused() { throw std::logic_error("not used by this test"); }
+};
+
+// getOrderCount calls are held until deliver(); each is answered with the
+// number of writes seen when it was issued
+class FakeAsyncApi : public IAsyncApiService {
+public:
+    std::atomic<int> writes{0};
+
+    int issued() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return (int)held_.size();
+    }
+    void deliver(int call) {
+        std::pair<int, ApiCallback<int>> held;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (call >= (int)held_.size()) return;
+            held = held_[call];
+        }
+        ApiResult<int> result;
+        result.value = held.first;
+        held.second(result);
+    }
+
+    void getOrderCount(long long, ApiCallback<int> cb) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_.emplace_back(writes.load(), std::move(cb));
+    }
+    void updateOrderStatus(long long, const std::string&, ApiCallback<bool> cb) override {
+        writes++;
+        ApiResult<bool> result;
+        result.value = true;
+        cb(result);
+    }
+
+    void getCategories(long long, ApiCallback<std::vector<CategoryDto>> cb) override { unused(cb); }
+    void getMenuItemsByCategory(long long, ApiCallback<std::vector<MenuItemDto>> cb) override {
+        unused(cb);
+    }
+    void getOrders(long long, ApiCallback<std::vector<OrderDto>> cb) override { unused(cb); }
+    void getOrdersByStatus(long long, const std::string&,
+                           ApiCallback<std::vector<OrderDto>> cb) override {
+        unused(cb);
+    }
+    void getActiveOrders(long long, ApiCallback<std::vector<OrderDto>> cb) override { unused(cb); }
+    void getOrderChangesSince(long long, const std::string&,
+                              ApiCallback<OrderChangesDto> cb) override {
+        unused(cb);
+    }
+    void getOrderItems(long long, ApiCallback<std::vector<OrderItemDto>> cb) override {
+        unused(cb);
+    }
+    void getRevenue(long long, ApiCallback<double> cb) override { unused(cb); }
+    void getPendingOrderCount(long long, ApiCallback<int> cb) override { unused(cb); }
+    void getInProgressOrderCount(long long, ApiCallback<int> cb) override { unused(cb); }
+
+private:
+    template <typename T>
+    static void unused(ApiCallback<T>& cb) {
+        ApiResult<T> result;
+        result.error = "not used by this test";
+        cb(result);
+    }
+
+    std::mutex mutex_;
+    std::vector<std::pair<int, ApiCallback<int>>> held_;
+};
+
+// ─── SingleFlight ────────────────────────────────────────────────────────────
+
+void runSharesOneCall() {
+    SingleFlight flights;
+    Gate gate;
+    std::atomic<int> calls{0};
+    std::atomic<int> sharedCount{0};
+    std::vector<int> results(kReaders, -1);
+
+    auto threads = startReaders(kReaders, [&](int i) {
+        bool shared = false;
+        results[i] = flights.run<int>("k", [&] {
+            calls++;
+            gate.wait();
+            return 42;
+        }, &shared);
+        if (shared) sharedCount++;
+    });
+    gate.open();
+    joinAll(threads);
+
+    CHECK(calls == 1);
+    CHECK(sharedCount == kReaders - 1);
+    for (int r : results) CHECK(r == 42);
+
+    // The key is free again: nothing is cached
+    CHECK(flights.run<int>("k", [] { return 7; }) == 7);
+}
+
+void runFansOutExceptions() {
+    SingleFlight flights;
+    Gate gate;
+    std::atomic<int> calls{0};
+    std::atomic<int> caught{0};
+
+    auto threads = startReaders(kReaders, [&](int) {
+        try {
+            flights.run<int>("k", [&]() -> int {
+                calls++;
+                gate.wait();
+                throw std::runtime_error("backend down");
+            });
+        } catch (std::runtime_error& e) {
+            if (std::string(e.what()) == "backend down") caught++;
+        }
+    });
+    gate.open();
+    joinAll(threads);
+
+    CHECK(calls == 1);
+    CHECK(caught == kReaders);
+    CHECK(flights.run<int>("k", [] { return 1; }) == 1);
+}
+
+void joinSharesOneCall() {
+    SingleFlight flights;
+    std::atomic<int> starts{0};
+    std::atomic<int> joined{0};
+    std::atomic<int> delivered{0};
+    std::mutex doneMutex;
+    std::function<void(ApiResult<int>)> done;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kReaders; i++) {
+        threads.emplace_back([&] {
+            bool wasJoined = flights.join<int>("k",
+                [&](ApiResult<int> r) { if (r.ok() && r.value == 42) delivered++; },
+                [&](std::function<void(ApiResult<int>)> d) {
+                    starts++;
+                    std::lock_guard<std::mutex> lock(doneMutex);
+                    done = std::move(d);
+                });
+            if (wasJoined) joined++;
+        });
+    }
+    joinAll(threads);
+
+    CHECK(starts == 1);
+    CHECK(joined == kReaders - 1);
+    CHECK(delivered == 0);
+    ApiResult<int> result;
+    result.value = 42;
+    done(result);
+    CHECK(delivered == kReaders);
+}
+
+void joinFansOutErrors() {
+    SingleFlight flights;
+    std::atomic<int> failed{0};
+    std::function<void(ApiResult<int>)> done;
+    for (int i = 0; i < kReaders; i++) {
+        flights.join<int>("k", [&](ApiResult<int> r) { if (r.error == "HTTP 503") failed++; },
+                          [&](std::function<void(ApiResult<int>)> d) { done = std::move(d); });
+    }
+    ApiResult<int> result;
+    result.error = "HTTP 503";
+    done(result);
+    CHECK(failed == kReaders);
+}
+
+// ─── CoalescingApiService ────────────────────────────────────────────────────
+
+void coalescingSharesReads() {
+    auto backend = std::make_shared<FakeApi>();
+    CoalescingApiService api(backend, std::make_shared<FakeAsyncApi>());
+    uint64_t before = coalesced();
+    std::vector<int> results(kReaders, -1);
+
+    auto threads = startReaders(kReaders, [&](int i) { results[i] = api.getOrderCount(1); });
+    backend->gate.open();
+    joinAll(threads);
+
+    CHECK(backend->reads == 1);
+    CHECK(coalesced() == before + kReaders - 1);
+    for (int r : results) CHECK(r == 0);
+}
+
+void coalescingForgetsAfterWrite() {
+    auto backend = std::make_shared<FakeApi>();
+    CoalescingApiService api(backend, std::make_shared<FakeAsyncApi>());
+
+    // A read in flight, started before the write
+    int early = -1;
+    std::thread reader([&] { early = api.getOrderCount(1); });
+    while (backend->reads == 0) std::this_thread::yield();
+
+    api.updateOrderStatus(7, "Ready");
+    // Must not join the early read, which would block it on the gate
+    auto late = std::async(std::launch::async, [&] { return api.getOrderCount(1); });
+    bool answered = late.wait_for(std::chrono::seconds(2)) == std::future_status::ready;
+    CHECK(answered);
+
+    backend->gate.open();
+    reader.join();
+    CHECK(early == 0);
+    CHECK(late.get() == 1);
+    CHECK(backend->reads == 2);
+}
+
+void coalescingAsyncForgetsAfterWrite() {
+    auto backend = std::make_shared<FakeAsyncApi>();
+    CoalescingApiService api(std::make_shared<FakeApi>(), backend);
+    std::atomic<int> early{0};
+    std::vector<int> late;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kReaders; i++) {
+        threads.emplace_back([&] {
+            api.getOrderCount(1, [&](ApiResult<int> r) { if (r.ok() && r.value == 0) early++; });
+        });
+    }
+    joinAll(threads);
+    CHECK(backend->issued() == 1);
+
+    api.updateOrderStatus(7, "Ready", [](ApiResult<bool>) {});
+    api.getOrderCount(1, [&](ApiResult<int> r) { late.push_back(r.value); });
+    CHECK(backend->issued() == 2);
+
+    backend->deliver(0);
+    backend->deliver(1);
+    CHECK(early == kReaders);
+    CHECK(late.size() == 1 && late[0] == 1);
+}
+
+} // namespace
+
+int main() {
+    struct Case { const char* name; void (*run)(); };
+    for (const Case& c : {Case{"run shares one call", runSharesOneCall},
+                          Case{"run fans out exceptions", runFansOutExceptions},
+                          Case{"join shares one call", joinSharesOneCall},
+                          Case{"join fans out errors", joinFansOutErrors},
+                          Case{"coalescing shares reads", coalescingSharesReads},
+                          Case{"coalescing forgets after a write", coalescingForgetsAfterWrite},
+                          Case{"async coalescing forgets after a write",
+                               coalescingAsyncForgetsAfterWrite}}) {
+        int before = failures;
+        c.run();
+        std::cout << (failures == before ? "[ OK ] " : "[FAIL] ") << c.name << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""Compare two Google Benchmark JSON result files.
+
+Usage:
+    bench_compare.py BASELINE.json CURRENT.json [--threshold PCT] [--metric real_time|cpu_time]
+
+Prints a per-benchmark table and exits with status 1 if any benchmark present
+in both files got slower by more than --threshold percent (default 10).
+When the runs used --benchmark_repetitions, the median aggregate is compared.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path, metric):
+    with open(path) as f:
+        doc = json.load(f)
+
+    plain = {}
+    medians = {}
+    for b in doc.get("benchmarks", []):
+        if b.get("error_occurred"):
+            continue
+        if b.get("run_type") == "aggregate":
+            if b.get("aggregate_name") == "median":
+                medians[b["run_name"]] = b[metric]
+            continue
+        # With repetitions every run shares a name; the median replaces them
+        plain[b.get("run_name", b["name"])] = b[metric]
+
+    plain.update(medians)
+    return plain
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("baseline")
+    ap.add_argument("current")
+    ap.add_argument("--threshold", type=float, default=10.0,
+                    help="allowed slowdown in percent (default 10)")
+    ap.add_argument("--metric", choices=["real_time", "cpu_time"], default="real_time")
+    args = ap.parse_args()
+
+    try:
+        base = load(args.baseline, args.metric)
+        cur = load(args.current, args.metric)
+    except (OSError, ValueError) as e:
+        print(f"[bench_compare] {e}", file=sys.stderr)
+        return 2
+
+    names = sorted(set(base) & set(cur))
+    if not names:
+        print("[bench_compare] no benchmarks in common", file=sys.stderr)
+        return 2
+
+    width = max(len(n) for n in names)
+    print(f"{'benchmark':<{width}}  {'baseline':>12}  {'current':>12}  {'change':>8}")
+
+    regressions = []
+    for n in names:
+        b, c = base[n], cur[n]
+        change = (c - b) / b * 100.0 if b > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions.append(n)
+        print(f"{n:<{width}}  {b:>12.1f}  {c:>12.1f}  {change:>+7.1f}%{flag}")
+
+    for n in sorted(set(base) - set(cur)):
+        print(f"{n:<{width}}  (missing from current run)")
+    for n in sorted(set(cur) - set(base)):
+        print(f"{n:<{width}}  (new, no baseline)")
+
+    if regressions:
+        print(f"\n[bench_compare] {len(regressions)} benchmark(s) slower than "
+              f"{args.threshold:g}%: {', '.join(regressions)}")
+        return 1
+
+    print(f"\n[bench_compare] OK: no benchmark slower than {args.threshold:g}%")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
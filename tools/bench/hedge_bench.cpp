@@ -0,0 +1,224 @@
+// ─── restaurant_pos_hedgebench ───────────────────────────────────────────────
+// Tail latency of one ApiLogicServer GET with and without request hedging.
+//
+// Runs the same closed-loop workload twice through HttpClient: first plain,
+// then hedged with the delay RestApiService would pick (Hedger at the given
+// quantile, or a fixed delay) under the same extra-load budget.  Prints the
+// latency distribution of both runs and how many duplicates were sent.
+//
+// Meant to run against restaurant_pos_mock_als with a heavy tail, e.g.
+//
+//   restaurant_pos_mock_als --port 5656 --latency-ms 10 --jitter-ms 10
+//       --tail-rate 0.02 --tail-ms 1000 &
+//   restaurant_pos_hedgebench --url http://localhost:5656/api --requests 4000
+
+#include "services/HttpClient.h"
+#include "services/Resilience.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// ─── Options ─────────────────────────────────────────────────────────────────
+
+struct Options {
+    std::string url = "http://localhost:5656/api";
+    std::string path = "/orders/?filter%5Brestaurant_id%5D=1&filter%5Bstatus%5D=Pending";
+    int requests = 4000;               // per run
+    int concurrency = 8;
+    int warmup = 200;                  // unmeasured requests that prime the Hedger
+    double quantile = 0.95;
+    long fixedMs = 0;                  // > 0: fixed delay instead of the quantile
+    double maxRatio = 0.1;
+    long timeoutMs = 5000;
+};
+
+void usage(const char* argv0) {
+    std::cout <<
+        "Usage: " << argv0 << " [options]\n"
+        "  --url URL                 ApiLogicServer base URL (default http://localhost:5656/api)\n"
+        "  --path PATH               GET path below the base URL (default: pending orders of restaurant 1)\n"
+        "  --requests N              measured requests per run (default 4000)\n"
+        "  --concurrency N           client threads (default 8)\n"
+        "  --warmup N                unmeasured requests before each run (default 200)\n"
+        "  --quantile Q              adaptive hedge delay quantile (default 0.95)\n"
+        "  --fixed-ms MS             fixed hedge delay instead of the quantile\n"
+        "  --max-ratio R             duplicates allowed per request (default 0.1)\n"
+        "  --timeout-ms MS           per-request deadline (default 5000)\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + a);
+            return argv[++i];
+        };
+        if      (a == "--url")         o.url = next();
+        else if (a == "--path")        o.path = next();
+        else if (a == "--requests")    o.requests = std::atoi(next());
+        else if (a == "--concurrency") o.concurrency = std::atoi(next());
+        else if (a == "--warmup")      o.warmup = std::atoi(next());
+        else if (a == "--quantile")    o.quantile = std::atof(next());
+        else if (a == "--fixed-ms")    o.fixedMs = std::atol(next());
+        else if (a == "--max-ratio")   o.maxRatio = std::atof(next());
+        else if (a == "--timeout-ms")  o.timeoutMs = std::atol(next());
+        else if (a == "--help" || a == "-h") { usage(argv[0]); return false; }
+        else throw std::runtime_error("unknown option " + a);
+    }
+    if (o.requests <= 0 || o.concurrency <= 0) {
+        throw std::runtime_error("--requests and --concurrency must be positive");
+    }
+    if (o.fixedMs > 0) o.quantile = 0;
+    return true;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = (size_t)std::ceil(p / 100.0 * sorted.size());
+    return sorted[std::min(sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+}
+
+// ─── Runs ────────────────────────────────────────────────────────────────────
+
+struct Result {
+    std::vector<double> ms;
+    long long errors = 0;
+    long long duplicates = 0;
+    long long hedgeWins = 0;
+    double elapsedSec = 0;
+};
+
+// `hedger` null: plain run.  Each thread takes request numbers from a shared
+// counter until `count` have been sent.
+Result run(const Options& o, HttpClient& http, Hedger* hedger, int count) {
+    const std::string endpoint = "hedgebench";
+    std::atomic<int> nextRequest{0};
+    std::atomic<long long> duplicates{0};
+    std::vector<Result> perThread(o.concurrency);
+
+    std::function<bool()> admit;
+    if (hedger) {
+        auto spend = hedger->admission(endpoint);
+        admit = [spend, &duplicates] {
+            if (!spend()) return false;
+            duplicates++;
+            return true;
+        };
+    }
+
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < o.concurrency; t++) {
+        threads.emplace_back([&, t] {
+            Result& r = perThread[t];
+            for (int n = nextRequest++; n < count; n = nextRequest++) {
+                HttpRequest req;
+                req.url = o.url + o.path;
+                req.headers = {"Accept: application/vnd.api+json"};
+                req.timeoutMs = o.timeoutMs;
+                if (hedger) {
+                    long delay = hedger->delayMs(endpoint, o.quantile, o.fixedMs);
+                    if (delay > 0 && delay < req.timeoutMs) {
+                        req.hedgeAfterMs = delay;
+                        req.hedgeAllowed = admit;
+                    }
+                }
+
+                auto sent = Clock::now();
+                HttpResponse resp = http.perform(req);
+                auto elapsed = Clock::now() - sent;
+                if (hedger && resp.ok()) hedger->record(endpoint, elapsed, resp.hedged);
+
+                if (!resp.ok()) r.errors++;
+                if (resp.hedged) r.hedgeWins++;
+                r.ms.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    Result merged;
+    merged.elapsedSec = std::chrono::duration<double>(Clock::now() - start).count();
+    for (auto& r : perThread) {
+        merged.ms.insert(merged.ms.end(), r.ms.begin(), r.ms.end());
+        merged.errors += r.errors;
+        merged.hedgeWins += r.hedgeWins;
+    }
+    merged.duplicates = duplicates;
+    std::sort(merged.ms.begin(), merged.ms.end());
+    return merged;
+}
+
+// ─── Report ──────────────────────────────────────────────────────────────────
+
+void printHeader() {
+    std::cout << "\n" << std::left << std::setw(12) << "run"
+              << std::right << std::setw(8) << "count" << std::setw(6) << "err"
+              << std::setw(9) << "p50 ms" << std::setw(9) << "p95 ms"
+              << std::setw(9) << "p99 ms" << std::setw(10) << "p99.9 ms"
+              << std::setw(9) << "max ms" << std::setw(10) << "extra %"
+              << std::setw(8) << "wins" << "\n"
+              << std::string(90, '-') << "\n";
+}
+
+void printRow(const std::string& name, const Result& r) {
+    double extra = r.ms.empty() ? 0.0 : 100.0 * r.duplicates / r.ms.size();
+    std::cout << std::left << std::setw(12) << name << std::right
+              << std::setw(8) << r.ms.size() << std::setw(6) << r.errors
+              << std::fixed << std::setprecision(1)
+              << std::setw(9) << percentile(r.ms, 50)
+              << std::setw(9) << percentile(r.ms, 95)
+              << std::setw(9) << percentile(r.ms, 99)
+              << std::setw(10) << percentile(r.ms, 99.9)
+              << std::setw(9) << (r.ms.empty() ? 0.0 : r.ms.back())
+              << std::setw(10) << extra
+              << std::setw(8) << r.hedgeWins << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options o;
+        if (!parseArgs(argc, argv, o)) return 0;
+
+        HttpClient http;
+
+        std::cout << "[hedgebench] " << o.url << o.path << "\n"
+                  << "[hedgebench] " << o.requests << " requests x 2 runs, concurrency "
+                  << o.concurrency << ", hedge at "
+                  << (o.fixedMs > 0 ? std::to_string(o.fixedMs) + " ms"
+                                    : "p" + std::to_string((int)std::lround(o.quantile * 100)))
+                  << ", max extra load " << o.maxRatio * 100 << "%" << std::endl;
+
+        run(o, http, nullptr, o.warmup);            // connections
+        Result plain = run(o, http, nullptr, o.requests);
+
+        Hedger hedger(Hedger::Options{o.maxRatio});
+        run(o, http, &hedger, o.warmup);            // latency history
+        Result hedged = run(o, http, &hedger, o.requests);
+
+        printHeader();
+        printRow("plain", plain);
+        printRow("hedged", hedged);
+        std::cout << std::string(90, '-') << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "[hedgebench] " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,181 @@
+// ─── restaurant_pos_outboxbench ──────────────────────────────────────────────
+// Front desk submit latency and replay throughput with the ALS write outbox.
+//
+// Submits orders (createOrder + addOrderItem per line) through RestApiService
+// from several threads, as FrontDeskView::submitOrder does, then waits until
+// the outbox has delivered everything.  Reports submit latency percentiles,
+// the submit rate, the replay rate and the enqueue → delivered lag.
+//
+// The site config must set api_outbox.  Stop restaurant_pos_mock_als during
+// the submit phase (or start it late) to see submits stay fast while the
+// queue builds up and drains afterwards.
+//
+//   restaurant_pos_outboxbench --config data/site-config.json --orders 500 --items 3
+
+#include "services/Metrics.h"
+#include "services/RestApiService.h"
+#include "services/SiteConfig.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// ─── Options ─────────────────────────────────────────────────────────────────
+
+struct Options {
+    std::string configPath = "data/site-config.json";
+    long long restaurantId = 1;
+    long long menuItemId = 0;          // 0: first item of the restaurant
+    int orders = 500;
+    int items = 3;                     // addOrderItem calls per order
+    int concurrency = 4;
+    double drainTimeoutSec = 300;
+};
+
+void usage(const char* argv0) {
+    std::cout <<
+        "Usage: " << argv0 << " [options]\n"
+        "  --config PATH             site config with api_base_url and api_outbox\n"
+        "                            (default data/site-config.json)\n"
+        "  --restaurant ID           restaurant to order for (default 1)\n"
+        "  --menu-item ID            item to order (default: first of the restaurant)\n"
+        "  --orders N                orders to submit (default 500)\n"
+        "  --items N                 lines per order (default 3)\n"
+        "  --concurrency N           submitting threads (default 4)\n"
+        "  --drain-timeout SEC       give up waiting for replay after (default 300)\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + a);
+            return argv[++i];
+        };
+        if      (a == "--config")        o.configPath = next();
+        else if (a == "--restaurant")    o.restaurantId = std::atoll(next());
+        else if (a == "--menu-item")     o.menuItemId = std::atoll(next());
+        else if (a == "--orders")        o.orders = std::atoi(next());
+        else if (a == "--items")         o.items = std::atoi(next());
+        else if (a == "--concurrency")   o.concurrency = std::atoi(next());
+        else if (a == "--drain-timeout") o.drainTimeoutSec = std::atof(next());
+        else if (a == "--help" || a == "-h") { usage(argv[0]); return false; }
+        else throw std::runtime_error("unknown option " + a);
+    }
+    if (o.orders <= 0 || o.concurrency <= 0 || o.items < 0) {
+        throw std::runtime_error("--orders and --concurrency must be positive");
+    }
+    return true;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = (size_t)std::ceil(p / 100.0 * sorted.size());
+    return sorted[std::min(sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options o;
+        if (!parseArgs(argc, argv, o)) return 0;
+
+        auto siteConfig = std::make_shared<SiteConfig>(o.configPath);
+        if (siteConfig->apiOutboxPath().empty()) {
+            throw std::runtime_error("api_outbox is not set in " + o.configPath);
+        }
+        RestApiService api(siteConfig);
+
+        if (o.menuItemId == 0) {
+            auto menu = api.getMenuItemsByRestaurant(o.restaurantId);
+            if (menu.empty()) throw std::runtime_error("restaurant has no menu items");
+            o.menuItemId = menu.front().id;
+        }
+
+        // Same instruments the Outbox registered
+        auto& r = MetricsRegistry::instance();
+        MetricGauge& depth = r.gauge("pos_outbox_depth", "", "");
+        MetricCounter& replayed = r.counter("pos_outbox_replayed_total", "", "");
+        MetricCounter& rejected = r.counter("pos_outbox_rejected_total", "", "");
+        LatencyHistogram& lag = r.histogram("pos_outbox_replay_lag_seconds", "", "");
+
+        uint64_t replayedBefore = replayed.value();
+        uint64_t rejectedBefore = rejected.value();
+        int64_t backlog = depth.value();
+        if (backlog > 0) {
+            std::cout << "[outboxbench] " << backlog << " writes already queued; "
+                      << "they are included in the replay figures" << std::endl;
+        }
+
+        // ── Submit ──
+        std::atomic<int> nextOrder{0};
+        std::atomic<long long> errors{0};
+        std::vector<std::vector<double>> perThread(o.concurrency);
+        auto start = Clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < o.concurrency; t++) {
+            threads.emplace_back([&, t] {
+                for (int n = nextOrder++; n < o.orders; n = nextOrder++) {
+                    auto sent = Clock::now();
+                    try {
+                        auto order = api.createOrder(o.restaurantId, 1 + n % 20, "Outbox Bench", "");
+                        for (int k = 0; k < o.items; k++) {
+                            api.addOrderItem(order.id, o.menuItemId, 1, "");
+                        }
+                    } catch (std::exception& e) {
+                        if (errors++ == 0) std::cerr << "[outboxbench] " << e.what() << std::endl;
+                    }
+                    perThread[t].push_back(
+                        std::chrono::duration<double, std::milli>(Clock::now() - sent).count());
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+        double submitSec = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::vector<double> ms;
+        for (auto& v : perThread) ms.insert(ms.end(), v.begin(), v.end());
+        std::sort(ms.begin(), ms.end());
+
+        // ── Drain ──
+        auto drainDeadline = start + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(submitSec + o.drainTimeoutSec));
+        while (depth.value() > 0 && Clock::now() < drainDeadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        double totalSec = std::chrono::duration<double>(Clock::now() - start).count();
+        uint64_t delivered = replayed.value() - replayedBefore;
+        long long writes = (long long)o.orders * (1 + o.items) + backlog;
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "\nSubmit: " << ms.size() << " orders x " << 1 + o.items << " writes, "
+                  << errors << " errors in " << submitSec << "s ("
+                  << ms.size() / submitSec << " orders/s)\n"
+                  << "  per order  p50 " << percentile(ms, 50) << " ms  p95 "
+                  << percentile(ms, 95) << " ms  p99 " << percentile(ms, 99)
+                  << " ms  max " << (ms.empty() ? 0.0 : ms.back()) << " ms\n"
+                  << "Replay: " << delivered << "/" << writes << " writes delivered, "
+                  << rejected.value() - rejectedBefore << " rejected, "
+                  << depth.value() << " still queued after " << totalSec << "s ("
+                  << delivered / totalSec << " writes/s)\n"
+                  << "  lag        p50 " << lag.quantileMicros(0.50) / 1000.0 << " ms  p99 "
+                  << lag.quantileMicros(0.99) / 1000.0 << " ms" << std::endl;
+        return depth.value() > 0 ? 2 : 0;
+    } catch (const std::exception& e) {
+        std::cerr << "[outboxbench] " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,207 @@
+// ─── restaurant_pos_payloadbench ─────────────────────────────────────────────
+// Response size and parse time of RestApiService's GETs, before and after
+// sparse fieldsets and response compression.
+//
+// For each call site that now sends fields[type]=..., fetches the URL as it
+// was (all attributes) and as it is (sparse) through HttpClient, each with
+// and without Accept-Encoding (libcurl offers every coding it decodes).
+// Reports bytes on the wire, bytes after decoding, median transfer time and
+// median parse time (the same JsonApi parse RestApiService runs).
+// getOrders is included unchanged as a compression-only reference.
+//
+//   restaurant_pos_mock_als --db big.db --port 5656 &
+//   restaurant_pos_payloadbench --url http://localhost:5656/api --iterations 50
+
+#include "services/HttpClient.h"
+#include "services/JsonApi.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace JsonApi;
+
+// ─── Options ─────────────────────────────────────────────────────────────────
+
+struct Options {
+    std::string url = "http://localhost:5656/api";
+    long long restaurantId = 1;
+    long long orderId = 0;             // 0: newest order of the restaurant
+    long long menuItemId = 0;          // 0: item of that order
+    int iterations = 50;               // per variant
+};
+
+void usage(const char* argv0) {
+    std::cout <<
+        "Usage: " << argv0 << " [options]\n"
+        "  --url URL                 ApiLogicServer base URL (default http://localhost:5656/api)\n"
+        "  --restaurant ID           restaurant whose orders are fetched (default 1)\n"
+        "  --order ID                order for getOrderItems (default: newest)\n"
+        "  --menu-item ID            item for the addOrderItem price lookup\n"
+        "  --iterations N            fetches per variant (default 50)\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + a);
+            return argv[++i];
+        };
+        if      (a == "--url")         o.url = next();
+        else if (a == "--restaurant")  o.restaurantId = std::atoll(next());
+        else if (a == "--order")       o.orderId = std::atoll(next());
+        else if (a == "--menu-item")   o.menuItemId = std::atoll(next());
+        else if (a == "--iterations")  o.iterations = std::atoi(next());
+        else if (a == "--help" || a == "-h") { usage(argv[0]); return false; }
+        else throw std::runtime_error("unknown option " + a);
+    }
+    if (o.iterations <= 0) throw std::runtime_error("--iterations must be positive");
+    return true;
+}
+
+double median(std::vector<double> v) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+// ─── Call sites ──────────────────────────────────────────────────────────────
+// URLs as RestApiService builds them; `fields` is what it appends now.
+
+struct CallSite {
+    std::string name;
+    std::string url;
+    std::string fields;                // empty: unchanged call site
+    std::function<size_t(const std::string&)> parse;   // returns the result size
+};
+
+volatile size_t gSink;   // keeps the parses from being optimised away
+
+HttpResponse fetch(HttpClient& http, const std::string& url) {
+    HttpRequest req;
+    req.url = url;
+    req.headers = {"Accept: application/vnd.api+json"};
+    HttpResponse res = http.perform(req);
+    if (!res.ok()) {
+        throw std::runtime_error("GET " + url + " failed: " +
+                                 (res.error.empty() ? "HTTP " + std::to_string(res.status)
+                                                    : res.error));
+    }
+    return res;
+}
+
+struct Sample {
+    long long wireBytes = 0;
+    size_t bodyBytes = 0;
+    double fetchMs = 0;
+    double parseMs = 0;
+};
+
+Sample measure(HttpClient& http, const CallSite& site, bool sparse, bool compressed,
+               int iterations) {
+    HttpRequest req;
+    req.url = site.url;
+    if (sparse) req.url += (req.url.find('?') == std::string::npos ? "?" : "&") + site.fields;
+    req.headers = {"Accept: application/vnd.api+json"};
+    req.compressed = compressed;
+
+    Sample s;
+    std::vector<double> fetchMs, parseMs;
+    for (int i = 0; i < iterations; i++) {
+        auto t0 = Clock::now();
+        HttpResponse res = http.perform(req);
+        auto t1 = Clock::now();
+        if (!res.ok()) throw std::runtime_error("GET " + req.url + " failed");
+        gSink = site.parse(res.body);
+        auto t2 = Clock::now();
+        fetchMs.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+        parseMs.push_back(std::chrono::duration<double, std::milli>(t2 - t1).count());
+        s.wireBytes = res.wireBytes;
+        s.bodyBytes = res.body.size();
+    }
+    s.fetchMs = median(fetchMs);
+    s.parseMs = median(parseMs);
+    return s;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options o;
+        if (!parseArgs(argc, argv, o)) return 0;
+
+        HttpClient http;
+        std::string rid = std::to_string(o.restaurantId);
+        std::string ordersUrl = o.url + "/orders/?filter%5Brestaurant_id%5D=" + rid + "&sort=-id";
+
+        if (o.orderId == 0) {
+            auto orders = parseList(fetch(http, ordersUrl + "&page%5Blimit%5D=1").body,
+                                    &parseOrder);
+            if (orders.empty()) throw std::runtime_error("restaurant has no orders");
+            o.orderId = orders.front().id;
+        }
+        std::string itemsUrl = o.url + "/order_item/?filter%5Border_id%5D=" +
+                               std::to_string(o.orderId) + "&include=menu_item";
+        if (o.menuItemId == 0) {
+            auto items = parseOrderItemList(fetch(http, itemsUrl).body);
+            if (items.empty()) throw std::runtime_error("order has no items; pass --menu-item");
+            o.menuItemId = items.front().menu_item_id;
+        }
+
+        auto countOrders = [](const std::string& json) {
+            return parseList(json, &parseOrder).size();
+        };
+        std::vector<CallSite> sites = {
+            {"getPendingOrderCount",
+             o.url + "/orders/?filter%5Brestaurant_id%5D=" + rid +
+                 "&filter%5Bstatus%5D=Pending&sort=id",
+             "fields%5Borders%5D=status", countOrders},
+            {"getOrderCount", ordersUrl, "fields%5Borders%5D=status", countOrders},
+            {"getRevenue", ordersUrl, "fields%5Borders%5D=status,total", countOrders},
+            {"getOrderItems", itemsUrl, "fields%5Bmenu_item%5D=name",
+             [](const std::string& json) { return parseOrderItemList(json).size(); }},
+            {"addOrderItem (price)",
+             o.url + "/menu_item/" + std::to_string(o.menuItemId) + "/",
+             "fields%5Bmenu_item%5D=price",
+             [](const std::string& json) { return (size_t)parseMenuItem(parseDataObject(json)).id; }},
+            {"getOrders (reference)", ordersUrl, "", countOrders},
+        };
+
+        std::cout << std::left << std::setw(24) << "call" << std::setw(8) << "fields"
+                  << std::setw(10) << "encoding" << std::right << std::setw(12) << "wire B"
+                  << std::setw(12) << "decoded B" << std::setw(11) << "fetch ms"
+                  << std::setw(11) << "parse ms" << "\n"
+                  << std::fixed << std::setprecision(3);
+        for (auto& site : sites) {
+            for (bool sparse : {false, true}) {
+                if (sparse && site.fields.empty()) continue;
+                for (bool compressed : {false, true}) {
+                    Sample s = measure(http, site, sparse, compressed, o.iterations);
+                    std::cout << std::left << std::setw(24) << site.name
+                              << std::setw(8) << (sparse ? "sparse" : "all")
+                              << std::setw(10) << (compressed ? "any" : "identity")
+                              << std::right << std::setw(12) << s.wireBytes
+                              << std::setw(12) << s.bodyBytes
+                              << std::setw(11) << s.fetchMs
+                              << std::setw(11) << s.parseMs << "\n";
+                }
+            }
+        }
+        std::cout << std::flush;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "[payloadbench] " << e.what() << std::endl;
+        return 1;
+    }
+}
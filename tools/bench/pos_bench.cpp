@@ -0,0 +1,474 @@
+// ─── pos_bench ───────────────────────────────────────────────────────────────
+// Service-layer microbenchmarks (Google Benchmark):
+//   BM_Local_*    every IApiService method on LocalApiService
+//   BM_JsonApi_*  JSON:API parse helpers on recorded ApiLogicServer payloads
+//   BM_JsonBody_* request bodies: JsonWriter against the old stringstream code
+//   BM_ToDto_*    Wt::Dbo::ptr<T> → DTO conversion
+//
+// Machine-readable results for bench_compare:
+//   pos_bench --benchmark_out=bench_result.json --benchmark_out_format=json
+//
+// Extra flags (after Google Benchmark's own):
+//   --db PATH         benchmark against an existing database (e.g. one from
+//                     restaurant_pos_loadgen).  Mutating benchmarks WRITE to it.
+//   --orders N        orders to pre-create in the scratch database (default 500)
+//   --payloads DIR    recorded JSON:API payloads (default: tools/bench/payloads)
+
+#include "services/ApiService.h"
+#include "services/DtoMapping.h"
+#include "services/JsonApi.h"
+#include "services/LocalApiService.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#ifndef POS_BENCH_PAYLOAD_DIR
+#define POS_BENCH_PAYLOAD_DIR "tools/bench/payloads"
+#endif
+
+namespace {
+
+// ─── Fixture state (set up once in main) ─────────────────────────────────────
+
+struct BenchEnv {
+    std::string dbPath = "pos_bench.db";
+    bool scratchDb = true;
+    int orders = 500;
+    std::string payloadDir = POS_BENCH_PAYLOAD_DIR;
+
+    std::unique_ptr<LocalApiService> local;
+    std::unique_ptr<ApiService> dbo;     // direct Dbo access for toDto benches
+
+    long long restaurantId = 0;
+    long long categoryId = 0;
+    long long menuItemId = 0;
+    long long orderId = 0;          // an order with line items
+    long long scratchOrderId = 0;   // mutated by the write benchmarks
+    long long appendOrderId = 0;    // grows under BM_Local_addOrderItem
+
+    std::string ordersJson;
+    std::string orderJson;
+    std::string orderItemsJson;
+    std::string menuItemsJson;
+    std::string categoriesJson;
+};
+
+BenchEnv env;
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("cannot read " + path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+void setUp() {
+    if (env.scratchDb) std::remove(env.dbPath.c_str());
+
+    env.local = std::make_unique<LocalApiService>(env.dbPath);
+    env.local->initializeDatabase();
+    env.local->seedDatabase();
+
+    auto restaurants = env.local->getRestaurants();
+    if (restaurants.empty()) throw std::runtime_error("database has no restaurants");
+    env.restaurantId = restaurants.front().id;
+
+    auto categories = env.local->getCategories(env.restaurantId);
+    if (categories.empty()) throw std::runtime_error("restaurant has no categories");
+    env.categoryId = categories.front().id;
+
+    auto items = env.local->getMenuItemsByCategory(env.categoryId);
+    if (items.empty()) throw std::runtime_error("category has no menu items");
+    env.menuItemId = items.front().id;
+
+    if (env.scratchDb) {
+        // Give the read paths realistic list sizes and status mix
+        const char* statuses[] = {"Served", "Served", "Served", "Cancelled",
+                                  "Pending", "In Progress", "Ready"};
+        for (int i = 0; i < env.orders; i++) {
+            auto o = env.local->createOrder(env.restaurantId, 1 + i % 50, "Bench Guest", "");
+            for (int k = 0; k < 3; k++) {
+                env.local->addOrderItem(o.id, items[(i + k) % items.size()].id, 1 + k % 2, "");
+            }
+            env.local->updateOrderStatus(o.id, statuses[i % 7]);
+        }
+    }
+
+    for (auto& o : env.local->getActiveOrders(env.restaurantId)) {
+        if (!env.local->getOrderItems(o.id).empty()) { env.orderId = o.id; break; }
+    }
+    if (env.orderId == 0) {
+        auto o = env.local->createOrder(env.restaurantId, 1, "Bench Guest", "");
+        env.local->addOrderItem(o.id, env.menuItemId, 2, "");
+        env.orderId = o.id;
+    }
+    env.scratchOrderId = env.local->createOrder(env.restaurantId, 1, "Bench Scratch", "").id;
+    env.appendOrderId = env.local->createOrder(env.restaurantId, 1, "Bench Append", "").id;
+
+    env.dbo = std::make_unique<ApiService>(env.dbPath);
+
+    env.ordersJson     = readFile(env.payloadDir + "/orders_200.json");
+    env.orderJson      = readFile(env.payloadDir + "/order_single.json");
+    env.orderItemsJson = readFile(env.payloadDir + "/order_items_include.json");
+    env.menuItemsJson  = readFile(env.payloadDir + "/menu_items_category.json");
+    env.categoriesJson = readFile(env.payloadDir + "/categories.json");
+}
+
+// ─── LocalApiService: reads ──────────────────────────────────────────────────
+
+void BM_Local_getRestaurants(benchmark::State& state) {
+    for (auto _ : state) benchmark::DoNotOptimize(env.local->getRestaurants());
+}
+BENCHMARK(BM_Local_getRestaurants);
+
+void BM_Local_getRestaurant(benchmark::State& state) {
+    for (auto _ : state) benchmark::DoNotOptimize(env.local->getRestaurant(env.restaurantId));
+}
+BENCHMARK(BM_Local_getRestaurant);
+
+void BM_Local_getCategories(benchmark::State& state) {
+    for (auto _ : state) benchmark::DoNotOptimize(env.local->getCategories(env.restaurantId));
+}
+BENCHMARK(BM_Local_getCategories);
+
+void BM_Local_getMenuItemsByCategory(benchmark::State& state) {
+    for (auto _ : state)
+        benchmark::DoNotOptimize(env.local->getMenuItemsByCategory(env.categoryId));
+}
+BENCHMARK(BM_Local_getMenuItemsByCategory);
+
+void BM_Local_getMenuItemsByRestaurant(benchmark::State& state) {
+    for (auto _ : state)
+        benchmark::DoNotOptimize(env.local->getMenuItemsByRestaurant(env.restaurantId));
+}
+BENCHMARK(BM_Local_getMenuItemsByRestaurant);
+
+void BM_Local_getMenuItem(benchmark::State& state) {
+    for (auto _ : state) benchmark::DoNotOptimize(env.local->getMenuItem(env.menuItemId));
+}
+BENCHMARK(BM_Local_getMenuItem);
+
+void BM_Local_getOrders(benchmark::State& state) {
+    size_t rows = 0;
+    for (auto _ : state) {
+        auto v = env.local->getOrders(env.restaurantId);
+        rows += v.size();
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed((int64_t)rows);
+}
+BENCHMARK(BM_Local_getOrders)->Unit(benchmark::kMillisecond);
+
+void BM_Local_getOrdersByStatus(benchmark::State& state) {
+    for (auto _ : state)
+        benchmark::DoNotOptimize(env.local->getOrdersByStatus(env.restaurantId, "Pending"));
+}
+BENCHMARK(BM_Local_getOrdersByStatus);
+
+void BM_Local_getActiveOrders(benchmark::State& state) {
+    for (auto _ : state) benchmark::DoNotOptimize(env.local->getActiveOrders(env.restaurantId));
+}
+BENCHMARK(BM_Local_getActiveOrders);
+
+void BM_Local_getOrder(benchmark::State& state) {
+    for (auto _ : state) benchmark::DoNotOptimize(env.local->getOrder(env.orderId));
+}
+BENCHMARK(BM_Local_getOrder);
+
+void BM_Local_getOrderItems(benchmark::State& state) {
+    for (auto _ : state) benchmark::DoNotOptimize(env.local->getOrderItems(env.orderId));
+}
+BENCHMARK(BM_Local_getOrderItems);
+
+void BM_Local_getOrderCount(benchmark::State& state) {
+    for (auto _ : state) benchmark::DoNotOptimize(env.local->getOrderCount(env.restaurantId));
+}
+BENCHMARK(BM_Local_getOrderCount);
+
+void BM_Local_getRevenue(benchmark::State& state) {
+    for (auto _ : state) benchmark::DoNotOptimize(env.local->getRevenue(env.restaurantId));
+}
+BENCHMARK(BM_Local_getRevenue);
+
+void BM_Local_getPendingOrderCount(benchmark::State& state) {
+    for (auto _ : state)
+        benchmark::DoNotOptimize(env.local->getPendingOrderCount(env.restaurantId));
+}
+BENCHMARK(BM_Local_getPendingOrderCount);
+
+void BM_Local_getInProgressOrderCount(benchmark::State& state) {
+    for (auto _ : state)
+        benchmark::DoNotOptimize(env.local->getInProgressOrderCount(env.restaurantId));
+}
+BENCHMARK(BM_Local_getInProgressOrderCount);
+
+// ─── LocalApiService: writes (each iteration commits a transaction) ──────────
+
+void BM_Local_createOrder(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            env.local->createOrder(env.restaurantId, 7, "Bench Guest", "bench"));
+    }
+}
+BENCHMARK(BM_Local_createOrder);
+
+void BM_Local_addOrderItem(benchmark::State& state) {
+    for (auto _ : state)
+        env.local->addOrderItem(env.appendOrderId, env.menuItemId, 1, "");
+}
+BENCHMARK(BM_Local_addOrderItem);
+
+void BM_Local_updateOrderStatus(benchmark::State& state) {
+    bool flip = false;
+    for (auto _ : state) {
+        env.local->updateOrderStatus(env.scratchOrderId, flip ? "Pending" : "In Progress");
+        flip = !flip;
+    }
+}
+BENCHMARK(BM_Local_updateOrderStatus);
+
+void BM_Local_cancelOrder(benchmark::State& state) {
+    for (auto _ : state) env.local->cancelOrder(env.scratchOrderId);
+}
+BENCHMARK(BM_Local_cancelOrder);
+
+void BM_Local_updateMenuItemAvailability(benchmark::State& state) {
+    bool flip = false;
+    for (auto _ : state) {
+        env.local->updateMenuItemAvailability(env.menuItemId, flip);
+        flip = !flip;
+    }
+    env.local->updateMenuItemAvailability(env.menuItemId, true);
+}
+BENCHMARK(BM_Local_updateMenuItemAvailability);
+
+// ─── JSON:API parsing (RestApiService hot path, no network) ──────────────────
+
+void BM_JsonApi_parseDataArray_orders(benchmark::State& state) {
+    for (auto _ : state) benchmark::DoNotOptimize(JsonApi::parseDataArray(env.ordersJson));
+    state.SetBytesProcessed((int64_t)(state.iterations() * env.ordersJson.size()));
+}
+BENCHMARK(BM_JsonApi_parseDataArray_orders);
+
+void BM_JsonApi_parseDataObject_order(benchmark::State& state) {
+    for (auto _ : state) benchmark::DoNotOptimize(JsonApi::parseDataObject(env.orderJson));
+    state.SetBytesProcessed((int64_t)(state.iterations() * env.orderJson.size()));
+}
+BENCHMARK(BM_JsonApi_parseDataObject_order);
+
+void BM_JsonApi_parseOrder(benchmark::State& state) {
+    auto arr = JsonApi::parseDataArray(env.ordersJson);
+    for (auto _ : state) {
+        for (int i = 0; i < (int)arr.size(); i++) {
+            const Wt::Json::Object& obj = arr[i];
+            benchmark::DoNotOptimize(JsonApi::parseOrder(obj));
+        }
+    }
+    state.SetItemsProcessed((int64_t)(state.iterations() * arr.size()));
+}
+BENCHMARK(BM_JsonApi_parseOrder);
+
+void BM_JsonApi_buildIncludedMap(benchmark::State& state) {
+    for (auto _ : state) benchmark::DoNotOptimize(JsonApi::buildIncludedMap(env.orderItemsJson));
+    state.SetBytesProcessed((int64_t)(state.iterations() * env.orderItemsJson.size()));
+}
+BENCHMARK(BM_JsonApi_buildIncludedMap);
+
+// Full response → DTO paths, mirroring the RestApiService methods
+
+void BM_JsonApi_getOrders(benchmark::State& state) {
+    for (auto _ : state) {
+        auto arr = JsonApi::parseDataArray(env.ordersJson);
+        std::vector<OrderDto> out;
+        for (int i = 0; i < (int)arr.size(); i++) {
+            const Wt::Json::Object& obj = arr[i];
+            out.push_back(JsonApi::parseOrder(obj));
+        }
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetBytesProcessed((int64_t)(state.iterations() * env.ordersJson.size()));
+}
+BENCHMARK(BM_JsonApi_getOrders);
+
+void BM_JsonApi_getOrderItems(benchmark::State& state) {
+    for (auto _ : state) {
+        auto out = JsonApi::parseOrderItemList(env.orderItemsJson);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetBytesProcessed((int64_t)(state.iterations() * env.orderItemsJson.size()));
+}
+BENCHMARK(BM_JsonApi_getOrderItems);
+
+void BM_JsonApi_getMenuItemsByCategory(benchmark::State& state) {
+    for (auto _ : state) {
+        auto arr = JsonApi::parseDataArray(env.menuItemsJson);
+        std::vector<MenuItemDto> out;
+        for (int i = 0; i < (int)arr.size(); i++) {
+            const Wt::Json::Object& obj = arr[i];
+            out.push_back(JsonApi::parseMenuItem(obj));
+        }
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetBytesProcessed((int64_t)(state.iterations() * env.menuItemsJson.size()));
+}
+BENCHMARK(BM_JsonApi_getMenuItemsByCategory);
+
+void BM_JsonApi_getCategories(benchmark::State& state) {
+    for (auto _ : state) {
+        auto arr = JsonApi::parseDataArray(env.categoriesJson);
+        std::vector<CategoryDto> out;
+        for (int i = 0; i < (int)arr.size(); i++) {
+            const Wt::Json::Object& obj = arr[i];
+            out.push_back(JsonApi::parseCategory(obj));
+        }
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetBytesProcessed((int64_t)(state.iterations() * env.categoriesJson.size()));
+}
+BENCHMARK(BM_JsonApi_getCategories);
+
+// ─── JSON:API request bodies ─────────────────────────────────────────────────
+// The builders RestApiService posts, against the stringstream code they
+// replaced (kept here as the reference; it did not escape strings).
+
+const std::string kCustomerName = "Table 12 - Alvarez";
+const std::string kNotes = "Birthday, bring the cake out with dessert";
+const std::string kInstructions = "No onions; sauce on the side";
+
+std::string streamOrderBody(long long restaurantId, int tableNumber,
+                            const std::string& customerName, const std::string& notes) {
+    std::stringstream body;
+    body << "{\"data\":{\"type\":\"orders\",\"attributes\":{"
+         << "\"restaurant_id\":" << restaurantId << ","
+         << "\"table_number\":" << tableNumber << ","
+         << "\"status\":\"Pending\","
+         << "\"customer_name\":\"" << customerName << "\","
+         << "\"notes\":\"" << notes << "\","
+         << "\"total\":0.0"
+         << "}}}";
+    return body.str();
+}
+
+std::string streamOrderItemBody(long long orderId, long long menuItemId, int quantity,
+                                double unitPrice, const std::string& instructions) {
+    std::stringstream body;
+    body << "{\"data\":{\"type\":\"order_item\",\"attributes\":{"
+         << "\"order_id\":" << orderId << ","
+         << "\"menu_item_id\":" << menuItemId << ","
+         << "\"quantity\":" << quantity << ","
+         << "\"unit_price\":" << std::fixed << std::setprecision(2) << unitPrice << ","
+         << "\"special_instructions\":\"" << instructions << "\""
+         << "}}}";
+    return body.str();
+}
+
+void BM_JsonBody_stringstream_newOrder(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(streamOrderBody(3, 12, kCustomerName, kNotes));
+    }
+}
+BENCHMARK(BM_JsonBody_stringstream_newOrder);
+
+void BM_JsonBody_newOrder(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(JsonApi::newOrderBody(3, 12, kCustomerName, kNotes));
+    }
+}
+BENCHMARK(BM_JsonBody_newOrder);
+
+void BM_JsonBody_stringstream_orderItem(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(streamOrderItemBody(123456, 42, 2, 14.5, kInstructions));
+    }
+}
+BENCHMARK(BM_JsonBody_stringstream_orderItem);
+
+void BM_JsonBody_orderItem(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(JsonApi::orderItemBody(123456, 42, 2, 14.5, kInstructions));
+    }
+}
+BENCHMARK(BM_JsonBody_orderItem);
+
+void BM_JsonBody_orderTotal(benchmark::State& state) {
+    for (auto _ : state) benchmark::DoNotOptimize(JsonApi::orderTotalBody(123456, 87.25));
+}
+BENCHMARK(BM_JsonBody_orderTotal);
+
+// ─── Wt::Dbo::ptr<T> → DTO ───────────────────────────────────────────────────
+
+void BM_ToDto_Order(benchmark::State& state) {
+    Wt::Dbo::Transaction t(env.dbo->session());
+    auto orders = env.dbo->getOrders(env.restaurantId);
+    for (auto _ : state) {
+        for (auto& p : orders) benchmark::DoNotOptimize(toDto(p));
+    }
+    state.SetItemsProcessed((int64_t)(state.iterations() * orders.size()));
+}
+BENCHMARK(BM_ToDto_Order);
+
+void BM_ToDto_MenuItem(benchmark::State& state) {
+    Wt::Dbo::Transaction t(env.dbo->session());
+    auto items = env.dbo->getMenuItemsByRestaurant(env.restaurantId);
+    for (auto _ : state) {
+        for (auto& p : items) benchmark::DoNotOptimize(toDto(p));
+    }
+    state.SetItemsProcessed((int64_t)(state.iterations() * items.size()));
+}
+BENCHMARK(BM_ToDto_MenuItem);
+
+void BM_ToDto_OrderItem(benchmark::State& state) {
+    Wt::Dbo::Transaction t(env.dbo->session());
+    auto items = env.dbo->getOrderItems(env.orderId);
+    for (auto _ : state) {
+        for (auto& p : items) benchmark::DoNotOptimize(toDto(p));
+    }
+    state.SetItemsProcessed((int64_t)(state.iterations() * items.size()));
+}
+BENCHMARK(BM_ToDto_OrderItem);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << "[pos_bench] missing value for " << a << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if      (a == "--db")       { env.dbPath = next(); env.scratchDb = false; }
+        else if (a == "--orders")   env.orders = std::atoi(next().c_str());
+        else if (a == "--payloads") env.payloadDir = next();
+        else {
+            std::cerr << "[pos_bench] unknown option " << a << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        setUp();
+    } catch (std::exception& e) {
+        std::cerr << "[pos_bench] Setup failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    benchmark::AddCustomContext("pos_bench.db", env.dbPath);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
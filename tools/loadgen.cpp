@@ -0,0 +1,537 @@
+// ─── restaurant_pos_loadgen ──────────────────────────────────────────────────
+// Builds a production-sized SQLite database for LocalApiService.
+//
+// The schema matches what Wt::Dbo's createTables() produces for the models in
+// src/models/Models.h, so the resulting file can be opened directly by
+// restaurant_pos (copy it to restaurant_pos.db) or by the load/bench tools.
+// Rows are written through prepared statements in large transactions with
+// journaling disabled; indexes are built once after the bulk load.
+//
+//   restaurant_pos_loadgen --db big.db --restaurants 20 --months 12 --orders-per-day 400
+//
+// produces ~2.9M orders / ~9.3M order items in well under a minute.
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+namespace {
+
+// ─── Options ─────────────────────────────────────────────────────────────────
+
+struct Options {
+    std::string dbPath       = "restaurant_pos_load.db";
+    int restaurants          = 3;
+    int categories           = 5;     // per restaurant
+    int itemsPerCategory     = 6;
+    int months               = 6;     // history depth (30-day months)
+    int ordersPerDay         = 150;   // per restaurant, average
+    int openOrders           = 8;     // per restaurant, Pending/In Progress/Ready
+    int batchSize            = 100000;
+    unsigned long long seed  = 42;
+    bool createIndexes       = true;
+    bool force               = false;
+};
+
+void usage(const char* argv0) {
+    std::cout <<
+        "Usage: " << argv0 << " [options]\n"
+        "  --db PATH              output database (default restaurant_pos_load.db)\n"
+        "  --restaurants N        number of restaurants (default 3)\n"
+        "  --categories N         categories per restaurant (default 5)\n"
+        "  --items N              menu items per category (default 6)\n"
+        "  --months N             months of order history (default 6)\n"
+        "  --orders-per-day N     average orders per restaurant per day (default 150)\n"
+        "  --open-orders N        live Pending/In Progress/Ready orders per restaurant (default 8)\n"
+        "  --batch N              rows per transaction (default 100000)\n"
+        "  --seed N               random seed (default 42)\n"
+        "  --no-indexes           skip secondary indexes (mirrors a bare Wt::Dbo schema)\n"
+        "  --force                overwrite an existing database file\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + a);
+            return argv[++i];
+        };
+        if      (a == "--db")             o.dbPath = next();
+        else if (a == "--restaurants")    o.restaurants = std::atoi(next());
+        else if (a == "--categories")     o.categories = std::atoi(next());
+        else if (a == "--items")          o.itemsPerCategory = std::atoi(next());
+        else if (a == "--months")         o.months = std::atoi(next());
+        else if (a == "--orders-per-day") o.ordersPerDay = std::atoi(next());
+        else if (a == "--open-orders")    o.openOrders = std::atoi(next());
+        else if (a == "--batch")          o.batchSize = std::atoi(next());
+        else if (a == "--seed")           o.seed = std::strtoull(next(), nullptr, 10);
+        else if (a == "--no-indexes")     o.createIndexes = false;
+        else if (a == "--force")          o.force = true;
+        else if (a == "--help" || a == "-h") { usage(argv[0]); return false; }
+        else throw std::runtime_error("unknown option " + a);
+    }
+    if (o.restaurants < 1 || o.categories < 1 || o.itemsPerCategory < 1 ||
+        o.months < 0 || o.ordersPerDay < 0 || o.openOrders < 0 || o.batchSize < 1) {
+        throw std::runtime_error("counts must be positive");
+    }
+    return true;
+}
+
+// ─── SQLite helpers ──────────────────────────────────────────────────────────
+
+class Db {
+public:
+    explicit Db(const std::string& path) {
+        if (sqlite3_open(path.c_str(), &db_) != SQLITE_OK) {
+            std::string msg = sqlite3_errmsg(db_);
+            sqlite3_close(db_);
+            throw std::runtime_error("cannot open " + path + ": " + msg);
+        }
+    }
+    ~Db() { sqlite3_close(db_); }
+
+    void exec(const std::string& sql) {
+        char* err = nullptr;
+        if (sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &err) != SQLITE_OK) {
+            std::string msg = err ? err : "unknown error";
+            sqlite3_free(err);
+            throw std::runtime_error(msg + " in: " + sql);
+        }
+    }
+
+    sqlite3_stmt* prepare(const char* sql) {
+        sqlite3_stmt* st = nullptr;
+        if (sqlite3_prepare_v2(db_, sql, -1, &st, nullptr) != SQLITE_OK)
+            throw std::runtime_error(std::string(sqlite3_errmsg(db_)) + " in: " + sql);
+        return st;
+    }
+
+    void step(sqlite3_stmt* st) {
+        if (sqlite3_step(st) != SQLITE_DONE)
+            throw std::runtime_error(sqlite3_errmsg(db_));
+        sqlite3_reset(st);
+    }
+
+private:
+    sqlite3* db_ = nullptr;
+};
+
+// Owns a prepared statement; bind helpers keep the insert loops readable.
+class Stmt {
+public:
+    Stmt(Db& db, const char* sql) : db_(db), st_(db.prepare(sql)) {}
+    ~Stmt() { sqlite3_finalize(st_); }
+
+    Stmt& bind(int i, long long v)  { sqlite3_bind_int64(st_, i, v); return *this; }
+    Stmt& bind(int i, int v)        { sqlite3_bind_int(st_, i, v); return *this; }
+    Stmt& bind(int i, double v)     { sqlite3_bind_double(st_, i, v); return *this; }
+    Stmt& bind(int i, const std::string& v) {
+        sqlite3_bind_text(st_, i, v.data(), (int)v.size(), SQLITE_TRANSIENT);
+        return *this;
+    }
+    Stmt& bindStatic(int i, const char* v) {
+        sqlite3_bind_text(st_, i, v, -1, SQLITE_STATIC);
+        return *this;
+    }
+    void run() { db_.step(st_); }
+
+private:
+    Db& db_;
+    sqlite3_stmt* st_;
+};
+
+// ─── Schema (mirrors Wt::Dbo::Session::createTables for Models.h) ────────────
+
+const char* kSchema =
+    "create table \"restaurant\" ("
+    "  \"id\" integer primary key autoincrement,"
+    "  \"version\" integer not null,"
+    "  \"name\" text not null,"
+    "  \"cuisine_type\" text not null,"
+    "  \"description\" text not null);"
+    "create table \"category\" ("
+    "  \"id\" integer primary key autoincrement,"
+    "  \"version\" integer not null,"
+    "  \"name\" text not null,"
+    "  \"sort_order\" integer not null,"
+    "  \"restaurant_id\" bigint,"
+    "  constraint \"fk_category_restaurant\" foreign key (\"restaurant_id\")"
+    "    references \"restaurant\" (\"id\") deferrable initially deferred);"
+    "create table \"menu_item\" ("
+    "  \"id\" integer primary key autoincrement,"
+    "  \"version\" integer not null,"
+    "  \"name\" text not null,"
+    "  \"description\" text not null,"
+    "  \"price\" real not null,"
+    "  \"available\" boolean not null,"
+    "  \"category_id\" bigint,"
+    "  constraint \"fk_menu_item_category\" foreign key (\"category_id\")"
+    "    references \"category\" (\"id\") deferrable initially deferred);"
+    "create table \"orders\" ("
+    "  \"id\" integer primary key autoincrement,"
+    "  \"version\" integer not null,"
+    "  \"table_number\" integer not null,"
+    "  \"status\" text not null,"
+    "  \"customer_name\" text not null,"
+    "  \"notes\" text not null,"
+    "  \"created_at\" text not null,"
+    "  \"updated_at\" text not null,"
+    "  \"total\" real not null,"
+    "  \"restaurant_id\" bigint,"
+    "  constraint \"fk_orders_restaurant\" foreign key (\"restaurant_id\")"
+    "    references \"restaurant\" (\"id\") deferrable initially deferred);"
+    "create table \"order_item\" ("
+    "  \"id\" integer primary key autoincrement,"
+    "  \"version\" integer not null,"
+    "  \"quantity\" integer not null,"
+    "  \"unit_price\" real not null,"
+    "  \"special_instructions\" text not null,"
+    "  \"order_id\" bigint,"
+    "  \"menu_item_id\" bigint,"
+    "  constraint \"fk_order_item_order\" foreign key (\"order_id\")"
+    "    references \"orders\" (\"id\") deferrable initially deferred,"
+    "  constraint \"fk_order_item_menu_item\" foreign key (\"menu_item_id\")"
+    "    references \"menu_item\" (\"id\") deferrable initially deferred);"
+    "create table \"app_user\" ("
+    "  \"id\" integer primary key autoincrement,"
+    "  \"version\" integer not null,"
+    "  \"username\" text not null,"
+    "  \"display_name\" text not null,"
+    "  \"role\" text not null,"
+    "  \"restaurant_id\" bigint,"
+    "  constraint \"fk_app_user_restaurant\" foreign key (\"restaurant_id\")"
+    "    references \"restaurant\" (\"id\") deferrable initially deferred);";
+
+// Same index set as sql/schema.sql, so LOCAL runs see production query plans.
+const char* kIndexes =
+    "create index if not exists idx_category_restaurant on category(restaurant_id, sort_order);"
+    "create index if not exists idx_menu_item_category on menu_item(category_id);"
+    "create index if not exists idx_orders_restaurant_status on orders(restaurant_id, status);"
+    "create index if not exists idx_order_item_order on order_item(order_id);"
+    "create index if not exists idx_app_user_restaurant on app_user(restaurant_id);";
+
+// ─── Synthetic vocabulary ────────────────────────────────────────────────────
+
+const std::vector<std::pair<const char*, const char*>> kCuisines = {
+    {"Thai", "Siam"}, {"Chinese", "Dragon"}, {"Sandwiches & More", "Bite"},
+    {"Italian", "Trattoria"}, {"Mexican", "Cantina"}, {"Indian", "Masala"},
+    {"Japanese", "Sakura"}, {"American", "Diner"},
+};
+
+const std::vector<const char*> kCategoryNames = {
+    "Appetizers", "Soups", "Salads", "Main Courses", "Noodles & Rice",
+    "Sandwiches", "Sides", "Desserts", "Drinks", "Espresso & Coffee",
+};
+
+const std::vector<const char*> kDishAdjectives = {
+    "Classic", "Spicy", "Grilled", "Crispy", "House", "Smoked", "Garlic",
+    "Lemongrass", "Honey", "Roasted", "Braised", "Fresh",
+};
+
+const std::vector<const char*> kDishNouns = {
+    "Chicken", "Beef", "Tofu", "Shrimp", "Noodles", "Curry", "Salad",
+    "Dumplings", "Wrap", "Bowl", "Soup", "Latte", "Tea", "Fries",
+};
+
+const std::vector<const char*> kCustomers = {
+    "Walk-In Guest", "Alex", "Sam", "Jordan", "Taylor", "Morgan", "Casey",
+    "Riley", "Jamie", "Avery", "Quinn", "Drew", "Table Guest",
+};
+
+const std::vector<const char*> kNotes = {
+    "No spicy", "Allergy: peanuts", "Birthday - bring candle", "Extra napkins",
+    "Gluten free please", "Rush order", "Split the check",
+};
+
+const std::vector<const char*> kInstructions = {
+    "No onions", "Extra sauce", "Sauce on the side", "Well done", "No ice",
+    "Oat milk", "Mild",
+};
+
+// "%Y-%m-%d %H:%M:%S" in local time, same as ApiService::getNowTimestamp().
+std::string formatTimestamp(std::time_t t) {
+    char buf[32];
+    std::tm tm{};
+    localtime_r(&t, &tm);
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+    return buf;
+}
+
+// Seconds after local midnight at which an order is placed: mostly lunch
+// (11:30-13:30) and dinner (17:30-20:30) rushes, with a thin all-day tail.
+int sampleTimeOfDay(std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    double r = u(rng);
+    if (r < 0.40) {
+        std::normal_distribution<double> lunch(12.5 * 3600, 45 * 60);
+        return (int)std::max(10.0 * 3600, std::min(15.0 * 3600, lunch(rng)));
+    }
+    if (r < 0.90) {
+        std::normal_distribution<double> dinner(19.0 * 3600, 60 * 60);
+        return (int)std::max(16.0 * 3600, std::min(22.5 * 3600, dinner(rng)));
+    }
+    std::uniform_int_distribution<int> allDay(10 * 3600, 22 * 3600);
+    return allDay(rng);
+}
+
+struct MenuEntry {
+    long long id;
+    double price;
+};
+
+// ─── Generator ───────────────────────────────────────────────────────────────
+
+class Generator {
+public:
+    Generator(Db& db, const Options& o) : db_(db), o_(o), rng_(o.seed) {}
+
+    void run() {
+        auto t0 = std::chrono::steady_clock::now();
+
+        db_.exec(kSchema);
+        generateMenus();
+        generateOrders();
+
+        if (o_.createIndexes) {
+            std::cout << "[loadgen] Building indexes..." << std::endl;
+            db_.exec(kIndexes);
+        }
+        db_.exec("ANALYZE;");
+
+        double secs = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - t0).count();
+        std::cout << "[loadgen] Done: " << o_.restaurants << " restaurants, "
+                  << menuItemCount_ << " menu items, " << orderId_ << " orders, "
+                  << orderItemId_ << " order items in " << secs << "s ("
+                  << (long long)(orderItemId_ / (secs > 0 ? secs : 1))
+                  << " order items/s)" << std::endl;
+    }
+
+private:
+    void beginBatch() { db_.exec("BEGIN"); pending_ = 0; }
+
+    void tick() {
+        if (++pending_ >= o_.batchSize) {
+            db_.exec("COMMIT");
+            db_.exec("BEGIN");
+            pending_ = 0;
+        }
+    }
+
+    void generateMenus() {
+        Stmt insRest(db_, "insert into restaurant (id, version, name, cuisine_type, description) "
+                          "values (?, 0, ?, ?, ?)");
+        Stmt insCat(db_, "insert into category (id, version, name, sort_order, restaurant_id) "
+                         "values (?, 0, ?, ?, ?)");
+        Stmt insItem(db_, "insert into menu_item (id, version, name, description, price, "
+                          "available, category_id) values (?, 0, ?, ?, ?, ?, ?)");
+        Stmt insUser(db_, "insert into app_user (id, version, username, display_name, role, "
+                          "restaurant_id) values (?, 0, ?, ?, ?, ?)");
+
+        std::uniform_int_distribution<int> cents(249, 2499);
+        std::uniform_real_distribution<double> u(0.0, 1.0);
+
+        beginBatch();
+        long long catId = 0, itemId = 0, userId = 0;
+        menus_.resize(o_.restaurants);
+        for (int r = 0; r < o_.restaurants; r++) {
+            long long restId = r + 1;
+            auto& cuisine = kCuisines[r % kCuisines.size()];
+            std::string name = std::string(cuisine.second) + " #" + std::to_string(restId);
+            insRest.bind(1, restId).bind(2, name).bindStatic(3, cuisine.first)
+                   .bind(4, std::string("Synthetic ") + cuisine.first + " restaurant")
+                   .run();
+
+            for (int c = 0; c < o_.categories; c++) {
+                ++catId;
+                std::string catName = kCategoryNames[c % kCategoryNames.size()];
+                if (c >= (int)kCategoryNames.size())
+                    catName += " " + std::to_string(c / kCategoryNames.size() + 1);
+                insCat.bind(1, catId).bind(2, catName).bind(3, c).bind(4, restId).run();
+
+                for (int i = 0; i < o_.itemsPerCategory; i++) {
+                    ++itemId;
+                    std::string dish = std::string(kDishAdjectives[(itemId * 7) % kDishAdjectives.size()])
+                        + " " + kDishNouns[(itemId * 5 + c) % kDishNouns.size()];
+                    double price = cents(rng_) / 100.0;
+                    bool available = u(rng_) > 0.05;   // ~5% 86'd at any time
+                    insItem.bind(1, itemId).bind(2, dish)
+                           .bind(3, dish + " prepared to order").bind(4, price)
+                           .bind(5, available ? 1 : 0).bind(6, catId).run();
+                    menus_[r].push_back({itemId, price});
+                }
+            }
+
+            const char* roles[] = {"Manager", "Front Desk", "Kitchen"};
+            const char* suffix[] = {"_manager", "_frontdesk", "_kitchen"};
+            for (int k = 0; k < 3; k++) {
+                insUser.bind(1, ++userId)
+                       .bind(2, "r" + std::to_string(restId) + suffix[k])
+                       .bind(3, name + " " + roles[k]).bindStatic(4, roles[k])
+                       .bind(5, restId).run();
+            }
+        }
+        db_.exec("COMMIT");
+        menuItemCount_ = itemId;
+    }
+
+    void generateOrders() {
+        Stmt insOrder(db_, "insert into orders (id, version, table_number, status, customer_name, "
+                           "notes, created_at, updated_at, total, restaurant_id) "
+                           "values (?, 0, ?, ?, ?, ?, ?, ?, ?, ?)");
+        Stmt insItem(db_, "insert into order_item (id, version, quantity, unit_price, "
+                          "special_instructions, order_id, menu_item_id) "
+                          "values (?, 0, ?, ?, ?, ?, ?)");
+
+        std::uniform_real_distribution<double> u(0.0, 1.0);
+        std::uniform_int_distribution<int> table(1, 50);
+        std::uniform_int_distribution<int> prepMinutes(15, 55);
+        // Line items per order: 1..8, mean ~3.3
+        std::discrete_distribution<int> lineCount({0, 18, 22, 22, 16, 10, 6, 4, 2});
+        std::discrete_distribution<int> quantity({0, 78, 16, 4, 2});
+        // Live orders: Pending / In Progress / Ready
+        std::discrete_distribution<int> liveStatus({40, 35, 25});
+        const char* liveNames[] = {"Pending", "In Progress", "Ready"};
+
+        std::time_t now = std::time(nullptr);
+        std::tm midnight{};
+        localtime_r(&now, &midnight);
+        midnight.tm_hour = midnight.tm_min = midnight.tm_sec = 0;
+        std::time_t today = std::mktime(&midnight);
+        int days = o_.months * 30;
+
+        std::poisson_distribution<int> perDay(o_.ordersPerDay > 0 ? o_.ordersPerDay : 1);
+        std::vector<int> offsets;
+        long long progressStep = std::max<long long>(1, (long long)o_.restaurants * days / 20);
+        long long dayCounter = 0;
+
+        auto writeOrder = [&](int r, std::time_t created, const char* status,
+                              std::time_t updated) {
+            long long oid = ++orderId_;
+            auto& menu = menus_[r];
+            std::uniform_int_distribution<size_t> pick(0, menu.size() - 1);
+
+            double total = 0.0;
+            int lines = lineCount(rng_);
+            for (int l = 0; l < lines; l++) {
+                const MenuEntry& mi = menu[pick(rng_)];
+                int qty = quantity(rng_);
+                insItem.bind(1, ++orderItemId_).bind(2, qty).bind(3, mi.price);
+                if (u(rng_) < 0.10)
+                    insItem.bindStatic(4, kInstructions[orderItemId_ % kInstructions.size()]);
+                else
+                    insItem.bindStatic(4, "");
+                insItem.bind(5, oid).bind(6, mi.id).run();
+                total += mi.price * qty;
+                tick();
+            }
+
+            insOrder.bind(1, oid).bind(2, table(rng_)).bindStatic(3, status)
+                    .bindStatic(4, kCustomers[oid % kCustomers.size()])
+                    .bindStatic(5, u(rng_) < 0.15 ? kNotes[oid % kNotes.size()] : "")
+                    .bind(6, formatTimestamp(created)).bind(7, formatTimestamp(updated))
+                    .bind(8, total).bind(9, (long long)(r + 1)).run();
+            tick();
+        };
+
+        beginBatch();
+        // Historical orders, oldest first so ids grow with created_at as in
+        // production.  Each day is generated for all restaurants before moving
+        // on, interleaving restaurant ids the way concurrent stores do.
+        for (int d = days; d >= 1; d--) {
+            std::time_t dayStart = today - (std::time_t)d * 86400;
+            for (int r = 0; r < o_.restaurants; r++) {
+                int n = o_.ordersPerDay > 0 ? perDay(rng_) : 0;
+                offsets.resize(n);
+                for (auto& off : offsets) off = sampleTimeOfDay(rng_);
+                std::sort(offsets.begin(), offsets.end());
+                for (int off : offsets) {
+                    std::time_t created = dayStart + off;
+                    bool cancelled = u(rng_) < 0.04;
+                    std::time_t updated = created + 60 * (cancelled ? 5 : prepMinutes(rng_));
+                    writeOrder(r, created, cancelled ? "Cancelled" : "Served", updated);
+                }
+                if (++dayCounter % progressStep == 0) {
+                    std::cout << "[loadgen] " << (100 * dayCounter / ((long long)o_.restaurants * days))
+                              << "% (" << orderId_ << " orders, " << orderItemId_
+                              << " items)" << std::endl;
+                }
+            }
+        }
+
+        // Today's live tickets, spread over the last hour.
+        std::uniform_int_distribution<int> recent(0, 3600);
+        for (int r = 0; r < o_.restaurants; r++) {
+            for (int k = 0; k < o_.openOrders; k++) {
+                std::time_t created = now - recent(rng_);
+                writeOrder(r, created, liveNames[liveStatus(rng_)], created);
+            }
+        }
+        db_.exec("COMMIT");
+    }
+
+    Db& db_;
+    const Options& o_;
+    std::mt19937_64 rng_;
+    std::vector<std::vector<MenuEntry>> menus_;
+    long long menuItemCount_ = 0;
+    long long orderId_ = 0;
+    long long orderItemId_ = 0;
+    int pending_ = 0;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options o;
+    bool writing = false;   // o.dbPath is ours to remove on failure
+    try {
+        if (!parseArgs(argc, argv, o)) return 0;
+
+        struct stat st;
+        if (stat(o.dbPath.c_str(), &st) == 0) {
+            if (!o.force) {
+                std::cerr << "[loadgen] " << o.dbPath
+                          << " already exists (use --force to overwrite)" << std::endl;
+                return 1;
+            }
+            std::remove(o.dbPath.c_str());
+        }
+
+        std::cout << "[loadgen] Writing " << o.dbPath << ": " << o.restaurants
+                  << " restaurants x " << o.categories << " categories x "
+                  << o.itemsPerCategory << " items, " << o.months << " months at ~"
+                  << o.ordersPerDay << " orders/day" << std::endl;
+
+        writing = true;
+        Db db(o.dbPath);
+        // Bulk-load settings: without a journal a failed load leaves a
+        // corrupt file, which is removed below.
+        db.exec("PRAGMA journal_mode=OFF;"
+                "PRAGMA synchronous=OFF;"
+                "PRAGMA locking_mode=EXCLUSIVE;"
+                "PRAGMA temp_store=MEMORY;"
+                "PRAGMA cache_size=-262144;");
+
+        Generator gen(db, o);
+        gen.run();
+
+        db.exec("PRAGMA journal_mode=DELETE;");
+    } catch (std::exception& e) {
+        std::cerr << "[loadgen] Error: " << e.what() << std::endl;
+        if (writing) std::remove(o.dbPath.c_str());   // db is closed by now
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,534 @@
+// ─── restaurant_pos_loadsim ──────────────────────────────────────────────────
+// Headless multi-terminal load simulator for IApiService.
+//
+// Each simulated terminal is a thread that replays the exact sequence of
+// service calls its view makes:
+//
+//   Front desk  FrontDeskView: browse categories (getMenuItemsByCategory per
+//               tap), submitOrder (createOrder + addOrderItem per cart line),
+//               refreshActiveOrders (getOrderChangesSince + getOrderItems per
+//               new or changed order), "Mark Served" on Ready orders.
+//   Kitchen     KitchenView::refreshOrders on its timer (getOrderChangesSince,
+//               getOrderItems per new or changed card), plus acceptOrder /
+//               markReady which each refresh again.
+//   Manager     ManagerView header refresh: refreshDashboard (4 aggregates),
+//               refreshOrders (full getOrders), refreshMenu (getCategories +
+//               getMenuItemsByCategory per category).
+//
+// Per-method and per-action latencies are collected and printed as
+// throughput and p50/p95/p99 at the end of the run.
+//
+//   restaurant_pos_loadsim --mode LOCAL --frontdesk 20 --kitchen 10 --duration 60
+
+#include "services/IApiService.h"
+#include "services/LocalApiService.h"
+#include "services/RestApiService.h"
+#include "services/SiteConfig.h"
+#include "ui/OrderTracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// ─── Options ─────────────────────────────────────────────────────────────────
+
+struct Options {
+    std::string mode;                  // LOCAL / ALS; empty = SiteConfig
+    std::string dbPath = "restaurant_pos.db";
+    std::string configPath = "data/site-config.json";
+    std::vector<long long> restaurants;  // empty = all
+    int frontDesk = 4;
+    int kitchen = 2;
+    int manager = 1;
+    double durationSec = 60;
+    double thinkMs = 3000;             // mean front desk pause between actions
+    double kitchenIntervalSec = 10;    // KitchenView WTimer interval
+    double managerIntervalSec = 30;    // how often a manager hits refresh
+    double kitchenActionProb = 0.5;    // chance to accept / mark ready per tick
+    unsigned long long seed = 1;
+};
+
+void usage(const char* argv0) {
+    std::cout <<
+        "Usage: " << argv0 << " [options]\n"
+        "  --mode LOCAL|ALS          data source (default: SiteConfig / DATA_SOURCE_TYPE)\n"
+        "  --db PATH                 SQLite database for LOCAL (default restaurant_pos.db)\n"
+        "  --config PATH             site config with api_base_url (default data/site-config.json)\n"
+        "  --restaurant ID           restaurant to target; repeatable (default: all)\n"
+        "  --frontdesk N             front desk terminals (default 4)\n"
+        "  --kitchen N               kitchen displays (default 2)\n"
+        "  --manager N               manager sessions (default 1)\n"
+        "  --duration SEC            run time (default 60)\n"
+        "  --think-ms MS             mean front desk think time (default 3000)\n"
+        "  --kitchen-interval SEC    kitchen refresh timer (default 10)\n"
+        "  --manager-interval SEC    manager refresh period (default 30)\n"
+        "  --kitchen-action P        per-tick probability of accept / mark ready (default 0.5)\n"
+        "  --seed N                  random seed (default 1)\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + a);
+            return argv[++i];
+        };
+        if      (a == "--mode")             o.mode = next();
+        else if (a == "--db")               o.dbPath = next();
+        else if (a == "--config")           o.configPath = next();
+        else if (a == "--restaurant")       o.restaurants.push_back(std::atoll(next()));
+        else if (a == "--frontdesk")        o.frontDesk = std::atoi(next());
+        else if (a == "--kitchen")          o.kitchen = std::atoi(next());
+        else if (a == "--manager")          o.manager = std::atoi(next());
+        else if (a == "--duration")         o.durationSec = std::atof(next());
+        else if (a == "--think-ms")         o.thinkMs = std::atof(next());
+        else if (a == "--kitchen-interval") o.kitchenIntervalSec = std::atof(next());
+        else if (a == "--manager-interval") o.managerIntervalSec = std::atof(next());
+        else if (a == "--kitchen-action")   o.kitchenActionProb = std::atof(next());
+        else if (a == "--seed")             o.seed = std::strtoull(next(), nullptr, 10);
+        else if (a == "--help" || a == "-h") { usage(argv[0]); return false; }
+        else throw std::runtime_error("unknown option " + a);
+    }
+    if (o.frontDesk < 0 || o.kitchen < 0 || o.manager < 0 ||
+        o.frontDesk + o.kitchen + o.manager == 0) {
+        throw std::runtime_error("need at least one terminal");
+    }
+    return true;
+}
+
+// ─── Latency collection ──────────────────────────────────────────────────────
+// Every terminal thread records into its own Stats; they are merged after
+// the run so the hot path never takes a shared lock.
+
+struct Series {
+    std::vector<double> ms;
+    long long errors = 0;
+};
+
+struct Stats {
+    std::map<std::string, Series> series;
+
+    void merge(const Stats& other) {
+        for (auto& [name, s] : other.series) {
+            auto& dst = series[name];
+            dst.ms.insert(dst.ms.end(), s.ms.begin(), s.ms.end());
+            dst.errors += s.errors;
+        }
+    }
+};
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = (size_t)std::ceil(p / 100.0 * sorted.size());
+    return sorted[std::min(sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+}
+
+// ─── Terminal base ───────────────────────────────────────────────────────────
+
+class StopSignal {
+public:
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    // Sleeps for d or until stop(); returns false once stopped.
+    template<class Duration>
+    bool sleepFor(Duration d) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return !cv_.wait_for(lock, d, [this] { return stopped_; });
+    }
+
+    bool stopped() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stopped_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopped_ = false;
+};
+
+class Terminal {
+public:
+    Terminal(IApiService& api, long long restaurantId, const Options& opts,
+             StopSignal& stop, unsigned long long seed)
+        : api_(api), restaurantId_(restaurantId), opts_(opts), stop_(stop), rng_(seed) {}
+    virtual ~Terminal() = default;
+
+    virtual void run() = 0;
+    const Stats& stats() const { return stats_; }
+
+protected:
+    // Times one IApiService call; exceptions are counted, not propagated.
+    template<class F>
+    auto call(const char* name, F&& f) -> decltype(f()) {
+        auto t0 = Clock::now();
+        try {
+            auto result = f();
+            record(name, t0);
+            return result;
+        } catch (std::exception&) {
+            stats_.series[name].errors++;
+            return decltype(f()){};
+        }
+    }
+
+    template<class F>
+    void callVoid(const char* name, F&& f) {
+        auto t0 = Clock::now();
+        try {
+            f();
+            record(name, t0);
+        } catch (std::exception&) {
+            stats_.series[name].errors++;
+        }
+    }
+
+    // Times a whole user-visible action (a click handler or timer tick).
+    template<class F>
+    void action(const char* name, F&& f) {
+        auto t0 = Clock::now();
+        f();
+        record(name, t0);
+    }
+
+    void record(const char* name, Clock::time_point t0) {
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        stats_.series[name].ms.push_back(ms);
+    }
+
+    bool think(double meanMs) {
+        std::exponential_distribution<double> d(1.0 / std::max(1.0, meanMs));
+        return stop_.sleepFor(std::chrono::duration<double, std::milli>(d(rng_)));
+    }
+
+    IApiService& api_;
+    long long restaurantId_;
+    const Options& opts_;
+    StopSignal& stop_;
+    std::mt19937_64 rng_;
+    Stats stats_;
+};
+
+// ─── Front desk (FrontDeskView) ──────────────────────────────────────────────
+
+class FrontDeskTerminal : public Terminal {
+public:
+    using Terminal::Terminal;
+
+    void run() override {
+        // Constructor: buildMenuBrowser + first category, refreshActiveOrders
+        std::vector<CategoryDto> categories;
+        action("view.frontdesk.open", [&] {
+            categories = call("getCategories", [&] { return api_.getCategories(restaurantId_); });
+            if (!categories.empty()) browseCategory(categories.front().id);
+            refreshActiveOrders();
+        });
+        if (categories.empty()) return;
+
+        std::uniform_int_distribution<size_t> pickCat(0, categories.size() - 1);
+        std::discrete_distribution<int> cartLines({0, 25, 30, 22, 13, 10});
+        std::discrete_distribution<int> qty({0, 80, 15, 5});
+
+        while (!stop_.stopped()) {
+            // Browse a few categories and fill the cart locally
+            std::vector<std::pair<long long, int>> cart;
+            int lines = cartLines(rng_);
+            for (int l = 0; l < lines; l++) {
+                if (!think(opts_.thinkMs / 2)) return;
+                auto items = browseCategory(categories[pickCat(rng_)].id);
+                std::vector<const MenuItemDto*> avail;
+                for (auto& mi : items) if (mi.available) avail.push_back(&mi);
+                if (avail.empty()) continue;
+                std::uniform_int_distribution<size_t> pickItem(0, avail.size() - 1);
+                cart.emplace_back(avail[pickItem(rng_)]->id, qty(rng_));
+            }
+            if (!think(opts_.thinkMs)) return;
+            if (!cart.empty()) submitOrder(cart);
+
+            // Serve anything the kitchen has marked Ready
+            if (!think(opts_.thinkMs)) return;
+            for (long long oid : readyOrders_) {
+                action("view.frontdesk.markServed", [&] {
+                    callVoid("updateOrderStatus", [&] { api_.updateOrderStatus(oid, "Served"); });
+                    refreshActiveOrders();
+                });
+                if (!think(opts_.thinkMs / 4)) return;
+            }
+        }
+    }
+
+private:
+    std::vector<MenuItemDto> browseCategory(long long categoryId) {
+        std::vector<MenuItemDto> items;
+        action("view.frontdesk.showCategory", [&] {
+            items = call("getMenuItemsByCategory",
+                         [&] { return api_.getMenuItemsByCategory(categoryId); });
+        });
+        return items;
+    }
+
+    void submitOrder(const std::vector<std::pair<long long, int>>& cart) {
+        std::uniform_int_distribution<int> table(1, 50);
+        action("view.frontdesk.submitOrder", [&] {
+            auto order = call("createOrder", [&] {
+                return api_.createOrder(restaurantId_, table(rng_), "Load Test", "");
+            });
+            if (order.id == 0) return;
+            for (auto& [menuItemId, quantity] : cart) {
+                callVoid("addOrderItem", [&] {
+                    api_.addOrderItem(order.id, menuItemId, quantity, "");
+                });
+            }
+            refreshActiveOrders();
+        });
+    }
+
+    void refreshActiveOrders() {
+        action("view.frontdesk.refreshActiveOrders", [&] {
+            auto changes = call("getOrderChangesSince", [&] {
+                return api_.getOrderChangesSince(restaurantId_, active_.cursor());
+            });
+            std::vector<OrderDto> stale;
+            active_.apply(std::move(changes), stale);
+            for (auto& o : stale) {
+                active_.setItems(o, call("getOrderItems",
+                                         [&] { return api_.getOrderItems(o.id); }));
+            }
+            readyOrders_.clear();
+            for (auto& entry : active_.orders()) {
+                if (entry.second.status == "Ready") readyOrders_.push_back(entry.first);
+            }
+        });
+    }
+
+    OrderTracker active_{[](const OrderDto& o) {
+        return o.status != "Served" && o.status != "Cancelled";
+    }};
+    std::vector<long long> readyOrders_;
+};
+
+// ─── Kitchen (KitchenView) ───────────────────────────────────────────────────
+
+class KitchenTerminal : public Terminal {
+public:
+    using Terminal::Terminal;
+
+    void run() override {
+        auto interval = std::chrono::duration<double>(opts_.kitchenIntervalSec);
+        // Stagger timers: kitchen screens are not opened at the same instant
+        std::uniform_real_distribution<double> phase(0.0, opts_.kitchenIntervalSec);
+        if (!stop_.sleepFor(std::chrono::duration<double>(phase(rng_)))) return;
+
+        action("view.kitchen.open", [&] { refreshOrders(); });
+
+        std::uniform_real_distribution<double> u(0.0, 1.0);
+        auto nextTick = Clock::now() + std::chrono::duration_cast<Clock::duration>(interval);
+        while (stop_.sleepFor(nextTick - Clock::now())) {
+            nextTick += std::chrono::duration_cast<Clock::duration>(interval);
+            action("view.kitchen.refreshOrders", [&] { refreshOrders(); });
+
+            if (!pending_.empty() && u(rng_) < opts_.kitchenActionProb) {
+                long long oid = pending_.front();
+                action("view.kitchen.acceptOrder", [&] {
+                    callVoid("updateOrderStatus",
+                             [&] { api_.updateOrderStatus(oid, "In Progress"); });
+                    refreshOrders();
+                });
+            }
+            if (!inProgress_.empty() && u(rng_) < opts_.kitchenActionProb) {
+                long long oid = inProgress_.front();
+                action("view.kitchen.markReady", [&] {
+                    callVoid("updateOrderStatus",
+                             [&] { api_.updateOrderStatus(oid, "Ready"); });
+                    refreshOrders();
+                });
+            }
+        }
+    }
+
+private:
+    void refreshOrders() {
+        auto changes = call("getOrderChangesSince", [&] {
+            return api_.getOrderChangesSince(restaurantId_, orders_.cursor());
+        });
+        std::vector<OrderDto> stale;
+        orders_.apply(std::move(changes), stale);
+        for (auto& o : stale) {
+            orders_.setItems(o, call("getOrderItems", [&] { return api_.getOrderItems(o.id); }));
+        }
+
+        pending_.clear();
+        inProgress_.clear();
+        for (auto& entry : orders_.orders()) {
+            if (entry.second.status == "Pending") pending_.push_back(entry.first);
+            else inProgress_.push_back(entry.first);
+        }
+    }
+
+    OrderTracker orders_{[](const OrderDto& o) {
+        return o.status == "Pending" || o.status == "In Progress";
+    }};
+    std::vector<long long> pending_;
+    std::vector<long long> inProgress_;
+};
+
+// ─── Manager (ManagerView) ───────────────────────────────────────────────────
+
+class ManagerTerminal : public Terminal {
+public:
+    using Terminal::Terminal;
+
+    void run() override {
+        action("view.manager.open", [&] { refreshAll(); });
+        while (think(opts_.managerIntervalSec * 1000.0)) {
+            action("view.manager.refresh", [&] { refreshAll(); });
+        }
+    }
+
+private:
+    void refreshAll() {
+        // refreshDashboard
+        call("getOrderCount", [&] { return api_.getOrderCount(restaurantId_); });
+        call("getRevenue", [&] { return api_.getRevenue(restaurantId_); });
+        call("getPendingOrderCount", [&] { return api_.getPendingOrderCount(restaurantId_); });
+        call("getInProgressOrderCount",
+             [&] { return api_.getInProgressOrderCount(restaurantId_); });
+        // refreshOrders
+        call("getOrders", [&] { return api_.getOrders(restaurantId_); });
+        // refreshMenu
+        auto cats = call("getCategories", [&] { return api_.getCategories(restaurantId_); });
+        for (auto& c : cats) {
+            call("getMenuItemsByCategory", [&] { return api_.getMenuItemsByCategory(c.id); });
+        }
+    }
+};
+
+// ─── Report ──────────────────────────────────────────────────────────────────
+
+void printReport(const Stats& total, double elapsedSec) {
+    std::cout << "\n" << std::left << std::setw(38) << "call"
+              << std::right << std::setw(9) << "count" << std::setw(7) << "err"
+              << std::setw(10) << "per sec" << std::setw(10) << "p50 ms"
+              << std::setw(10) << "p95 ms" << std::setw(10) << "p99 ms"
+              << std::setw(10) << "max ms" << "\n"
+              << std::string(104, '-') << "\n";
+
+    auto printSection = [&](bool views) {
+        for (auto& [name, s] : total.series) {
+            if ((name.rfind("view.", 0) == 0) != views) continue;
+            auto sorted = s.ms;
+            std::sort(sorted.begin(), sorted.end());
+            std::cout << std::left << std::setw(38) << name << std::right
+                      << std::setw(9) << sorted.size() << std::setw(7) << s.errors
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(10) << sorted.size() / elapsedSec
+                      << std::setprecision(2)
+                      << std::setw(10) << percentile(sorted, 50)
+                      << std::setw(10) << percentile(sorted, 95)
+                      << std::setw(10) << percentile(sorted, 99)
+                      << std::setw(10) << (sorted.empty() ? 0.0 : sorted.back()) << "\n";
+        }
+    };
+    printSection(false);
+    std::cout << std::string(104, '-') << "\n";
+    printSection(true);
+
+    long long calls = 0, errors = 0;
+    for (auto& [name, s] : total.series) {
+        if (name.rfind("view.", 0) == 0) continue;
+        calls += (long long)s.ms.size();
+        errors += s.errors;
+    }
+    std::cout << std::string(104, '-') << "\n"
+              << "Total: " << calls << " service calls, " << errors << " errors in "
+              << std::setprecision(1) << elapsedSec << "s ("
+              << calls / elapsedSec << " calls/s)" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options o;
+        if (!parseArgs(argc, argv, o)) return 0;
+
+        auto siteConfig = std::make_shared<SiteConfig>(o.configPath);
+        std::string mode = o.mode.empty() ? siteConfig->dataSourceType() : o.mode;
+
+        std::shared_ptr<IApiService> api;
+        if (mode == "ALS") {
+            std::cout << "[loadsim] ALS mode: " << siteConfig->apiBaseUrl() << std::endl;
+            api = std::make_shared<RestApiService>(siteConfig);
+        } else {
+            std::cout << "[loadsim] LOCAL mode: " << o.dbPath << std::endl;
+            auto local = std::make_shared<LocalApiService>(o.dbPath);
+            local->initializeDatabase();
+            local->seedDatabase();
+            api = local;
+        }
+
+        if (o.restaurants.empty()) {
+            for (auto& r : api->getRestaurants()) o.restaurants.push_back(r.id);
+        }
+        if (o.restaurants.empty()) throw std::runtime_error("no restaurants found");
+
+        StopSignal stop;
+        std::vector<std::unique_ptr<Terminal>> terminals;
+        unsigned long long seed = o.seed;
+        auto restaurantFor = [&](int i) { return o.restaurants[i % o.restaurants.size()]; };
+        for (int i = 0; i < o.frontDesk; i++)
+            terminals.push_back(std::make_unique<FrontDeskTerminal>(
+                *api, restaurantFor(i), o, stop, seed++));
+        for (int i = 0; i < o.kitchen; i++)
+            terminals.push_back(std::make_unique<KitchenTerminal>(
+                *api, restaurantFor(i), o, stop, seed++));
+        for (int i = 0; i < o.manager; i++)
+            terminals.push_back(std::make_unique<ManagerTerminal>(
+                *api, restaurantFor(i), o, stop, seed++));
+
+        std::cout << "[loadsim] " << o.frontDesk << " front desk, " << o.kitchen
+                  << " kitchen, " << o.manager << " manager terminals across "
+                  << o.restaurants.size() << " restaurant(s) for " << o.durationSec
+                  << "s" << std::endl;
+
+        auto t0 = Clock::now();
+        std::vector<std::thread> threads;
+        for (auto& t : terminals) {
+            threads.emplace_back([&t] { t->run(); });
+        }
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(o.durationSec));
+        stop.stop();
+        for (auto& th : threads) th.join();
+        double elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        Stats total;
+        for (auto& t : terminals) total.merge(t->stats());
+        printReport(total, elapsed);
+    } catch (std::exception& e) {
+        std::cerr << "[loadsim] Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,1288 @@
+// ─── restaurant_pos_mock_als ─────────────────────────────────────────────────
+// Offline stand-in for ApiLogicServer, so RestApiService (ALS mode) can be
+// exercised and benchmarked without a PostgreSQL + ALS deployment.
+//
+// Serves the JSON:API endpoints RestApiService uses, backed by a LOCAL-mode
+// SQLite database (restaurant_pos.db or one built by restaurant_pos_loadgen):
+//
+//   GET   /api/<type>/?filter[col]=v&sort=-col,col&include=rel&page[limit]=n&fields[t]=a,b
+//         filter[col][op]=v compares with op gt, ge, lt or le instead of equality
+//         with page[limit] or page[offset], "meta": {"count": N} gives the
+//         matching total as ALS does
+//   GET   /api/<type>/<id>/?fields[t]=a,b
+//   POST  /api/<type>/          {"data":{"attributes":{...}}}
+//   PATCH /api/<type>/<id>/     {"data":{"attributes":{...}}}
+//
+// updated_at is stamped with the server's clock on every insert and update,
+// whatever the body says, as sql/schema.sql's triggers do on PostgreSQL.
+//
+// Stock ApiLogicServer ignores the Idempotency-Key header, and so does the
+// mock unless started with --idempotency-header: then a POST with the header
+// is applied once, and repeating the key returns the first response without
+// writing again.  orders.idempotency_key and order_item.line_key are added
+// if missing, unique when set, as in sql/schema.sql.
+//
+// Responses of 256 bytes or more are brotli- or gzip-encoded when the
+// request's Accept-Encoding allows it (brotli only if built with it), as a
+// compressing reverse proxy in front of ApiLogicServer would.
+//
+// for <type> in restaurant, category, menu_item, orders, order_item.
+// Latency, jitter, tail spikes, error responses and dropped connections can
+// be injected to reproduce a slow or flaky middleware tier:
+//
+//   restaurant_pos_mock_als --db big.db --latency-ms 15 --jitter-ms 10 --error-rate 0.01
+//   DATA_SOURCE_TYPE=ALS restaurant_pos_loadsim ...   (api_base_url http://localhost:5656/api)
+
+#include <sqlite3.h>
+#include <zlib.h>
+#ifdef MOCK_ALS_BROTLI
+#include <brotli/encode.h>
+#endif
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// ─── Options ─────────────────────────────────────────────────────────────────
+
+struct Options {
+    std::string dbPath       = "restaurant_pos.db";
+    std::string bindAddr     = "127.0.0.1";
+    int port                 = 5656;
+    std::string prefix       = "/api";
+    int defaultPageLimit     = 0;      // 0 = unlimited
+    double latencyMs         = 0;      // added to every request
+    double jitterMs          = 0;      // + uniform [0, jitter)
+    double tailRate          = 0;      // fraction of requests that also get...
+    double tailMs            = 0;      // ...this extra delay
+    double errorRate         = 0;      // fraction answered with errorStatus
+    int errorStatus          = 503;
+    double dropRate          = 0;      // fraction closed without a response
+    unsigned long long seed  = 1;
+    bool compression         = true;   // honour Accept-Encoding
+    bool idempotencyHeader   = false;  // replay repeated Idempotency-Key POSTs
+    bool verbose             = false;
+};
+
+void usage(const char* argv0) {
+    std::cout <<
+        "Usage: " << argv0 << " [options]\n"
+        "  --db PATH              LOCAL-mode SQLite database (default restaurant_pos.db)\n"
+        "  --bind ADDR            listen address (default 127.0.0.1)\n"
+        "  --port N               listen port (default 5656)\n"
+        "  --prefix PATH          URL prefix (default /api)\n"
+        "  --page-limit N         default page[limit] for collections (default unlimited)\n"
+        "  --latency-ms X         fixed delay per request\n"
+        "  --jitter-ms X          extra uniform random delay in [0, X)\n"
+        "  --tail-rate P          fraction of requests given an extra --tail-ms delay\n"
+        "  --tail-ms X            tail spike size\n"
+        "  --error-rate P         fraction of requests answered with --error-status\n"
+        "  --error-status N       injected HTTP status (default 503)\n"
+        "  --drop-rate P          fraction of requests whose connection is closed unanswered\n"
+        "  --seed N               random seed for fault injection (default 1)\n"
+        "  --no-compression       ignore Accept-Encoding; always send identity\n"
+        "  --idempotency-header   answer a repeated Idempotency-Key POST with the first\n"
+        "                         response (stock ApiLogicServer ignores the header)\n"
+        "  --verbose              log every request\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + a);
+            return argv[++i];
+        };
+        if      (a == "--db")           o.dbPath = next();
+        else if (a == "--bind")         o.bindAddr = next();
+        else if (a == "--port")         o.port = std::atoi(next());
+        else if (a == "--prefix")       o.prefix = next();
+        else if (a == "--page-limit")   o.defaultPageLimit = std::atoi(next());
+        else if (a == "--latency-ms")   o.latencyMs = std::atof(next());
+        else if (a == "--jitter-ms")    o.jitterMs = std::atof(next());
+        else if (a == "--tail-rate")    o.tailRate = std::atof(next());
+        else if (a == "--tail-ms")      o.tailMs = std::atof(next());
+        else if (a == "--error-rate")   o.errorRate = std::atof(next());
+        else if (a == "--error-status") o.errorStatus = std::atoi(next());
+        else if (a == "--drop-rate")    o.dropRate = std::atof(next());
+        else if (a == "--seed")         o.seed = std::strtoull(next(), nullptr, 10);
+        else if (a == "--no-compression") o.compression = false;
+        else if (a == "--idempotency-header") o.idempotencyHeader = true;
+        else if (a == "--verbose")      o.verbose = true;
+        else if (a == "--help" || a == "-h") { usage(argv[0]); return false; }
+        else throw std::runtime_error("unknown option " + a);
+    }
+    while (!o.prefix.empty() && o.prefix.back() == '/') o.prefix.pop_back();
+    if (o.port <= 0 || o.port > 65535) throw std::runtime_error("invalid --port");
+    return true;
+}
+
+// ─── Resource metadata (mirrors src/models/Models.h) ─────────────────────────
+
+enum class Kind { Int, Real, Text, Bool, Fk, Timestamp };
+
+struct Column {
+    const char* name;
+    Kind kind;
+};
+
+// To-one relationship, exposed under "relationships" and usable in ?include=
+struct Relation {
+    const char* name;
+    const char* fk;
+    const char* target;     // resource type
+};
+
+struct Resource {
+    const char* type;       // URL segment and JSON:API "type"; also the table
+    std::vector<Column> columns;
+    std::vector<Relation> relations;
+
+    const Column* column(const std::string& name) const {
+        for (auto& c : columns) if (name == c.name) return &c;
+        return nullptr;
+    }
+    const Relation* relation(const std::string& name) const {
+        for (auto& r : relations) if (name == r.name) return &r;
+        return nullptr;
+    }
+};
+
+const std::vector<Resource>& resources() {
+    static const std::vector<Resource> all = {
+        {"restaurant",
+            {{"name", Kind::Text}, {"cuisine_type", Kind::Text}, {"description", Kind::Text}},
+            {}},
+        {"category",
+            {{"name", Kind::Text}, {"sort_order", Kind::Int}, {"restaurant_id", Kind::Fk}},
+            {{"restaurant", "restaurant_id", "restaurant"}}},
+        {"menu_item",
+            {{"name", Kind::Text}, {"description", Kind::Text}, {"price", Kind::Real},
+             {"available", Kind::Bool}, {"category_id", Kind::Fk}},
+            {{"category", "category_id", "category"}}},
+        {"orders",
+            {{"table_number", Kind::Int}, {"status", Kind::Text},
+             {"customer_name", Kind::Text}, {"notes", Kind::Text},
+             {"created_at", Kind::Timestamp}, {"updated_at", Kind::Timestamp},
+             {"total", Kind::Real}, {"restaurant_id", Kind::Fk},
+             {"idempotency_key", Kind::Text}},
+            {{"restaurant", "restaurant_id", "restaurant"}}},
+        {"order_item",
+            {{"quantity", Kind::Int}, {"unit_price", Kind::Real},
+             {"special_instructions", Kind::Text}, {"order_id", Kind::Fk},
+             {"menu_item_id", Kind::Fk}, {"line_key", Kind::Text}},
+            {{"order", "order_id", "orders"}, {"menu_item", "menu_item_id", "menu_item"}}},
+    };
+    return all;
+}
+
+const Resource* findResource(const std::string& type) {
+    for (auto& r : resources()) if (type == r.type) return &r;
+    return nullptr;
+}
+
+// ─── Errors surfaced as JSON:API error documents ─────────────────────────────
+
+struct HttpError : std::runtime_error {
+    int status;
+    HttpError(int s, const std::string& msg) : std::runtime_error(msg), status(s) {}
+};
+
+// ─── SQLite helpers ──────────────────────────────────────────────────────────
+
+class Db {
+public:
+    explicit Db(const std::string& path) {
+        if (sqlite3_open_v2(path.c_str(), &db_, SQLITE_OPEN_READWRITE, nullptr) != SQLITE_OK) {
+            std::string msg = db_ ? sqlite3_errmsg(db_) : "out of memory";
+            sqlite3_close(db_);
+            throw std::runtime_error("cannot open " + path + ": " + msg);
+        }
+        sqlite3_busy_timeout(db_, 5000);
+    }
+    ~Db() { sqlite3_close(db_); }
+
+    void exec(const std::string& sql) {
+        char* err = nullptr;
+        if (sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &err) != SQLITE_OK) {
+            std::string msg = err ? err : "unknown error";
+            sqlite3_free(err);
+            throw std::runtime_error(msg + " in: " + sql);
+        }
+    }
+
+    sqlite3* handle() { return db_; }
+
+private:
+    sqlite3* db_ = nullptr;
+};
+
+class Stmt {
+public:
+    Stmt(Db& db, const std::string& sql) : db_(db) {
+        if (sqlite3_prepare_v2(db.handle(), sql.c_str(), -1, &st_, nullptr) != SQLITE_OK)
+            throw std::runtime_error(std::string(sqlite3_errmsg(db.handle())) + " in: " + sql);
+    }
+    ~Stmt() { sqlite3_finalize(st_); }
+
+    bool step() {
+        int rc = sqlite3_step(st_);
+        if (rc == SQLITE_ROW) return true;
+        if (rc == SQLITE_DONE) return false;
+        throw std::runtime_error(sqlite3_errmsg(db_.handle()));
+    }
+    sqlite3_stmt* get() { return st_; }
+
+private:
+    Db& db_;
+    sqlite3_stmt* st_ = nullptr;
+};
+
+std::string nowTimestamp() {
+    std::time_t t = std::time(nullptr);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", std::localtime(&t));
+    return buf;
+}
+
+// ─── Minimal JSON ────────────────────────────────────────────────────────────
+// Enough to read {"data":{"attributes":{...}}} request bodies.
+
+struct JValue {
+    enum Type { Null, Bool, Number, String, Array, Object } type = Null;
+    bool b = false;
+    double n = 0;
+    std::string s;
+    std::vector<JValue> arr;
+    std::vector<std::pair<std::string, JValue>> obj;
+
+    const JValue* get(const std::string& key) const {
+        for (auto& kv : obj) if (kv.first == key) return &kv.second;
+        return nullptr;
+    }
+};
+
+class JsonReader {
+public:
+    explicit JsonReader(const std::string& text) : p_(text.data()), end_(p_ + text.size()) {}
+
+    JValue parse() {
+        JValue v = value();
+        ws();
+        if (p_ != end_) fail();
+        return v;
+    }
+
+private:
+    const char* p_;
+    const char* end_;
+
+    [[noreturn]] void fail() { throw HttpError(400, "malformed JSON body"); }
+
+    void ws() { while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) p_++; }
+
+    bool lit(const char* word) {
+        size_t n = std::strlen(word);
+        if ((size_t)(end_ - p_) < n || std::strncmp(p_, word, n) != 0) return false;
+        p_ += n;
+        return true;
+    }
+
+    JValue value() {
+        ws();
+        if (p_ >= end_) fail();
+        JValue v;
+        char c = *p_;
+        if (c == '{') {
+            v.type = JValue::Object;
+            p_++; ws();
+            if (p_ < end_ && *p_ == '}') { p_++; return v; }
+            for (;;) {
+                ws();
+                if (p_ >= end_ || *p_ != '"') fail();
+                std::string key = string();
+                ws();
+                if (p_ >= end_ || *p_++ != ':') fail();
+                v.obj.emplace_back(std::move(key), value());
+                ws();
+                if (p_ < end_ && *p_ == ',') { p_++; continue; }
+                if (p_ < end_ && *p_ == '}') { p_++; return v; }
+                fail();
+            }
+        }
+        if (c == '[') {
+            v.type = JValue::Array;
+            p_++; ws();
+            if (p_ < end_ && *p_ == ']') { p_++; return v; }
+            for (;;) {
+                v.arr.push_back(value());
+                ws();
+                if (p_ < end_ && *p_ == ',') { p_++; continue; }
+                if (p_ < end_ && *p_ == ']') { p_++; return v; }
+                fail();
+            }
+        }
+        if (c == '"') { v.type = JValue::String; v.s = string(); return v; }
+        if (lit("true"))  { v.type = JValue::Bool; v.b = true; return v; }
+        if (lit("false")) { v.type = JValue::Bool; return v; }
+        if (lit("null"))  return v;
+
+        char* stop = nullptr;
+        v.n = std::strtod(p_, &stop);
+        if (stop == p_ || stop > end_) fail();
+        v.type = JValue::Number;
+        p_ = stop;
+        return v;
+    }
+
+    std::string string() {
+        std::string out;
+        p_++;  // opening quote
+        while (p_ < end_ && *p_ != '"') {
+            char c = *p_++;
+            if (c != '\\') { out += c; continue; }
+            if (p_ >= end_) fail();
+            char e = *p_++;
+            switch (e) {
+                case '"': case '\\': case '/': out += e; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    if (end_ - p_ < 4) fail();
+                    unsigned cp = std::strtoul(std::string(p_, 4).c_str(), nullptr, 16);
+                    p_ += 4;
+                    // BMP only; surrogate pairs are not produced by RestApiService
+                    if (cp < 0x80) out += (char)cp;
+                    else if (cp < 0x800) { out += (char)(0xC0 | (cp >> 6)); out += (char)(0x80 | (cp & 0x3F)); }
+                    else {
+                        out += (char)(0xE0 | (cp >> 12));
+                        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+                        out += (char)(0x80 | (cp & 0x3F));
+                    }
+                    break;
+                }
+                default: fail();
+            }
+        }
+        if (p_ >= end_) fail();
+        p_++;  // closing quote
+        return out;
+    }
+};
+
+void appendEscaped(std::string& out, const char* s, size_t n) {
+    out += '"';
+    for (size_t i = 0; i < n; i++) {
+        unsigned char c = (unsigned char)s[i];
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += (char)c;
+                }
+        }
+    }
+    out += '"';
+}
+
+void appendEscaped(std::string& out, const std::string& s) { appendEscaped(out, s.data(), s.size()); }
+
+void appendNumber(std::string& out, double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.15g", v);
+    out += buf;
+}
+
+// ─── HTTP request ────────────────────────────────────────────────────────────
+
+struct Request {
+    std::string method;
+    std::string path;
+    std::multimap<std::string, std::string> query;
+    std::map<std::string, std::string> headers;   // lower-case names
+    std::string body;
+};
+
+std::string urlDecode(const std::string& in) {
+    std::string out;
+    out.reserve(in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        if (in[i] == '+') out += ' ';
+        else if (in[i] == '%' && i + 2 < in.size()) {
+            out += (char)std::strtol(in.substr(i + 1, 2).c_str(), nullptr, 16);
+            i += 2;
+        } else {
+            out += in[i];
+        }
+    }
+    return out;
+}
+
+void parseQuery(const std::string& qs, std::multimap<std::string, std::string>& out) {
+    size_t pos = 0;
+    while (pos <= qs.size()) {
+        size_t amp = qs.find('&', pos);
+        if (amp == std::string::npos) amp = qs.size();
+        std::string pair = qs.substr(pos, amp - pos);
+        if (!pair.empty()) {
+            size_t eq = pair.find('=');
+            if (eq == std::string::npos) out.emplace(urlDecode(pair), "");
+            else out.emplace(urlDecode(pair.substr(0, eq)), urlDecode(pair.substr(eq + 1)));
+        }
+        pos = amp + 1;
+    }
+}
+
+const char* reasonPhrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 500: return "Internal Server Error";
+        case 502: return "Bad Gateway";
+        case 503: return "Service Unavailable";
+        case 504: return "Gateway Timeout";
+        default:  return "Error";
+    }
+}
+
+std::string errorDocument(int status, const std::string& detail) {
+    std::string out = "{\"errors\":[{\"status\":\"" + std::to_string(status) + "\",\"title\":";
+    appendEscaped(out, reasonPhrase(status));
+    out += ",\"detail\":";
+    appendEscaped(out, detail);
+    out += "}]}";
+    return out;
+}
+
+// ─── JSON:API handlers ───────────────────────────────────────────────────────
+
+class Handler {
+public:
+    Handler(Db& db, const Options& o) : db_(db), o_(o) {}
+
+    // Returns the HTTP status; fills body.
+    int handle(const Request& req, std::string& body) {
+        std::string rest = req.path;
+        if (rest.compare(0, o_.prefix.size(), o_.prefix) != 0)
+            throw HttpError(404, "no route for " + req.path);
+        rest = rest.substr(o_.prefix.size());
+
+        // /<type>/ or /<type>/<id>/
+        std::vector<std::string> seg;
+        size_t pos = 0;
+        while (pos < rest.size()) {
+            size_t slash = rest.find('/', pos);
+            if (slash == std::string::npos) slash = rest.size();
+            if (slash > pos) seg.push_back(rest.substr(pos, slash - pos));
+            pos = slash + 1;
+        }
+        if (seg.empty() || seg.size() > 2) throw HttpError(404, "no route for " + req.path);
+
+        const Resource* res = findResource(seg[0]);
+        if (!res) throw HttpError(404, "unknown resource type " + seg[0]);
+
+        long long id = 0;
+        if (seg.size() == 2) {
+            char* stop = nullptr;
+            id = std::strtoll(seg[1].c_str(), &stop, 10);
+            if (*stop != '\0' || id <= 0) throw HttpError(404, "invalid id " + seg[1]);
+        }
+
+        if (req.method == "GET" && id == 0) { body = list(*res, req); return 200; }
+        if (req.method == "GET")            { body = single(*res, id, req); return 200; }
+        if (req.method == "POST" && id == 0) { body = create(*res, req); return 201; }
+        if (req.method == "PATCH" && id != 0) { body = patch(*res, id, req); return 200; }
+        throw HttpError(405, req.method + " not supported on " + req.path);
+    }
+
+private:
+    Db& db_;
+    const Options& o_;
+
+    std::string selectList(const Resource& res) const {
+        std::string sql = "select \"id\"";
+        for (auto& c : res.columns) sql += std::string(", \"") + c.name + "\"";
+        return sql + " from \"" + res.type + "\"";
+    }
+
+    void bindValue(sqlite3_stmt* st, int idx, const Column& col, const std::string& v) const {
+        switch (col.kind) {
+            case Kind::Int:
+            case Kind::Fk:
+                sqlite3_bind_int64(st, idx, std::strtoll(v.c_str(), nullptr, 10));
+                break;
+            case Kind::Real:
+                sqlite3_bind_double(st, idx, std::strtod(v.c_str(), nullptr));
+                break;
+            case Kind::Bool:
+                sqlite3_bind_int(st, idx, (v == "true" || v == "1") ? 1 : 0);
+                break;
+            case Kind::Text:
+            case Kind::Timestamp:
+                sqlite3_bind_text(st, idx, v.data(), (int)v.size(), SQLITE_TRANSIENT);
+                break;
+        }
+    }
+
+    void bindJson(sqlite3_stmt* st, int idx, const Column& col, const JValue& v) const {
+        if (v.type == JValue::Null) { sqlite3_bind_null(st, idx); return; }
+        switch (col.kind) {
+            case Kind::Int:
+            case Kind::Fk:
+                if (v.type == JValue::Number) sqlite3_bind_int64(st, idx, (long long)v.n);
+                else if (v.type == JValue::String) bindValue(st, idx, col, v.s);
+                else throw HttpError(400, std::string("expected number for ") + col.name);
+                break;
+            case Kind::Real:
+                if (v.type == JValue::Number) sqlite3_bind_double(st, idx, v.n);
+                else if (v.type == JValue::String) bindValue(st, idx, col, v.s);
+                else throw HttpError(400, std::string("expected number for ") + col.name);
+                break;
+            case Kind::Bool:
+                if (v.type == JValue::Bool) sqlite3_bind_int(st, idx, v.b ? 1 : 0);
+                else if (v.type == JValue::Number) sqlite3_bind_int(st, idx, v.n != 0 ? 1 : 0);
+                else throw HttpError(400, std::string("expected boolean for ") + col.name);
+                break;
+            case Kind::Text:
+            case Kind::Timestamp:
+                if (v.type != JValue::String)
+                    throw HttpError(400, std::string("expected string for ") + col.name);
+                sqlite3_bind_text(st, idx, v.s.data(), (int)v.s.size(), SQLITE_TRANSIENT);
+                break;
+        }
+    }
+
+    // fields[type]=a,b: attributes and relationships to send, by type
+    using Fieldsets = std::map<std::string, std::vector<std::string>>;
+
+    static bool parseFieldset(const std::string& k, const std::string& v, Fieldsets& out) {
+        if (k.compare(0, 7, "fields[") != 0 || k.back() != ']') return false;
+        std::string type = k.substr(7, k.size() - 8);
+        const Resource* target = findResource(type);
+        if (!target) throw HttpError(400, "unknown fieldset type " + type);
+        auto& names = out[type];
+        size_t pos = 0;
+        while (pos <= v.size()) {
+            size_t comma = v.find(',', pos);
+            if (comma == std::string::npos) comma = v.size();
+            std::string name = v.substr(pos, comma - pos);
+            pos = comma + 1;
+            if (name.empty()) continue;
+            if (!target->column(name) && !target->relation(name))
+                throw HttpError(400, "unknown field " + name + " of " + type);
+            names.push_back(name);
+        }
+        return true;
+    }
+
+    static bool wanted(const std::vector<std::string>* fields, const char* name) {
+        return !fields || std::find(fields->begin(), fields->end(), name) != fields->end();
+    }
+
+    static const std::vector<std::string>* fieldsetOf(const Fieldsets& fs, const Resource& res) {
+        auto it = fs.find(res.type);
+        return it == fs.end() ? nullptr : &it->second;
+    }
+
+    // Row layout matches selectList(): id, then res.columns in order.
+    // `fields` limits the attributes and relationships written (nullptr: all).
+    void appendResource(std::string& out, const Resource& res, sqlite3_stmt* st,
+                        const std::vector<std::string>* fields = nullptr) const {
+        long long id = sqlite3_column_int64(st, 0);
+        out += "{\"attributes\":{";
+        bool firstAttr = true;
+        for (size_t i = 0; i < res.columns.size(); i++) {
+            const Column& c = res.columns[i];
+            int ci = (int)i + 1;
+            if (!wanted(fields, c.name)) continue;
+            if (!firstAttr) out += ',';
+            firstAttr = false;
+            out += '"'; out += c.name; out += "\":";
+            if (sqlite3_column_type(st, ci) == SQLITE_NULL) { out += "null"; continue; }
+            switch (c.kind) {
+                case Kind::Int:
+                case Kind::Fk:
+                    out += std::to_string(sqlite3_column_int64(st, ci));
+                    break;
+                case Kind::Real:
+                    appendNumber(out, sqlite3_column_double(st, ci));
+                    break;
+                case Kind::Bool:
+                    out += sqlite3_column_int(st, ci) ? "true" : "false";
+                    break;
+                case Kind::Text:
+                case Kind::Timestamp:
+                    appendEscaped(out, (const char*)sqlite3_column_text(st, ci),
+                                  (size_t)sqlite3_column_bytes(st, ci));
+                    break;
+            }
+        }
+        std::string self = o_.prefix + "/" + res.type + "/" + std::to_string(id) + "/";
+        out += "},\"id\":\"" + std::to_string(id) + "\",\"links\":{\"self\":\"" + self + "\"}";
+        bool firstRel = true;
+        for (const Relation& rel : res.relations) {
+            if (!wanted(fields, rel.name)) continue;
+            out += firstRel ? ",\"relationships\":{" : ",";
+            firstRel = false;
+            out += '"'; out += rel.name; out += "\":{\"data\":";
+            int ci = 1;
+            for (size_t i = 0; i < res.columns.size(); i++)
+                if (std::strcmp(res.columns[i].name, rel.fk) == 0) ci = (int)i + 1;
+            if (sqlite3_column_type(st, ci) == SQLITE_NULL) out += "null";
+            else out += "{\"id\":\"" + std::to_string(sqlite3_column_int64(st, ci)) +
+                        "\",\"type\":\"" + rel.target + "\"}";
+            out += ",\"links\":{\"self\":\"" + self + rel.name + "\"}}";
+        }
+        if (!firstRel) out += '}';
+        out += ",\"type\":\"";
+        out += res.type;
+        out += "\"}";
+    }
+
+    std::string list(const Resource& res, const Request& req) {
+        std::string where, order;
+        std::vector<std::pair<const Column*, std::string>> binds;
+        std::vector<const Relation*> includes;
+        Fieldsets fieldsets;
+        long long limit = o_.defaultPageLimit, offset = 0;
+        bool paged = false;
+
+        for (auto& kv : req.query) {
+            const std::string& k = kv.first;
+            if (k.compare(0, 7, "filter[") == 0 && k.back() == ']') {
+                std::string col = k.substr(7, k.size() - 8);
+                const char* op = "=";
+                size_t split = col.find("][");
+                if (split != std::string::npos) {
+                    std::string name = col.substr(split + 2);
+                    col.resize(split);
+                    if      (name == "gt") op = ">";
+                    else if (name == "ge") op = ">=";
+                    else if (name == "lt") op = "<";
+                    else if (name == "le") op = "<=";
+                    else throw HttpError(400, "unknown filter operator " + name);
+                }
+                const Column* c = res.column(col);
+                if (!c && col != "id") throw HttpError(400, "unknown filter attribute " + col);
+                static const Column idCol{"id", Kind::Int};
+                where += where.empty() ? " where " : " and ";
+                where += "\"" + col + "\" " + op + " ?";
+                binds.emplace_back(c ? c : &idCol, kv.second);
+            } else if (k == "sort") {
+                size_t pos = 0;
+                const std::string& s = kv.second;
+                while (pos <= s.size()) {
+                    size_t comma = s.find(',', pos);
+                    if (comma == std::string::npos) comma = s.size();
+                    std::string key = s.substr(pos, comma - pos);
+                    pos = comma + 1;
+                    if (key.empty()) continue;
+                    bool desc = key[0] == '-';
+                    if (desc) key = key.substr(1);
+                    if (key != "id" && !res.column(key))
+                        throw HttpError(400, "unknown sort attribute " + key);
+                    order += order.empty() ? " order by " : ", ";
+                    order += "\"" + key + "\"" + (desc ? " desc" : " asc");
+                }
+            } else if (k == "include") {
+                size_t pos = 0;
+                const std::string& s = kv.second;
+                while (pos <= s.size()) {
+                    size_t comma = s.find(',', pos);
+                    if (comma == std::string::npos) comma = s.size();
+                    std::string name = s.substr(pos, comma - pos);
+                    pos = comma + 1;
+                    if (name.empty()) continue;
+                    const Relation* rel = res.relation(name);
+                    if (!rel) throw HttpError(400, "unknown relationship " + name);
+                    includes.push_back(rel);
+                }
+            } else if (k == "page[limit]") {
+                limit = std::atoll(kv.second.c_str());
+                paged = true;
+            } else if (k == "page[offset]") {
+                offset = std::atoll(kv.second.c_str());
+                paged = true;
+            } else if (parseFieldset(k, kv.second, fieldsets)) {
+                // applied when writing resources
+            } else {
+                throw HttpError(400, "unsupported query parameter " + k);
+            }
+        }
+
+        std::string sql = selectList(res) + where + order;
+        if (limit > 0) sql += " limit " + std::to_string(limit);
+        if (offset > 0) sql += (limit > 0 ? "" : " limit -1") + std::string(" offset ") +
+                               std::to_string(offset);
+
+        Stmt st(db_, sql);
+        for (size_t i = 0; i < binds.size(); i++)
+            bindValue(st.get(), (int)i + 1, *binds[i].first, binds[i].second);
+
+        // Remember FK values for ?include=
+        std::vector<std::vector<long long>> fkIds(includes.size());
+        std::vector<int> fkCol(includes.size());
+        for (size_t r = 0; r < includes.size(); r++)
+            for (size_t i = 0; i < res.columns.size(); i++)
+                if (std::strcmp(res.columns[i].name, includes[r]->fk) == 0) fkCol[r] = (int)i + 1;
+
+        std::string out = "{\"data\":[";
+        bool first = true;
+        const std::vector<std::string>* fields = fieldsetOf(fieldsets, res);
+        while (st.step()) {
+            if (!first) out += ',';
+            first = false;
+            appendResource(out, res, st.get(), fields);
+            for (size_t r = 0; r < includes.size(); r++)
+                if (sqlite3_column_type(st.get(), fkCol[r]) != SQLITE_NULL)
+                    fkIds[r].push_back(sqlite3_column_int64(st.get(), fkCol[r]));
+        }
+        out += ']';
+
+        if (!includes.empty()) {
+            out += ",\"included\":[";
+            bool firstInc = true;
+            for (size_t r = 0; r < includes.size(); r++) {
+                const Resource& target = *findResource(includes[r]->target);
+                appendIncluded(out, target, fkIds[r], fieldsetOf(fieldsets, target), firstInc);
+            }
+            out += ']';
+        }
+        if (paged) {
+            Stmt count(db_, std::string("select count(*) from \"") + res.type + "\"" + where);
+            for (size_t i = 0; i < binds.size(); i++)
+                bindValue(count.get(), (int)i + 1, *binds[i].first, binds[i].second);
+            count.step();
+            out += ",\"meta\":{\"count\":" +
+                   std::to_string(sqlite3_column_int64(count.get(), 0)) + "}";
+        }
+        out += ",\"jsonapi\":{\"version\":\"1.0\"}}";
+        return out;
+    }
+
+    void appendIncluded(std::string& out, const Resource& target, std::vector<long long>& ids,
+                        const std::vector<std::string>* fields, bool& first) {
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+        const size_t chunk = 500;   // stay well under SQLITE_MAX_VARIABLE_NUMBER
+        for (size_t start = 0; start < ids.size(); start += chunk) {
+            size_t n = std::min(chunk, ids.size() - start);
+            std::string sql = selectList(target) + " where \"id\" in (";
+            for (size_t i = 0; i < n; i++) sql += i ? ",?" : "?";
+            sql += ")";
+            Stmt st(db_, sql);
+            for (size_t i = 0; i < n; i++) sqlite3_bind_int64(st.get(), (int)i + 1, ids[start + i]);
+            while (st.step()) {
+                if (!first) out += ',';
+                first = false;
+                appendResource(out, target, st.get(), fields);
+            }
+        }
+    }
+
+    std::string single(const Resource& res, long long id, const Request& req) {
+        Fieldsets fieldsets;
+        for (auto& kv : req.query)
+            if (!parseFieldset(kv.first, kv.second, fieldsets))
+                throw HttpError(400, "unsupported query parameter " + kv.first);
+        return single(res, id, fieldsetOf(fieldsets, res));
+    }
+
+    std::string single(const Resource& res, long long id,
+                       const std::vector<std::string>* fields = nullptr) {
+        Stmt st(db_, selectList(res) + " where \"id\" = ?");
+        sqlite3_bind_int64(st.get(), 1, id);
+        if (!st.step())
+            throw HttpError(404, std::string(res.type) + " " + std::to_string(id) + " not found");
+        std::string out = "{\"data\":";
+        appendResource(out, res, st.get(), fields);
+        out += ",\"jsonapi\":{\"version\":\"1.0\"}}";
+        return out;
+    }
+
+    static const JValue& attributesOf(const JValue& doc) {
+        const JValue* data = doc.get("data");
+        if (!data || data->type != JValue::Object) throw HttpError(400, "body has no data object");
+        const JValue* attrs = data->get("attributes");
+        if (!attrs || attrs->type != JValue::Object) throw HttpError(400, "body has no attributes");
+        return *attrs;
+    }
+
+    std::string create(const Resource& res, const Request& req) {
+        JValue doc = JsonReader(req.body).parse();
+        const JValue& attrs = attributesOf(doc);
+        for (auto& kv : attrs.obj)
+            if (!res.column(kv.first)) throw HttpError(400, "unknown attribute " + kv.first);
+
+        // Every column is written: Wt::Dbo declares them all NOT NULL
+        std::string sql = std::string("insert into \"") + res.type + "\" (\"version\"";
+        std::string vals = "0";
+        for (auto& c : res.columns) {
+            sql += std::string(", \"") + c.name + "\"";
+            vals += ", ?";
+        }
+        sql += ") values (" + vals + ")";
+
+        Stmt st(db_, sql);
+        std::string now = nowTimestamp();
+        for (size_t i = 0; i < res.columns.size(); i++) {
+            const Column& c = res.columns[i];
+            int idx = (int)i + 1;
+            if (std::strcmp(c.name, "updated_at") == 0) { bindValue(st.get(), idx, c, now); continue; }
+            if (const JValue* v = attrs.get(c.name)) { bindJson(st.get(), idx, c, *v); continue; }
+            switch (c.kind) {
+                case Kind::Int:       sqlite3_bind_int(st.get(), idx, 0); break;
+                case Kind::Real:      sqlite3_bind_double(st.get(), idx, 0.0); break;
+                case Kind::Bool:      sqlite3_bind_int(st.get(), idx, 1); break;
+                case Kind::Text:      sqlite3_bind_text(st.get(), idx, "", 0, SQLITE_STATIC); break;
+                case Kind::Timestamp: bindValue(st.get(), idx, c, now); break;
+                case Kind::Fk:        sqlite3_bind_null(st.get(), idx); break;
+            }
+        }
+        st.step();
+        return single(res, sqlite3_last_insert_rowid(db_.handle()));
+    }
+
+    std::string patch(const Resource& res, long long id, const Request& req) {
+        JValue doc = JsonReader(req.body).parse();
+        const JValue& attrs = attributesOf(doc);
+
+        std::string sql = std::string("update \"") + res.type + "\" set \"version\" = \"version\" + 1";
+        std::vector<std::pair<const Column*, const JValue*>> sets;
+        for (auto& kv : attrs.obj) {
+            const Column* c = res.column(kv.first);
+            if (!c) throw HttpError(400, "unknown attribute " + kv.first);
+            if (kv.first == "updated_at") continue;     // the trigger's, below
+            sql += std::string(", \"") + c->name + "\" = ?";
+            sets.emplace_back(c, &kv.second);
+        }
+        const Column* touched = res.column("updated_at");
+        if (touched) sql += ", \"updated_at\" = ?";
+        sql += " where \"id\" = ?";
+
+        Stmt st(db_, sql);
+        int idx = 1;
+        for (auto& s : sets) bindJson(st.get(), idx++, *s.first, *s.second);
+        if (touched) bindValue(st.get(), idx++, *touched, nowTimestamp());
+        sqlite3_bind_int64(st.get(), idx, id);
+        st.step();
+        if (sqlite3_changes(db_.handle()) == 0)
+            throw HttpError(404, std::string(res.type) + " " + std::to_string(id) + " not found");
+        return single(res, id);
+    }
+};
+
+// ─── Server ──────────────────────────────────────────────────────────────────
+
+std::atomic<bool> gStop{false};
+
+void onSignal(int) { gStop = true; }
+
+struct Counters {
+    std::atomic<long long> requests{0};
+    std::atomic<long long> injectedErrors{0};
+    std::atomic<long long> dropped{0};
+    std::atomic<long long> failed{0};     // 4xx/5xx not injected
+    std::atomic<long long> replayed{0};   // answered from IdempotencyCache
+    std::atomic<int> activeConnections{0};
+};
+
+// Successful POST responses by Idempotency-Key, oldest dropped first.
+// Keyed POSTs run under mutex() from lookup to store, so two connections
+// racing on one key cannot both write; unkeyed requests are unaffected.
+class IdempotencyCache {
+public:
+    static constexpr size_t kCapacity = 100000;
+
+    std::mutex& mutex() { return mutex_; }
+
+    // mutex() held
+    bool find(const std::string& key, int& status, std::string& body) const {
+        auto it = responses_.find(key);
+        if (it == responses_.end()) return false;
+        status = it->second.first;
+        body = it->second.second;
+        return true;
+    }
+
+    // mutex() held
+    void store(const std::string& key, int status, const std::string& body) {
+        if (!responses_.emplace(key, std::make_pair(status, body)).second) return;
+        order_.push_back(key);
+        if (order_.size() > kCapacity) {
+            responses_.erase(order_.front());
+            order_.pop_front();
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::pair<int, std::string>> responses_;
+    std::deque<std::string> order_;
+};
+
+// ─── Response compression ────────────────────────────────────────────────────
+
+const size_t kMinCompressBytes = 256;
+
+// Whether an Accept-Encoding header value allows `coding` (q=0 refuses it)
+bool accepts(const std::string& acceptEncoding, const std::string& coding) {
+    size_t pos = 0;
+    while (pos < acceptEncoding.size()) {
+        size_t comma = acceptEncoding.find(',', pos);
+        if (comma == std::string::npos) comma = acceptEncoding.size();
+        std::string item = acceptEncoding.substr(pos, comma - pos);
+        pos = comma + 1;
+
+        size_t semi = item.find(';');
+        std::string name = item.substr(0, semi);
+        name.erase(0, name.find_first_not_of(' '));
+        name.erase(name.find_last_not_of(' ') + 1);
+        if (name != coding) continue;
+        size_t q = semi == std::string::npos ? std::string::npos : item.find("q=", semi);
+        return q == std::string::npos || std::atof(item.c_str() + q + 2) > 0;
+    }
+    return false;
+}
+
+std::string gzipEncode(const std::string& in) {
+    z_stream zs{};
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK)
+        throw std::runtime_error("deflateInit2 failed");
+    std::string out(deflateBound(&zs, (uLong)in.size()), '\0');
+    zs.next_in = (Bytef*)in.data();
+    zs.avail_in = (uInt)in.size();
+    zs.next_out = (Bytef*)&out[0];
+    zs.avail_out = (uInt)out.size();
+    int rc = deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    if (rc != Z_STREAM_END) throw std::runtime_error("gzip failed");
+    return out;
+}
+
+#ifdef MOCK_ALS_BROTLI
+std::string brotliEncode(const std::string& in) {
+    size_t size = BrotliEncoderMaxCompressedSize(in.size());
+    std::string out(size, '\0');
+    // Quality 5: the usual on-the-fly setting for reverse proxies
+    if (!BrotliEncoderCompress(5, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, in.size(),
+                               (const uint8_t*)in.data(), &size, (uint8_t*)&out[0]))
+        throw std::runtime_error("brotli failed");
+    out.resize(size);
+    return out;
+}
+#endif
+
+// Encodes body in place as the request allows; returns the coding or nullptr
+const char* compressBody(const Options& o, const Request& req, std::string& body) {
+    if (!o.compression || body.size() < kMinCompressBytes) return nullptr;
+    auto ae = req.headers.find("accept-encoding");
+    if (ae == req.headers.end()) return nullptr;
+#ifdef MOCK_ALS_BROTLI
+    if (accepts(ae->second, "br")) { body = brotliEncode(body); return "br"; }
+#endif
+    if (accepts(ae->second, "gzip")) { body = gzipEncode(body); return "gzip"; }
+    return nullptr;
+}
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += (size_t)n;
+    }
+    return true;
+}
+
+// Reads one request; false on EOF, timeout or malformed input.
+bool readRequest(int fd, std::string& buf, Request& req) {
+    size_t headerEnd;
+    while ((headerEnd = buf.find("\r\n\r\n")) == std::string::npos) {
+        if (buf.size() > 64 * 1024) return false;
+        char tmp[8192];
+        ssize_t n = ::recv(fd, tmp, sizeof(tmp), 0);
+        if (n <= 0) return false;
+        buf.append(tmp, (size_t)n);
+    }
+
+    std::string head = buf.substr(0, headerEnd);
+    size_t lineEnd = head.find("\r\n");
+    std::string requestLine = head.substr(0, lineEnd);
+
+    size_t sp1 = requestLine.find(' ');
+    size_t sp2 = requestLine.find(' ', sp1 + 1);
+    if (sp1 == std::string::npos || sp2 == std::string::npos) return false;
+    req.method = requestLine.substr(0, sp1);
+    std::string target = requestLine.substr(sp1 + 1, sp2 - sp1 - 1);
+    size_t q = target.find('?');
+    req.path = urlDecode(target.substr(0, q));
+    req.query.clear();
+    if (q != std::string::npos) parseQuery(target.substr(q + 1), req.query);
+
+    req.headers.clear();
+    size_t pos = lineEnd == std::string::npos ? head.size() : lineEnd + 2;
+    while (pos < head.size()) {
+        size_t e = head.find("\r\n", pos);
+        if (e == std::string::npos) e = head.size();
+        std::string line = head.substr(pos, e - pos);
+        pos = e + 2;
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string name = line.substr(0, colon);
+        for (auto& ch : name) ch = (char)std::tolower((unsigned char)ch);
+        size_t v = line.find_first_not_of(' ', colon + 1);
+        req.headers[name] = v == std::string::npos ? "" : line.substr(v);
+    }
+
+    size_t contentLength = 0;
+    auto cl = req.headers.find("content-length");
+    if (cl != req.headers.end()) contentLength = std::strtoul(cl->second.c_str(), nullptr, 10);
+    if (contentLength > 16 * 1024 * 1024) return false;
+
+    size_t bodyStart = headerEnd + 4;
+    while (buf.size() < bodyStart + contentLength) {
+        char tmp[8192];
+        ssize_t n = ::recv(fd, tmp, sizeof(tmp), 0);
+        if (n <= 0) return false;
+        buf.append(tmp, (size_t)n);
+    }
+    req.body = buf.substr(bodyStart, contentLength);
+    buf.erase(0, bodyStart + contentLength);
+    return true;
+}
+
+void serveConnection(int fd, const Options& o, Counters& counters, IdempotencyCache& idempotency,
+                     unsigned long long seed) {
+    counters.activeConnections++;
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    try {
+        Db db(o.dbPath);
+        Handler handler(db, o);
+        std::string buf;
+        Request req;
+
+        while (!gStop && readRequest(fd, buf, req)) {
+            auto t0 = std::chrono::steady_clock::now();
+            counters.requests++;
+
+            double delayMs = o.latencyMs + o.jitterMs * unit(rng);
+            if (o.tailRate > 0 && unit(rng) < o.tailRate) delayMs += o.tailMs;
+            if (delayMs > 0)
+                std::this_thread::sleep_for(std::chrono::microseconds((long long)(delayMs * 1000)));
+
+            if (o.dropRate > 0 && unit(rng) < o.dropRate) {
+                counters.dropped++;
+                if (o.verbose)
+                    std::cout << "[mock_als] " << req.method << " " << req.path
+                              << " -> dropped" << std::endl;
+                break;
+            }
+
+            int status;
+            std::string body;
+            if (o.errorRate > 0 && unit(rng) < o.errorRate) {
+                counters.injectedErrors++;
+                status = o.errorStatus;
+                body = errorDocument(status, "injected by restaurant_pos_mock_als");
+            } else {
+                auto key = req.headers.find("idempotency-key");
+                std::unique_lock<std::mutex> keyed;
+                if (o.idempotencyHeader && req.method == "POST" && key != req.headers.end() &&
+                    !key->second.empty())
+                    keyed = std::unique_lock<std::mutex>(idempotency.mutex());
+
+                if (keyed && idempotency.find(key->second, status, body)) {
+                    counters.replayed++;
+                } else {
+                    try {
+                        status = handler.handle(req, body);
+                    } catch (HttpError& e) {
+                        status = e.status;
+                        body = errorDocument(status, e.what());
+                    } catch (std::exception& e) {
+                        status = 500;
+                        body = errorDocument(status, e.what());
+                    }
+                    if (status >= 400) counters.failed++;
+                    else if (keyed) idempotency.store(key->second, status, body);
+                }
+            }
+
+            auto conn = req.headers.find("connection");
+            bool close = conn != req.headers.end() && conn->second == "close";
+            const char* encoding = compressBody(o, req, body);
+
+            std::string resp = "HTTP/1.1 " + std::to_string(status) + " " + reasonPhrase(status) +
+                "\r\nContent-Type: application/vnd.api+json"
+                "\r\nContent-Length: " + std::to_string(body.size()) +
+                (encoding ? std::string("\r\nContent-Encoding: ") + encoding : "") +
+                (o.compression ? "\r\nVary: Accept-Encoding" : "") +
+                (close ? "\r\nConnection: close" : "") + "\r\n\r\n";
+            resp += body;
+            if (!sendAll(fd, resp)) break;
+
+            if (o.verbose) {
+                double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - t0).count();
+                std::cout << "[mock_als] " << req.method << " " << req.path << " -> " << status
+                          << " (" << body.size() << " bytes" << (encoding ? " " : "")
+                          << (encoding ? encoding : "") << ", " << ms << " ms)" << std::endl;
+            }
+            if (close) break;
+        }
+    } catch (std::exception& e) {
+        std::cerr << "[mock_als] Connection error: " << e.what() << std::endl;
+    }
+
+    ::close(fd);
+    counters.activeConnections--;
+}
+
+int listenOn(const Options& o) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)o.port);
+    if (::inet_pton(AF_INET, o.bindAddr.c_str(), &addr.sin_addr) != 1)
+        throw std::runtime_error("invalid --bind address " + o.bindAddr);
+    if (::bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0)
+        throw std::runtime_error("bind " + o.bindAddr + ":" + std::to_string(o.port) + ": " +
+                                 std::strerror(errno));
+    if (::listen(fd, 256) < 0)
+        throw std::runtime_error(std::string("listen: ") + std::strerror(errno));
+    return fd;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options o;
+        if (!parseArgs(argc, argv, o)) return 0;
+
+        {
+            Db db(o.dbPath);
+            int tables;
+            {
+                Stmt st(db, "select count(*) from sqlite_master where type = 'table' and name in "
+                            "('restaurant','category','menu_item','orders','order_item')");
+                st.step();
+                tables = sqlite3_column_int(st.get(), 0);
+            }
+            if (tables != 5) {
+                std::cerr << "[mock_als] " << o.dbPath << " lacks the POS schema; run "
+                             "restaurant_pos once in LOCAL mode or use restaurant_pos_loadgen"
+                          << std::endl;
+                return 1;
+            }
+            // Readers on other connections must not block writers
+            db.exec("PRAGMA journal_mode=WAL;");
+
+            // createOrder's and addOrderItems' keys, as sql/schema.sql has
+            // them ("" when none was sent)
+            auto addKeyColumn = [&db](const std::string& table, const std::string& column) {
+                Stmt st(db, "select count(*) from pragma_table_info('" + table + "') "
+                            "where name = '" + column + "'");
+                st.step();
+                if (sqlite3_column_int(st.get(), 0) > 0) return;
+                db.exec("alter table " + table + " add column " + column +
+                        " text not null default ''");
+            };
+            addKeyColumn("orders", "idempotency_key");
+            addKeyColumn("order_item", "line_key");
+            db.exec("create unique index if not exists idx_orders_idempotency_key "
+                    "on orders (idempotency_key) where idempotency_key <> ''");
+            db.exec("create unique index if not exists idx_order_item_line_key "
+                    "on order_item (line_key) where line_key <> ''");
+        }
+
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+
+        int lfd = listenOn(o);
+        std::cout << "[mock_als] Serving " << o.dbPath << " at http://" << o.bindAddr << ":"
+                  << o.port << o.prefix << "/ (latency " << o.latencyMs << "+" << o.jitterMs
+                  << " ms, tail " << o.tailRate << "@" << o.tailMs << " ms, errors "
+                  << o.errorRate << ", drops " << o.dropRate << ")" << std::endl;
+
+        static Counters counters;   // outlive detached connection threads
+        static IdempotencyCache idempotency;
+        unsigned long long connSeq = 0;
+        while (!gStop) {
+            pollfd pfd{lfd, POLLIN, 0};
+            if (::poll(&pfd, 1, 200) <= 0) continue;
+            int cfd = ::accept(lfd, nullptr, nullptr);
+            if (cfd < 0) continue;
+
+            int one = 1;
+            ::setsockopt(cfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            timeval tv{30, 0};   // idle keep-alive connections
+            ::setsockopt(cfd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+            std::thread(serveConnection, cfd, std::cref(o), std::ref(counters),
+                        std::ref(idempotency), o.seed + connSeq++).detach();
+        }
+        ::close(lfd);
+
+        // Let in-flight requests finish before the counters go away
+        for (int i = 0; i < 50 && counters.activeConnections > 0; i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        std::cout << "\n[mock_als] " << counters.requests << " requests, "
+                  << counters.failed << " failed, " << counters.injectedErrors
+                  << " injected errors, " << counters.dropped << " dropped, "
+                  << counters.replayed << " idempotent replays" << std::endl;
+    } catch (std::exception& e) {
+        std::cerr << "[mock_als] Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}